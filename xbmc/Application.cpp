@@ -203,6 +203,7 @@
 #else
 #define MEASURE_FUNCTION
 #endif
+#include "utils/PerformanceTrace.h"
 
 #ifdef TARGET_WINDOWS
 #include <shlobj.h>
@@ -1759,6 +1760,11 @@ bool CApplication::LoadSkin(const SkinPtr& skin)
 
   g_localizeStrings.LoadSkinStrings(langPath, CSettings::Get().GetString("locale.language"));
 
+  // have the characters of the skin's labels rendered while the skin loads, rather than when they're first shown
+  std::wstring characters;
+  g_localizeStrings.GetCharacters(characters, 31000, 31999);
+  g_fontManager.PrecacheGlyphs(characters);
+
   g_SkinInfo->LoadIncludes();
 
   int64_t start;
@@ -1946,6 +1952,7 @@ bool CApplication::LoadUserWindows()
 bool CApplication::RenderNoPresent()
 {
   MEASURE_FUNCTION;
+  TRACE_SCOPE("CApplication::RenderNoPresent");
 
 // DXMERGE: This may have been important?
 //  g_graphicsContext.AcquireCurrentContext();
@@ -1990,6 +1997,7 @@ void CApplication::Render()
     return;
 
   MEASURE_FUNCTION;
+  TRACE_SCOPE("CApplication::Render");
 
   int vsync_mode = CSettings::Get().GetInt("videoscreen.vsync");
 
@@ -2106,10 +2114,14 @@ void CApplication::Render()
   }
 
   if (flip)
+  {
+    TRACE_SCOPE("Flip");
     g_graphicsContext.Flip(dirtyRegions);
+  }
 
   if (!extPlayerActive && g_graphicsContext.IsFullScreenVideo() && !m_pPlayer->IsPausedPlayback())
   {
+    TRACE_SCOPE("FrameWait");
     g_renderManager.FrameWait(100);
   }
 
@@ -2687,6 +2699,7 @@ bool CApplication::OnAction(const CAction &action)
 void CApplication::FrameMove(bool processEvents, bool processGUI)
 {
   MEASURE_FUNCTION;
+  TRACE_SCOPE("CApplication::FrameMove");
 
   if (processEvents)
   {
@@ -4431,6 +4444,7 @@ void CApplication::ShowAppMigrationMessage()
 void CApplication::Process()
 {
   MEASURE_FUNCTION;
+  TRACE_SCOPE("CApplication::Process");
 
   // dispatch the messages generated by python or other threads to the current window
   g_windowManager.DispatchThreadMessages();
@@ -78,6 +78,9 @@ using namespace std;
 using namespace MUSIC_INFO;
 using namespace PERIPHERALS;
 
+// time in ms that may be spent on queued messages each time they are processed
+#define MESSAGE_TIME_BUDGET 20
+
 CDelayedMessage::CDelayedMessage(ThreadMessage& msg, unsigned int delay) : CThread("DelayedMessage")
 {
   m_msg.dwMessage  = msg.dwMessage;
@@ -116,28 +119,17 @@ CApplicationMessenger::~CApplicationMessenger()
 
 void CApplicationMessenger::Cleanup()
 {
-  CSingleLock lock (m_critSection);
-
-  while (!m_vecMessages.empty())
-  {
-    ThreadMessage* pMsg = m_vecMessages.front();
-
-    if (pMsg->waitEvent)
-      pMsg->waitEvent->Set();
-
-    delete pMsg;
-    m_vecMessages.pop();
-  }
-
-  while (!m_vecWindowMessages.empty())
+  MessageQueue* queues[] = { &m_messages, &m_windowMessages };
+  for (unsigned int i = 0; i < sizeof(queues) / sizeof(queues[0]); i++)
   {
-    ThreadMessage* pMsg = m_vecWindowMessages.front();
-
-    if (pMsg->waitEvent)
-      pMsg->waitEvent->Set();
-
-    delete pMsg;
-    m_vecWindowMessages.pop();
+    MessageQueue::Node* node;
+    while ((node = queues[i]->Pop()))
+    {
+      if (node->value.waitEvent)
+        node->value.waitEvent->Set();
+      node->value.waitEvent.reset();
+      queues[i]->Free(node);
+    }
   }
 }
 
@@ -162,8 +154,6 @@ void CApplicationMessenger::SendMessage(ThreadMessage& message, bool wait)
     }
   }
 
-  CSingleLock lock (m_critSection);
-
   if (g_application.m_bStop)
   {
     if (message.waitEvent)
@@ -171,7 +161,11 @@ void CApplicationMessenger::SendMessage(ThreadMessage& message, bool wait)
     return;
   }
 
-  ThreadMessage* msg = new ThreadMessage();
+  MessageQueue &queue = message.dwMessage == TMSG_DIALOG_DOMODAL ? m_windowMessages : m_messages;
+
+  // the node comes from the queue's pool, assigning reuses its string storage
+  MessageQueue::Node* node = queue.Alloc();
+  ThreadMessage* msg = &node->value;
   msg->dwMessage = message.dwMessage;
   msg->param1   = message.param1;
   msg->param2   = message.param2;
@@ -180,16 +174,11 @@ void CApplicationMessenger::SendMessage(ThreadMessage& message, bool wait)
   msg->strParam = message.strParam;
   msg->params = message.params;
 
-  if (msg->dwMessage == TMSG_DIALOG_DOMODAL)
-    m_vecWindowMessages.push(msg);
-  else
-    m_vecMessages.push(msg);
-  lock.Leave();  // this releases the lock on the vec of messages and
-                 //   allows the ProcessMessage to execute and therefore
-                 //   delete the message itself. Therefore any accesss
-                 //   of the message itself after this point consittutes
-                 //   a race condition (yarc - "yet another race condition")
-                 //
+  queue.Push(node); // from here on the message belongs to the processing
+                    //   thread, which may already have deleted it. Any
+                    //   access of the message itself after this point
+                    //   consittutes a race condition
+                    //
   if (waitEvent) // ... it just so happens we have a spare reference to the
                  //  waitEvent ... just for such contingencies :)
   { 
@@ -202,25 +191,31 @@ void CApplicationMessenger::SendMessage(ThreadMessage& message, bool wait)
 void CApplicationMessenger::ProcessMessages()
 {
   // process threadmessages
-  CSingleLock lock (m_critSection);
-  while (!m_vecMessages.empty())
-  {
-    ThreadMessage* pMsg = m_vecMessages.front();
-    //first remove the message from the queue, else the message could be processed more then once
-    m_vecMessages.pop();
+  ProcessQueue(m_messages);
+}
 
-    //Leave here as the message might make another
-    //thread call processmessages or sendmessage
+void CApplicationMessenger::ProcessQueue(MessageQueue &queue)
+{
+  // messages are handled until the time budget of this frame is used up, the
+  // remaining ones are left for the next frame. At least one is processed.
+  XbmcThreads::EndTime budget(MESSAGE_TIME_BUDGET);
 
-    boost::shared_ptr<CEvent> waitEvent = pMsg->waitEvent; 
-    lock.Leave(); // <- see the large comment in SendMessage ^
+  MessageQueue::Node* node;
+  while ((node = queue.Pop()))
+  {
+    // the node is ours now, so the message might make another
+    // thread call processmessages or sendmessage
+    ThreadMessage* pMsg = &node->value;
+    boost::shared_ptr<CEvent> waitEvent = pMsg->waitEvent;
+    pMsg->waitEvent.reset();
 
     ProcessMessage(pMsg);
     if (waitEvent)
       waitEvent->Set();
-    delete pMsg;
+    queue.Free(node);
 
-    lock.Enter();
+    if (budget.IsTimePast())
+      break;
   }
 }
 
@@ -869,26 +864,8 @@ void CApplicationMessenger::ProcessMessage(ThreadMessage *pMsg)
 
 void CApplicationMessenger::ProcessWindowMessages()
 {
-  CSingleLock lock (m_critSection);
   //message type is window, process window messages
-  while (!m_vecWindowMessages.empty())
-  {
-    ThreadMessage* pMsg = m_vecWindowMessages.front();
-    //first remove the message from the queue, else the message could be processed more then once
-    m_vecWindowMessages.pop();
-
-    // leave here in case we make more thread messages from this one
-
-    boost::shared_ptr<CEvent> waitEvent = pMsg->waitEvent;
-    lock.Leave(); // <- see the large comment in SendMessage ^
-
-    ProcessMessage(pMsg);
-    if (waitEvent)
-      waitEvent->Set();
-    delete pMsg;
-
-    lock.Enter();
-  }
+  ProcessQueue(m_windowMessages);
 }
 
 int CApplicationMessenger::SetResponse(std::string response)
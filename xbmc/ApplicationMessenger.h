@@ -21,10 +21,10 @@
  */
 
 #include "guilib/WindowIDs.h"
+#include "threads/MPSCQueue.h"
 #include "threads/Thread.h"
 #include <boost/shared_ptr.hpp>
 
-#include <queue>
 #include "utils/GlobalsHandling.h"
 
 class CFileItem;
@@ -152,6 +152,8 @@ namespace xbmcutil
 class CApplicationMessenger
 {
 public:
+  typedef XbmcThreads::CMPSCQueue<ThreadMessage> MessageQueue;
+
   /*!
    \brief The only way through which the global instance of the CApplicationMessenger should be accessed.
    \return the global instance.
@@ -164,6 +166,11 @@ public:
   void ProcessMessages(); // only call from main thread.
   void ProcessWindowMessages();
 
+  /*!
+   \brief Depth and latency statistics of the queued thread messages
+   */
+  MessageQueue::Stats GetQueueStats() const { return m_messages.GetStats(); }
+
 
   void MediaPlay(std::string filename);
   void MediaPlay(const CFileItem &item, bool wait = true);
@@ -264,10 +271,10 @@ private:
   CApplicationMessenger(const CApplicationMessenger&);
   CApplicationMessenger const& operator=(CApplicationMessenger const&);
   void ProcessMessage(ThreadMessage *pMsg);
+  void ProcessQueue(MessageQueue &queue);
 
-  std::queue<ThreadMessage*> m_vecMessages;
-  std::queue<ThreadMessage*> m_vecWindowMessages;
-  CCriticalSection m_critSection;
+  MessageQueue m_messages;
+  MessageQueue m_windowMessages;
   CCriticalSection m_critBuffer;
   std::string bufferResponse;
 };
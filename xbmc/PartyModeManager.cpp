@@ -41,6 +41,16 @@ using namespace std;
 using namespace PLAYLIST;
 
 #define QUEUE_DEPTH       10
+#define MAX_FAILED_FETCH  10
+
+static vector<int> GetIds(const vector< pair<int,int> > &songIDs)
+{
+  vector<int> ids;
+  ids.reserve(songIDs.size());
+  for (vector< pair<int,int> >::const_iterator it = songIDs.begin(); it != songIDs.end(); ++it)
+    ids.push_back(it->second);
+  return ids;
+}
 
 CPartyModeManager::CPartyModeManager(void)
 {
@@ -122,6 +132,7 @@ bool CPartyModeManager::Enable(PartyModeContext context /*= PARTYMODECONTEXT_MUS
 
       CLog::Log(LOGINFO, "PARTY MODE MANAGER: Registering filter:[%s]", m_strCurrentFilterMusic.c_str());
       m_iMatchingSongs = (int)db.GetSongIDs(m_strCurrentFilterMusic, songIDs);
+      m_songSampler.Reset(GetIds(songIDs));
       if (m_iMatchingSongs < 1 && StringUtils::EqualsNoCase(m_type, "songs"))
       {
         pDialog->Close();
@@ -152,6 +163,7 @@ bool CPartyModeManager::Enable(PartyModeContext context /*= PARTYMODECONTEXT_MUS
 
       CLog::Log(LOGINFO, "PARTY MODE MANAGER: Registering filter:[%s]", m_strCurrentFilterVideo.c_str());
       m_iMatchingSongs += (int)db.GetMusicVideoIDs(m_strCurrentFilterVideo, songIDs2);
+      m_videoSampler.Reset(GetIds(songIDs2));
       if (m_iMatchingSongs < 1)
       {
         pDialog->Close();
@@ -341,29 +353,35 @@ bool CPartyModeManager::AddRandomSongs(int iSongs /* = 0 */)
     if (database.Open())
     {
       // Method:
-      // 1. Grab a random entry from the database using a where clause
-      // 2. Iterate on iSongs.
-
-      // Note: At present, this method is faster than the alternative, which is to grab
-      // all valid songids, then select a random number of them (as done in AddInitialSongs()).
-      // The reason for this is simply the number of songs we are requesting - we generally
-      // only want one here.  Any more than about 3 songs and it is more efficient
-      // to use the technique in AddInitialSongs.  As it's unlikely that we'll require
-      // more than 1 song at a time here, this method is faster.
+      // 1. Draw a random id from the matching ones gathered in Enable(),
+      //    passing over the ones in the history
+      // 2. Grab that entry from the database by its id
+      // 3. Iterate on iSongs.
+
+      // Note: This saves the database from filtering and randomly sorting the
+      // whole library for every song we add. An entry that can't be fetched
+      // is skipped for this round, the ids are gathered again on Enable().
       bool error(false);
+      int failed = 0;
       for (int i = 0; i < iSongsToAdd; i++)
       {
-        pair<std::string,std::string> whereClause = GetWhereClauseWithHistory();
         CFileItemPtr item(new CFileItem);
         int songID;
-        if (database.GetRandomSong(item.get(), songID, whereClause.first))
+        if (!m_songSampler.Next(songID, GetHistory(1)))
+        {
+          error = true;
+          break;
+        }
+        if (database.GetPartyModeSong(item.get(), songID))
         { // success
           Add(item);
           AddToHistory(1,songID);
         }
+        else if (++failed < MAX_FAILED_FETCH)
+          i--;
         else
         {
-          error = true;
+          CLog::Log(LOGWARNING, "CPartyModeManager::AddRandomSongs - failed to fetch %i entries, giving up for now", failed);
           break;
         }
       }
@@ -389,29 +407,35 @@ bool CPartyModeManager::AddRandomSongs(int iSongs /* = 0 */)
     if (database.Open())
     {
       // Method:
-      // 1. Grab a random entry from the database using a where clause
-      // 2. Iterate on iSongs.
-
-      // Note: At present, this method is faster than the alternative, which is to grab
-      // all valid songids, then select a random number of them (as done in AddInitialSongs()).
-      // The reason for this is simply the number of songs we are requesting - we generally
-      // only want one here.  Any more than about 3 songs and it is more efficient
-      // to use the technique in AddInitialSongs.  As it's unlikely that we'll require
-      // more than 1 song at a time here, this method is faster.
+      // 1. Draw a random id from the matching ones gathered in Enable(),
+      //    passing over the ones in the history
+      // 2. Grab that entry from the database by its id
+      // 3. Iterate on iSongs.
+
+      // Note: This saves the database from filtering and randomly sorting the
+      // whole library for every song we add. An entry that can't be fetched
+      // is skipped for this round, the ids are gathered again on Enable().
       bool error(false);
+      int failed = 0;
       for (int i = 0; i < iVidsToAdd; i++)
       {
-        pair<std::string,std::string> whereClause = GetWhereClauseWithHistory();
         CFileItemPtr item(new CFileItem);
         int songID;
-        if (database.GetRandomMusicVideo(item.get(), songID, whereClause.second))
+        if (!m_videoSampler.Next(songID, GetHistory(2)))
+        {
+          error = true;
+          break;
+        }
+        if (database.GetPartyModeMusicVideo(item.get(), songID))
         { // success
           Add(item);
           AddToHistory(2,songID);
         }
+        else if (++failed < MAX_FAILED_FETCH)
+          i--;
         else
         {
-          error = true;
+          CLog::Log(LOGWARNING, "CPartyModeManager::AddRandomSongs - failed to fetch %i entries, giving up for now", failed);
           break;
         }
       }
@@ -584,6 +608,8 @@ void CPartyModeManager::ClearState()
 
   m_songsInHistory = 0;
   m_history.clear();
+  m_songSampler.Clear();
+  m_videoSampler.Clear();
 }
 
 void CPartyModeManager::UpdateStats()
@@ -648,37 +674,15 @@ bool CPartyModeManager::AddInitialSongs(vector<pair<int,int> > &songIDs)
   return true;
 }
 
-pair<std::string,std::string> CPartyModeManager::GetWhereClauseWithHistory() const
+std::set<int> CPartyModeManager::GetHistory(int type) const
 {
-  // now add this on to the normal where clause
-  std::vector<std::string> historyItemsMusic;
-  std::vector<std::string> historyItemsVideo;
+  std::set<int> history;
   for (unsigned int i = 0; i < m_history.size(); i++)
   {
-    std::string number = StringUtils::Format("%i", m_history[i].second);
-    if (m_history[i].first == 1)
-      historyItemsMusic.push_back(number);
-    if (m_history[i].first == 2)
-      historyItemsVideo.push_back(number);
-  }
-
-  std::string historyWhereMusic;
-  if (!historyItemsMusic.empty())
-  {
-    if (!m_strCurrentFilterMusic.empty())
-      historyWhereMusic = m_strCurrentFilterMusic + " and ";
-    historyWhereMusic += "songview.idSong not in (" + StringUtils::Join(historyItemsMusic, ", ") + ")";
+    if (m_history[i].first == type)
+      history.insert(m_history[i].second);
   }
-
-  std::string historyWhereVideo;
-  if (!historyItemsVideo.empty())
-  {
-    if (!m_strCurrentFilterVideo.empty())
-      historyWhereVideo = m_strCurrentFilterVideo + " and ";
-    historyWhereVideo += "idMVideo not in (" + StringUtils::Join(historyItemsVideo, ", ") + ")";
-  }
-
-  return make_pair(historyWhereMusic, historyWhereVideo);
+  return history;
 }
 
 void CPartyModeManager::AddToHistory(int type, int songID)
@@ -19,11 +19,14 @@
  *
  */
 
+#include <set>
 #include <string>
 #include <vector>
 
 #include <boost/shared_ptr.hpp>
 
+#include "utils/RandomSampler.h"
+
 class CFileItem; typedef boost::shared_ptr<CFileItem> CFileItemPtr;
 class CFileItemList;
 namespace PLAYLIST
@@ -70,7 +73,7 @@ private:
   void OnError(int iError, const std::string& strLogMessage);
   void ClearState();
   void UpdateStats();
-  std::pair<std::string,std::string> GetWhereClauseWithHistory() const;
+  std::set<int> GetHistory(int type) const;
   void AddToHistory(int type, int songID);
   void GetRandomSelection(std::vector< std::pair<int,int> > &in, unsigned int number, std::vector< std::pair<int, int> > &out);
   void Announce();
@@ -94,6 +97,10 @@ private:
   // history
   unsigned int m_songsInHistory;
   std::vector< std::pair<int,int> > m_history;
+
+  // matching songs and music videos to draw the random ones from
+  CRandomSampler m_songSampler;
+  CRandomSampler m_videoSampler;
 };
 
 extern CPartyModeManager g_partyModeManager;
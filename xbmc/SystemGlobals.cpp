@@ -19,6 +19,7 @@
  */
 #include "system.h"
 #include "cores/VideoRenderers/RenderManager.h"
+#include "cores/VideoRenderers/VideoTelemetry.h"
 #include "cores/DataCacheCore.h"
 #include "input/MouseStat.h"
 #include "Application.h"
@@ -48,6 +49,7 @@
 #endif
 
   CXBMCRenderManager g_renderManager;
+  CVideoTelemetry    g_videoTelemetry;
   CLangCodeExpander  g_LangCodeExpander;
   CLocalizeStrings   g_localizeStrings;
   CLocalizeStrings   g_localizeStringsTemp;
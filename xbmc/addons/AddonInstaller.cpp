@@ -39,6 +39,7 @@
 #include "dialogs/GUIDialogKaiToast.h"
 #include "dialogs/GUIDialogProgress.h"
 #include "URL.h"
+#include "interfaces/generic/ScriptInvocationManager.h"
 
 using namespace std;
 using namespace XFILE;
@@ -724,6 +725,9 @@ void CAddonInstallJob::OnPostInstall(bool reloadAddon)
                                           TOAST_DISPLAY_TIME);
   }
 
+  // scripts of an updated add-on must not run in what is kept of the old one
+  CScriptInvocationManager::Get().OnAddonChanged(m_addon->ID());
+
   m_addon->OnPostInstall(reloadAddon, m_update);
 }
 
@@ -804,5 +808,7 @@ void CAddonUnInstallJob::OnPostUnInstall()
   if (bSave)
     CFavouritesDirectory::Save(items);
 
+  CScriptInvocationManager::Get().OnAddonChanged(m_addon->ID());
+
   m_addon->OnPostUnInstall();
 }
@@ -48,6 +48,7 @@
 #include "Skin.h"
 #include "Service.h"
 #include "Util.h"
+#include "interfaces/generic/ScriptInvocationManager.h"
 
 using namespace std;
 using namespace XFILE;
@@ -596,14 +597,16 @@ void CAddonMgr::RemoveAddon(const std::string& ID)
 
 bool CAddonMgr::DisableAddon(const std::string& ID, bool disable)
 {
-  CSingleLock lock(m_critSection);
-  if (m_database.DisableAddon(ID, disable))
   {
+    CSingleLock lock(m_critSection);
+    if (!m_database.DisableAddon(ID, disable))
+      return false;
     m_disabled[ID] = disable;
-    return true;
   }
 
-  return false;
+  if (disable)
+    CScriptInvocationManager::Get().OnAddonChanged(ID);
+  return true;
 }
 
 bool CAddonMgr::IsAddonDisabled(const std::string& ID)
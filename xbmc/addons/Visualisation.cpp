@@ -19,7 +19,6 @@
  */
 #include "system.h"
 #include "Visualisation.h"
-#include "utils/fft.h"
 #include "GUIInfoManager.h"
 #include "Application.h"
 #include "guilib/GraphicContext.h"
@@ -42,28 +41,30 @@ using namespace std;
 using namespace MUSIC_INFO;
 using namespace ADDON;
 
-CAudioBuffer::CAudioBuffer(int iSize)
-{
-  m_iLen = iSize;
-  m_pBuffer = new float[iSize];
-}
-
-CAudioBuffer::~CAudioBuffer()
-{
-  delete [] m_pBuffer;
-}
+// blocks pending on top of the sync delay of the visualisation, older ones
+// are dropped when the visualisation wasn't rendered for a while
+#define MAX_PENDING_AUDIO_BUFFERS 16
 
-const float* CAudioBuffer::Get() const
+CVisualisation::CVisualisation(const ADDON::AddonProps &props)
+  : CAddonDll<DllVisualisation, Visualisation, VIS_PROPS>(props),
+    m_buffer(AUDIO_BUFFER_SIZE, MAX_AUDIO_BUFFERS + MAX_PENDING_AUDIO_BUFFERS),
+    m_iNumBuffers(0),
+    m_bWantsFreq(false),
+    m_fft(AUDIO_BUFFER_SIZE)
 {
-  return m_pBuffer;
+  memset(m_fSamples, 0, sizeof(m_fSamples));
+  memset(m_fFreq, 0, sizeof(m_fFreq));
 }
 
-void CAudioBuffer::Set(const float* psBuffer, int iSize)
+CVisualisation::CVisualisation(const cp_extension_t *ext)
+  : CAddonDll<DllVisualisation, Visualisation, VIS_PROPS>(ext),
+    m_buffer(AUDIO_BUFFER_SIZE, MAX_AUDIO_BUFFERS + MAX_PENDING_AUDIO_BUFFERS),
+    m_iNumBuffers(0),
+    m_bWantsFreq(false),
+    m_fft(AUDIO_BUFFER_SIZE)
 {
-  if (iSize<0)
-    return;
-  memcpy(m_pBuffer, psBuffer, iSize * sizeof(float));
-  for (int i = iSize; i < m_iLen; ++i) m_pBuffer[i] = 0;
+  memset(m_fSamples, 0, sizeof(m_fSamples));
+  memset(m_fFreq, 0, sizeof(m_fFreq));
 }
 
 bool CVisualisation::Create(int x, int y, int w, int h, void *device)
@@ -155,6 +156,8 @@ void CVisualisation::AudioData(const float* pAudioData, int iAudioDataLength, fl
 
 void CVisualisation::Render()
 {
+  ProcessAudioData();
+
   // ask visz. to render itself
   g_graphicsContext.BeginPaint();
   if (Initialized())
@@ -265,40 +268,50 @@ void CVisualisation::OnAudioData(const float* pAudioData, int iAudioDataLength)
   if (iAudioDataLength<0)
     return;
 
-  // Save our audio data in the buffers
-  auto_ptr<CAudioBuffer> pBuffer ( new CAudioBuffer(AUDIO_BUFFER_SIZE) );
-  pBuffer->Set(pAudioData, iAudioDataLength);
-  m_vecBuffers.push_back( pBuffer.release() );
+  // this runs on the audio thread, so only hand the samples over to the render thread
+  m_buffer.Write(pAudioData, iAudioDataLength);
+}
+
+void CVisualisation::ProcessAudioData()
+{
+  if (!m_pStruct || m_iNumBuffers < 1)
+    return;
 
-  if ( (int)m_vecBuffers.size() < m_iNumBuffers) return ;
+  // the newest blocks stay in the buffer for the sync delay of the vis
+  unsigned int delay = m_iNumBuffers - 1;
+  unsigned int blocks = m_buffer.GetBlocks();
+  if (blocks > delay + MAX_PENDING_AUDIO_BUFFERS)
+    m_buffer.Skip(blocks - delay - MAX_PENDING_AUDIO_BUFFERS);
 
-  auto_ptr<CAudioBuffer> ptrAudioBuffer ( m_vecBuffers.front() );
-  m_vecBuffers.pop_front();
-  // Fourier transform the data if the vis wants it...
-  if (m_bWantsFreq)
+  for (; m_buffer.GetBlocks() > delay; )
   {
-    const float *psAudioData = ptrAudioBuffer->Get();
-    memcpy(m_fFreq, psAudioData, AUDIO_BUFFER_SIZE * sizeof(float));
-
-    // FFT the data
-    twochanwithwindow(m_fFreq, AUDIO_BUFFER_SIZE);
+    // the transform covers the previous block as well
+    memcpy(m_fSamples, m_fSamples + AUDIO_BUFFER_SIZE, AUDIO_BUFFER_SIZE * sizeof(float));
+    float *psAudioData = m_fSamples + AUDIO_BUFFER_SIZE;
+    m_buffer.Read(psAudioData);
 
-    // Normalize the data
-    float fMinData = (float)AUDIO_BUFFER_SIZE * AUDIO_BUFFER_SIZE * 3 / 8 * 0.5 * 0.5; // 3/8 for the Hann window, 0.5 as minimum amplitude
-    float fInvMinData = 1.0f/fMinData;
-    for (int i = 0; i < AUDIO_BUFFER_SIZE + 2; i++)
+    // Fourier transform the data if the vis wants it...
+    if (m_bWantsFreq)
     {
-      m_fFreq[i] *= fInvMinData;
-    }
+      // FFT the data
+      m_fft.Calculate(m_fSamples, m_fFreq);
 
-    // Transfer data to our visualisation
-    AudioData(psAudioData, AUDIO_BUFFER_SIZE, m_fFreq, AUDIO_BUFFER_SIZE);
-  }
-  else
-  { // Transfer data to our visualisation
-    AudioData(ptrAudioBuffer->Get(), AUDIO_BUFFER_SIZE, NULL, 0);
+      // Normalize the data
+      float fMinData = (float)AUDIO_BUFFER_SIZE * AUDIO_BUFFER_SIZE * 3 / 8 * 0.5 * 0.5; // 3/8 for the Hann window, 0.5 as minimum amplitude
+      float fInvMinData = 1.0f/fMinData;
+      for (int i = 0; i < AUDIO_BUFFER_SIZE + 2; i++)
+      {
+        m_fFreq[i] *= fInvMinData;
+      }
+
+      // Transfer data to our visualisation
+      AudioData(psAudioData, AUDIO_BUFFER_SIZE, m_fFreq, AUDIO_BUFFER_SIZE);
+    }
+    else
+    { // Transfer data to our visualisation
+      AudioData(psAudioData, AUDIO_BUFFER_SIZE, NULL, 0);
+    }
   }
-  return ;
 }
 
 void CVisualisation::CreateBuffers()
@@ -321,14 +334,11 @@ void CVisualisation::ClearBuffers()
   m_bWantsFreq = false;
   m_iNumBuffers = 0;
 
-  while (!m_vecBuffers.empty())
-  {
-    CAudioBuffer* pAudioBuffer = m_vecBuffers.front();
-    delete pAudioBuffer;
-    m_vecBuffers.pop_front();
-  }
+  // the buffer is emptied from the reading side, the audio thread might still write
+  m_buffer.Skip(m_buffer.GetBlocks());
   for (int j = 0; j < AUDIO_BUFFER_SIZE*2; j++)
   {
+    m_fSamples[j] = 0.0f;
     m_fFreq[j] = 0.0f;
   }
 }
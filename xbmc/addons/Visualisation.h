@@ -21,11 +21,12 @@
 
 #include "AddonDll.h"
 #include "cores/IAudioCallback.h"
+#include "cores/AudioEngine/Utils/AEVizBuffer.h"
 #include "include/xbmc_vis_types.h"
 #include "guilib/IRenderingCallback.h"
+#include "utils/fft.h"
 
 #include <map>
-#include <list>
 #include <memory>
 
 #define AUDIO_BUFFER_SIZE 512 // MUST BE A POWER OF 2!!!
@@ -35,19 +36,6 @@ class CCriticalSection;
 
 typedef DllAddon<Visualisation, VIS_PROPS> DllVisualisation;
 
-class CAudioBuffer
-{
-public:
-  CAudioBuffer(int iSize);
-  virtual ~CAudioBuffer();
-  const float* Get() const;
-  void Set(const float* psBuffer, int iSize);
-private:
-  CAudioBuffer();
-  float* m_pBuffer;
-  int m_iLen;
-};
-
 namespace ADDON
 {
   class CVisualisation : public CAddonDll<DllVisualisation, Visualisation, VIS_PROPS>
@@ -55,8 +43,8 @@ namespace ADDON
                        , public IRenderingCallback
   {
   public:
-    CVisualisation(const ADDON::AddonProps &props) : CAddonDll<DllVisualisation, Visualisation, VIS_PROPS>(props) {}
-    CVisualisation(const cp_extension_t *ext) : CAddonDll<DllVisualisation, Visualisation, VIS_PROPS>(ext) {}
+    CVisualisation(const ADDON::AddonProps &props);
+    CVisualisation(const cp_extension_t *ext);
     virtual void OnInitialize(int iChannels, int iSamplesPerSec, int iBitsPerSample);
     virtual void OnAudioData(const float* pAudioData, int iAudioDataLength);
     bool Create(int x, int y, int w, int h, void *device);
@@ -80,6 +68,11 @@ namespace ADDON
     void CreateBuffers();
     void ClearBuffers();
 
+    /*! \brief Passes the samples the audio thread left in the buffer on to the visualisation.
+     Called before rendering, so the transforms happen on the render thread.
+     */
+    void ProcessAudioData();
+
     bool GetPresets();
     bool GetSubModules();
 
@@ -99,11 +92,13 @@ namespace ADDON
     int m_iChannels;
     int m_iSamplesPerSec;
     int m_iBitsPerSample;
-    std::list<CAudioBuffer*> m_vecBuffers;
+    CAEVizBuffer m_buffer;    // filled by the audio thread, emptied before rendering
     int m_iNumBuffers;        // Number of Audio buffers
     bool m_bWantsFreq;
+    float m_fSamples[2*AUDIO_BUFFER_SIZE];      // previous and current block, transformed together
     float m_fFreq[2*AUDIO_BUFFER_SIZE];         // Frequency data
     bool m_bCalculate_Freq;       // True if the vis wants freq data
+    CTwoChannelFFT m_fft;
 
     // track information
     std::string m_AlbumThumb;
@@ -32,6 +32,7 @@ using namespace ActiveAE;
 #include "windowing/WindowingFactory.h"
 
 #include "utils/TimeUtils.h"
+#include "utils/PerformanceTrace.h"
 
 #define MAX_CACHE_LEVEL 0.5   // total cache time of stream in seconds
 #define MAX_WATER_LEVEL 0.25  // buffered time after stream stages in seconds
@@ -1654,6 +1655,7 @@ void CActiveAE::UnconfigureSink()
 
 bool CActiveAE::RunStages()
 {
+  TRACE_SCOPE("CActiveAE::RunStages");
   bool busy = false;
 
   // serve input streams
@@ -20,8 +20,11 @@
 
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "ActiveAEResampleFFMPEG.h"
+#include "ActiveAEResamplePolyphase.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
 extern "C" {
 #include "libavutil/channel_layout.h"
 #include "libavutil/opt.h"
@@ -34,12 +37,15 @@ CActiveAEResampleFFMPEG::CActiveAEResampleFFMPEG()
 {
   m_pContext = NULL;
   m_loaded = true;
+  m_fine = NULL;
+  m_fineActive = false;
 }
 
 CActiveAEResampleFFMPEG::~CActiveAEResampleFFMPEG()
 {
   if (m_pContext)
     swr_free(&m_pContext);
+  delete m_fine;
 }
 
 bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, int dst_rate, AVSampleFormat dst_fmt, int dst_bits, int dst_dither, uint64_t src_chan_layout, int src_channels, int src_rate, AVSampleFormat src_fmt, int src_bits, int src_dither, bool upmix, bool normalize, CAEChannelInfo *remapLayout, AEQuality quality)
@@ -176,11 +182,26 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
     CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Init - init resampler failed");
     return false;
   }
+
+  // swr_set_compensation rebuilds the filter whenever the ratio changes, float output
+  // goes through tables that take any ratio instead
+  if (m_dst_fmt == AV_SAMPLE_FMT_FLT || m_dst_fmt == AV_SAMPLE_FMT_FLTP)
+  {
+    m_fine = new CActiveAEResamplePolyphase();
+    if (!m_fine->Init(m_dst_channels, av_sample_fmt_is_planar(m_dst_fmt), quality))
+    {
+      delete m_fine;
+      m_fine = NULL;
+    }
+  }
   return true;
 }
 
 int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio)
 {
+  if (m_fine && (ratio != 1.0 || m_fineActive))
+    return ResampleFine(dst_buffer, dst_samples, src_buffer, src_samples, ratio);
+
   if (ratio != 1.0)
   {
     if (swr_set_compensation(m_pContext,
@@ -199,6 +220,9 @@ int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uin
     return 0;
   }
 
+  if (m_fine)
+    m_fine->Bypass((float**)dst_buffer, ret);
+
   // special handling for S24 formats which are carried in S32
   if (m_dst_fmt == AV_SAMPLE_FMT_S32 || m_dst_fmt == AV_SAMPLE_FMT_S32P)
   {
@@ -252,15 +276,55 @@ int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uin
   return ret;
 }
 
+int CActiveAEResampleFFMPEG::ResampleFine(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio)
+{
+  // once the samples went through the filter they have to stay with it, the phase
+  // won't be back to 0 when the ratio is
+  m_fineActive = true;
+
+  // convert what fills dst_buffer, swresample keeps the rest of the input
+  int samples = m_fine->GetSrcSamples(dst_samples, ratio);
+  int converted = 0;
+  if (samples > 0 || src_samples > 0)
+  {
+    int planes = av_sample_fmt_is_planar(m_dst_fmt) ? m_dst_channels : 1;
+    if ((int)m_fineSamples.size() < std::max(samples, 1) * m_dst_channels)
+      m_fineSamples.resize(std::max(samples, 1) * m_dst_channels);
+    for (int i = 0; i < planes; i++)
+      m_finePlanes[i] = (uint8_t*)&m_fineSamples[i * samples * m_dst_channels / planes];
+
+    converted = swr_convert(m_pContext, m_finePlanes, samples, (const uint8_t**)src_buffer, src_samples);
+    if (converted < 0)
+    {
+      CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::ResampleFine - resample failed");
+      return 0;
+    }
+  }
+
+  if (converted > 0)
+    m_fine->Add((float**)m_finePlanes, converted);
+  // swresample is drained
+  if (!src_buffer && converted < samples)
+    m_fine->Drain();
+
+  return m_fine->Resample((float**)dst_buffer, dst_samples, ratio);
+}
+
 int64_t CActiveAEResampleFFMPEG::GetDelay(int64_t base)
 {
-  return swr_get_delay(m_pContext, base);
+  int64_t delay = swr_get_delay(m_pContext, base);
+  if (m_fine)
+    delay += av_rescale_rnd(m_fine->GetBufferedSamples(), base, m_dst_rate, AV_ROUND_UP);
+  return delay;
 }
 
 int CActiveAEResampleFFMPEG::GetBufferedSamples()
 {
-  return av_rescale_rnd(swr_get_delay(m_pContext, m_src_rate),
-                                    m_dst_rate, m_src_rate, AV_ROUND_UP);
+  int samples = av_rescale_rnd(swr_get_delay(m_pContext, m_src_rate),
+                               m_dst_rate, m_src_rate, AV_ROUND_UP);
+  if (m_fine)
+    samples += m_fine->GetBufferedSamples();
+  return samples;
 }
 
 int CActiveAEResampleFFMPEG::CalcDstSampleCount(int src_samples, int dst_rate, int src_rate)
@@ -31,6 +31,8 @@ struct SwrContext;
 namespace ActiveAE
 {
 
+class CActiveAEResamplePolyphase;
+
 class CActiveAEResampleFFMPEG : public IAEResample
 {
 public:
@@ -47,6 +49,7 @@ public:
   int GetDstBufferSize(int samples);
 
 protected:
+  int ResampleFine(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio);
   bool m_loaded;
   uint64_t m_src_chan_layout, m_dst_chan_layout;
   int m_src_rate, m_dst_rate;
@@ -56,6 +59,10 @@ protected:
   int m_src_dither_bits, m_dst_dither_bits;
   SwrContext *m_pContext;
   double m_rematrix[AE_CH_MAX][AE_CH_MAX];
+  CActiveAEResamplePolyphase *m_fine;  // applies ratios other than 1.0 to float output
+  bool m_fineActive;
+  std::vector<float> m_fineSamples;
+  uint8_t *m_finePlanes[AE_CH_MAX];
 };
 
 }
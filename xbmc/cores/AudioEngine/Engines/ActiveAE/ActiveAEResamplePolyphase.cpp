@@ -0,0 +1,266 @@
+/*
+ *      Copyright (C) 2010-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ActiveAEResamplePolyphase.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace ActiveAE;
+
+// zeroth order modified bessel function of the first kind, for the kaiser window
+static double BesselI0(double x)
+{
+  double sum = 1.0, term = 1.0;
+  for (int k = 1; k < 50 && term > sum * 1e-12; k++)
+  {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+CActiveAEResamplePolyphase::CActiveAEResamplePolyphase()
+{
+  m_channels = 0;
+  m_planar = false;
+  m_taps = 0;
+  m_phases = 0;
+  m_samples = 0;
+  m_position = 0.0;
+  m_drained = false;
+}
+
+bool CActiveAEResamplePolyphase::Init(int channels, bool planar, AEQuality quality)
+{
+  if (channels <= 0 || channels > AE_CH_MAX)
+  {
+    CLog::Log(LOGERROR, "CActiveAEResamplePolyphase::Init - unsupported number of channels %d", channels);
+    return false;
+  }
+
+  m_channels = channels;
+  m_planar = planar;
+
+  // the ratio stays within a few percent of 1.0, so a cutoff a little below nyquist
+  // keeps the aliasing of slowing down out of the audible range
+  double cutoff, beta;
+  if (quality == AE_QUALITY_LOW)
+  {
+    m_taps = 16;
+    m_phases = 64;
+    cutoff = 0.85;
+    beta = 6.0;
+  }
+  else if (quality == AE_QUALITY_HIGH || quality == AE_QUALITY_REALLYHIGH)
+  {
+    m_taps = 64;
+    m_phases = 256;
+    cutoff = 0.95;
+    beta = 9.0;
+  }
+  else
+  {
+    m_taps = 32;
+    m_phases = 128;
+    cutoff = 0.91;
+    beta = 8.0;
+  }
+
+  int half = m_taps / 2;
+  double window = BesselI0(beta);
+  m_filter.resize((m_phases + 1) * m_taps);
+  for (int k = 0; k <= m_phases; k++)
+  {
+    float *phase = &m_filter[k * m_taps];
+    double sum = 0.0;
+    for (int j = 0; j < m_taps; j++)
+    {
+      // distance of the tap from the sample being written
+      double x = j - half + 1 - (double)k / m_phases;
+      double t = x / half;
+      double w = fabs(t) < 1.0 ? BesselI0(beta * sqrt(1.0 - t * t)) / window : 0.0;
+      double s = x == 0.0 ? 1.0 : sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+      phase[j] = (float)(s * w);
+      sum += phase[j];
+    }
+    // unity gain for every phase, or the ratio would modulate the level
+    for (int j = 0; j < m_taps; j++)
+      phase[j] = (float)(phase[j] / sum);
+  }
+  m_coefs.resize(m_taps);
+
+  m_history.resize(m_channels);
+  Flush();
+  return true;
+}
+
+void CActiveAEResamplePolyphase::Flush()
+{
+  // start with silence before the first sample
+  m_samples = m_taps / 2 - 1;
+  for (int c = 0; c < m_channels; c++)
+    m_history[c].assign(std::max(m_samples, m_taps * 4), 0.0f);
+  m_position = m_samples;
+  m_drained = false;
+}
+
+void CActiveAEResamplePolyphase::Append(float **buffer, int offset, int samples)
+{
+  if (samples <= 0)
+    return;
+
+  if (m_samples + samples > (int)m_history[0].size())
+  {
+    for (int c = 0; c < m_channels; c++)
+      m_history[c].resize(m_samples + samples);
+  }
+
+  for (int c = 0; c < m_channels; c++)
+  {
+    float *dst = &m_history[c][m_samples];
+    if (m_planar)
+      memcpy(dst, buffer[c] + offset, samples * sizeof(float));
+    else
+    {
+      const float *src = buffer[0] + offset * m_channels + c;
+      for (int i = 0; i < samples; i++, src += m_channels)
+        dst[i] = *src;
+    }
+  }
+  m_samples += samples;
+}
+
+void CActiveAEResamplePolyphase::Discard(int samples)
+{
+  samples = std::min(samples, m_samples);
+  if (samples <= 0)
+    return;
+
+  for (int c = 0; c < m_channels; c++)
+    memmove(&m_history[c][0], &m_history[c][samples], (m_samples - samples) * sizeof(float));
+  m_samples -= samples;
+  m_position -= samples;
+}
+
+void CActiveAEResamplePolyphase::Bypass(float **buffer, int samples)
+{
+  // only what the filter needs before the next sample
+  int keep = m_taps / 2 - 1;
+  int skip = std::max(0, samples - keep);
+  Append(buffer, skip, samples - skip);
+  Discard(m_samples - keep);
+  m_position = keep;
+  m_drained = false;
+}
+
+void CActiveAEResamplePolyphase::Add(float **src_buffer, int src_samples)
+{
+  if (src_samples <= 0)
+    return;
+
+  // more input after the end, don't play the silence it was padded with
+  if (m_drained)
+    Flush();
+  Append(src_buffer, 0, src_samples);
+}
+
+void CActiveAEResamplePolyphase::Drain()
+{
+  if (m_drained)
+    return;
+
+  int half = m_taps / 2;
+  for (int c = 0; c < m_channels; c++)
+  {
+    m_history[c].resize(std::max((int)m_history[c].size(), m_samples + half));
+    memset(&m_history[c][m_samples], 0, half * sizeof(float));
+  }
+  m_samples += half;
+  m_drained = true;
+}
+
+int CActiveAEResamplePolyphase::Resample(float **dst_buffer, int dst_samples, double ratio)
+{
+  int half = m_taps / 2;
+  if (ratio <= 0.0)
+    ratio = 1.0;
+
+  double step = 1.0 / ratio;
+  int written = 0;
+  while (written < dst_samples)
+  {
+    int index = (int)m_position;
+    if (index + half >= m_samples)
+      break;
+
+    // interpolate between the two phases next to the position
+    double phase = (m_position - index) * m_phases;
+    int k = (int)phase;
+    float frac = (float)(phase - k);
+    const float *f0 = &m_filter[k * m_taps];
+    const float *f1 = f0 + m_taps;
+    for (int j = 0; j < m_taps; j++)
+      m_coefs[j] = f0[j] + frac * (f1[j] - f0[j]);
+
+    int first = index - half + 1;
+    for (int c = 0; c < m_channels; c++)
+    {
+      const float *in = &m_history[c][first];
+      float sum = 0.0f;
+      for (int j = 0; j < m_taps; j++)
+        sum += in[j] * m_coefs[j];
+
+      if (m_planar)
+        dst_buffer[c][written] = sum;
+      else
+        dst_buffer[0][written * m_channels + c] = sum;
+    }
+
+    written++;
+    m_position += step;
+  }
+
+  Discard((int)m_position - half + 1);
+  return written;
+}
+
+int CActiveAEResamplePolyphase::GetSrcSamples(int dst_samples, double ratio) const
+{
+  if (dst_samples <= 0)
+    return 0;
+  if (ratio <= 0.0)
+    ratio = 1.0;
+
+  double last = m_position + (dst_samples - 1) / ratio;
+  return std::max(0, (int)last + m_taps / 2 + 1 - m_samples);
+}
+
+int CActiveAEResamplePolyphase::GetBufferedSamples() const
+{
+  int samples = m_samples - (m_drained ? m_taps / 2 : 0);
+  return std::max(0, (int)ceil(samples - m_position));
+}
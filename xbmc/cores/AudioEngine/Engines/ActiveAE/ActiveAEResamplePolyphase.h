@@ -0,0 +1,98 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Interfaces/AE.h"
+
+#include <vector>
+
+namespace ActiveAE
+{
+
+/*!
+ \brief Changes the rate of float samples by a ratio close to 1.0, which is
+ what keeping a stream in sync with a drifting clock takes.
+
+ The windowed sinc filter is computed once in Init as a table of phases.
+ Samples that fall between two phases interpolate between them, so the ratio
+ may change with every call without rebuilding anything. The filter looks
+ ahead half its length, those samples are buffered.
+
+ Until the ratio first differs from 1.0 the samples are passed through by
+ Bypass, which keeps the last few of them to start filtering with.
+ */
+class CActiveAEResamplePolyphase
+{
+public:
+  CActiveAEResamplePolyphase();
+  bool Init(int channels, bool planar, AEQuality quality);
+
+  /*!
+   \brief Add samples to write
+   */
+  void Add(float **src_buffer, int src_samples);
+
+  /*!
+   \brief There is no more input, write the samples the filter was looking ahead for
+   */
+  void Drain();
+
+  /*!
+   \brief Write up to dst_samples of the samples added
+   \param ratio output samples per input sample
+   \return samples written
+   */
+  int Resample(float **dst_buffer, int dst_samples, double ratio);
+
+  /*!
+   \brief Keep the end of samples that were output without resampling
+   */
+  void Bypass(float **buffer, int samples);
+
+  /*!
+   \brief Samples to add so that the next call to Resample writes dst_samples
+   */
+  int GetSrcSamples(int dst_samples, double ratio) const;
+
+  /*!
+   \brief Samples added that weren't written yet
+   */
+  int GetBufferedSamples() const;
+
+  void Flush();
+  int GetTaps() const { return m_taps; }
+
+private:
+  void Append(float **buffer, int offset, int samples);
+  void Discard(int samples);
+
+  int m_channels;
+  bool m_planar;
+  int m_taps;                   // per phase
+  int m_phases;
+  std::vector<float> m_filter;  // m_phases + 1 phases, the last one is the first moved by a sample
+  std::vector<float> m_coefs;   // interpolated for the sample being written
+  std::vector< std::vector<float> > m_history; // per channel
+  int m_samples;                // in m_history
+  double m_position;            // of the next sample to write, in m_history
+  bool m_drained;               // padded with silence after the end of the input
+};
+
+}
@@ -27,6 +27,7 @@
 #include "cores/AudioEngine/AEResampleFactory.h"
 
 #include "settings/Settings.h"
+#include "utils/PerformanceTrace.h"
 
 #include <new> // for std::bad_alloc
 
@@ -790,6 +791,7 @@ void CActiveAESink::ReturnBuffers()
 
 unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
 {
+  TRACE_SCOPE("CActiveAESink::OutputSamples");
   uint8_t **buffer = samples->pkt->data;
   unsigned int frames = samples->pkt->nb_samples;
   unsigned int maxFrames;
@@ -0,0 +1,243 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResamplePolyphase.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+#include <math.h>
+#include <vector>
+
+#define SAMPLE_RATE 48000
+#define CHANNELS    2
+#define BLOCK_SIZE  512
+
+using namespace ActiveAE;
+
+// a sine of the given frequency at a fractional sample position
+static double Sine(double frequency, double position)
+{
+  return sin(2.0 * 3.14159265358979323846 * frequency * position / SAMPLE_RATE);
+}
+
+static void FillPlanar(std::vector<float> *planes, double frequency, int first, int samples)
+{
+  for (int c = 0; c < CHANNELS; c++)
+  {
+    planes[c].resize(samples);
+    for (int i = 0; i < samples; i++)
+      planes[c][i] = (float)(0.5 * Sine(frequency, first + i));
+  }
+}
+
+/* Resamples a sine in blocks, with the ratio of each block from ratios, and
+ * measures how far the output is from the sine evaluated at the positions the
+ * output samples stand for: harmonics, aliasing and noise together, in dB
+ * relative to the sine. */
+struct SweepResult
+{
+  double thdn;
+  double seconds;   // spent resampling
+  int samples;      // written per channel
+};
+
+static SweepResult Sweep(AEQuality quality, double frequency, const std::vector<double>& ratios)
+{
+  CActiveAEResamplePolyphase resampler;
+  EXPECT_TRUE(resampler.Init(CHANNELS, true, quality));
+
+  std::vector<float> in[CHANNELS], out[CHANNELS];
+  float *src[CHANNELS], *dst[CHANNELS];
+  for (int c = 0; c < CHANNELS; c++)
+    out[c].resize(BLOCK_SIZE);
+
+  SweepResult result;
+  result.samples = 0;
+  double signal = 0.0, error = 0.0;
+  double position = 0.0;
+  int added = 0;
+  int64_t ticks = 0;
+  for (size_t b = 0; b < ratios.size(); b++)
+  {
+    int samples = resampler.GetSrcSamples(BLOCK_SIZE, ratios[b]);
+    FillPlanar(in, frequency, added, samples);
+    for (int c = 0; c < CHANNELS; c++)
+    {
+      src[c] = samples ? &in[c][0] : NULL;
+      dst[c] = &out[c][0];
+    }
+    added += samples;
+
+    int64_t start = CurrentHostCounter();
+    resampler.Add(src, samples);
+    int written = resampler.Resample(dst, BLOCK_SIZE, ratios[b]);
+    ticks += CurrentHostCounter() - start;
+    EXPECT_EQ(BLOCK_SIZE, written);
+
+    for (int i = 0; i < written; i++)
+    {
+      // leave out the start, the filter had silence before the first sample
+      if (result.samples + i > BLOCK_SIZE)
+      {
+        double expected = 0.5 * Sine(frequency, position);
+        for (int c = 0; c < CHANNELS; c++)
+        {
+          signal += expected * expected;
+          error += (out[c][i] - expected) * (out[c][i] - expected);
+        }
+      }
+      position += 1.0 / ratios[b];
+    }
+    result.samples += written;
+  }
+
+  result.thdn = 10.0 * log10(error / signal);
+  result.seconds = (double)ticks / CurrentHostFrequency();
+  return result;
+}
+
+TEST(TestActiveAEResamplePolyphase, Bypass)
+{
+  CActiveAEResamplePolyphase resampler;
+  ASSERT_TRUE(resampler.Init(CHANNELS, true, AE_QUALITY_MID));
+
+  // the output before the ratio first changed went out as it was, filtering
+  // continues from there without a gap or a click
+  std::vector<float> in[CHANNELS], out[CHANNELS];
+  float *src[CHANNELS], *dst[CHANNELS];
+  FillPlanar(in, 1000.0, 0, 4 * BLOCK_SIZE);
+  for (int c = 0; c < CHANNELS; c++)
+  {
+    src[c] = &in[c][0];
+    out[c].resize(4 * BLOCK_SIZE);
+    dst[c] = &out[c][0];
+  }
+  resampler.Bypass(src, BLOCK_SIZE);
+  EXPECT_EQ(0, resampler.GetBufferedSamples());
+
+  for (int c = 0; c < CHANNELS; c++)
+    src[c] += BLOCK_SIZE;
+  resampler.Add(src, 3 * BLOCK_SIZE);
+  int written = resampler.Resample(dst, 4 * BLOCK_SIZE, 1.0);
+  EXPECT_EQ(3 * BLOCK_SIZE - resampler.GetTaps() / 2, written);
+  EXPECT_EQ(resampler.GetTaps() / 2, resampler.GetBufferedSamples());
+  for (int c = 0; c < CHANNELS; c++)
+  {
+    for (int i = 0; i < written; i++)
+      EXPECT_NEAR(in[c][BLOCK_SIZE + i], out[c][i], 0.001);
+  }
+}
+
+TEST(TestActiveAEResamplePolyphase, Ratio)
+{
+  CActiveAEResamplePolyphase resampler;
+  ASSERT_TRUE(resampler.Init(CHANNELS, false, AE_QUALITY_MID));
+
+  std::vector<float> in(CHANNELS * 10000, 0.25f), out(CHANNELS * 11000);
+  float *src = &in[0], *dst = &out[0];
+  resampler.Add(&src, 10000);
+  int written = resampler.Resample(&dst, 11000, 1.01);
+  resampler.Drain();
+  dst += written * CHANNELS;
+  written += resampler.Resample(&dst, 11000 - written, 1.01);
+
+  EXPECT_NEAR(10100, written, 1);
+  EXPECT_EQ(0, resampler.GetBufferedSamples());
+  // every phase has unity gain
+  for (int i = BLOCK_SIZE; i < 9000; i++)
+    EXPECT_NEAR(0.25f, out[i], 0.0001f);
+}
+
+TEST(TestActiveAEResamplePolyphase, SrcSamples)
+{
+  CActiveAEResamplePolyphase resampler;
+  ASSERT_TRUE(resampler.Init(CHANNELS, true, AE_QUALITY_HIGH));
+
+  std::vector<float> in[CHANNELS], out[CHANNELS];
+  float *src[CHANNELS], *dst[CHANNELS];
+  for (int c = 0; c < CHANNELS; c++)
+    out[c].resize(BLOCK_SIZE);
+
+  // what GetSrcSamples asks for is just enough whatever the ratio does
+  double ratios[] = { 1.0, 0.97, 1.03, 1.0001, 0.9999, 1.0 };
+  for (unsigned int i = 0; i < sizeof(ratios) / sizeof(ratios[0]); i++)
+  {
+    int samples = resampler.GetSrcSamples(BLOCK_SIZE, ratios[i]);
+    FillPlanar(in, 440.0, 0, samples);
+    for (int c = 0; c < CHANNELS; c++)
+    {
+      src[c] = &in[c][0];
+      dst[c] = &out[c][0];
+    }
+    resampler.Add(src, samples);
+    EXPECT_EQ(BLOCK_SIZE, resampler.Resample(dst, BLOCK_SIZE, ratios[i]));
+    EXPECT_EQ(0, resampler.GetSrcSamples(0, ratios[i]));
+  }
+}
+
+TEST(TestActiveAEResamplePolyphase, Distortion)
+{
+  // a second of a ratio a clock correction might ask for
+  std::vector<double> ratios(SAMPLE_RATE / BLOCK_SIZE, 1.001);
+  EXPECT_LT(Sweep(AE_QUALITY_LOW, 1000.0, ratios).thdn, -60.0);
+  EXPECT_LT(Sweep(AE_QUALITY_MID, 1000.0, ratios).thdn, -80.0);
+  EXPECT_LT(Sweep(AE_QUALITY_HIGH, 1000.0, ratios).thdn, -80.0);
+}
+
+// 10 seconds for every ratio and quality, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestActiveAEResamplePolyphase.*
+TEST(TestActiveAEResamplePolyphase, DISABLED_Benchmark)
+{
+  // 10 seconds of a fixed ratio, and a clock drifting back and forth the way
+  // the player corrects it, with a new ratio for every block
+  int blocks = 10 * SAMPLE_RATE / BLOCK_SIZE;
+  double fixed[] = { 0.99, 0.999, 1.001, 1.01, 1.04271 };
+  AEQuality qualities[] = { AE_QUALITY_LOW, AE_QUALITY_MID, AE_QUALITY_HIGH };
+  const char *names[] = { "low", "mid", "high" };
+
+  for (unsigned int q = 0; q < sizeof(qualities) / sizeof(qualities[0]); q++)
+  {
+    for (unsigned int r = 0; r <= sizeof(fixed) / sizeof(fixed[0]); r++)
+    {
+      std::vector<double> ratios(blocks);
+      for (int b = 0; b < blocks; b++)
+      {
+        if (r < sizeof(fixed) / sizeof(fixed[0]))
+          ratios[b] = fixed[r];
+        else
+          ratios[b] = 1.0 + 0.005 * sin(b * 0.05);
+      }
+
+      SweepResult low = Sweep(qualities[q], 1000.0, ratios);
+      SweepResult high = Sweep(qualities[q], 15000.0, ratios);
+      double duration = (double)low.samples / SAMPLE_RATE;
+
+      std::cout << "ActiveAEResamplePolyphase: " << names[q] << " quality, ratio ";
+      if (r < sizeof(fixed) / sizeof(fixed[0]))
+        std::cout << fixed[r];
+      else
+        std::cout << "1.0 +- 0.005 sweep";
+      std::cout << ": THD+N " << low.thdn << " dB at 1 kHz, " << high.thdn << " dB at 15 kHz, "
+                << low.seconds * 100.0 / duration << "% of a cpu for " << CHANNELS << " channels" << std::endl;
+    }
+  }
+}
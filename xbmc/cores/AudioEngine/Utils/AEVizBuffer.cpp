@@ -0,0 +1,77 @@
+/*
+ *      Copyright (C) 2010-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "AEVizBuffer.h"
+#include "AERingBuffer.h"
+
+#include <algorithm>
+
+CAEVizBuffer::CAEVizBuffer(unsigned int blockSize, unsigned int blocks) :
+  m_ring(new AERingBuffer(blockSize * blocks * sizeof(float))),
+  m_blockSize(blockSize),
+  m_silence(blockSize, 0.0f),
+  m_dropped(0)
+{
+}
+
+CAEVizBuffer::~CAEVizBuffer()
+{
+  delete m_ring;
+}
+
+bool CAEVizBuffer::Write(const float *samples, unsigned int count)
+{
+  unsigned int bytes = m_blockSize * sizeof(float);
+  if (m_ring->GetWriteSize() < bytes)
+  {
+    m_dropped++;
+    return false;
+  }
+
+  if (count > m_blockSize)
+    count = m_blockSize;
+  // the reader only takes complete blocks, so the block may be written in two parts
+  if (count > 0)
+    m_ring->Write((unsigned char*)samples, count * sizeof(float));
+  if (count < m_blockSize)
+    m_ring->Write((unsigned char*)&m_silence[0], (m_blockSize - count) * sizeof(float));
+  return true;
+}
+
+unsigned int CAEVizBuffer::GetBlocks()
+{
+  return m_ring->GetReadSize() / (m_blockSize * sizeof(float));
+}
+
+bool CAEVizBuffer::Read(float *block)
+{
+  if (GetBlocks() == 0)
+    return false;
+  m_ring->Read((unsigned char*)block, m_blockSize * sizeof(float));
+  return true;
+}
+
+void CAEVizBuffer::Skip(unsigned int blocks)
+{
+  blocks = std::min(blocks, GetBlocks());
+  if (blocks > 0)
+    m_ring->Read(NULL, blocks * m_blockSize * sizeof(float));
+}
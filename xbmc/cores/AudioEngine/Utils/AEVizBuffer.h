@@ -0,0 +1,80 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+class AERingBuffer;
+
+/**
+ * Hands the samples for a visualisation from the audio thread over to the
+ * thread that renders it. Samples travel in blocks of a fixed size through
+ * an AERingBuffer, so writing neither locks nor allocates, and blocks are
+ * dropped while the buffer is full.
+ *
+ * Only one thread may write and one other thread may read at a time.
+ */
+class CAEVizBuffer
+{
+public:
+  CAEVizBuffer(unsigned int blockSize, unsigned int blocks);
+  ~CAEVizBuffer();
+
+  /**
+   * Adds a block, called from the audio thread.
+   * @param samples the samples, up to a block size, the rest of the block is silence
+   * @param count the number of samples
+   * @return false if the block was dropped as the buffer is full
+   */
+  bool Write(const float *samples, unsigned int count);
+
+  /**
+   * Returns the number of complete blocks that can be read.
+   */
+  unsigned int GetBlocks();
+
+  /**
+   * Takes the oldest block out of the buffer.
+   * @param block gets a block size of samples
+   * @return false if there is no complete block
+   */
+  bool Read(float *block);
+
+  /**
+   * Drops the oldest blocks, which is how the reader empties the buffer.
+   */
+  void Skip(unsigned int blocks);
+
+  unsigned int GetBlockSize() const { return m_blockSize; }
+
+  /**
+   * Returns the number of blocks the writer had to drop so far.
+   */
+  unsigned int GetDropped() const { return m_dropped; }
+
+private:
+  CAEVizBuffer(const CAEVizBuffer&);
+  CAEVizBuffer& operator=(const CAEVizBuffer&);
+
+  AERingBuffer *m_ring;
+  unsigned int m_blockSize;
+  std::vector<float> m_silence;
+  volatile unsigned int m_dropped;
+};
@@ -0,0 +1,222 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEVizBuffer.h"
+#include "threads/test/TestHelpers.h"
+#include "utils/fft.h"
+#include "utils/TimeUtils.h"
+
+#include <iostream>
+#include <math.h>
+#include <string.h>
+
+#define BLOCK_SIZE   512
+#define BLOCKS       32
+#define CALLBACKS    10000
+
+static void FillBlock(float *block, unsigned int number)
+{
+  for (unsigned int i = 0; i < BLOCK_SIZE; i++)
+    block[i] = (float)sin(number + i * 0.01);
+  block[0] = (float)number;
+}
+
+TEST(TestAEVizBuffer, Blocks)
+{
+  CAEVizBuffer buffer(BLOCK_SIZE, 4);
+  float in[BLOCK_SIZE], out[BLOCK_SIZE];
+
+  EXPECT_EQ(0u, buffer.GetBlocks());
+  EXPECT_FALSE(buffer.Read(out));
+
+  FillBlock(in, 1);
+  EXPECT_TRUE(buffer.Write(in, BLOCK_SIZE));
+  // a short block is filled up with silence
+  EXPECT_TRUE(buffer.Write(in, 100));
+  EXPECT_EQ(2u, buffer.GetBlocks());
+
+  EXPECT_TRUE(buffer.Read(out));
+  EXPECT_EQ(0, memcmp(in, out, sizeof(in)));
+  EXPECT_TRUE(buffer.Read(out));
+  EXPECT_EQ(0, memcmp(in, out, 100 * sizeof(float)));
+  for (unsigned int i = 100; i < BLOCK_SIZE; i++)
+    EXPECT_EQ(0.0f, out[i]);
+
+  // a full buffer drops what comes in
+  for (unsigned int i = 0; i < 4; i++)
+  {
+    FillBlock(in, 10 + i);
+    EXPECT_TRUE(buffer.Write(in, BLOCK_SIZE));
+  }
+  EXPECT_FALSE(buffer.Write(in, BLOCK_SIZE));
+  EXPECT_EQ(1u, buffer.GetDropped());
+
+  buffer.Skip(3);
+  EXPECT_EQ(1u, buffer.GetBlocks());
+  EXPECT_TRUE(buffer.Read(out));
+  EXPECT_EQ(13.0f, out[0]);
+  buffer.Skip(1);
+  EXPECT_EQ(0u, buffer.GetBlocks());
+}
+
+class VizWriter : public IRunnable
+{
+public:
+  VizWriter(CAEVizBuffer& buffer, bool paced)
+    : m_buffer(buffer), m_paced(paced), m_written(0), m_time(0), m_worst(0) {}
+
+  // what the engine does for each period it processes while a visualisation is active
+  virtual void Run()
+  {
+    float block[BLOCK_SIZE];
+    for (unsigned int i = 0; i < CALLBACKS; i++)
+    {
+      // the engine delivers blocks in real time, which leaves the reader time to catch up
+      while (m_paced && m_buffer.GetBlocks() > BLOCKS - 2)
+        XbmcThreads::ThreadSleep(1);
+
+      FillBlock(block, i);
+      int64_t start = CurrentHostCounter();
+      bool written = m_buffer.Write(block, BLOCK_SIZE);
+      int64_t time = CurrentHostCounter() - start;
+      if (written)
+      {
+        m_written++;
+        m_time += time;
+        m_worst = std::max(m_worst, time);
+      }
+    }
+  }
+
+  CAEVizBuffer& m_buffer;
+  bool m_paced;
+  unsigned int m_written;
+  int64_t m_time;
+  int64_t m_worst;
+};
+
+class VizReader : public IRunnable
+{
+public:
+  VizReader(CAEVizBuffer& buffer, const volatile bool& done)
+    : m_buffer(buffer), m_done(done), m_fft(BLOCK_SIZE), m_read(0), m_ordered(true) {}
+
+  // what the visualisation does before rendering
+  virtual void Run()
+  {
+    float samples[2 * BLOCK_SIZE];
+    float spectrum[BLOCK_SIZE + 2];
+    float last = -1.0f;
+    memset(samples, 0, sizeof(samples));
+    while (!m_done || m_buffer.GetBlocks() > 0)
+    {
+      if (!m_buffer.Read(samples + BLOCK_SIZE))
+      {
+        XbmcThreads::ThreadSleep(0);
+        continue;
+      }
+      if (samples[BLOCK_SIZE] <= last || samples[BLOCK_SIZE + 1] != (float)sin(samples[BLOCK_SIZE] + 0.01))
+        m_ordered = false;
+      last = samples[BLOCK_SIZE];
+      m_fft.Calculate(samples, spectrum);
+      memcpy(samples, samples + BLOCK_SIZE, BLOCK_SIZE * sizeof(float));
+      m_read++;
+    }
+  }
+
+  CAEVizBuffer& m_buffer;
+  const volatile bool& m_done;
+  CTwoChannelFFT m_fft;
+  unsigned int m_read;
+  bool m_ordered;
+};
+
+TEST(TestAEVizBuffer, Threads)
+{
+  CAEVizBuffer buffer(BLOCK_SIZE, BLOCKS);
+  volatile bool done = false;
+  VizWriter writer(buffer, false);
+  VizReader reader(buffer, done);
+
+  thread readerThread(reader);
+  thread writerThread(writer);
+  EXPECT_TRUE(writerThread.timed_join(MILLIS(10000)));
+  done = true;
+  EXPECT_TRUE(readerThread.timed_join(MILLIS(10000)));
+
+  EXPECT_EQ(CALLBACKS, writer.m_written + buffer.GetDropped());
+  EXPECT_EQ(writer.m_written, reader.m_read);
+  EXPECT_TRUE(reader.m_ordered);
+}
+
+TEST(TestAEVizBuffer, CallbackCost)
+{
+  double frequency = (double)CurrentHostFrequency();
+
+  // nothing reads, the writer only sees an emptied buffer
+  CAEVizBuffer idle(BLOCK_SIZE, BLOCKS);
+  float block[BLOCK_SIZE];
+  int64_t idleTime = 0;
+  for (unsigned int i = 0; i < CALLBACKS; i++)
+  {
+    FillBlock(block, i);
+    int64_t start = CurrentHostCounter();
+    idle.Write(block, BLOCK_SIZE);
+    idleTime += CurrentHostCounter() - start;
+    idle.Skip(1);
+  }
+
+  // the transform on the audio thread, as it used to be done
+  CTwoChannelFFT fft(BLOCK_SIZE);
+  float samples[2 * BLOCK_SIZE], spectrum[BLOCK_SIZE + 2];
+  memset(samples, 0, sizeof(samples));
+  int64_t syncTime = 0;
+  for (unsigned int i = 0; i < CALLBACKS; i++)
+  {
+    FillBlock(block, i);
+    int64_t start = CurrentHostCounter();
+    memcpy(samples + BLOCK_SIZE, block, sizeof(block));
+    fft.Calculate(samples, spectrum);
+    memcpy(samples, samples + BLOCK_SIZE, BLOCK_SIZE * sizeof(float));
+    syncTime += CurrentHostCounter() - start;
+  }
+
+  // the transform on another thread, while the visualisation is active
+  CAEVizBuffer buffer(BLOCK_SIZE, BLOCKS);
+  volatile bool done = false;
+  VizWriter writer(buffer, true);
+  VizReader reader(buffer, done);
+  {
+    thread readerThread(reader);
+    thread writerThread(writer);
+    EXPECT_TRUE(writerThread.timed_join(MILLIS(10000)));
+    done = true;
+    EXPECT_TRUE(readerThread.timed_join(MILLIS(10000)));
+  }
+  ASSERT_GT(writer.m_written, 0u);
+
+  double idleCost = idleTime * 1000000000.0 / frequency / CALLBACKS;
+  double syncCost = syncTime * 1000000000.0 / frequency / CALLBACKS;
+  double activeCost = writer.m_time * 1000000000.0 / frequency / writer.m_written;
+  std::cout << "AEVizBuffer: per callback " << idleCost << " ns without a visualisation, "
+            << activeCost << " ns with one (worst " << writer.m_worst * 1000000000.0 / frequency
+            << " ns, " << buffer.GetDropped() << " blocks dropped), "
+            << syncCost << " ns with the transform on the audio thread" << std::endl;
+}
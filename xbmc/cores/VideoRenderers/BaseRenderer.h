@@ -71,6 +71,7 @@ typedef void (*RenderUpdateCallBackFn)(const void *ctx, const CRect &SrcRect, co
 typedef void (*RenderFeaturesCallBackFn)(const void *ctx, Features &renderFeatures);
 
 struct DVDVideoPicture;
+class CDVDVideoBuffer;
 
 class CBaseRenderer
 {
@@ -84,6 +85,12 @@ public:
   float GetAspectRatio() const;
 
   virtual bool AddVideoPicture(DVDVideoPicture* picture, int index) { return false; }
+  /**
+   * Use the planes of a software decoded picture for the image at index instead of
+   * copying them. The renderer keeps a reference until the buffer is released.
+   * Returns false if the picture has to be copied into the image.
+   */
+  virtual bool AddVideoBuffer(CDVDVideoBuffer* buffer, int index) { return false; }
   virtual void Flush() {};
 
   /**
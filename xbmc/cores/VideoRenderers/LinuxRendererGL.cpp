@@ -48,6 +48,7 @@
 #include "RenderFormats.h"
 #include "cores/IPlayer.h"
 #include "cores/dvdplayer/DVDCodecs/DVDCodecUtils.h"
+#include "cores/dvdplayer/DVDCodecs/Video/DVDVideoBufferPool.h"
 #include "cores/FFmpeg.h"
 
 extern "C" {
@@ -119,6 +120,7 @@ CLinuxRendererGL::YUVBUFFER::YUVBUFFER()
   memset(&image , 0, sizeof(image));
   memset(&pbo   , 0, sizeof(pbo));
   flipindex = 0;
+  videoBuffer = NULL;
 #ifdef HAVE_LIBVDPAU
   vdpau = NULL;
 #endif
@@ -132,6 +134,7 @@ CLinuxRendererGL::YUVBUFFER::YUVBUFFER()
 
 CLinuxRendererGL::YUVBUFFER::~YUVBUFFER()
 {
+  SAFE_RELEASE(videoBuffer);
 #ifdef TARGET_DARWIN_OSX
   if (cvBufferRef)
     CVBufferRelease(cvBufferRef);
@@ -549,6 +552,8 @@ void CLinuxRendererGL::Flush()
 
 void CLinuxRendererGL::ReleaseBuffer(int idx)
 {
+  DetachVideoBuffer(idx);
+
 #if defined(HAVE_LIBVDPAU) || defined(HAVE_LIBVA) || defined(TARGET_DARWIN)
   YUVBUFFER &buf = m_buffers[idx];
 #endif
@@ -565,6 +570,43 @@ void CLinuxRendererGL::ReleaseBuffer(int idx)
 #endif
 }
 
+bool CLinuxRendererGL::AddVideoBuffer(CDVDVideoBuffer* buffer, int index)
+{
+  YUVBUFFER &buf = m_buffers[index];
+
+  // planes mapped from pixel buffer objects have to be filled by copying
+  if (m_textureUpload != &CLinuxRendererGL::UploadYV12Texture || buf.pbo[0])
+    return false;
+
+  DetachVideoBuffer(index);
+
+  YV12Image &im = buf.image;
+  for (int p = 0; p < MAX_PLANES; p++)
+  {
+    buf.ownPlane[p]  = im.plane[p];
+    buf.ownStride[p] = im.stride[p];
+    im.plane[p]  = buffer->GetPlane(p);
+    im.stride[p] = buffer->GetStride(p);
+  }
+  buf.videoBuffer = buffer->Acquire();
+  return true;
+}
+
+void CLinuxRendererGL::DetachVideoBuffer(int index)
+{
+  YUVBUFFER &buf = m_buffers[index];
+  if (!buf.videoBuffer)
+    return;
+
+  YV12Image &im = buf.image;
+  for (int p = 0; p < MAX_PLANES; p++)
+  {
+    im.plane[p]  = buf.ownPlane[p];
+    im.stride[p] = buf.ownStride[p];
+  }
+  SAFE_RELEASE(buf.videoBuffer);
+}
+
 void CLinuxRendererGL::Update()
 {
   if (!m_bConfigured) return;
@@ -1789,6 +1831,8 @@ void CLinuxRendererGL::DeleteYV12Texture(int index)
   YUVFIELDS &fields = m_buffers[index].fields;
   GLuint    *pbo    = m_buffers[index].pbo;
 
+  DetachVideoBuffer(index);
+
   if( fields[FIELD_FULL][0].id == 0 ) return;
 
   /* finish up all textures, and delete them */
@@ -133,6 +133,7 @@ public:
   virtual void         Reset(); /* resets renderer after seek for example */
   virtual void         Flush();
   virtual void         ReleaseBuffer(int idx);
+  virtual bool         AddVideoBuffer(CDVDVideoBuffer* buffer, int index);
   virtual void         SetBufferSize(int numBuffers) { m_NumYV12Buffers = numBuffers; }
   virtual unsigned int GetMaxBufferSize() { return NUM_BUFFERS; }
   virtual unsigned int GetOptimalBufferSize();
@@ -180,6 +181,7 @@ protected:
   bool UploadYV12Texture(int index);
   void DeleteYV12Texture(int index);
   bool CreateYV12Texture(int index);
+  void DetachVideoBuffer(int index);
 
   bool UploadNV12Texture(int index);
   void DeleteNV12Texture(int index);
@@ -276,6 +278,11 @@ protected:
     unsigned  flipindex; /* used to decide if this has been uploaded */
     GLuint    pbo[MAX_PLANES];
 
+    /* decoder planes the image points to, and the image's own planes while they are in use */
+    CDVDVideoBuffer *videoBuffer;
+    uint8_t         *ownPlane[MAX_PLANES];
+    unsigned         ownStride[MAX_PLANES];
+
 #ifdef HAVE_LIBVDPAU
     VDPAU::CVdpauRenderPicture *vdpau;
 #endif
@@ -53,10 +53,12 @@
 #endif
 
 #include "RenderCapture.h"
+#include "VideoTelemetry.h"
 
 /* to use the same as player */
 #include "../dvdplayer/DVDClock.h"
 #include "../dvdplayer/DVDCodecs/Video/DVDVideoCodec.h"
+#include "../dvdplayer/DVDCodecs/Video/DVDVideoBufferPool.h"
 #include "../dvdplayer/DVDCodecs/DVDCodecUtils.h"
 
 #ifdef HAVE_LIBVA
@@ -121,6 +123,9 @@ CXBMCRenderManager::CXBMCRenderManager()
   m_QueueSkip   = 0;
   m_format      = RENDER_FMT_NONE;
   m_renderedOverlay = false;
+  m_renderticks = 0;
+  for (int i = 0; i < NUM_BUFFERS; i++)
+    m_Queue[i].telemetry = -1;
 }
 
 CXBMCRenderManager::~CXBMCRenderManager()
@@ -401,6 +406,16 @@ void CXBMCRenderManager::FrameFinish()
 
   { CSingleLock lock(m_presentlock);
 
+    if(m_presentstep == PRESENT_FRAME && m.telemetry >= 0)
+    {
+      // the clock isn't interpolated, so this is the vblank the frame went out at
+      double interval;
+      if (g_VideoReferenceClock.GetRefreshRate(&interval) <= 0)
+        interval = 1.0 / GetMaximumFPS();
+      g_videoTelemetry.Present(m.telemetry, m.timestamp, m_clock_framefinish, interval, (double)m_renderticks / CurrentHostFrequency());
+    }
+    m_renderticks = 0;
+
     if(m_presentstep == PRESENT_FRAME)
     {
       if( m.presentmethod == PRESENT_METHOD_BOB
@@ -661,7 +676,7 @@ void CXBMCRenderManager::SetViewMode(int iViewMode)
   g_dataCacheCore.SignalVideoInfoChange();
 }
 
-void CXBMCRenderManager::FlipPage(volatile bool& bStop, double timestamp /* = 0LL*/, double pts /* = 0 */, int source /*= -1*/, EFIELDSYNC sync /*= FS_NONE*/)
+void CXBMCRenderManager::FlipPage(volatile bool& bStop, double timestamp /* = 0LL*/, double pts /* = 0 */, int source /*= -1*/, EFIELDSYNC sync /*= FS_NONE*/, int telemetry /*= -1*/)
 {
   { CSharedLock lock(m_sharedSection);
 
@@ -728,6 +743,7 @@ void CXBMCRenderManager::FlipPage(volatile bool& bStop, double timestamp /* = 0L
     m.presentfield  = sync;
     m.presentmethod = presentmethod;
     m.pts           = pts;
+    m.telemetry     = telemetry;
     requeue(m_queued, m_free);
 
     /* signal to any waiters to check state */
@@ -789,8 +805,12 @@ void CXBMCRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
   if (!gui && m_pRenderer->IsGuiLayer())
     return;
 
+  // video and overlays go on top of the GUI queued so far
+  g_graphicsContext.FlushBatch();
+
   if (!gui || m_pRenderer->IsGuiLayer())
   {
+    int64_t start = CurrentHostCounter();
     SPresent& m = m_Queue[m_presentsource];
 
     if( m.presentmethod == PRESENT_METHOD_BOB )
@@ -801,6 +821,7 @@ void CXBMCRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
       PresentBlend(clear, flags, alpha);
     else
       PresentSingle(clear, flags, alpha);
+    m_renderticks += CurrentHostCounter() - start;
   }
 
   if (gui)
@@ -963,7 +984,10 @@ int CXBMCRenderManager::AddVideoPicture(DVDVideoPicture& pic)
   || pic.format == RENDER_FMT_YUV420P10
   || pic.format == RENDER_FMT_YUV420P16)
   {
-    CDVDCodecUtils::CopyPicture(&image, &pic);
+    // render straight from the decoder's planes if the renderer can take them
+    if (!pic.videoBuffer || !pic.videoBuffer->Matches(&pic)
+    ||  !m_pRenderer->AddVideoBuffer(pic.videoBuffer, index))
+      CDVDCodecUtils::CopyPicture(&image, &pic);
   }
   else if(pic.format == RENDER_FMT_NV12)
   {
@@ -1160,6 +1184,7 @@ void CXBMCRenderManager::PrepareNextRender()
     /* skip late frames */
     while(m_queued.front() != idx)
     {
+      g_videoTelemetry.Drop(m_Queue[m_queued.front()].telemetry);
       requeue(m_discard, m_queued);
       m_QueueSkip++;
     }
@@ -1182,6 +1207,8 @@ void CXBMCRenderManager::DiscardBuffer()
   while(!m_queued.empty())
     requeue(m_discard, m_queued);
 
+  g_videoTelemetry.Discontinuity();
+
   if(m_presentstep == PRESENT_READY)
     m_presentstep   = PRESENT_IDLE;
   m_presentevent.notifyAll();
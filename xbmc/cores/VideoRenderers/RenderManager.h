@@ -105,8 +105,9 @@ public:
    * @param pts used for lateness detection
    * @param source depreciated
    * @param sync signals frame, top, or bottom field
+   * @param telemetry id of the frame in g_videoTelemetry
    */
-  void FlipPage(volatile bool& bStop, double timestamp = 0.0, double pts = 0.0, int source = -1, EFIELDSYNC sync = FS_NONE);
+  void FlipPage(volatile bool& bStop, double timestamp = 0.0, double pts = 0.0, int source = -1, EFIELDSYNC sync = FS_NONE, int telemetry = -1);
   unsigned int PreInit();
   void UnInit();
   bool Flush();
@@ -238,6 +239,7 @@ protected:
     double         timestamp;
     EFIELDSYNC     presentfield;
     EPRESENTMETHOD presentmethod;
+    int            telemetry;
   } m_Queue[NUM_BUFFERS];
 
   std::deque<int> m_free;
@@ -258,6 +260,7 @@ protected:
   CCriticalSection m_presentlock;
   CEvent     m_flushEvent;
   double     m_clock_framefinish;
+  int64_t    m_renderticks;
 
 
   OVERLAY::CRenderer m_overlays;
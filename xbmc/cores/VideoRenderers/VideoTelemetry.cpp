@@ -0,0 +1,265 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "VideoTelemetry.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/MathUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <limits.h>
+#include <math.h>
+
+// histogram buckets, each counts the values up to its bound
+static const double TimeBounds[]    = { 1, 2, 4, 8, 16, 32, 64 };                  // ms
+static const double OffsetBounds[]  = { 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0 }; // vblanks
+static const double DriftBounds[]   = { -40, -20, -10, -5, -2, 2, 5, 10, 20, 40 }; // ms
+static const double VblanksBounds[] = { 1, 2, 3, 4, 5, 6 };
+
+#define NUM_BOUNDS(x) (sizeof(x) / sizeof(x[0]))
+
+static double Percentile(const std::vector<double>& sorted, double percentile)
+{
+  return sorted[std::min(sorted.size() - 1, (size_t)(percentile * (sorted.size() - 1) + 0.5))];
+}
+
+static void Summarise(std::vector<double>& values, const double* bounds, unsigned int count, CVariant& result)
+{
+  result = CVariant(CVariant::VariantTypeObject);
+  result["count"] = (unsigned int)values.size();
+  result["histogram"] = CVariant(CVariant::VariantTypeArray);
+  if (values.empty())
+    return;
+
+  std::sort(values.begin(), values.end());
+  double total = 0.0;
+  for (std::vector<double>::const_iterator it = values.begin(); it != values.end(); ++it)
+    total += *it;
+
+  result["minimum"] = values.front();
+  result["maximum"] = values.back();
+  result["average"] = total / values.size();
+  result["median"]  = Percentile(values, 0.5);
+  result["p95"]     = Percentile(values, 0.95);
+  result["p99"]     = Percentile(values, 0.99);
+
+  std::vector<double>::iterator begin = values.begin();
+  for (unsigned int i = 0; i <= count; i++)
+  {
+    std::vector<double>::iterator end = i < count ? std::upper_bound(begin, values.end(), bounds[i]) : values.end();
+    CVariant bucket(CVariant::VariantTypeObject);
+    if (i < count)
+      bucket["upto"] = bounds[i];
+    bucket["count"] = (unsigned int)(end - begin);
+    result["histogram"].append(bucket);
+    begin = end;
+  }
+}
+
+CVideoTelemetry::CVideoTelemetry(unsigned int size)
+  : m_frames(size)
+{
+  Reset();
+}
+
+void CVideoTelemetry::Reset()
+{
+  CSingleLock lock(m_section);
+  m_next = 0;
+  m_lastPresented = -1;
+  m_audioDrift = 0.0;
+}
+
+CVideoTelemetry::Frame* CVideoTelemetry::Find(int id)
+{
+  if (id < 0 || id >= m_next || m_next - id > (int)m_frames.size())
+    return NULL;
+  return &m_frames[id % m_frames.size()];
+}
+
+int CVideoTelemetry::AddFrame(double pts, double duration, double decodeTime, double queueWait, bool dropped)
+{
+  CSingleLock lock(m_section);
+  // ids wrap after a year of playback
+  if (m_next == INT_MAX)
+  {
+    m_next = 0;
+    m_lastPresented = -1;
+  }
+
+  Frame& frame = m_frames[m_next % m_frames.size()];
+  frame = Frame();
+  frame.id = m_next;
+  frame.pts = pts;
+  frame.duration = duration;
+  frame.dropped = dropped;
+  frame.decodeTime = decodeTime;
+  frame.queueWait = queueWait;
+  frame.audioDrift = m_audioDrift;
+  return m_next++;
+}
+
+void CVideoTelemetry::SetAudioDrift(double drift)
+{
+  CSingleLock lock(m_section);
+  m_audioDrift = drift;
+}
+
+void CVideoTelemetry::Present(int id, double target, double vblank, double interval, double renderTime)
+{
+  CSingleLock lock(m_section);
+  Frame* frame = Find(id);
+  if (!frame || frame->present != 0.0)
+    return;
+
+  frame->target = target;
+  frame->present = vblank;
+  frame->interval = interval;
+  frame->renderTime = renderTime;
+
+  // the previous frame stayed on screen until now
+  Frame* last = Find(m_lastPresented);
+  if (last && interval > 0.0)
+    last->vblanks = std::max(1, MathUtils::round_int((vblank - last->present) / interval));
+  m_lastPresented = id;
+}
+
+void CVideoTelemetry::Drop(int id)
+{
+  CSingleLock lock(m_section);
+  Frame* frame = Find(id);
+  if (frame)
+    frame->dropped = true;
+}
+
+void CVideoTelemetry::Discontinuity()
+{
+  CSingleLock lock(m_section);
+  m_lastPresented = -1;
+}
+
+std::vector<CVideoTelemetry::Frame> CVideoTelemetry::GetFrames() const
+{
+  CSingleLock lock(m_section);
+  std::vector<Frame> frames;
+  int first = std::max(0, m_next - (int)m_frames.size());
+  frames.reserve(m_next - first);
+  for (int id = first; id < m_next; id++)
+    frames.push_back(m_frames[id % m_frames.size()]);
+  return frames;
+}
+
+int CVideoTelemetry::GetExpectedVblanks(const Frame& frame)
+{
+  if (frame.interval <= 0.0)
+    return 0;
+  // a little slack, 25fps on 50Hz is 2 vblanks rather than 3 after rounding errors
+  return std::max(1, (int)ceil(frame.duration / frame.interval - 0.05));
+}
+
+bool CVideoTelemetry::IsDuplicated(const Frame& frame)
+{
+  return !frame.dropped && frame.vblanks > 0 && frame.vblanks > GetExpectedVblanks(frame);
+}
+
+void CVideoTelemetry::GetSummary(CVariant& summary) const
+{
+  std::vector<Frame> frames = GetFrames();
+
+  unsigned int presented = 0, dropped = 0, duplicated = 0;
+  double interval = 0.0;
+  std::vector<double> decodeTime, queueWait, renderTime, offset, drift, vblanks;
+  for (std::vector<Frame>::const_iterator it = frames.begin(); it != frames.end(); ++it)
+  {
+    decodeTime.push_back(it->decodeTime * 1000.0);
+    if (it->dropped)
+    {
+      dropped++;
+      continue;
+    }
+
+    queueWait.push_back(it->queueWait * 1000.0);
+    drift.push_back(it->audioDrift * 1000.0);
+    if (it->present == 0.0)
+      continue;
+
+    presented++;
+    interval = it->interval;
+    renderTime.push_back(it->renderTime * 1000.0);
+    if (it->interval > 0.0)
+      offset.push_back((it->present - it->target) / it->interval);
+    if (it->vblanks > 0)
+      vblanks.push_back(it->vblanks);
+    if (IsDuplicated(*it))
+      duplicated++;
+  }
+
+  summary = CVariant(CVariant::VariantTypeObject);
+  summary["frames"] = (unsigned int)frames.size();
+  summary["presented"] = presented;
+  summary["dropped"] = dropped;
+  summary["duplicated"] = duplicated;
+  summary["refreshrate"] = interval > 0.0 ? 1.0 / interval : 0.0;
+  Summarise(decodeTime, TimeBounds, NUM_BOUNDS(TimeBounds), summary["decodetime"]);
+  Summarise(queueWait, TimeBounds, NUM_BOUNDS(TimeBounds), summary["queuewait"]);
+  Summarise(renderTime, TimeBounds, NUM_BOUNDS(TimeBounds), summary["rendertime"]);
+  Summarise(offset, OffsetBounds, NUM_BOUNDS(OffsetBounds), summary["vblankoffset"]);
+  Summarise(vblanks, VblanksBounds, NUM_BOUNDS(VblanksBounds), summary["vblanks"]);
+  Summarise(drift, DriftBounds, NUM_BOUNDS(DriftBounds), summary["audiodrift"]);
+}
+
+std::string CVideoTelemetry::GetCSV() const
+{
+  std::vector<Frame> frames = GetFrames();
+
+  std::string csv = "id,pts,duration,dropped,decodetime,queuewait,audiodrift,target,present,interval,rendertime,vblanks,duplicated\n";
+  for (std::vector<Frame>::const_iterator it = frames.begin(); it != frames.end(); ++it)
+  {
+    csv += StringUtils::Format("%d,%.6f,%.6f,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%d,%d\n",
+                               it->id, it->pts, it->duration, it->dropped ? 1 : 0,
+                               it->decodeTime, it->queueWait, it->audioDrift,
+                               it->target, it->present, it->interval, it->renderTime,
+                               it->vblanks, IsDuplicated(*it) ? 1 : 0);
+  }
+  return csv;
+}
+
+bool CVideoTelemetry::Dump(const std::string& file) const
+{
+  std::string csv = GetCSV();
+
+  XFILE::CFile output;
+  if (!output.OpenForWrite(file, true) ||
+      output.Write(csv.c_str(), csv.size()) != (ssize_t)csv.size())
+  {
+    CLog::Log(LOGERROR, "CVideoTelemetry::Dump - unable to write %s", file.c_str());
+    return false;
+  }
+  return true;
+}
+
+double CVideoTelemetryVblank::GetVblank(double target) const
+{
+  // tolerate rounding errors for targets right on a vblank
+  return m_phase + ceil((target - m_phase) / m_interval - 1e-6) * m_interval;
+}
@@ -0,0 +1,136 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+
+#include <string>
+#include <vector>
+
+class CVariant;
+
+/*!
+ \brief Records how the most recent video frames went through the pipeline.
+
+ The video player adds every frame it outputs or drops, with the time it took
+ to decode and to get a render buffer. The render manager adds when the frame
+ was presented, how far the vblank it was presented at was from its target
+ and how long rendering took. How many vblanks a frame stayed on screen is
+ known once the next frame is presented, frames shown for more vblanks than
+ their duration needs are duplicated.
+
+ Times are in seconds, present times in the clock of CDVDClock::GetAbsoluteClock().
+ */
+class CVideoTelemetry
+{
+public:
+  struct Frame
+  {
+    int    id;
+    double pts;
+    double duration;     // how long the frame should be shown
+    bool   dropped;
+    double decodeTime;
+    double queueWait;    // waiting for a free render buffer
+    double audioDrift;   // audio clock minus player clock when the frame was output
+    double target;       // when the frame should have been presented
+    double present;      // the vblank it was presented at, 0 if it wasn't presented
+    double interval;     // between vblanks at the time
+    double renderTime;
+    int    vblanks;      // on screen, 0 until the next frame is presented
+  };
+
+  CVideoTelemetry(unsigned int size = 4096);
+
+  void Reset();
+
+  /*!
+   \brief Add a frame output by the player
+   \return the id to present the frame with
+   */
+  int AddFrame(double pts, double duration, double decodeTime, double queueWait, bool dropped = false);
+  void SetAudioDrift(double drift);
+
+  /*!
+   \brief The render manager presented a frame
+   \param target when the frame should have been presented
+   \param vblank when it was presented
+   \param interval between vblanks
+   */
+  void Present(int id, double target, double vblank, double interval, double renderTime);
+
+  /*!
+   \brief The render manager skipped a frame that was late
+   */
+  void Drop(int id);
+
+  /*!
+   \brief Don't count vblanks across a flush or pause
+   */
+  void Discontinuity();
+
+  std::vector<Frame> GetFrames() const;
+
+  /*!
+   \brief Vblanks a frame may stay on screen without being a duplicate
+   */
+  static int GetExpectedVblanks(const Frame& frame);
+  static bool IsDuplicated(const Frame& frame);
+
+  /*!
+   \brief Counts and histograms of the recorded frames
+   */
+  void GetSummary(CVariant& summary) const;
+
+  /*!
+   \brief The recorded frames as CSV, one line per frame
+   */
+  std::string GetCSV() const;
+  bool Dump(const std::string& file) const;
+
+private:
+  Frame* Find(int id);
+
+  mutable CCriticalSection m_section;
+  std::vector<Frame> m_frames;
+  int    m_next;           // id of the next frame
+  int    m_lastPresented;  // id of the frame presented last, -1 after a discontinuity
+  double m_audioDrift;
+};
+
+/*!
+ \brief A display refreshing at a fixed rate, to feed the telemetry without a
+ render loop. Frames are presented at the first vblank at or after their target.
+ */
+class CVideoTelemetryVblank
+{
+public:
+  CVideoTelemetryVblank(double refreshRate, double phase = 0.0)
+    : m_interval(1.0 / refreshRate), m_phase(phase) {}
+
+  double GetInterval() const { return m_interval; }
+  double GetVblank(double target) const;
+
+private:
+  double m_interval;
+  double m_phase;
+};
+
+extern CVideoTelemetry g_videoTelemetry;
@@ -0,0 +1,210 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoRenderers/VideoTelemetry.h"
+#include "filesystem/File.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+/* Plays frames of the given rate on a simulated display the way the render
+ * manager does, each frame targeted half a vblank before the vblank it should
+ * go out at. Frame late is presented a vblank late, as if rendering stalled. */
+static void Play(CVideoTelemetry& telemetry, double frameRate, double refreshRate, int frames, int late = -1)
+{
+  CVideoTelemetryVblank vblank(refreshRate);
+  double duration = 1.0 / frameRate;
+  for (int i = 0; i < frames; i++)
+  {
+    int id = telemetry.AddFrame(i * duration, duration, 0.004, 0.010);
+    double target = 10.0 + i * duration + 0.5 * vblank.GetInterval();
+    double present = vblank.GetVblank(target);
+    if (i == late)
+      present += vblank.GetInterval();
+    telemetry.Present(id, target, present, vblank.GetInterval(), 0.002);
+  }
+}
+
+static unsigned int HistogramCount(const CVariant& histogram, double upto)
+{
+  for (unsigned int i = 0; i < histogram.size(); i++)
+  {
+    if (histogram[i]["upto"].asDouble() == upto)
+      return (unsigned int)histogram[i]["count"].asUnsignedInteger();
+  }
+  return 0;
+}
+
+TEST(TestVideoTelemetry, Ring)
+{
+  CVideoTelemetry telemetry(8);
+  for (int i = 0; i < 20; i++)
+    EXPECT_EQ(i, telemetry.AddFrame(i, 0.04, 0.0, 0.0));
+
+  std::vector<CVideoTelemetry::Frame> frames = telemetry.GetFrames();
+  ASSERT_EQ(8U, frames.size());
+  EXPECT_EQ(12, frames.front().id);
+  EXPECT_EQ(19, frames.back().id);
+
+  // frames that fell out of the ring are ignored
+  telemetry.Present(3, 1.0, 1.0, 0.02, 0.0);
+  telemetry.Present(12, 1.0, 1.0, 0.02, 0.0);
+  frames = telemetry.GetFrames();
+  EXPECT_EQ(1.0, frames.front().present);
+  for (size_t i = 1; i < frames.size(); i++)
+    EXPECT_EQ(0.0, frames[i].present);
+
+  telemetry.Reset();
+  EXPECT_TRUE(telemetry.GetFrames().empty());
+}
+
+TEST(TestVideoTelemetry, Cadence)
+{
+  // 23.976fps on 60Hz is the 3:2 cadence, which is what it should be
+  CVideoTelemetry telemetry;
+  Play(telemetry, 24000.0 / 1001.0, 60.0, 240);
+
+  CVariant summary;
+  telemetry.GetSummary(summary);
+  EXPECT_EQ(240U, summary["frames"].asUnsignedInteger());
+  EXPECT_EQ(240U, summary["presented"].asUnsignedInteger());
+  EXPECT_EQ(0U, summary["dropped"].asUnsignedInteger());
+  EXPECT_EQ(0U, summary["duplicated"].asUnsignedInteger());
+  EXPECT_NEAR(60.0, summary["refreshrate"].asDouble(), 0.001);
+
+  // the last frame is still on screen
+  const CVariant& vblanks = summary["vblanks"];
+  EXPECT_EQ(239U, vblanks["count"].asUnsignedInteger());
+  EXPECT_EQ(0U, HistogramCount(vblanks["histogram"], 1));
+  EXPECT_EQ(239U, HistogramCount(vblanks["histogram"], 2) + HistogramCount(vblanks["histogram"], 3));
+  EXPECT_GT(HistogramCount(vblanks["histogram"], 2), 100U);
+  EXPECT_GT(HistogramCount(vblanks["histogram"], 3), 100U);
+
+  // every frame went out at the first vblank after its target
+  EXPECT_GE(summary["vblankoffset"]["minimum"].asDouble(), 0.0);
+  EXPECT_LT(summary["vblankoffset"]["maximum"].asDouble(), 1.0);
+
+  EXPECT_DOUBLE_EQ(4.0, summary["decodetime"]["median"].asDouble());
+  EXPECT_DOUBLE_EQ(10.0, summary["queuewait"]["p99"].asDouble());
+  EXPECT_DOUBLE_EQ(2.0, summary["rendertime"]["average"].asDouble());
+  EXPECT_EQ(240U, HistogramCount(summary["queuewait"]["histogram"], 16));
+}
+
+TEST(TestVideoTelemetry, Duplicated)
+{
+  // 25fps on 50Hz with one frame that missed its vblank, the one before stays on screen
+  CVideoTelemetry telemetry;
+  Play(telemetry, 25.0, 50.0, 50, 10);
+
+  std::vector<CVideoTelemetry::Frame> frames = telemetry.GetFrames();
+  ASSERT_EQ(50U, frames.size());
+  EXPECT_EQ(2, CVideoTelemetry::GetExpectedVblanks(frames[9]));
+  EXPECT_EQ(3, frames[9].vblanks);
+  EXPECT_TRUE(CVideoTelemetry::IsDuplicated(frames[9]));
+  EXPECT_EQ(1, frames[10].vblanks);
+  EXPECT_FALSE(CVideoTelemetry::IsDuplicated(frames[10]));
+  EXPECT_EQ(2, frames[11].vblanks);
+
+  CVariant summary;
+  telemetry.GetSummary(summary);
+  EXPECT_EQ(1U, summary["duplicated"].asUnsignedInteger());
+  // the late frame is the only one off by more than a vblank
+  const CVariant& histogram = summary["vblankoffset"]["histogram"];
+  EXPECT_EQ(1U, histogram[histogram.size() - 1]["count"].asUnsignedInteger());
+  EXPECT_NEAR(1.5, summary["vblankoffset"]["maximum"].asDouble(), 0.001);
+}
+
+TEST(TestVideoTelemetry, Dropped)
+{
+  CVideoTelemetry telemetry;
+  int first = telemetry.AddFrame(0.00, 0.04, 0.0, 0.0);
+  telemetry.AddFrame(0.04, 0.04, 0.0, 0.0, true);
+  int late = telemetry.AddFrame(0.08, 0.04, 0.0, 0.0);
+  int last = telemetry.AddFrame(0.12, 0.04, 0.0, 0.0);
+  telemetry.Present(first, 1.00, 1.01, 0.02, 0.0);
+  telemetry.Drop(late);
+  telemetry.Present(last, 1.12, 1.13, 0.02, 0.0);
+
+  CVariant summary;
+  telemetry.GetSummary(summary);
+  EXPECT_EQ(4U, summary["frames"].asUnsignedInteger());
+  EXPECT_EQ(2U, summary["presented"].asUnsignedInteger());
+  EXPECT_EQ(2U, summary["dropped"].asUnsignedInteger());
+  // the first frame stayed on screen for the dropped ones
+  EXPECT_EQ(1U, summary["duplicated"].asUnsignedInteger());
+  EXPECT_EQ(6, telemetry.GetFrames()[0].vblanks);
+}
+
+TEST(TestVideoTelemetry, Discontinuity)
+{
+  CVideoTelemetry telemetry;
+  int first = telemetry.AddFrame(0.00, 0.04, 0.0, 0.0);
+  int second = telemetry.AddFrame(0.04, 0.04, 0.0, 0.0);
+  telemetry.Present(first, 1.00, 1.01, 0.02, 0.0);
+  telemetry.Discontinuity();
+  telemetry.Present(second, 5.00, 5.01, 0.02, 0.0);
+
+  EXPECT_EQ(0, telemetry.GetFrames()[0].vblanks);
+
+  CVariant summary;
+  telemetry.GetSummary(summary);
+  EXPECT_EQ(0U, summary["duplicated"].asUnsignedInteger());
+  EXPECT_EQ(0U, summary["vblanks"]["count"].asUnsignedInteger());
+}
+
+TEST(TestVideoTelemetry, AudioDrift)
+{
+  CVideoTelemetry telemetry;
+  telemetry.SetAudioDrift(0.003);
+  telemetry.AddFrame(0.00, 0.04, 0.0, 0.0);
+  telemetry.SetAudioDrift(-0.015);
+  telemetry.AddFrame(0.04, 0.04, 0.0, 0.0);
+
+  CVariant summary;
+  telemetry.GetSummary(summary);
+  const CVariant& drift = summary["audiodrift"];
+  EXPECT_EQ(2U, drift["count"].asUnsignedInteger());
+  EXPECT_DOUBLE_EQ(-15.0, drift["minimum"].asDouble());
+  EXPECT_DOUBLE_EQ(3.0, drift["maximum"].asDouble());
+  EXPECT_EQ(1U, HistogramCount(drift["histogram"], -10));
+  EXPECT_EQ(1U, HistogramCount(drift["histogram"], 5));
+}
+
+TEST(TestVideoTelemetry, Dump)
+{
+  CVideoTelemetry telemetry;
+  Play(telemetry, 24.0, 24.0, 10);
+
+  std::string csv = telemetry.GetCSV();
+  std::vector<std::string> lines = StringUtils::Split(csv, "\n");
+  ASSERT_EQ(12U, lines.size());
+  EXPECT_TRUE(StringUtils::StartsWith(lines[0], "id,pts,duration,"));
+  EXPECT_TRUE(StringUtils::StartsWith(lines[1], "0,0.000000,0.041667,0,"));
+  EXPECT_TRUE(lines[11].empty());
+
+  std::string file = "special://temp/videotelemetry.csv";
+  ASSERT_TRUE(telemetry.Dump(file));
+  XFILE::CFile input;
+  XFILE::auto_buffer buffer;
+  EXPECT_EQ((ssize_t)csv.size(), input.LoadFile(file, buffer));
+  EXPECT_EQ(csv, std::string(buffer.get(), buffer.size()));
+  XFILE::CFile::Delete(file);
+}
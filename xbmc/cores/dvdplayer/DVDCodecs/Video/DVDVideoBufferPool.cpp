@@ -0,0 +1,206 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDVideoBufferPool.h"
+#include "DVDVideoCodec.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+extern "C" {
+#include "libavutil/imgutils.h"
+}
+
+#include <algorithm>
+
+// stride alignment of the pooled planes, suitable for SIMD copies and
+// texture uploads with GL_UNPACK_ALIGNMENT of 8 or less
+#define DVD_BUFFER_STRIDE_ALIGN 64
+
+CDVDVideoBuffer* CDVDVideoBuffer::Create(const AVFrame *frame)
+{
+  if (!frame || !frame->buf[0])
+    return NULL;
+
+  AVFrame *ref = av_frame_alloc();
+  if (!ref)
+    return NULL;
+
+  if (av_frame_ref(ref, frame) < 0)
+  {
+    av_frame_free(&ref);
+    return NULL;
+  }
+  return new CDVDVideoBuffer(ref);
+}
+
+CDVDVideoBuffer::CDVDVideoBuffer(AVFrame *frame)
+  : m_frame(frame)
+{
+}
+
+CDVDVideoBuffer::~CDVDVideoBuffer()
+{
+  av_frame_free(&m_frame);
+}
+
+bool CDVDVideoBuffer::Matches(const DVDVideoPicture *picture) const
+{
+  for (int i = 0; i < 3; i++)
+  {
+    if (picture->data[i] != m_frame->data[i] || picture->iLineSize[i] != m_frame->linesize[i])
+      return false;
+  }
+  return true;
+}
+
+CDVDVideoBufferPool::CDVDVideoBufferPool()
+{
+  for (int i = 0; i < 4; i++)
+  {
+    m_pools[i] = NULL;
+    m_linesize[i] = 0;
+  }
+  m_width = 0;
+  m_height = 0;
+  m_format = AV_PIX_FMT_NONE;
+}
+
+CDVDVideoBufferPool::~CDVDVideoBufferPool()
+{
+  FreePools();
+}
+
+bool CDVDVideoBufferPool::IsDirectFormat(int pix_fmt)
+{
+  switch (pix_fmt)
+  {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+    case AV_PIX_FMT_YUV420P10:
+    case AV_PIX_FMT_YUV420P16:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void CDVDVideoBufferPool::FreePools()
+{
+  // buffers still referenced by the codec or a renderer keep their pool
+  // alive until they are returned, so this is safe at any time
+  for (int i = 0; i < 4; i++)
+    av_buffer_pool_uninit(&m_pools[i]);
+  m_width = 0;
+  m_height = 0;
+  m_format = AV_PIX_FMT_NONE;
+}
+
+bool CDVDVideoBufferPool::UpdatePools(AVCodecContext *avctx, int width, int height, int format)
+{
+  if (m_pools[0] && width == m_width && height == m_height && format == m_format)
+    return true;
+
+  FreePools();
+
+  int w = width;
+  int h = height;
+  int linesize_align[AV_NUM_DATA_POINTERS];
+  avcodec_align_dimensions2(avctx, &w, &h, linesize_align);
+
+  // grow the width until all planes satisfy both the codec's and our own
+  // stride alignment; aligning planes individually would break codecs
+  // assuming fixed ratios between the luma and chroma strides
+  int linesize[4];
+  int unaligned;
+  do
+  {
+    if (av_image_fill_linesizes(linesize, (AVPixelFormat)format, w) < 0)
+      return false;
+    w += w & ~(w - 1);
+
+    unaligned = 0;
+    for (int i = 0; i < 4; i++)
+      unaligned |= linesize[i] % std::max(linesize_align[i], DVD_BUFFER_STRIDE_ALIGN);
+  } while (unaligned);
+
+  uint8_t *data[4];
+  int size = av_image_fill_pointers(data, (AVPixelFormat)format, h, NULL, linesize);
+  if (size < 0)
+    return false;
+
+  for (int i = 0; i < 4 && data[i]; i++)
+  {
+    int planesize;
+    if (i < 3 && data[i + 1])
+      planesize = data[i + 1] - data[i];
+    else
+      planesize = size - (data[i] - data[0]);
+
+    m_linesize[i] = linesize[i];
+    m_pools[i] = av_buffer_pool_init(planesize + 16 + DVD_BUFFER_STRIDE_ALIGN - 1, av_buffer_allocz);
+    if (!m_pools[i])
+    {
+      FreePools();
+      return false;
+    }
+  }
+
+  m_width = width;
+  m_height = height;
+  m_format = format;
+  CLog::Log(LOGDEBUG, "CDVDVideoBufferPool::UpdatePools - %dx%d format %d, strides %d/%d/%d",
+            width, height, format, m_linesize[0], m_linesize[1], m_linesize[2]);
+  return true;
+}
+
+int CDVDVideoBufferPool::GetBuffer(AVCodecContext *avctx, AVFrame *frame, int flags)
+{
+  if (!IsDirectFormat(frame->format) || !(avctx->codec->capabilities & CODEC_CAP_DR1))
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+
+  CSingleLock lock(m_section);
+  if (!UpdatePools(avctx, frame->width, frame->height, frame->format))
+  {
+    CLog::Log(LOGWARNING, "CDVDVideoBufferPool::GetBuffer - unable to set up pools, using default allocator");
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+  }
+
+  int i;
+  for (i = 0; i < 4 && m_pools[i]; i++)
+  {
+    frame->buf[i] = av_buffer_pool_get(m_pools[i]);
+    if (!frame->buf[i])
+    {
+      av_frame_unref(frame);
+      return AVERROR(ENOMEM);
+    }
+    // the pool pads every buffer so that the plane can start on an aligned address
+    frame->data[i] = (uint8_t*)(((uintptr_t)frame->buf[i]->data + DVD_BUFFER_STRIDE_ALIGN - 1) & ~(uintptr_t)(DVD_BUFFER_STRIDE_ALIGN - 1));
+    frame->linesize[i] = m_linesize[i];
+  }
+  for (; i < AV_NUM_DATA_POINTERS; i++)
+  {
+    frame->data[i] = NULL;
+    frame->linesize[i] = 0;
+  }
+  frame->extended_data = frame->data;
+
+  return 0;
+}
@@ -0,0 +1,92 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDResource.h"
+#include "threads/CriticalSection.h"
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+#include "libavutil/buffer.h"
+}
+
+struct DVDVideoPicture;
+
+/*! \brief A reference to a decoded software frame.
+ Holds a reference on the buffers FFmpeg decoded the picture into, so that a
+ renderer can upload straight from them instead of copying the planes into its
+ own image first. The planes stay valid until the last reference is released.
+ */
+class CDVDVideoBuffer : public IDVDResourceCounted<CDVDVideoBuffer>
+{
+public:
+  /*! \brief Take a new reference on the buffers of frame
+   \return the buffer or NULL if frame is not reference counted
+   */
+  static CDVDVideoBuffer* Create(const AVFrame *frame);
+
+  /*! \brief Check whether the planes of picture are the ones held by this buffer.
+   Filters, post processing and overlay blending may substitute the picture
+   data after decode, in which case the buffer must not be used for rendering.
+   */
+  bool Matches(const DVDVideoPicture *picture) const;
+
+  uint8_t* GetPlane(int plane) const  { return m_frame->data[plane]; }
+  int      GetStride(int plane) const { return m_frame->linesize[plane]; }
+
+private:
+  CDVDVideoBuffer(AVFrame *frame);
+  virtual ~CDVDVideoBuffer();
+
+  AVFrame *m_frame;
+};
+
+/*! \brief Allocates the frames of software decoders.
+ Installed as get_buffer2 on the codec context, this hands out pooled,
+ reference counted planes laid out the way the renderers can consume them
+ directly: 4:2:0 planar formats with strides aligned for texture upload.
+ Any other format, or codecs not supporting direct rendering, fall back to the
+ default FFmpeg allocator.
+ */
+class CDVDVideoBufferPool
+{
+public:
+  CDVDVideoBufferPool();
+  ~CDVDVideoBufferPool();
+
+  /*! \brief get_buffer2 implementation, see CDVDVideoCodecFFmpeg::GetBuffer
+   */
+  int GetBuffer(AVCodecContext *avctx, AVFrame *frame, int flags);
+
+  /*! \brief Check whether frames of this format can be handed to the renderer without a copy
+   */
+  static bool IsDirectFormat(int pix_fmt);
+
+private:
+  bool UpdatePools(AVCodecContext *avctx, int width, int height, int format);
+  void FreePools();
+
+  CCriticalSection m_section;
+  AVBufferPool    *m_pools[4];
+  int              m_linesize[4];
+  int              m_width;
+  int              m_height;
+  int              m_format;
+};
@@ -57,6 +57,7 @@ class CDVDVideoCodecStageFright;
 class CDVDMediaCodecInfo;
 class CDVDVideoCodecIMXBuffer;
 class CMMALVideoBuffer;
+class CDVDVideoBuffer;
 typedef void* EGLImageKHR;
 
 
@@ -110,6 +111,8 @@ struct DVDVideoPicture
 
   };
 
+  CDVDVideoBuffer* videoBuffer; // optional, holds the software decoded planes in data[] for direct rendering
+
   unsigned int iFlags;
 
   double       iRepeatPicture;
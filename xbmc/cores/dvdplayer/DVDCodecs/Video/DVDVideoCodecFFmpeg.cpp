@@ -147,7 +147,7 @@ enum PixelFormat CDVDVideoCodecFFmpeg::GetFormat( struct AVCodecContext * avctx
   if (ctx->GetHardware())
   {
     ctx->SetHardware(NULL);
-    avctx->get_buffer2     = avcodec_default_get_buffer2;
+    avctx->get_buffer2     = GetBuffer;
     avctx->slice_flags     = 0;
     avctx->hwaccel_context = 0;
   }
@@ -155,10 +155,17 @@ enum PixelFormat CDVDVideoCodecFFmpeg::GetFormat( struct AVCodecContext * avctx
   return avcodec_default_get_format(avctx, fmt);
 }
 
+int CDVDVideoCodecFFmpeg::GetBuffer(struct AVCodecContext * avctx, AVFrame *frame, int flags)
+{
+  CDVDVideoCodecFFmpeg* ctx = (CDVDVideoCodecFFmpeg*)avctx->opaque;
+  return ctx->m_bufferPool.GetBuffer(avctx, frame, flags);
+}
+
 CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
 {
   m_pCodecContext = NULL;
   m_pFrame = NULL;
+  m_pVideoBuffer = NULL;
   m_pFilterGraph  = NULL;
   m_pFilterIn     = NULL;
   m_pFilterOut    = NULL;
@@ -252,6 +259,10 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->debug = 0;
   m_pCodecContext->workaround_bugs = FF_BUG_AUTODETECT;
   m_pCodecContext->get_format = GetFormat;
+  // software frames are allocated from our own pool and stay referenced by
+  // the renderer after decoding, see CDVDVideoBufferPool
+  m_pCodecContext->get_buffer2 = GetBuffer;
+  m_pCodecContext->refcounted_frames = 1;
   m_pCodecContext->codec_tag = hints.codec_tag;
   /* Only allow slice threading, since frame threading is more
    * sensitive to changes in frame sizes, and it causes crashes
@@ -329,8 +340,8 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
 
 void CDVDVideoCodecFFmpeg::Dispose()
 {
-  if (m_pFrame) av_free(m_pFrame);
-  m_pFrame = NULL;
+  SAFE_RELEASE(m_pVideoBuffer);
+  av_frame_free(&m_pFrame);
 
   av_frame_free(&m_pFilterFrame);
 
@@ -488,6 +499,8 @@ int CDVDVideoCodecFFmpeg::Decode(uint8_t* pData, int iSize, double dts, double p
   /* We lie, but this flag is only used by pngdec.c.
    * Setting it correctly would allow CorePNG decoding. */
   avpkt.flags = AV_PKT_FLAG_KEY;
+  // frames are reference counted, drop ours on the previous picture
+  av_frame_unref(m_pFrame);
   len = avcodec_decode_video2(m_pCodecContext, m_pFrame, &iGotPicture, &avpkt);
 
   if(m_iLastKeyframe < m_pCodecContext->has_b_frames + 2)
@@ -729,6 +742,13 @@ bool CDVDVideoCodecFFmpeg::GetPicture(DVDVideoPicture* pDvdVideoPicture)
   PixelFormat pix_fmt;
   pix_fmt = (PixelFormat)m_pFrame->format;
 
+  // hand out a reference on the planes, so the renderer can take them
+  // without copying. we hold one until the next picture is returned.
+  SAFE_RELEASE(m_pVideoBuffer);
+  if (pDvdVideoPicture->data[0] && CDVDVideoBufferPool::IsDirectFormat(pix_fmt))
+    m_pVideoBuffer = CDVDVideoBuffer::Create(m_pFrame);
+  pDvdVideoPicture->videoBuffer = m_pVideoBuffer;
+
   pDvdVideoPicture->format = CDVDCodecUtils::EFormatFromPixfmt(pix_fmt);
   return true;
 }
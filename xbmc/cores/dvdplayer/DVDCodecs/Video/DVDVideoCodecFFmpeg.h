@@ -21,6 +21,7 @@
  */
 
 #include "DVDVideoCodec.h"
+#include "DVDVideoBufferPool.h"
 #include "DVDResource.h"
 #include <string>
 #include <vector>
@@ -76,6 +77,7 @@ public:
 
 protected:
   static enum PixelFormat GetFormat(struct AVCodecContext * avctx, const PixelFormat * fmt);
+  static int GetBuffer(struct AVCodecContext * avctx, AVFrame *frame, int flags);
 
   int  FilterOpen(const std::string& filters, bool scale);
   void FilterClose();
@@ -96,6 +98,9 @@ protected:
   AVFrame* m_pFrame;
   AVCodecContext* m_pCodecContext;
 
+  CDVDVideoBufferPool m_bufferPool;
+  CDVDVideoBuffer*    m_pVideoBuffer; // reference on the planes of the last picture returned by GetPicture
+
   std::string       m_filters;
   std::string       m_filters_next;
   AVFilterGraph*   m_pFilterGraph;
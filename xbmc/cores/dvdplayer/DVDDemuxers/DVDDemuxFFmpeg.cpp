@@ -49,6 +49,8 @@
 #include "threads/SystemClock.h"
 #include "utils/TimeUtils.h"
 #include "utils/StringUtils.h"
+#include "utils/JobManager.h"
+#include "utils/URIUtils.h"
 #include "URL.h"
 #include "cores/FFmpeg.h"
 
@@ -179,6 +181,9 @@ CDVDDemuxFFmpeg::CDVDDemuxFFmpeg() : CDVDDemux()
   memset(&m_pkt.pkt, 0, sizeof(AVPacket));
   m_streaminfo = true; /* set to true if we want to look for streams before playback */
   m_checkvideo = false;
+  m_indexStream = -1;
+  m_indexPackets = false;
+  m_indexEntries = 0;
 }
 
 CDVDDemuxFFmpeg::~CDVDDemuxFFmpeg()
@@ -498,6 +503,8 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput, bool streaminfo, bool filein
   if (skipCreateStreams && GetNrOfStreams() == 0)
     m_program = 0;
 
+  OpenIndex(strFile);
+
   return true;
 }
 
@@ -506,6 +513,16 @@ void CDVDDemuxFFmpeg::Dispose()
   m_pkt.result = -1;
   av_free_packet(&m_pkt.pkt);
 
+  if (m_indexStream >= 0)
+  {
+    UpdateIndex();
+    if (m_index.IsChanged())
+      CJobManager::GetInstance().AddJob(new CDVDDemuxIndexJob(m_indexFile, m_index), NULL);
+    m_index.Clear();
+    m_indexFile.clear();
+    m_indexStream = -1;
+  }
+
   if (m_pFormatContext)
   {
     if (m_ioContext && m_pFormatContext->pb && m_pFormatContext->pb != m_ioContext)
@@ -725,6 +742,12 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
     {
       ParsePacket(&m_pkt.pkt);
 
+      // keep track of the keyframes the way lavf's generic index does
+      if (m_indexPackets && m_pkt.pkt.stream_index == m_indexStream &&
+          (m_pkt.pkt.flags & AV_PKT_FLAG_KEY) &&
+          m_pkt.pkt.pos >= 0 && m_pkt.pkt.dts != (int64_t)AV_NOPTS_VALUE)
+        m_index.Add(m_pkt.pkt.dts, m_pkt.pkt.pos);
+
       AVStream *stream = m_pFormatContext->streams[m_pkt.pkt.stream_index];
 
       if (IsVideoReady())
@@ -886,6 +909,9 @@ bool CDVDDemuxFFmpeg::SeekTime(int time, bool backwords, double *startpts)
   m_pkt.result = -1;
   av_free_packet(&m_pkt.pkt);
 
+  // the keyframes read after the seek don't follow the ones before
+  m_index.Break();
+
   CDVDInputStream::ISeekTime* ist = dynamic_cast<CDVDInputStream::ISeekTime*>(m_pInput);
   if (ist)
   {
@@ -917,7 +943,15 @@ bool CDVDDemuxFFmpeg::SeekTime(int time, bool backwords, double *startpts)
   int ret;
   {
     CSingleLock lock(m_critSection);
-    ret = av_seek_frame(m_pFormatContext, -1, seek_pts, backwords ? AVSEEK_FLAG_BACKWARD : 0);
+    int64_t pos;
+    if (m_indexPackets && SeekIndex(seek_pts, backwords, pos))
+    {
+      // jump straight to the keyframe instead of having lavf search for it
+      CLog::Log(LOGDEBUG, "%s - seeking to indexed keyframe at %" PRId64, __FUNCTION__, pos);
+      ret = av_seek_frame(m_pFormatContext, -1, pos, AVSEEK_FLAG_BYTE);
+    }
+    else
+      ret = av_seek_frame(m_pFormatContext, -1, seek_pts, backwords ? AVSEEK_FLAG_BACKWARD : 0);
 
     // demuxer will return failure, if you seek behind eof
     if (ret < 0 && m_pFormatContext->duration && seek_pts >= (m_pFormatContext->duration + m_pFormatContext->start_time))
@@ -944,6 +978,7 @@ bool CDVDDemuxFFmpeg::SeekTime(int time, bool backwords, double *startpts)
 bool CDVDDemuxFFmpeg::SeekByte(int64_t pos)
 {
   CSingleLock lock(m_critSection);
+  m_index.Break();
   int ret = av_seek_frame(m_pFormatContext, -1, pos, AVSEEK_FLAG_BYTE);
 
   if(ret >= 0)
@@ -955,6 +990,91 @@ bool CDVDDemuxFFmpeg::SeekByte(int64_t pos)
   return (ret >= 0);
 }
 
+void CDVDDemuxFFmpeg::OpenIndex(const std::string& strFile)
+{
+  m_index.Clear();
+  m_indexFile.clear();
+  m_indexStream = -1;
+  m_indexPackets = false;
+  m_indexEntries = 0;
+
+  // only files that stay the same are worth indexing, discs know where to go anyway
+  if (!m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE) || !m_ioContext || !m_ioContext->seekable ||
+      URIUtils::IsInternetStream(strFile))
+    return;
+
+  int stream = av_find_default_stream_index(m_pFormatContext);
+  if (stream < 0 || !m_pFormatContext->streams[stream]->codec ||
+      m_pFormatContext->streams[stream]->codec->codec_type != AVMEDIA_TYPE_VIDEO)
+    return;
+  AVStream* st = m_pFormatContext->streams[stream];
+
+  // lavf bisects formats like mpegts and mpeg-ps to seek, reading a little of the file
+  // in every step. matroska without cues and avi without index build an index of their
+  // own while they are played, which only has to be kept for the next time.
+  const AVInputFormat* format = m_pFormatContext->iformat;
+  if (format->read_timestamp && !format->read_seek && !(format->flags & AVFMT_NO_BYTE_SEEK))
+    m_indexPackets = true;
+  else if (!(m_bMatroska || m_bAVI) || st->nb_index_entries > 0)
+    return;
+
+  m_index.m_hash = CDVDDemuxIndex::GetFileHash(strFile);
+  if (m_index.m_hash.empty())
+    return;
+  m_index.m_stream = stream;
+  m_index.m_codec = st->codec->codec_id;
+  m_index.m_timeBaseNum = st->time_base.num;
+  m_index.m_timeBaseDen = st->time_base.den;
+  m_indexFile = CDVDDemuxIndex::GetCacheFile(strFile);
+  m_indexStream = stream;
+
+  if (!m_index.Load(m_indexFile))
+    return;
+
+  CLog::Log(LOGDEBUG, "%s - loaded index with %u keyframes from %s", __FUNCTION__,
+            (unsigned int)m_index.GetEntries().size(), m_indexFile.c_str());
+
+  if (!m_indexPackets)
+  {
+    const std::vector<CDVDDemuxIndex::Entry>& entries = m_index.GetEntries();
+    for (std::vector<CDVDDemuxIndex::Entry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+      av_add_index_entry(st, it->pos, it->timestamp, 0, 0, AVINDEX_KEYFRAME);
+    m_indexEntries = st->nb_index_entries;
+  }
+}
+
+void CDVDDemuxFFmpeg::UpdateIndex()
+{
+  if (m_indexPackets || !m_pFormatContext || m_indexStream >= (int)m_pFormatContext->nb_streams)
+    return;
+
+  // collect what the demuxer added to its own index
+  AVStream* st = m_pFormatContext->streams[m_indexStream];
+  if (st->nb_index_entries <= m_indexEntries)
+    return;
+
+  // lavf's index doesn't tell which keyframes were read one after the other
+  for (int i = 0; i < st->nb_index_entries; i++)
+  {
+    if (st->index_entries[i].flags & AVINDEX_KEYFRAME)
+    {
+      m_index.Break();
+      m_index.Add(st->index_entries[i].timestamp, st->index_entries[i].pos);
+    }
+  }
+  m_indexEntries = st->nb_index_entries;
+}
+
+bool CDVDDemuxFFmpeg::SeekIndex(int64_t seek_pts, bool backwords, int64_t& pos)
+{
+  if (m_indexStream >= (int)m_pFormatContext->nb_streams)
+    return false;
+
+  AVStream* st = m_pFormatContext->streams[m_indexStream];
+  int64_t timestamp = av_rescale(seek_pts, st->time_base.den, (int64_t)st->time_base.num * AV_TIME_BASE);
+  return m_index.Find(timestamp, backwords, pos);
+}
+
 void CDVDDemuxFFmpeg::UpdateCurrentPTS()
 {
   m_currentPts = DVD_NOPTS_VALUE;
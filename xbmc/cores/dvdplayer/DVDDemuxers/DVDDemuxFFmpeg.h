@@ -21,6 +21,7 @@
  */
 
 #include "DVDDemux.h"
+#include "DVDDemuxIndex.h"
 #include "threads/CriticalSection.h"
 #include "threads/SystemClock.h"
 #include <map>
@@ -115,6 +116,11 @@ public:
 
   bool Aborted();
 
+  /*!
+   \brief Whether a keyframe index of the file is kept to speed up seeking
+   */
+  bool HasIndex() const { return m_indexStream >= 0; }
+
   AVFormatContext* m_pFormatContext;
   CDVDInputStream* m_pInput;
 
@@ -137,6 +143,9 @@ protected:
   double ConvertTimestamp(int64_t pts, int den, int num);
   void UpdateCurrentPTS();
   bool IsProgramChange();
+  void OpenIndex(const std::string& strFile);
+  void UpdateIndex();
+  bool SeekIndex(int64_t seek_pts, bool backwords, int64_t& pos);
 
   std::string GetStereoModeFromMetadata(AVDictionary *pMetadata);
   std::string ConvertCodecToInternalStereoMode(const std::string &mode, const StereoModeConversionMap *conversionMap);
@@ -167,5 +176,11 @@ protected:
 
   bool m_streaminfo;
   bool m_checkvideo;
+
+  CDVDDemuxIndex m_index;
+  std::string m_indexFile;
+  int  m_indexStream;   // the stream whose keyframes are indexed, -1 if there is no index
+  bool m_indexPackets;  // whether the keyframes are collected from the packets read, otherwise from the demuxer's own index
+  int  m_indexEntries;  // entries in the demuxer's own index that have been collected already
 };
 
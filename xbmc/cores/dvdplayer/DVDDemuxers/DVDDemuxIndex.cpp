@@ -0,0 +1,265 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxIndex.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <algorithm>
+#include <string.h>
+
+// bump whenever the format or the way keyframes are collected changes
+#define SEEK_INDEX_VERSION 2
+#define SEEK_INDEX_FOLDER  "special://database/SeekIndex/"
+
+static const char SeekIndexMagic[4] = { 'X', 'S', 'I', 'X' };
+
+struct SeekIndexHeader
+{
+  char     magic[4];
+  uint32_t version;
+  int32_t  stream;
+  int32_t  codec;
+  int32_t  timeBaseNum;
+  int32_t  timeBaseDen;
+  uint32_t hashLength;    // the hash of the file follows the header
+  uint32_t entries;       // the entries follow the hash
+  uint32_t crc;           // of everything after the header
+};
+
+static bool CompareTimestamp(const CDVDDemuxIndex::Entry& entry, int64_t timestamp)
+{
+  return entry.timestamp < timestamp;
+}
+
+CDVDDemuxIndex::CDVDDemuxIndex()
+{
+  m_stream = -1;
+  m_codec = 0;
+  m_timeBaseNum = 0;
+  m_timeBaseDen = 0;
+  m_changed = false;
+  m_hasPrevious = false;
+  m_previous = 0;
+}
+
+void CDVDDemuxIndex::Clear()
+{
+  m_hash.clear();
+  m_stream = -1;
+  m_codec = 0;
+  m_timeBaseNum = 0;
+  m_timeBaseDen = 0;
+  m_entries.clear();
+  m_changed = false;
+  m_hasPrevious = false;
+}
+
+bool CDVDDemuxIndex::Add(int64_t timestamp, int64_t pos)
+{
+  // keyframes mostly come in order, so this rarely has to insert
+  std::vector<Entry>::iterator it = m_entries.end();
+  if (!m_entries.empty() && m_entries.back().timestamp >= timestamp)
+    it = std::lower_bound(m_entries.begin(), m_entries.end(), timestamp, CompareTimestamp);
+
+  // the keyframe follows the one before it in the index only if that's the one read last
+  bool follows = m_hasPrevious && it != m_entries.begin() && (it - 1)->timestamp == m_previous;
+  m_hasPrevious = true;
+  m_previous = timestamp;
+
+  if (it != m_entries.end() && it->timestamp == timestamp)
+  {
+    if (it->pos == pos && (!follows || (it->flags & FLAG_FOLLOWS)))
+      return false;
+    it->pos = pos;
+    if (follows)
+      it->flags |= FLAG_FOLLOWS;
+  }
+  else
+  {
+    // the next entry doesn't follow its previous one any more
+    if (it != m_entries.end())
+      it->flags &= ~FLAG_FOLLOWS;
+
+    Entry entry;
+    entry.timestamp = timestamp;
+    entry.pos = pos;
+    entry.flags = follows ? FLAG_FOLLOWS : 0;
+    entry.reserved = 0;
+    m_entries.insert(it, entry);
+  }
+  m_changed = true;
+  return true;
+}
+
+bool CDVDDemuxIndex::Find(int64_t timestamp, bool backwards, int64_t& pos) const
+{
+  std::vector<Entry>::const_iterator next = std::lower_bound(m_entries.begin(), m_entries.end(), timestamp, CompareTimestamp);
+  if (next != m_entries.end() && next->timestamp == timestamp)
+  {
+    pos = next->pos;
+    return true;
+  }
+
+  // unless the keyframes around the timestamp were read one after the other, there might
+  // be others in between that haven't been indexed
+  if (next == m_entries.begin() || next == m_entries.end() || !(next->flags & FLAG_FOLLOWS))
+    return false;
+  std::vector<Entry>::const_iterator prev = next - 1;
+
+  pos = backwards ? prev->pos : next->pos;
+  return true;
+}
+
+bool CDVDDemuxIndex::Load(const std::string& filename)
+{
+  m_entries.clear();
+  m_changed = false;
+  m_hasPrevious = false;
+
+  XFILE::CFile file;
+  XFILE::auto_buffer buffer;
+  if (file.LoadFile(filename, buffer) < (ssize_t)sizeof(SeekIndexHeader))
+    return false;
+
+  SeekIndexHeader header;
+  memcpy(&header, buffer.get(), sizeof(header));
+  const char* pos = buffer.get() + sizeof(header);
+  const char* end = buffer.get() + buffer.size();
+  if (memcmp(header.magic, SeekIndexMagic, sizeof(header.magic)) != 0 ||
+      header.version != SEEK_INDEX_VERSION ||
+      (size_t)(end - pos) != header.hashLength + (size_t)header.entries * sizeof(Entry))
+    return false;
+
+  // the file changed or the demuxer sees it differently since the index was collected
+  if (header.stream != m_stream || header.codec != m_codec ||
+      header.timeBaseNum != m_timeBaseNum || header.timeBaseDen != m_timeBaseDen ||
+      m_hash.compare(0, std::string::npos, pos, header.hashLength) != 0)
+    return false;
+
+  Crc32 crc;
+  crc.Compute(pos, end - pos);
+  if ((uint32_t)crc != header.crc)
+  {
+    CLog::Log(LOGWARNING, "CDVDDemuxIndex::Load - ignoring damaged index %s", filename.c_str());
+    return false;
+  }
+  pos += header.hashLength;
+
+  m_entries.resize(header.entries);
+  if (header.entries)
+    memcpy(&m_entries[0], pos, header.entries * sizeof(Entry));
+  return true;
+}
+
+bool CDVDDemuxIndex::Save(const std::string& filename)
+{
+  std::string data(m_hash);
+  if (!m_entries.empty())
+    data.append((const char*)&m_entries[0], m_entries.size() * sizeof(Entry));
+
+  SeekIndexHeader header;
+  memcpy(header.magic, SeekIndexMagic, sizeof(header.magic));
+  header.version = SEEK_INDEX_VERSION;
+  header.stream = m_stream;
+  header.codec = m_codec;
+  header.timeBaseNum = m_timeBaseNum;
+  header.timeBaseDen = m_timeBaseDen;
+  header.hashLength = m_hash.size();
+  header.entries = m_entries.size();
+  Crc32 crc;
+  crc.Compute(data.c_str(), data.size());
+  header.crc = crc;
+
+  std::string folder = URIUtils::GetDirectory(filename);
+  if (!XFILE::CDirectory::Exists(folder))
+    XFILE::CDirectory::Create(folder);
+
+  // write to a temporary file first so that a player opening the file meanwhile doesn't
+  // see half an index
+  std::string tempFile = filename + ".tmp";
+  XFILE::CFile file;
+  if (!file.OpenForWrite(tempFile, true))
+    return false;
+  bool written = file.Write(&header, sizeof(header)) == sizeof(header) &&
+                 file.Write(data.c_str(), data.size()) == (ssize_t)data.size();
+  file.Close();
+
+  // not every platform renames over an existing file
+  if (written && XFILE::CFile::Exists(filename))
+    XFILE::CFile::Delete(filename);
+  if (!written || !XFILE::CFile::Rename(tempFile, filename))
+  {
+    XFILE::CFile::Delete(tempFile);
+    return false;
+  }
+  m_changed = false;
+  return true;
+}
+
+std::string CDVDDemuxIndex::GetCacheFile(const std::string& path)
+{
+  Crc32 crc;
+  crc.Compute(path);
+  return StringUtils::Format(SEEK_INDEX_FOLDER "%08x.idx", (uint32_t)crc);
+}
+
+std::string CDVDDemuxIndex::GetFileHash(const std::string& path)
+{
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(path, &st) != 0)
+    return "";
+
+  int64_t time = st.st_mtime;
+  if (!time)
+    time = st.st_ctime;
+  if (!time && !st.st_size)
+    return "";
+  return StringUtils::Format("d%" PRId64"s%" PRId64, time, (int64_t)st.st_size);
+}
+
+CDVDDemuxIndexJob::CDVDDemuxIndexJob(const std::string& cacheFile, const CDVDDemuxIndex& index)
+  : m_cacheFile(cacheFile),
+    m_index(index)
+{
+}
+
+bool CDVDDemuxIndexJob::operator==(const CJob* job) const
+{
+  if (strcmp(job->GetType(), GetType()) != 0)
+    return false;
+
+  const CDVDDemuxIndexJob* indexJob = static_cast<const CDVDDemuxIndexJob*>(job);
+  return indexJob->m_cacheFile == m_cacheFile;
+}
+
+bool CDVDDemuxIndexJob::DoWork()
+{
+  if (!m_index.Save(m_cacheFile))
+  {
+    CLog::Log(LOGDEBUG, "CDVDDemuxIndexJob::DoWork - unable to store index in %s", m_cacheFile.c_str());
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/Job.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Keyframes of the video stream of a file, by timestamp and byte position.
+
+ The index is collected by CDVDDemuxFFmpeg while it reads a file and cached in
+ the database folder, so that the next time the file is played a seek can go
+ straight to a keyframe instead of having the demuxer search for it.
+ */
+class CDVDDemuxIndex
+{
+public:
+  enum
+  {
+    FLAG_FOLLOWS = 1  // read right after the previous entry, there's no keyframe in between
+  };
+
+  struct Entry
+  {
+    int64_t timestamp; // in the time base of the stream
+    int64_t pos;
+    uint32_t flags;
+    uint32_t reserved; // keeps the cached entries free of padding
+  };
+
+  CDVDDemuxIndex();
+
+  void Clear();
+  bool IsEmpty() const { return m_entries.empty(); }
+  bool IsChanged() const { return m_changed; }
+  const std::vector<Entry>& GetEntries() const { return m_entries; }
+
+  /*!
+   \brief Add a keyframe to the index
+   \return true if the keyframe wasn't known yet
+   */
+  bool Add(int64_t timestamp, int64_t pos);
+
+  /*!
+   \brief Mark that the next keyframe added doesn't follow the last one, e.g. after a seek
+   */
+  void Break() { m_hasPrevious = false; }
+
+  /*!
+   \brief Find the keyframe to seek to for a timestamp
+   \param timestamp the timestamp to seek to, in the time base of the stream
+   \param backwards whether to look for the keyframe before or after the timestamp
+   \param pos the position of the keyframe
+   \return true if the index covers the timestamp, i.e. the keyframes around it were read
+            one after the other
+   */
+  bool Find(int64_t timestamp, bool backwards, int64_t& pos) const;
+
+  /*!
+   \brief Load the cached index of a file
+   Only succeeds if the cached index was collected from the same file and stream as set
+   in the public members.
+   */
+  bool Load(const std::string& filename);
+  bool Save(const std::string& filename);
+
+  static std::string GetCacheFile(const std::string& path);
+  static std::string GetFileHash(const std::string& path);
+
+  std::string m_hash;
+  int m_stream;
+  int m_codec;
+  int m_timeBaseNum;
+  int m_timeBaseDen;
+
+private:
+  std::vector<Entry> m_entries;
+  bool m_changed;
+  bool m_hasPrevious;
+  int64_t m_previous; // timestamp of the last keyframe added
+};
+
+/*!
+ \brief Stores the index collected during playback in the cache
+ */
+class CDVDDemuxIndexJob : public CJob
+{
+public:
+  CDVDDemuxIndexJob(const std::string& cacheFile, const CDVDDemuxIndex& index);
+
+  virtual const char* GetType() const { return "demuxindex"; }
+  virtual bool operator==(const CJob* job) const;
+  virtual bool DoWork();
+
+private:
+  std::string m_cacheFile;
+  CDVDDemuxIndex m_index;
+};
@@ -26,8 +26,212 @@
 #include "DVDCodecs/Overlay/DVDOverlaySSA.h"
 #include "cores/VideoRenderers/OverlayRendererUtil.h"
 
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 #define CLAMP(a, min, max) ((a) > (max) ? (max) : ( (a) < (min) ? (min) : a ))
 
+// number of pixels palette lookups and chroma coverage are staged in before blending them
+#define BLEND_CHUNK 256
+
+// exact x / 255 for 0 <= x <= 65534
+static inline unsigned int Div255(unsigned int x)
+{
+  return (x + 1 + (x >> 8)) >> 8;
+}
+
+#if defined(__SSE2__)
+static inline __m128i Div255(__m128i x)
+{
+  return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+#elif defined(__ARM_NEON__)
+static inline uint16x8_t Div255(uint16x8_t x)
+{
+  return vshrq_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+}
+#endif
+
+/* Blend a run of a single SPU color: dst = (color + dst * weight) >> 4, with
+ color already multiplied by its 4 bit alpha + 1 and weight being 15 - alpha. */
+static void BlendRun(uint8_t *dst, int count, uint16_t color, uint8_t weight)
+{
+  int i = 0;
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i c = _mm_set1_epi16(color);
+  const __m128i w = _mm_set1_epi16(weight);
+  for (; i + 16 <= count; i += 16)
+  {
+    __m128i d  = _mm_loadu_si128((const __m128i *)(dst + i));
+    __m128i lo = _mm_srli_epi16(_mm_add_epi16(c, _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), w)), 4);
+    __m128i hi = _mm_srli_epi16(_mm_add_epi16(c, _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), w)), 4);
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+  }
+#elif defined(__ARM_NEON__)
+  const uint16x8_t c = vdupq_n_u16(color);
+  const uint8x8_t  w = vdup_n_u8(weight);
+  for (; i + 16 <= count; i += 16)
+  {
+    uint8x16_t d  = vld1q_u8(dst + i);
+    uint16x8_t lo = vmlal_u8(c, vget_low_u8(d), w);
+    uint16x8_t hi = vmlal_u8(c, vget_high_u8(d), w);
+    vst1q_u8(dst + i, vcombine_u8(vshrn_n_u16(lo, 4), vshrn_n_u16(hi, 4)));
+  }
+#endif
+  for (; i < count; i++)
+    dst[i] = (color + dst[i] * weight) >> 4;
+}
+
+/* Blend a single color through an 8 bit coverage mask, additionally scaled by
+ opacity: k = mask * opacity / 255, dst = (k * color + (255 - k) * dst) / 255 */
+static void BlendMask(uint8_t *dst, const uint8_t *mask, int count, uint8_t opacity, uint8_t color)
+{
+  int i = 0;
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i o    = _mm_set1_epi16(opacity);
+  const __m128i c    = _mm_set1_epi16(color);
+  const __m128i full = _mm_set1_epi16(255);
+  for (; i + 16 <= count; i += 16)
+  {
+    __m128i m = _mm_loadu_si128((const __m128i *)(mask + i));
+    __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+    __m128i r[2];
+    for (int h = 0; h < 2; h++)
+    {
+      __m128i m16 = h ? _mm_unpackhi_epi8(m, zero) : _mm_unpacklo_epi8(m, zero);
+      __m128i d16 = h ? _mm_unpackhi_epi8(d, zero) : _mm_unpacklo_epi8(d, zero);
+      __m128i k   = Div255(_mm_mullo_epi16(m16, o));
+      r[h] = Div255(_mm_add_epi16(_mm_mullo_epi16(k, c), _mm_mullo_epi16(_mm_sub_epi16(full, k), d16)));
+    }
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(r[0], r[1]));
+  }
+#elif defined(__ARM_NEON__)
+  const uint8x8_t o    = vdup_n_u8(opacity);
+  const uint8x8_t c    = vdup_n_u8(color);
+  const uint8x8_t full = vdup_n_u8(255);
+  for (; i + 8 <= count; i += 8)
+  {
+    uint8x8_t k = vmovn_u16(Div255(vmull_u8(vld1_u8(mask + i), o)));
+    uint16x8_t x = vmlal_u8(vmull_u8(k, c), vsub_u8(full, k), vld1_u8(dst + i));
+    vst1_u8(dst + i, vmovn_u16(Div255(x)));
+  }
+#endif
+  for (; i < count; i++)
+  {
+    unsigned int k = Div255(mask[i] * opacity);
+    dst[i] = Div255(k * color + (255 - k) * dst[i]);
+  }
+}
+
+/* Blend per pixel colors with per pixel 8 bit alpha, both packed into one value
+ as color | alpha << 8: dst = (dst * (256 - s) + color * s) >> 8 with s = alpha + 1,
+ alpha 0 leaving dst untouched. */
+static void BlendAlpha(uint8_t *dst, const uint16_t *pixels, int count)
+{
+  int i = 0;
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i full = _mm_set1_epi16(256);
+  const __m128i low  = _mm_set1_epi16(0xff);
+  for (; i + 16 <= count; i += 16)
+  {
+    __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+    __m128i r[2];
+    for (int h = 0; h < 2; h++)
+    {
+      __m128i p   = _mm_loadu_si128((const __m128i *)(pixels + i + 8 * h));
+      __m128i c16 = _mm_and_si128(p, low);
+      __m128i a16 = _mm_srli_epi16(p, 8);
+      __m128i d16 = h ? _mm_unpackhi_epi8(d, zero) : _mm_unpacklo_epi8(d, zero);
+      // the compare yields -1 for non zero alpha, so this adds one to those
+      __m128i s = _mm_sub_epi16(a16, _mm_cmpgt_epi16(a16, zero));
+      r[h] = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(d16, _mm_sub_epi16(full, s)), _mm_mullo_epi16(c16, s)), 8);
+    }
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(r[0], r[1]));
+  }
+#elif defined(__ARM_NEON__)
+  const uint16x8_t full = vdupq_n_u16(256);
+  const uint8x8_t  one  = vdup_n_u8(1);
+  for (; i + 8 <= count; i += 8)
+  {
+    uint8x8x2_t p = vld2_u8((const uint8_t *)(pixels + i)); // little endian: color, alpha
+    uint16x8_t s = vaddl_u8(p.val[1], vmin_u8(p.val[1], one));
+    uint16x8_t x = vmulq_u16(vmovl_u8(vld1_u8(dst + i)), vsubq_u16(full, s));
+    x = vmlaq_u16(x, vmovl_u8(p.val[0]), s);
+    vst1_u8(dst + i, vshrn_n_u16(x, 8));
+  }
+#endif
+  for (; i < count; i++)
+  {
+    int alpha = pixels[i] >> 8;
+    if (alpha)
+    {
+      int s = alpha + 1;
+      dst[i] = (dst[i] * (256 - s) + (pixels[i] & 0xff) * s) >> 8;
+    }
+  }
+}
+
+/* Blend count palette indices, taken step bytes apart, onto dst. palette holds
+ color | alpha << 8 for every index. The lookups are staged a chunk at a time
+ and chunks without any visible pixel are skipped entirely. */
+static void BlendIndices(uint8_t *dst, const uint8_t *index, int count, int step, const uint16_t *palette)
+{
+  uint16_t pixels[BLEND_CHUNK];
+  for (int j = 0; j < count; j += BLEND_CHUNK)
+  {
+    int n = std::min(BLEND_CHUNK, count - j);
+    const uint8_t *in = index + j * step;
+    uint16_t visible = 0;
+    for (int k = 0; k < n; k++)
+    {
+      pixels[k] = palette[in[k * step]];
+      visible |= pixels[k];
+    }
+    if (visible >> 8)
+      BlendAlpha(dst + j, pixels, n);
+  }
+}
+
+/* Take every other byte of src, starting with the first, reading at most
+ 2 * count - 1 bytes. Used to pick the coverage of the chroma sited pixels. */
+static void EvenBytes(uint8_t *dst, const uint8_t *src, int count)
+{
+  int i = 0;
+#if defined(__SSE2__)
+  const __m128i low = _mm_set1_epi16(0xff);
+  for (; i + 16 < count; i += 16)
+  {
+    __m128i a = _mm_and_si128(_mm_loadu_si128((const __m128i *)(src + 2 * i)), low);
+    __m128i b = _mm_and_si128(_mm_loadu_si128((const __m128i *)(src + 2 * i + 16)), low);
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(a, b));
+  }
+#elif defined(__ARM_NEON__)
+  for (; i + 16 < count; i += 16)
+    vst1q_u8(dst + i, vld2q_u8(src + 2 * i).val[0]);
+#endif
+  for (; i < count; i++)
+    dst[i] = src[2 * i];
+}
+
+/* Clip the rectangle x, y, width, height to the picture. Returns false when
+ nothing of it is visible, otherwise the visible part is [x0, x1) x [y0, y1). */
+static bool ClipRect(const DVDPictureRenderer* pPicture, int x, int y, int width, int height,
+                     int &x0, int &y0, int &x1, int &y1)
+{
+  x0 = std::max(x, 0);
+  y0 = std::max(y, 0);
+  x1 = std::min(x + width, pPicture->width);
+  y1 = std::min(y + height, pPicture->height);
+  return x0 < x1 && y0 < y1;
+}
 
 void CDVDOverlayRenderer::Render(DVDPictureRenderer* pPicture, CDVDOverlay* pOverlay, double pts)
 {
@@ -77,127 +281,119 @@ void CDVDOverlayRenderer::Render(DVDPictureRenderer* pPicture, CDVDOverlaySSA* p
 
   while(img)
   {
-    unsigned int color = img->color;
-    uint8_t alpha = (uint8_t)(color &0xff);
-
     // fully transparent or width or height is 0 -> not displayed
-    if(alpha == 255 || img->w == 0 || img->h == 0)
+    if((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
     {
       img = img->next;
       continue;
     }
 
-    //ASS_Image colors are RGBA
-    double r = ((color >> 24) & 0xff) / 255.0;
-    double g = ((color >> 16) & 0xff) / 255.0;
-    double b = ((color >> 8 ) & 0xff) / 255.0;
-
-    uint8_t luma  = (uint8_t)(        255 * CLAMP( 0.299 * r + 0.587 * g + 0.114 * b,  0.0, 1.0));
-    uint8_t v     = (uint8_t)(127.5 + 255 * CLAMP( 0.500 * r - 0.419 * g - 0.081 * b, -0.5, 0.5));
-    uint8_t u     = (uint8_t)(127.5 + 255 * CLAMP(-0.169 * r - 0.331 * g + 0.500 * b, -0.5, 0.5));
-
     int y = std::max(0,std::min(img->dst_y, pPicture->height-img->h));
     int x = std::max(0,std::min(img->dst_x + depth, pPicture->width-img->w));
 
-    for(int i=0; i<img->h; i++)
-    {
-      if(y + i >= pPicture->height)
-        break;
+    RenderMask(pPicture, img->bitmap, img->stride, x, y, img->w, img->h, img->color);
+    img = img->next;
+  }
+}
+
+void CDVDOverlayRenderer::RenderMask(DVDPictureRenderer* pPicture, const uint8_t* mask, int stride,
+                                     int x, int y, int width, int height, uint32_t color)
+{
+  uint8_t alpha = (uint8_t)(color & 0xff);
+  if (alpha == 255)
+    return;
 
-      uint8_t* line = img->bitmap + img->stride*i;
+  int x0, y0, x1, y1;
+  if (!ClipRect(pPicture, x, y, width, height, x0, y0, x1, y1))
+    return;
 
-      uint8_t* target[3];
-      target[0] = pPicture->data[0] + pPicture->stride[0]*(i + y) + x;
-      target[1] = pPicture->data[1] + pPicture->stride[1]*((i + y)>>1) + (x>>1);
-      target[2] = pPicture->data[2] + pPicture->stride[2]*((i + y)>>1) + (x>>1);
+  //ASS_Image colors are RGBA
+  double r = ((color >> 24) & 0xff) / 255.0;
+  double g = ((color >> 16) & 0xff) / 255.0;
+  double b = ((color >> 8 ) & 0xff) / 255.0;
 
-      for(int j=0; j<img->w; j++)
-      {
-        if(x + j >= pPicture->width)
-          break;
+  uint8_t yuv[3];
+  yuv[0] = (uint8_t)(        255 * CLAMP( 0.299 * r + 0.587 * g + 0.114 * b,  0.0, 1.0));
+  yuv[1] = (uint8_t)(127.5 + 255 * CLAMP(-0.169 * r - 0.331 * g + 0.500 * b, -0.5, 0.5));
+  yuv[2] = (uint8_t)(127.5 + 255 * CLAMP( 0.500 * r - 0.419 * g - 0.081 * b, -0.5, 0.5));
 
-        unsigned char index, opacity, k;
-        index = line[j];
+  uint8_t opacity = 255 - alpha;
 
-        //Blend the image with the underlying picture
-        opacity = 255 - alpha;
-        k = (unsigned char)index * opacity / 255;
+  // chroma is blended once per 2x2 block, with the coverage of the top left pixel
+  int cx0 = (x0 + 1) >> 1;
+  int cx1 = (x1 + 1) >> 1;
+  uint8_t coverage[BLEND_CHUNK];
 
-        target[0][j]    = (k*luma + (255-k)*target[0][j])/255;
-        target[1][j>>1] = (k*u    + (255-k)*target[1][j>>1])/255;
-        target[2][j>>1] = (k*v    + (255-k)*target[2][j>>1])/255;
-      }
+  for (int i = y0; i < y1; i++)
+  {
+    const uint8_t* line = mask + stride * (i - y);
+
+    BlendMask(pPicture->data[0] + pPicture->stride[0] * i + x0, line + x0 - x, x1 - x0, opacity, yuv[0]);
+
+    if (i & 1)
+      continue;
+
+    for (int cx = cx0; cx < cx1; cx += BLEND_CHUNK)
+    {
+      int count = std::min(BLEND_CHUNK, cx1 - cx);
+      EvenBytes(coverage, line + 2 * cx - x, count);
+      for (int p = 1; p < 3; p++)
+        BlendMask(pPicture->data[p] + pPicture->stride[p] * (i >> 1) + cx, coverage, count, opacity, yuv[p]);
     }
-    img = img->next;
   }
 }
 
 void CDVDOverlayRenderer::Render(DVDPictureRenderer* pPicture, CDVDOverlayImage* pOverlay)
 {
-  uint8_t* palette[4];
-  for(int i=0;i<4;i++)
-    palette[i] = (uint8_t*)calloc(1, pOverlay->palette_colors);
+  // only palette based images can be rendered into yuv pictures
+  if (!pOverlay->palette)
+    return;
+
+  // every plane gets a table of color | alpha << 8, indices outside of the
+  // palette are left transparent
+  uint16_t palette[3][256];
+  memset(palette, 0, sizeof(palette));
 
-  for(int i=0;i<pOverlay->palette_colors;i++)
+  int colors = std::min(pOverlay->palette_colors, 256);
+  for(int i=0;i<colors;i++)
   {
     uint32_t color = pOverlay->palette[i];
 
-    palette[3][i] = (uint8_t)((color >> 24) & 0xff);
+    uint16_t alpha = (uint16_t)((color >> 16) & 0xff00);
 
     double r = ((color >> 16) & 0xff) / 255.0;
     double g = ((color >> 8 ) & 0xff) / 255.0;
     double b = ((color >> 0 ) & 0xff) / 255.0;
 
-    palette[0][i] = (uint8_t)(255 * CLAMP(0.299 * r + 0.587 * g + 0.114 * b, 0.0, 1.0));
-    palette[1][i] = (uint8_t)(127.5 + 255 * CLAMP( 0.500 * r - 0.419 * g - 0.081 * b, -0.5, 0.5));
-    palette[2][i] = (uint8_t)(127.5 + 255 * CLAMP(-0.169 * r - 0.331 * g + 0.500 * b, -0.5, 0.5));
+    palette[0][i] = alpha | (uint8_t)(255 * CLAMP(0.299 * r + 0.587 * g + 0.114 * b, 0.0, 1.0));
+    palette[1][i] = alpha | (uint8_t)(127.5 + 255 * CLAMP( 0.500 * r - 0.419 * g - 0.081 * b, -0.5, 0.5));
+    palette[2][i] = alpha | (uint8_t)(127.5 + 255 * CLAMP(-0.169 * r - 0.331 * g + 0.500 * b, -0.5, 0.5));
   }
 
   // we try o fit it in if it's outside the image
   int y = std::max(0,std::min(pOverlay->y, pPicture->height-pOverlay->height));
   int x = std::max(0,std::min(pOverlay->x, pPicture->width-pOverlay->width));
 
-  for(int i=0;i<pOverlay->height;i++)
-  {
-    if(y + i >= pPicture->height)
-      break;
+  int x0, y0, x1, y1;
+  if (!ClipRect(pPicture, x, y, pOverlay->width, pOverlay->height, x0, y0, x1, y1))
+    return;
 
-    uint8_t* line = pOverlay->data + pOverlay->linesize*i;
+  int cx0 = (x0 + 1) >> 1;
+  int cx1 = (x1 + 1) >> 1;
 
-    uint8_t* target[3];
-    target[0] = pPicture->data[0] + pPicture->stride[0]*(i + y) + x;
-    target[1] = pPicture->data[1] + pPicture->stride[1]*((i + y)>>1) + (x>>1);
-    target[2] = pPicture->data[2] + pPicture->stride[2]*((i + y)>>1) + (x>>1);
-
-    for(int j=0;j<pOverlay->width;j++)
-    {
-      if(x + j >= pPicture->width)
-        break;
-
-      unsigned char index = line[j];
-      if(index > pOverlay->palette_colors)
-      {
-        CLog::Log(LOGWARNING, "%s - out of range color index %u", __FUNCTION__, index);
-        continue;
-      }
-
-      if(palette[3][index] == 0)
-        continue;
+  for (int i = y0; i < y1; i++)
+  {
+    const uint8_t* line = pOverlay->data + pOverlay->linesize * (i - y);
 
-      int s_blend = palette[3][index] + 1;
-      int t_blend = 256 - s_blend;
+    BlendIndices(pPicture->data[0] + pPicture->stride[0] * i + x0, line + x0 - x, x1 - x0, 1, palette[0]);
 
-      target[0][j] = (target[0][j] * t_blend + palette[0][index] * s_blend) >> 8;
-      if(!(1&(i|j)))
-      {
-        target[1][j>>1] = (target[1][j>>1] * t_blend + palette[1][index] * s_blend) >> 8;
-        target[2][j>>1] = (target[2][j>>1] * t_blend + palette[2][index] * s_blend) >> 8;
-      }
-    }
+    // chroma is blended once per 2x2 block, with the top left pixel
+    if (i & 1)
+      continue;
 
+    for (int p = 1; p < 3; p++)
+      BlendIndices(pPicture->data[p] + pPicture->stride[p] * (i >> 1) + cx0, line + 2 * cx0 - x, cx1 - cx0, 2, palette[p]);
   }
-  for(int i=0;i<4;i++)
-    free(palette[i]);
 }
 
 // render the parsed sub (parsed rle) onto the yuv image
@@ -205,13 +401,11 @@ void CDVDOverlayRenderer::Render_SPU_YUV(DVDPictureRenderer* pPicture, CDVDOverl
 {
   CDVDOverlaySpu* pOverlay = (CDVDOverlaySpu*)pOverlaySpu;
 
-  unsigned __int8*  p_destptr = NULL;
   unsigned __int16* p_source = (unsigned __int16*)pOverlay->result;
-  unsigned __int8*  p_dest[3];
+  unsigned __int8*  p_dest[3] = { NULL, NULL, NULL };
 
   int i_x, i_y;
   int rp_len, i_color, pixels_to_draw;
-  unsigned __int16 i_colprecomp, i_destalpha;
 
   int btn_x_start = pOverlay->crop_i_x_start;
   int btn_x_end   = pOverlay->crop_i_x_end;
@@ -221,13 +415,18 @@ void CDVDOverlayRenderer::Render_SPU_YUV(DVDPictureRenderer* pPicture, CDVDOverl
   int *p_color;
   int p_alpha;
 
-  p_dest[0] = pPicture->data[0] + pPicture->stride[0] * pOverlay->y;
-  p_dest[1] = pPicture->data[1] + pPicture->stride[1] * (pOverlay->y >> 1);
-  p_dest[2] = pPicture->data[2] + pPicture->stride[2] * (pOverlay->y >> 1);
-
   /* Draw until we reach the bottom of the subtitle */
   for (i_y = pOverlay->y; i_y < pOverlay->y + pOverlay->height; i_y++)
   {
+    /* Lines outside of the picture are still parsed, but not drawn */
+    bool visible = i_y >= 0 && i_y < pPicture->height;
+    if (visible)
+    {
+      p_dest[0] = pPicture->data[0] + pPicture->stride[0] * i_y;
+      p_dest[1] = pPicture->data[1] + pPicture->stride[1] * (i_y >> 1);
+      p_dest[2] = pPicture->data[2] + pPicture->stride[2] * (i_y >> 1);
+    }
+
     /* Draw until we reach the end of the line */
     for (i_x = pOverlay->x; i_x < pOverlay->x + pOverlay->width ; i_x += rp_len)
     {
@@ -261,17 +460,23 @@ void CDVDOverlayRenderer::Render_SPU_YUV(DVDPictureRenderer* pPicture, CDVDOverl
             pixels_to_draw = rp_len;
         }
 
+        /* clip the run to the picture */
+        int x_start = std::max(i_x, 0);
+        int x_end   = std::min(i_x + pixels_to_draw, pPicture->width);
+        if (!visible || x_start >= x_end)
+          p_alpha = 0x00;
+
         switch (p_alpha)
         {
         case 0x00:
           break;
 
         case 0x0f:
-          memset(p_dest[0] + i_x, p_color[0], pixels_to_draw);
+          memset(p_dest[0] + x_start, p_color[0], x_end - x_start);
           if (!(i_y & 1)) // Only draw even lines
           {
-            memset(p_dest[1] + (i_x >> 1), p_color[2], pixels_to_draw >> 1);
-            memset(p_dest[2] + (i_x >> 1), p_color[1], pixels_to_draw >> 1);
+            memset(p_dest[1] + (x_start >> 1), p_color[2], (x_end - x_start) >> 1);
+            memset(p_dest[2] + (x_start >> 1), p_color[1], (x_end - x_start) >> 1);
           }
           break;
 
@@ -280,31 +485,14 @@ void CDVDOverlayRenderer::Render_SPU_YUV(DVDPictureRenderer* pPicture, CDVDOverl
             * This means Alpha 0 won't be completely transparent, but
             * that's handled in a special case above anyway. */
           // First we deal with Y
-          i_colprecomp = (unsigned __int16)p_color[0]
-                        * (unsigned __int16)(p_alpha + 1);
-          i_destalpha = 15 - p_alpha;
-
-          for (p_destptr = p_dest[0] + i_x; p_destptr < p_dest[0] + i_x + pixels_to_draw; p_destptr++)
-          {
-            *p_destptr = (( i_colprecomp + (unsigned __int16) * p_destptr * i_destalpha ) >> 4) & 0xFF;
-          }
+          BlendRun(p_dest[0] + x_start, x_end - x_start, p_color[0] * (p_alpha + 1), 15 - p_alpha);
 
           if (!(i_y & 1)) // Only draw even lines
           {
-            // now U
-            i_colprecomp = (unsigned __int16)p_color[2]
-                          * (unsigned __int16)(p_alpha + 1);
-            for ( p_destptr = p_dest[1] + (i_x >> 1); p_destptr < p_dest[1] + ((i_x + pixels_to_draw) >> 1); p_destptr++)
-            {
-              *p_destptr = (( i_colprecomp + (unsigned __int16) * p_destptr * i_destalpha ) >> 4) & 0xFF;
-            }
-            // and finally V
-            i_colprecomp = (unsigned __int16)p_color[1]
-                          * (unsigned __int16)(p_alpha + 1);
-            for ( p_destptr = p_dest[2] + (i_x >> 1); p_destptr < p_dest[2] + ((i_x + pixels_to_draw) >> 1); p_destptr++)
-            {
-              *p_destptr = (( i_colprecomp + (unsigned __int16) * p_destptr * i_destalpha ) >> 4) & 0xFF;
-            }
+            // now U and finally V
+            int count = (x_end >> 1) - (x_start >> 1);
+            BlendRun(p_dest[1] + (x_start >> 1), count, p_color[2] * (p_alpha + 1), 15 - p_alpha);
+            BlendRun(p_dest[2] + (x_start >> 1), count, p_color[1] * (p_alpha + 1), 15 - p_alpha);
           }
           break;
         }
@@ -314,11 +502,5 @@ void CDVDOverlayRenderer::Render_SPU_YUV(DVDPictureRenderer* pPicture, CDVDOverl
         i_x += pixels_to_draw;
       }
     }
-
-    p_dest[0] += pPicture->stride[0];
-    if (i_y & 1)
-      continue;
-    p_dest[1] += pPicture->stride[1];
-    p_dest[2] += pPicture->stride[2];
   }
 }
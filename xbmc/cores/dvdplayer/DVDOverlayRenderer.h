@@ -47,6 +47,12 @@ public:
   static void Render(DVDPictureRenderer* pPicture, CDVDOverlayImage* pOverlay);
   static void Render(DVDPictureRenderer* pPicture, CDVDOverlaySSA *pOverlay, double pts);
 
+  /*! \brief Blend a single color through an 8 bit coverage mask, such as a libass glyph bitmap.
+   \param color RGBA color, with an alpha of 0 being opaque as used by libass
+   */
+  static void RenderMask(DVDPictureRenderer* pPicture, const uint8_t* mask, int stride,
+                         int x, int y, int width, int height, uint32_t color);
+
 #ifdef HAS_VIDEO_PLAYBACK
   static void Render(YV12Image* pImage, CDVDOverlay* pOverlay, double pts)
   {
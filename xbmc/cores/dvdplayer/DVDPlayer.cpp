@@ -69,6 +69,7 @@
 #include "settings/MediaSettings.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/StreamDetails.h"
 #include "pvr/PVRManager.h"
 #include "pvr/channels/PVRChannel.h"
@@ -916,6 +917,7 @@ void CDVDPlayer::OpenDefaultStreams(bool reset)
 
 bool CDVDPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
 {
+  TRACE_SCOPE("CDVDPlayer::ReadPacket");
 
   // check if we should read from subtitle demuxer
   if( m_pSubtitleDemuxer && m_dvdPlayerSubtitle->AcceptsData() )
@@ -1510,6 +1512,7 @@ bool CDVDPlayer::CheckIsCurrent(CCurrentStream& current, CDemuxStream* stream, D
 
 void CDVDPlayer::ProcessPacket(CDemuxStream* pStream, DemuxPacket* pPacket)
 {
+  TRACE_SCOPE("CDVDPlayer::ProcessPacket");
     /* process packet if it belongs to selected stream. for dvd's don't allow automatic opening of streams*/
 
       if (CheckIsCurrent(m_CurrentAudio, pStream, pPacket))
@@ -27,11 +27,13 @@
 #include "settings/Settings.h"
 #include "video/VideoReferenceClock.h"
 #include "utils/log.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/TimeUtils.h"
 #include "utils/MathUtils.h"
 #include "cores/AudioEngine/AEFactory.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/DataCacheCore.h"
+#include "cores/VideoRenderers/VideoTelemetry.h"
 
 #include <sstream>
 #include <iomanip>
@@ -246,6 +248,7 @@ void CDVDPlayerAudio::CloseStream(bool bWaitForBuffers)
 // decode one audio frame and returns its uncompressed size
 int CDVDPlayerAudio::DecodeFrame(DVDAudioFrame &audioframe)
 {
+  TRACE_SCOPE("CDVDPlayerAudio::DecodeFrame");
   int result = 0;
 
   // make sure the sent frame is clean
@@ -647,6 +650,7 @@ void CDVDPlayerAudio::HandleSyncError(double duration)
   double error = m_dvdAudio.GetPlayingPts() - clock;
 
   m_errors.Add(error);
+  g_videoTelemetry.SetAudioDrift(error / DVD_TIME_BASE);
 
   if (fabs(error) > DVD_MSEC_TO_TIME(100))
   {
@@ -711,6 +715,7 @@ void CDVDPlayerAudio::HandleSyncError(double duration)
 
 bool CDVDPlayerAudio::OutputPacket(DVDAudioFrame &audioframe)
 {
+  TRACE_SCOPE("CDVDPlayerAudio::OutputPacket");
   if (m_syncclock)
   {
     double absolute;
@@ -20,6 +20,7 @@
 
 #include "system.h"
 #include "cores/VideoRenderers/RenderFlags.h"
+#include "cores/VideoRenderers/VideoTelemetry.h"
 #include "windowing/WindowingFactory.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/MediaSettings.h"
@@ -44,6 +45,8 @@
 #include <iterator>
 #include "guilib/GraphicContext.h"
 #include "utils/log.h"
+#include "utils/PerformanceTrace.h"
+#include "utils/TimeUtils.h"
 
 using namespace std;
 using namespace RenderManager;
@@ -147,6 +150,7 @@ CDVDPlayerVideo::CDVDPlayerVideo( CDVDClock* pClock
   m_messageQueue.SetMaxTimeSize(8.0);
 
   m_iDroppedFrames = 0;
+  m_decodeTicks = 0;
   m_fFrameRate = 25;
   m_bCalcFrameRate = false;
   m_fStableFrameRate = 0.0;
@@ -290,6 +294,7 @@ void CDVDPlayerVideo::CloseStream(bool bWaitForBuffers)
 void CDVDPlayerVideo::OnStartup()
 {
   m_iDroppedFrames = 0;
+  m_decodeTicks = 0;
 
   m_crop.x1 = m_crop.x2 = 0.0f;
   m_crop.y1 = m_crop.y2 = 0.0f;
@@ -464,6 +469,8 @@ void CDVDPlayerVideo::Process()
       if (m_pVideoCodec)
         m_pVideoCodec->SetSpeed(m_speed);
       m_droppingStats.Reset();
+      // frames on screen while paused aren't duplicates
+      g_videoTelemetry.Discontinuity();
     }
     else if (pMsg->IsType(CDVDMsg::PLAYER_STARTED))
     {
@@ -529,6 +536,7 @@ void CDVDPlayerVideo::Process()
       {
         m_iDroppedFrames++;
         iDropped++;
+        g_videoTelemetry.AddFrame(pts / DVD_TIME_BASE, frametime / DVD_TIME_BASE, TakeDecodeTime(), 0.0, true);
       }
 
       if (m_messageQueue.GetDataSize() == 0
@@ -571,7 +579,13 @@ void CDVDPlayerVideo::Process()
 
       mFilters = m_pVideoCodec->SetFilters(mFilters);
 
-      int iDecoderState = m_pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+      int iDecoderState;
+      {
+        TRACE_SCOPE("CDVDVideoCodec::Decode");
+        int64_t start = CurrentHostCounter();
+        iDecoderState = m_pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+        m_decodeTicks += CurrentHostCounter() - start;
+      }
 
       // buffer packets so we can recover should decoder flush for some reason
       if(m_pVideoCodec->GetConvergeCount() > 0)
@@ -702,6 +716,8 @@ void CDVDPlayerVideo::Process()
               picture.iDuration *= picture.iRepeatPicture + 1;
 
             int iResult = OutputPicture(&picture, pts);
+            if ((iResult & EOS_DROPPED) && !bPacketDrop)
+              g_videoTelemetry.AddFrame(picture.pts / DVD_TIME_BASE, picture.iDuration / DVD_TIME_BASE, TakeDecodeTime(), 0.0, true);
 
             frametime = (double)DVD_TIME_BASE/m_fFrameRate;
 
@@ -750,7 +766,9 @@ void CDVDPlayerVideo::Process()
         CalcDropRequirement(pts, true);
 
         // the decoder didn't need more data, flush the remaning buffer
+        int64_t start = CurrentHostCounter();
         iDecoderState = m_pVideoCodec->Decode(NULL, 0, DVD_NOPTS_VALUE, DVD_NOPTS_VALUE);
+        m_decodeTicks += CurrentHostCounter() - start;
       }
     }
 
@@ -873,6 +891,7 @@ void CDVDPlayerVideo::ProcessOverlays(DVDVideoPicture* pSource, double pts)
       CDVDCodecUtils::CopyPicture(m_pTempOverlayPicture, pSource);
       memcpy(pSource->data     , m_pTempOverlayPicture->data     , sizeof(pSource->data));
       memcpy(pSource->iLineSize, m_pTempOverlayPicture->iLineSize, sizeof(pSource->iLineSize));
+      pSource->videoBuffer = NULL; // the planes no longer belong to the decoder
     }
   }
 
@@ -969,6 +988,7 @@ std::string CDVDPlayerVideo::GetStereoMode()
 
 int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
 {
+  TRACE_SCOPE("CDVDPlayerVideo::OutputPicture");
   /* picture buffer is not allowed to be modified in this call */
   DVDVideoPicture picture(*src);
   DVDVideoPicture* pPicture = &picture;
@@ -1163,7 +1183,9 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
       mDisplayField = FS_BOT;
   }
 
+  int64_t start = CurrentHostCounter();
   int buffer = g_renderManager.WaitForBuffer(m_bStop, std::max(DVD_TIME_TO_MSEC(iSleepTime) + 500, 50));
+  double queueWait = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
   if (buffer < 0)
   {
     m_droppingStats.AddOutputDropGain(pts, 1/m_fFrameRate);
@@ -1188,7 +1210,8 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
     return EOS_DROPPED;
   }
 
-  g_renderManager.FlipPage(CThread::m_bStop, (iCurrentClock + iSleepTime) / DVD_TIME_BASE, pts, -1, mDisplayField);
+  int telemetry = g_videoTelemetry.AddFrame(pPicture->pts / DVD_TIME_BASE, pPicture->iDuration / DVD_TIME_BASE, TakeDecodeTime(), queueWait);
+  g_renderManager.FlipPage(CThread::m_bStop, (iCurrentClock + iSleepTime) / DVD_TIME_BASE, pts, -1, mDisplayField, telemetry);
 
   return result;
 #else
@@ -1197,6 +1220,13 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
 #endif
 }
 
+double CDVDPlayerVideo::TakeDecodeTime()
+{
+  double decodeTime = (double)m_decodeTicks / CurrentHostFrequency();
+  m_decodeTicks = 0;
+  return decodeTime;
+}
+
 std::string CDVDPlayerVideo::GetPlayerInfo()
 {
   std::ostringstream s;
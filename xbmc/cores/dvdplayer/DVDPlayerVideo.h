@@ -128,6 +128,7 @@ protected:
   CRect m_crop;
 
   int OutputPicture(const DVDVideoPicture* src, double pts);
+  double TakeDecodeTime();
 #ifdef HAS_VIDEO_PLAYBACK
   void ProcessOverlays(DVDVideoPicture* pSource, double pts);
 #endif
@@ -144,6 +145,7 @@ protected:
   int m_iLateFrames;
   int m_iDroppedFrames;
   int m_iDroppedRequest;
+  int64_t m_decodeTicks;  // spent decoding since the last picture was output
 
   void   ResetFrameRateCalc();
   void   CalcFrameRate();
@@ -0,0 +1,500 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDClock.h"
+#include "DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "DVDDemuxers/DVDDemuxIndex.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDInputStreams/DVDInputStreamFile.h"
+#include "filesystem/File.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string.h>
+
+#define TEST_FPS        25
+#define TEST_GOP        12
+#define TEST_SECONDS    300
+#define TEST_STUFFING   2048  // bytes per frame, so that the file has the size of a real one
+#define TEST_FILE       "special://temp/DVDDemuxIndex.ts"
+
+#define BENCHMARK_SEEKS 50
+
+#define TS_PACKET_SIZE  188
+#define TS_PID_PMT      0x1000
+#define TS_PID_VIDEO    0x100
+
+/* writes the bits of an mpeg-1 video elementary stream */
+class CBitWriter
+{
+public:
+  CBitWriter() : m_value(0), m_bits(0) {}
+
+  void Put(uint32_t value, int bits)
+  {
+    for (int i = bits - 1; i >= 0; i--)
+    {
+      m_value = (m_value << 1) | ((value >> i) & 1);
+      if (++m_bits == 8)
+      {
+        m_data.push_back((char)m_value);
+        m_value = 0;
+        m_bits = 0;
+      }
+    }
+  }
+
+  void Align()
+  {
+    while (m_bits)
+      Put(0, 1);
+  }
+
+  void StartCode(uint8_t code)
+  {
+    Align();
+    Put(0x000001, 24);
+    Put(code, 8);
+  }
+
+  std::string m_data;
+
+private:
+  uint32_t m_value;
+  int m_bits;
+};
+
+/* an mpegts file with a 16x16 mpeg-1 video stream, an I frame starts every gop */
+class CTestStream
+{
+public:
+  static std::string Create()
+  {
+    if (XFILE::CFile::Exists(TEST_FILE))
+      return TEST_FILE;
+
+    CTestStream stream;
+    for (int frame = 0; frame < TEST_SECONDS * TEST_FPS; frame++)
+      stream.WriteFrame(frame);
+
+    XFILE::CFile file;
+    if (!file.OpenForWrite(TEST_FILE, true) ||
+        file.Write(stream.m_data.c_str(), stream.m_data.size()) != (ssize_t)stream.m_data.size())
+      return "";
+    return TEST_FILE;
+  }
+
+  // the time of the keyframe that has to be shown for a time in ms
+  static int KeyframeTime(int time)
+  {
+    int frame = time * TEST_FPS / 1000;
+    return (frame - frame % TEST_GOP) * 1000 / TEST_FPS;
+  }
+
+private:
+  CTestStream()
+  {
+    memset(m_counter, 0, sizeof(m_counter));
+  }
+
+  void WriteFrame(int frame)
+  {
+    bool keyframe = frame % TEST_GOP == 0;
+    if (keyframe)
+    {
+      WriteSection(0, Pat());
+      WriteSection(TS_PID_PMT, Pmt());
+    }
+
+    // pts start at one second, pcr runs half a second ahead of them
+    int64_t pts = 90000 + (int64_t)frame * 90000 / TEST_FPS;
+    std::string pes("\x00\x00\x01\xe0\x00\x00\x84\x80\x05", 9);
+    pes.push_back((char)(0x21 | ((pts >> 29) & 0x0e)));
+    pes.push_back((char)(pts >> 22));
+    pes.push_back((char)(0x01 | ((pts >> 14) & 0xfe)));
+    pes.push_back((char)(pts >> 7));
+    pes.push_back((char)(0x01 | ((pts << 1) & 0xfe)));
+    pes.append(Picture(frame, keyframe));
+
+    WritePes(pes, pts - 45000, keyframe);
+  }
+
+  static std::string Picture(int frame, bool keyframe)
+  {
+    CBitWriter bits;
+    if (keyframe)
+    {
+      bits.StartCode(0xb3);   // sequence header
+      bits.Put(16, 12);       // width
+      bits.Put(16, 12);       // height
+      bits.Put(1, 4);         // square pixels
+      bits.Put(3, 4);         // 25 fps
+      bits.Put(0x3ffff, 18);  // variable bit rate
+      bits.Put(1, 1);
+      bits.Put(20, 10);       // vbv buffer size
+      bits.Put(0, 3);         // no constrained parameters or quantiser matrices
+
+      int seconds = frame / TEST_FPS;
+      bits.StartCode(0xb8);   // gop header
+      bits.Put(0, 1);
+      bits.Put(seconds / 3600, 5);
+      bits.Put(seconds / 60 % 60, 6);
+      bits.Put(1, 1);
+      bits.Put(seconds % 60, 6);
+      bits.Put(frame % TEST_FPS, 6);
+      bits.Put(1, 1);         // closed gop
+      bits.Put(0, 1);
+    }
+
+    bits.StartCode(0x00);     // picture header
+    bits.Put(frame % TEST_GOP, 10);
+    bits.Put(keyframe ? 1 : 2, 3);
+    bits.Put(0xffff, 16);
+    if (!keyframe)
+    {
+      bits.Put(0, 1);         // half pel forward vectors
+      bits.Put(1, 3);         // forward f code
+    }
+    bits.Put(0, 1);
+
+    bits.StartCode(0x01);     // slice of the only macroblock
+    bits.Put(8, 5);           // quantiser scale
+    bits.Put(0, 1);
+    bits.Put(1, 1);           // address increment
+    if (keyframe)
+    {
+      bits.Put(1, 1);         // intra
+      for (int block = 0; block < 6; block++)
+      {
+        if (block < 4)
+          bits.Put(4, 3);     // luma dc size 0
+        else
+          bits.Put(0, 2);     // chroma dc size 0
+        bits.Put(2, 2);       // end of block
+      }
+    }
+    else
+    {
+      bits.Put(1, 3);         // forward motion, not coded
+      bits.Put(1, 1);         // no horizontal motion
+      bits.Put(1, 1);         // no vertical motion
+    }
+    bits.Align();
+
+    // zero bytes are allowed in front of every start code
+    return bits.m_data + std::string(TEST_STUFFING, '\0');
+  }
+
+  static std::string Pat()
+  {
+    return std::string("\x00\xb0\x0d\x00\x01\xc1\x00\x00\x00\x01\xf0\x00", 12);
+  }
+
+  static std::string Pmt()
+  {
+    return std::string("\x02\xb0\x12\x00\x01\xc1\x00\x00\xe1\x00\xf0\x00\x01\xe1\x00\xf0\x00", 17);
+  }
+
+  static uint32_t Crc(const std::string& data)
+  {
+    uint32_t crc = 0xffffffff;
+    for (size_t i = 0; i < data.size(); i++)
+    {
+      crc ^= (uint32_t)(uint8_t)data[i] << 24;
+      for (int bit = 0; bit < 8; bit++)
+        crc = crc & 0x80000000 ? (crc << 1) ^ 0x04c11db7 : crc << 1;
+    }
+    return crc;
+  }
+
+  void WriteSection(int pid, const std::string& section)
+  {
+    uint32_t crc = Crc(section);
+    std::string payload(1, '\0');
+    payload.append(section);
+    for (int i = 24; i >= 0; i -= 8)
+      payload.push_back((char)(crc >> i));
+    payload.resize(TS_PACKET_SIZE - 4, '\xff');
+    WritePacket(pid, true, false, "", payload);
+  }
+
+  void WritePes(const std::string& pes, int64_t pcr, bool keyframe)
+  {
+    for (size_t pos = 0; pos < pes.size();)
+    {
+      bool hasAdaptation = pos == 0;
+      std::string adaptation;
+      if (pos == 0)
+      {
+        adaptation.push_back(keyframe ? 0x50 : 0x10); // random access, pcr
+        adaptation.push_back((char)(pcr >> 25));
+        adaptation.push_back((char)(pcr >> 17));
+        adaptation.push_back((char)(pcr >> 9));
+        adaptation.push_back((char)(pcr >> 1));
+        adaptation.push_back((char)(((pcr << 7) & 0x80) | 0x7e));
+        adaptation.push_back(0);
+      }
+
+      size_t room = TS_PACKET_SIZE - 4 - (hasAdaptation ? adaptation.size() + 1 : 0);
+      size_t size = std::min(room, pes.size() - pos);
+      if (size < room)
+      {
+        // stuff the last packet of the pes
+        if (!hasAdaptation)
+        {
+          hasAdaptation = true;
+          room--;
+          if (size < room)
+          {
+            adaptation.push_back(0);
+            room--;
+          }
+        }
+        adaptation.append(room - size, '\xff');
+      }
+      WritePacket(TS_PID_VIDEO, pos == 0, hasAdaptation, adaptation, pes.substr(pos, size));
+      pos += size;
+    }
+  }
+
+  void WritePacket(int pid, bool start, bool hasAdaptation, const std::string& adaptation, const std::string& payload)
+  {
+    m_data.push_back(0x47);
+    m_data.push_back((char)((start ? 0x40 : 0) | (pid >> 8)));
+    m_data.push_back((char)pid);
+    m_data.push_back((char)((hasAdaptation ? 0x30 : 0x10) | (m_counter[pid] & 0x0f)));
+    if (hasAdaptation)
+    {
+      m_data.push_back((char)adaptation.size());
+      m_data.append(adaptation);
+    }
+    m_data.append(payload);
+    m_counter[pid]++;
+  }
+
+  std::string m_data;
+  uint8_t m_counter[0x2000];
+};
+
+/* counts the seeks the demuxer does on the file, over a network share each one is a round trip */
+class CCountingInputStream : public CDVDInputStreamFile
+{
+public:
+  CCountingInputStream() : m_seeks(0) {}
+
+  virtual int64_t Seek(int64_t offset, int whence)
+  {
+    if (whence != SEEK_POSSIBLE)
+      m_seeks++;
+    return CDVDInputStreamFile::Seek(offset, whence);
+  }
+
+  int m_seeks;
+};
+
+class CTestDemuxer : public CDVDDemuxFFmpeg
+{
+public:
+  ~CTestDemuxer()
+  {
+    // don't leave the index for the next test
+    DisableIndex();
+  }
+
+  void DisableIndex()
+  {
+    m_index.Clear();
+    m_indexStream = -1;
+  }
+
+  // reading the file once indexes all keyframes
+  void ReadAll()
+  {
+    DemuxPacket* packet;
+    while ((packet = Read()))
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+
+  // seek and return the time of the first video packet, in ms
+  int Seek(int time)
+  {
+    if (!SeekTime(time, true))
+      return -1;
+
+    for (int i = 0; i < 1000; i++)
+    {
+      DemuxPacket* packet = Read();
+      if (!packet)
+        return -1;
+      double pts = packet->pts;
+      int size = packet->iSize;
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+      if (size > 0 && pts != DVD_NOPTS_VALUE)
+        return DVD_TIME_TO_MSEC(pts);
+    }
+    return -1;
+  }
+};
+
+static int SeekTarget(int seek)
+{
+  return (seek * 7919 % (TEST_SECONDS - 10) + 5) * 1000 + seek * 37 % 1000;
+}
+
+TEST(TestDVDDemuxIndex, Find)
+{
+  CDVDDemuxIndex index;
+  EXPECT_TRUE(index.Add(1000, 100));
+  EXPECT_TRUE(index.Add(2000, 200));
+  EXPECT_TRUE(index.Add(3000, 300));
+  EXPECT_FALSE(index.Add(3000, 300));
+  // seeking forwards and back again
+  index.Break();
+  EXPECT_TRUE(index.Add(9000, 900));
+  EXPECT_TRUE(index.Add(10000, 1000));
+  index.Break();
+  EXPECT_TRUE(index.Add(500, 50));
+  ASSERT_EQ(6U, index.GetEntries().size());
+  EXPECT_EQ(500, index.GetEntries()[0].timestamp);
+  EXPECT_EQ(900, index.GetEntries()[4].pos);
+
+  int64_t pos = -1;
+  EXPECT_TRUE(index.Find(2000, true, pos));
+  EXPECT_EQ(200, pos);
+  EXPECT_TRUE(index.Find(2500, true, pos));
+  EXPECT_EQ(200, pos);
+  EXPECT_TRUE(index.Find(2500, false, pos));
+  EXPECT_EQ(300, pos);
+  EXPECT_TRUE(index.Find(9500, true, pos));
+  EXPECT_EQ(900, pos);
+
+  // nothing is known about the keyframes around these
+  EXPECT_FALSE(index.Find(100, true, pos));
+  EXPECT_FALSE(index.Find(750, true, pos));
+  EXPECT_FALSE(index.Find(5000, true, pos));
+  EXPECT_FALSE(index.Find(11000, true, pos));
+
+  // until reading on closes the gap
+  EXPECT_TRUE(index.Add(1000, 100));
+  EXPECT_TRUE(index.Find(750, true, pos));
+  EXPECT_EQ(50, pos);
+}
+
+TEST(TestDVDDemuxIndex, SaveLoad)
+{
+  std::string cacheFile = "special://temp/DVDDemuxIndex.idx";
+  CDVDDemuxIndex index;
+  index.m_hash = "d1s2";
+  index.m_stream = 1;
+  index.m_codec = 2;
+  index.m_timeBaseNum = 1;
+  index.m_timeBaseDen = 90000;
+  for (int i = 0; i < 1000; i++)
+    index.Add(i * 43200, i * 100000);
+  ASSERT_TRUE(index.Save(cacheFile));
+  EXPECT_FALSE(index.IsChanged());
+
+  CDVDDemuxIndex cached(index);
+  ASSERT_TRUE(cached.Load(cacheFile));
+  ASSERT_EQ(1000U, cached.GetEntries().size());
+  EXPECT_EQ(index.GetEntries()[999].timestamp, cached.GetEntries()[999].timestamp);
+  EXPECT_EQ(index.GetEntries()[999].pos, cached.GetEntries()[999].pos);
+  EXPECT_EQ(index.GetEntries()[999].flags, cached.GetEntries()[999].flags);
+
+  // the file changed since
+  cached.m_hash = "d1s3";
+  EXPECT_FALSE(cached.Load(cacheFile));
+  EXPECT_TRUE(cached.IsEmpty());
+  cached.m_hash = index.m_hash;
+  cached.m_timeBaseDen = 1000;
+  EXPECT_FALSE(cached.Load(cacheFile));
+
+  XFILE::CFile::Delete(cacheFile);
+}
+
+TEST(TestDVDDemuxIndex, SeekTime)
+{
+  std::string file = CTestStream::Create();
+  ASSERT_FALSE(file.empty());
+
+  CDVDInputStreamFile input;
+  ASSERT_TRUE(input.Open(file.c_str(), ""));
+  CTestDemuxer demuxer;
+  ASSERT_TRUE(demuxer.Open(&input));
+  ASSERT_TRUE(demuxer.HasIndex());
+  demuxer.ReadAll();
+
+  for (int seek = 0; seek < 10; seek++)
+  {
+    int time = SeekTarget(seek);
+    EXPECT_EQ(CTestStream::KeyframeTime(time), demuxer.Seek(time)) << "seeking to " << time;
+  }
+}
+
+// 50 seeks with and without the index, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestDVDDemuxIndex.*
+TEST(TestDVDDemuxIndex, DISABLED_Benchmark)
+{
+  std::string file = CTestStream::Create();
+  ASSERT_FALSE(file.empty());
+  double frequency = (double)CurrentHostFrequency();
+
+  int64_t searching = 0;
+  int searchingSeeks = 0;
+  {
+    CCountingInputStream input;
+    ASSERT_TRUE(input.Open(file.c_str(), ""));
+    CTestDemuxer demuxer;
+    ASSERT_TRUE(demuxer.Open(&input));
+    demuxer.DisableIndex();
+
+    input.m_seeks = 0;
+    int64_t start = CurrentHostCounter();
+    for (int seek = 0; seek < BENCHMARK_SEEKS; seek++)
+      EXPECT_LE(0, demuxer.Seek(SeekTarget(seek)));
+    searching = CurrentHostCounter() - start;
+    searchingSeeks = input.m_seeks;
+  }
+
+  int64_t indexed = 0;
+  int indexedSeeks = 0;
+  {
+    CCountingInputStream input;
+    ASSERT_TRUE(input.Open(file.c_str(), ""));
+    CTestDemuxer demuxer;
+    ASSERT_TRUE(demuxer.Open(&input));
+    demuxer.ReadAll();
+
+    input.m_seeks = 0;
+    int64_t start = CurrentHostCounter();
+    for (int seek = 0; seek < BENCHMARK_SEEKS; seek++)
+      EXPECT_LE(0, demuxer.Seek(SeekTarget(seek)));
+    indexed = CurrentHostCounter() - start;
+    indexedSeeks = input.m_seeks;
+  }
+
+  std::cout << "DVDDemuxIndex: seeking takes " << searching * 1000.0 / frequency / BENCHMARK_SEEKS
+            << " ms and " << (double)searchingSeeks / BENCHMARK_SEEKS << " seeks in the file without index, "
+            << indexed * 1000.0 / frequency / BENCHMARK_SEEKS << " ms and "
+            << (double)indexedSeeks / BENCHMARK_SEEKS << " seeks with the index" << std::endl;
+}
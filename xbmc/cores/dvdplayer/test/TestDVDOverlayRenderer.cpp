@@ -0,0 +1,388 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDOverlayRenderer.h"
+#include "DVDCodecs/Overlay/DVDOverlayImage.h"
+#include "DVDCodecs/Overlay/DVDOverlaySpu.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define CLAMP(a, min, max) ((a) > (max) ? (max) : ( (a) < (min) ? (min) : a ))
+
+#define BENCHMARK_ITERATIONS 50
+
+// a 4:2:0 planar picture filled with a gradient
+class CTestPicture
+{
+public:
+  CTestPicture(int width, int height)
+  {
+    for (int p = 0; p < 3; p++)
+    {
+      int w = p ? (width + 1) / 2 : width;
+      int h = p ? (height + 1) / 2 : height;
+      m_planes[p].resize(w * h);
+      for (int i = 0; i < w * h; i++)
+        m_planes[p][i] = (uint8_t)(i * (p + 3) + p * 40);
+      picture.data[p] = &m_planes[p][0];
+      picture.stride[p] = w;
+    }
+    picture.data[3] = NULL;
+    picture.stride[3] = 0;
+    picture.width = width;
+    picture.height = height;
+  }
+
+  bool operator==(const CTestPicture &other) const
+  {
+    for (int p = 0; p < 3; p++)
+    {
+      if (m_planes[p] != other.m_planes[p])
+        return false;
+    }
+    return true;
+  }
+
+  DVDPictureRenderer picture;
+
+private:
+  std::vector<uint8_t> m_planes[3];
+};
+
+static double ElapsedMs(int64_t start)
+{
+  return (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency();
+}
+
+// per pixel blending of palette images, for images at even offsets inside the picture
+static void ReferenceImage(DVDPictureRenderer* pPicture, CDVDOverlayImage* pOverlay)
+{
+  uint8_t palette[4][256];
+  for (int i = 0; i < pOverlay->palette_colors; i++)
+  {
+    uint32_t color = pOverlay->palette[i];
+    palette[3][i] = (uint8_t)((color >> 24) & 0xff);
+
+    double r = ((color >> 16) & 0xff) / 255.0;
+    double g = ((color >> 8 ) & 0xff) / 255.0;
+    double b = ((color >> 0 ) & 0xff) / 255.0;
+
+    palette[0][i] = (uint8_t)(255 * CLAMP(0.299 * r + 0.587 * g + 0.114 * b, 0.0, 1.0));
+    palette[1][i] = (uint8_t)(127.5 + 255 * CLAMP( 0.500 * r - 0.419 * g - 0.081 * b, -0.5, 0.5));
+    palette[2][i] = (uint8_t)(127.5 + 255 * CLAMP(-0.169 * r - 0.331 * g + 0.500 * b, -0.5, 0.5));
+  }
+
+  int x = pOverlay->x, y = pOverlay->y;
+  for (int i = 0; i < pOverlay->height; i++)
+  {
+    uint8_t* line = pOverlay->data + pOverlay->linesize * i;
+    uint8_t* target[3];
+    target[0] = pPicture->data[0] + pPicture->stride[0] * (i + y) + x;
+    target[1] = pPicture->data[1] + pPicture->stride[1] * ((i + y) >> 1) + (x >> 1);
+    target[2] = pPicture->data[2] + pPicture->stride[2] * ((i + y) >> 1) + (x >> 1);
+
+    for (int j = 0; j < pOverlay->width; j++)
+    {
+      unsigned char index = line[j];
+      if (palette[3][index] == 0)
+        continue;
+
+      int s_blend = palette[3][index] + 1;
+      int t_blend = 256 - s_blend;
+
+      target[0][j] = (target[0][j] * t_blend + palette[0][index] * s_blend) >> 8;
+      if (!(1 & (i | j)))
+      {
+        target[1][j >> 1] = (target[1][j >> 1] * t_blend + palette[1][index] * s_blend) >> 8;
+        target[2][j >> 1] = (target[2][j >> 1] * t_blend + palette[2][index] * s_blend) >> 8;
+      }
+    }
+  }
+}
+
+// per pixel blending of a coverage mask, chroma taken from the top left pixel of each 2x2 block
+static void ReferenceMask(DVDPictureRenderer* pPicture, const uint8_t* mask, int stride,
+                          int x, int y, int width, int height, uint32_t color)
+{
+  double r = ((color >> 24) & 0xff) / 255.0;
+  double g = ((color >> 16) & 0xff) / 255.0;
+  double b = ((color >> 8 ) & 0xff) / 255.0;
+
+  uint8_t yuv[3];
+  yuv[0] = (uint8_t)(        255 * CLAMP( 0.299 * r + 0.587 * g + 0.114 * b,  0.0, 1.0));
+  yuv[1] = (uint8_t)(127.5 + 255 * CLAMP(-0.169 * r - 0.331 * g + 0.500 * b, -0.5, 0.5));
+  yuv[2] = (uint8_t)(127.5 + 255 * CLAMP( 0.500 * r - 0.419 * g - 0.081 * b, -0.5, 0.5));
+  unsigned int opacity = 255 - (color & 0xff);
+
+  for (int i = 0; i < height; i++)
+  {
+    int py = y + i;
+    if (py < 0 || py >= pPicture->height)
+      continue;
+    for (int j = 0; j < width; j++)
+    {
+      int px = x + j;
+      if (px < 0 || px >= pPicture->width)
+        continue;
+
+      unsigned int k = mask[stride * i + j] * opacity / 255;
+      uint8_t* target = pPicture->data[0] + pPicture->stride[0] * py + px;
+      *target = (k * yuv[0] + (255 - k) * *target) / 255;
+      if ((px | py) & 1)
+        continue;
+      for (int p = 1; p < 3; p++)
+      {
+        target = pPicture->data[p] + pPicture->stride[p] * (py >> 1) + (px >> 1);
+        *target = (k * yuv[p] + (255 - k) * *target) / 255;
+      }
+    }
+  }
+}
+
+// per pixel blending of run length encoded SPU lines, for overlays at even offsets inside the picture
+static void ReferenceSpu(DVDPictureRenderer* pPicture, CDVDOverlaySpu* pOverlay)
+{
+  uint16_t* p_source = (uint16_t*)pOverlay->result;
+  for (int i_y = pOverlay->y; i_y < pOverlay->y + pOverlay->height; i_y++)
+  {
+    uint8_t* p_dest[3];
+    p_dest[0] = pPicture->data[0] + pPicture->stride[0] * i_y;
+    p_dest[1] = pPicture->data[1] + pPicture->stride[1] * (i_y >> 1);
+    p_dest[2] = pPicture->data[2] + pPicture->stride[2] * (i_y >> 1);
+
+    int rp_len;
+    for (int i_x = pOverlay->x; i_x < pOverlay->x + pOverlay->width; i_x += rp_len)
+    {
+      int i_color = *p_source & 0x3;
+      rp_len = *p_source++ >> 2;
+
+      int* p_color = pOverlay->color[i_color];
+      int p_alpha = pOverlay->alpha[i_color];
+      if (p_alpha == 0)
+        continue;
+
+      uint16_t precomp[3];
+      for (int p = 0; p < 3; p++)
+        precomp[p] = p_color[p] * (p_alpha + 1);
+
+      for (int x = i_x; x < i_x + rp_len; x++)
+        p_dest[0][x] = (precomp[0] + p_dest[0][x] * (15 - p_alpha)) >> 4;
+      if (i_y & 1)
+        continue;
+      // opaque runs are filled, which covers rp_len / 2 chroma samples
+      int x_end = p_alpha == 0x0f ? (i_x >> 1) + (rp_len >> 1) : (i_x + rp_len) >> 1;
+      for (int x = i_x >> 1; x < x_end; x++)
+      {
+        p_dest[1][x] = (precomp[2] + p_dest[1][x] * (15 - p_alpha)) >> 4;
+        p_dest[2][x] = (precomp[1] + p_dest[2][x] * (15 - p_alpha)) >> 4;
+      }
+    }
+  }
+}
+
+// an image with outlined letter like strokes on a transparent background
+static CDVDOverlayImage* CreateImage(int x, int y, int width, int height)
+{
+  static const uint8_t strokes[] = { 0, 0, 0, 0, 0, 0, 0, 0, 2, 3, 1, 1, 1, 1, 1, 3, 2, 0, 0, 0, 2, 3, 1, 1, 3, 2 };
+  CDVDOverlayImage* image = new CDVDOverlayImage();
+  image->x = x;
+  image->y = y;
+  image->width = width;
+  image->height = height;
+  image->linesize = width + 3;
+  image->data = (uint8_t*)malloc(image->linesize * height);
+  image->palette_colors = 4;
+  image->palette = (uint32_t*)malloc(image->palette_colors * 4);
+  image->palette[0] = 0x00000000;
+  image->palette[1] = 0xffffffff;
+  image->palette[2] = 0x80202020;
+  image->palette[3] = 0xc0ff8000;
+  for (int i = 0; i < height; i++)
+  {
+    for (int j = 0; j < image->linesize; j++)
+      image->data[i * image->linesize + j] = strokes[(j / 2 + i / 5) % sizeof(strokes)];
+  }
+  return image;
+}
+
+// a glyph like coverage mask with solid, anti aliased and empty parts
+static std::vector<uint8_t> CreateMask(int stride, int height)
+{
+  std::vector<uint8_t> mask(stride * height);
+  for (int i = 0; i < height; i++)
+  {
+    for (int j = 0; j < stride; j++)
+    {
+      int phase = (j + i / 3) % 24;
+      mask[i * stride + j] = phase < 8 ? 255 : phase < 14 ? (uint8_t)(phase * 37) : 0;
+    }
+  }
+  return mask;
+}
+
+// runs of all 4 colors, covering width pixels on each line
+static CDVDOverlaySpu* CreateSpu(int x, int y, int width, int height)
+{
+  CDVDOverlaySpu* spu = new CDVDOverlaySpu();
+  spu->x = x;
+  spu->y = y;
+  spu->width = width;
+  spu->height = height;
+  for (int i = 0; i < 4; i++)
+  {
+    spu->alpha[i] = i * 5;
+    spu->color[i][0] = 16 + i * 70;
+    spu->color[i][1] = 128 - i * 20;
+    spu->color[i][2] = 128 + i * 30;
+  }
+
+  uint16_t* rle = (uint16_t*)spu->result;
+  for (int i = 0; i < height; i++)
+  {
+    int x_pos = 0, run = 0;
+    while (x_pos < width)
+    {
+      int len = std::min(3 + (run * 7 + i) % 40, width - x_pos);
+      *rle++ = (uint16_t)((len << 2) | ((run + i) & 3));
+      x_pos += len;
+      run++;
+    }
+  }
+  return spu;
+}
+
+TEST(TestDVDOverlayRenderer, Image)
+{
+  static const int rects[][4] = { { 0, 0, 1, 1 }, { 2, 4, 17, 9 }, { 100, 50, 161, 40 }, { 640 - 300, 360 - 30, 300, 30 } };
+  for (unsigned int r = 0; r < sizeof(rects) / sizeof(rects[0]); r++)
+  {
+    CDVDOverlayImage* image = CreateImage(rects[r][0], rects[r][1], rects[r][2], rects[r][3]);
+    CTestPicture expected(640, 360), actual(640, 360);
+    ReferenceImage(&expected.picture, image);
+    CDVDOverlayRenderer::Render(&actual.picture, image);
+    EXPECT_TRUE(expected == actual) << "image at " << rects[r][0] << "," << rects[r][1];
+    image->Release();
+  }
+}
+
+TEST(TestDVDOverlayRenderer, ImageClipped)
+{
+  // larger than the picture, must not write outside of it
+  CDVDOverlayImage* image = CreateImage(0, 0, 700, 400);
+  CTestPicture picture(640, 360);
+  CDVDOverlayRenderer::Render(&picture.picture, image);
+  image->Release();
+}
+
+TEST(TestDVDOverlayRenderer, Mask)
+{
+  static const int rects[][4] = { { 0, 0, 1, 1 }, { 3, 5, 17, 9 }, { 100, 51, 161, 40 }, { -7, -3, 40, 20 }, { 620, 350, 40, 20 } };
+  static const uint32_t colors[] = { 0xffffff00, 0x20408080, 0x000000fe };
+  for (unsigned int r = 0; r < sizeof(rects) / sizeof(rects[0]); r++)
+  {
+    for (unsigned int c = 0; c < sizeof(colors) / sizeof(colors[0]); c++)
+    {
+      int stride = rects[r][2] + 5;
+      std::vector<uint8_t> mask = CreateMask(stride, rects[r][3]);
+      CTestPicture expected(640, 360), actual(640, 360);
+      ReferenceMask(&expected.picture, &mask[0], stride, rects[r][0], rects[r][1], rects[r][2], rects[r][3], colors[c]);
+      CDVDOverlayRenderer::RenderMask(&actual.picture, &mask[0], stride, rects[r][0], rects[r][1], rects[r][2], rects[r][3], colors[c]);
+      EXPECT_TRUE(expected == actual) << "mask at " << rects[r][0] << "," << rects[r][1] << " color " << colors[c];
+    }
+  }
+}
+
+TEST(TestDVDOverlayRenderer, Spu)
+{
+  static const int rects[][4] = { { 0, 0, 5, 2 }, { 2, 4, 17, 9 }, { 100, 50, 161, 40 }, { 40, 300, 600, 60 } };
+  for (unsigned int r = 0; r < sizeof(rects) / sizeof(rects[0]); r++)
+  {
+    CDVDOverlaySpu* spu = CreateSpu(rects[r][0], rects[r][1], rects[r][2], rects[r][3]);
+    CTestPicture expected(640, 360), actual(640, 360);
+    ReferenceSpu(&expected.picture, spu);
+    CDVDOverlayRenderer::Render(&actual.picture, spu, 0.0);
+    EXPECT_TRUE(expected == actual) << "spu at " << rects[r][0] << "," << rects[r][1];
+    spu->Release();
+  }
+}
+
+TEST(TestDVDOverlayRenderer, SpuClipped)
+{
+  // partly outside of the picture, must not write outside of it
+  CDVDOverlaySpu* spu = CreateSpu(600, 340, 100, 40);
+  CTestPicture picture(640, 360);
+  CDVDOverlayRenderer::Render(&picture.picture, spu, 0.0);
+  spu->Release();
+}
+
+// times bitmap and text subtitles on a 1080p picture, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestDVDOverlayRenderer.*
+TEST(TestDVDOverlayRenderer, DISABLED_Benchmark)
+{
+  CTestPicture picture(1920, 1080);
+  int64_t start;
+  double reference, vectorized;
+
+  // two lines of bitmap subtitles
+  CDVDOverlayImage* image = CreateImage(160, 880, 1600, 160);
+  start = CurrentHostCounter();
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++)
+    ReferenceImage(&picture.picture, image);
+  reference = ElapsedMs(start) / BENCHMARK_ITERATIONS;
+  start = CurrentHostCounter();
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++)
+    CDVDOverlayRenderer::Render(&picture.picture, image);
+  vectorized = ElapsedMs(start) / BENCHMARK_ITERATIONS;
+  image->Release();
+  std::cout << "Image overlay 1600x160: per pixel " << reference << " ms, vectorized " << vectorized << " ms" << std::endl;
+
+  // dense karaoke subtitles, a fill, an outline and a shadow layer for each of the lines
+  static const int layers = 6;
+  std::vector<uint8_t> mask = CreateMask(1600, 80);
+  start = CurrentHostCounter();
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++)
+    for (int l = 0; l < layers; l++)
+      ReferenceMask(&picture.picture, &mask[0], 1600, 160, 860 + (l & 1) * 90, 1600, 80, 0xffe00000 + l);
+  reference = ElapsedMs(start) / BENCHMARK_ITERATIONS;
+  start = CurrentHostCounter();
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++)
+    for (int l = 0; l < layers; l++)
+      CDVDOverlayRenderer::RenderMask(&picture.picture, &mask[0], 1600, 160, 860 + (l & 1) * 90, 1600, 80, 0xffe00000 + l);
+  vectorized = ElapsedMs(start) / BENCHMARK_ITERATIONS;
+  std::cout << "SSA overlay " << layers << "x1600x80: per pixel " << reference << " ms, vectorized " << vectorized << " ms" << std::endl;
+
+  // dvd subtitles
+  CDVDOverlaySpu* spu = CreateSpu(160, 880, 1600, 160);
+  start = CurrentHostCounter();
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++)
+    ReferenceSpu(&picture.picture, spu);
+  reference = ElapsedMs(start) / BENCHMARK_ITERATIONS;
+  start = CurrentHostCounter();
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++)
+    CDVDOverlayRenderer::Render(&picture.picture, spu, 0.0);
+  vectorized = ElapsedMs(start) / BENCHMARK_ITERATIONS;
+  spu->Release();
+  std::cout << "SPU overlay 1600x160: per pixel " << reference << " ms, vectorized " << vectorized << " ms" << std::endl;
+}
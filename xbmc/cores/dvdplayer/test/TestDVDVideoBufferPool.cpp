@@ -0,0 +1,194 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDCodecs/DVDCodecUtils.h"
+#include "DVDCodecs/Video/DVDVideoBufferPool.h"
+#include "DVDCodecs/Video/DVDVideoCodec.h"
+#include "cores/VideoRenderers/BaseRenderer.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#define TEST_WIDTH  1920
+#define TEST_HEIGHT 1080
+#define TEST_FRAMES 100
+
+class TestDVDVideoBufferPool : public testing::Test
+{
+protected:
+  TestDVDVideoBufferPool()
+  {
+    avcodec_register_all();
+    // any decoder with CODEC_CAP_DR1 will do, the pool only looks at the capabilities
+    m_context = avcodec_alloc_context3(NULL);
+    m_context->codec = avcodec_find_decoder(AV_CODEC_ID_MPEG2VIDEO);
+    m_context->codec_id = AV_CODEC_ID_MPEG2VIDEO;
+    m_context->width = TEST_WIDTH;
+    m_context->height = TEST_HEIGHT;
+    m_context->pix_fmt = AV_PIX_FMT_YUV420P;
+  }
+
+  ~TestDVDVideoBufferPool()
+  {
+    m_context->codec = NULL;
+    avcodec_free_context(&m_context);
+  }
+
+  // let the pool allocate a frame, as the decoder would through get_buffer2
+  AVFrame* GetFrame()
+  {
+    AVFrame *frame = av_frame_alloc();
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = TEST_WIDTH;
+    frame->height = TEST_HEIGHT;
+    if (m_pool.GetBuffer(m_context, frame, 0) < 0)
+      av_frame_free(&frame);
+    return frame;
+  }
+
+  static void FillPicture(DVDVideoPicture &picture, const AVFrame *frame)
+  {
+    memset(&picture, 0, sizeof(picture));
+    for (int i = 0; i < 4; i++)
+    {
+      picture.data[i] = frame->data[i];
+      picture.iLineSize[i] = frame->linesize[i];
+    }
+    picture.iWidth = frame->width;
+    picture.iHeight = frame->height;
+    picture.format = RENDER_FMT_YUV420P;
+  }
+
+  AVCodecContext *m_context;
+  CDVDVideoBufferPool m_pool;
+};
+
+TEST_F(TestDVDVideoBufferPool, Alignment)
+{
+  AVFrame *frame = GetFrame();
+  ASSERT_TRUE(frame != NULL);
+
+  for (int i = 0; i < 3; i++)
+  {
+    EXPECT_TRUE(frame->buf[i] != NULL);
+    EXPECT_TRUE(frame->data[i] != NULL);
+    EXPECT_EQ(0u, (uintptr_t)frame->data[i] % 64);
+    EXPECT_EQ(0, frame->linesize[i] % 64);
+  }
+  EXPECT_GE(frame->linesize[0], TEST_WIDTH);
+  EXPECT_GE(frame->linesize[1], TEST_WIDTH / 2);
+  EXPECT_TRUE(frame->data[3] == NULL);
+
+  av_frame_free(&frame);
+}
+
+TEST_F(TestDVDVideoBufferPool, Reference)
+{
+  AVFrame *frame = GetFrame();
+  ASSERT_TRUE(frame != NULL);
+
+  CDVDVideoBuffer *buffer = CDVDVideoBuffer::Create(frame);
+  ASSERT_TRUE(buffer != NULL);
+
+  DVDVideoPicture picture;
+  FillPicture(picture, frame);
+  EXPECT_TRUE(buffer->Matches(&picture));
+
+  // the planes must outlive the frame the codec decoded into
+  uint8_t *plane = frame->data[0];
+  av_frame_free(&frame);
+  EXPECT_EQ(plane, buffer->GetPlane(0));
+  memset(buffer->GetPlane(0), 0x10, buffer->GetStride(0));
+
+  // substituted planes must not be rendered from the buffer
+  std::vector<uint8_t> other(TEST_WIDTH * TEST_HEIGHT);
+  picture.data[0] = &other[0];
+  EXPECT_FALSE(buffer->Matches(&picture));
+
+  buffer->Release();
+}
+
+TEST_F(TestDVDVideoBufferPool, Reuse)
+{
+  AVFrame *frame = GetFrame();
+  ASSERT_TRUE(frame != NULL);
+  uint8_t *plane = frame->data[0];
+  av_frame_free(&frame);
+
+  // a returned buffer is handed out again instead of allocating a new one
+  frame = GetFrame();
+  ASSERT_TRUE(frame != NULL);
+  EXPECT_EQ(plane, frame->data[0]);
+  av_frame_free(&frame);
+}
+
+// compares copying a decoded 1080p frame with handing its buffer over, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestDVDVideoBufferPool.*
+TEST_F(TestDVDVideoBufferPool, DISABLED_Benchmark)
+{
+  std::vector<uint8_t> image_data(TEST_WIDTH * TEST_HEIGHT * 3 / 2);
+  YV12Image image;
+  memset(&image, 0, sizeof(image));
+  image.width = TEST_WIDTH;
+  image.height = TEST_HEIGHT;
+  image.cshift_x = 1;
+  image.cshift_y = 1;
+  image.bpp = 1;
+  image.stride[0] = TEST_WIDTH;
+  image.stride[1] = image.stride[2] = TEST_WIDTH / 2;
+  image.plane[0] = &image_data[0];
+  image.plane[1] = image.plane[0] + TEST_WIDTH * TEST_HEIGHT;
+  image.plane[2] = image.plane[1] + TEST_WIDTH * TEST_HEIGHT / 4;
+
+  int64_t copy = 0, direct = 0;
+  for (int i = 0; i < TEST_FRAMES; i++)
+  {
+    AVFrame *frame = GetFrame();
+    ASSERT_TRUE(frame != NULL);
+    DVDVideoPicture picture;
+    FillPicture(picture, frame);
+
+    int64_t start = CurrentHostCounter();
+    CDVDCodecUtils::CopyPicture(&image, &picture);
+    copy += CurrentHostCounter() - start;
+
+    start = CurrentHostCounter();
+    CDVDVideoBuffer *buffer = CDVDVideoBuffer::Create(frame);
+    if (buffer && buffer->Matches(&picture))
+      buffer->Acquire();
+    direct += CurrentHostCounter() - start;
+
+    av_frame_free(&frame);
+    if (buffer)
+    {
+      buffer->Release();
+      buffer->Release();
+    }
+  }
+
+  double frequency = (double)CurrentHostFrequency();
+  std::cout << TEST_WIDTH << "x" << TEST_HEIGHT << " I420 hand-off per frame: copy "
+            << copy * 1000.0 / frequency / TEST_FRAMES << " ms, direct "
+            << direct * 1000.0 / frequency / TEST_FRAMES << " ms" << std::endl;
+}
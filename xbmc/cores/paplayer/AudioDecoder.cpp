@@ -24,13 +24,111 @@
 #include "settings/Settings.h"
 #include "FileItem.h"
 #include "music/tags/MusicInfoTag.h"
+#include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include <math.h>
+#include <vector>
+
+#define PCM_BUFFER_SECONDS   2 // the pcm buffer always holds at least this much audio
+#define PCM_BUFFERS_TO_KEEP  2 // current and next track
+
+/*!
+ \brief Pool of the pcm ring buffers used by the decoders.
+
+ With decode-ahead each queued track holds several seconds of pcm, so the buffers are
+ handed from one track to the next instead of being freed and reallocated at every
+ transition. The pool also enforces the <decodeaheadmemory> cap over all buffers.
+ */
+class CPCMBufferPool
+{
+public:
+  CPCMBufferPool() : m_allocated(0) {}
+
+  ~CPCMBufferPool()
+  {
+    for (std::vector<CRingBuffer*>::iterator it = m_free.begin(); it != m_free.end(); ++it)
+      delete *it;
+  }
+
+  /*! \brief Get a cleared buffer of at least minSize bytes, preferably wantedSize bytes */
+  CRingBuffer *Get(unsigned int minSize, unsigned int wantedSize)
+  {
+    CSingleLock lock(m_section);
+
+    unsigned int limit = (unsigned int)g_advancedSettings.m_audioDecodeAheadMemory * 1024 * 1024;
+
+    // the smallest free buffer that fits the whole window
+    std::vector<CRingBuffer*>::iterator best = m_free.end();
+    for (std::vector<CRingBuffer*>::iterator it = m_free.begin(); it != m_free.end(); ++it)
+    {
+      if ((*it)->getSize() >= wantedSize && (best == m_free.end() || (*it)->getSize() < (*best)->getSize()))
+        best = it;
+    }
+
+    // otherwise the largest one that is usable at all, if a new buffer would break the cap
+    if (best == m_free.end() && m_allocated + wantedSize > limit)
+    {
+      for (std::vector<CRingBuffer*>::iterator it = m_free.begin(); it != m_free.end(); ++it)
+      {
+        if ((*it)->getSize() >= minSize && (best == m_free.end() || (*it)->getSize() > (*best)->getSize()))
+          best = it;
+      }
+    }
+
+    if (best != m_free.end())
+    {
+      CRingBuffer *buffer = *best;
+      m_free.erase(best);
+      buffer->Clear();
+      return buffer;
+    }
+
+    // shrink the window to what is left of the budget, but never below the minimum
+    unsigned int size = wantedSize;
+    if (m_allocated + size > limit)
+      size = std::max(minSize, limit > m_allocated ? limit - m_allocated : 0);
+
+    CRingBuffer *buffer = new CRingBuffer();
+    if (!buffer->Create(size))
+    {
+      delete buffer;
+      return NULL;
+    }
+    m_allocated += size;
+    return buffer;
+  }
+
+  void Release(CRingBuffer *buffer)
+  {
+    if (!buffer)
+      return;
+
+    CSingleLock lock(m_section);
+    if (m_free.size() < PCM_BUFFERS_TO_KEEP)
+    {
+      buffer->Clear();
+      m_free.push_back(buffer);
+      return;
+    }
+
+    m_allocated -= buffer->getSize();
+    delete buffer;
+  }
+
+private:
+  CCriticalSection          m_section;
+  std::vector<CRingBuffer*> m_free;
+  unsigned int              m_allocated; // bytes held by all buffers, in use or free
+};
+
+static CPCMBufferPool g_pcmBufferPool;
 
 CAudioDecoder::CAudioDecoder()
 {
   m_codec = NULL;
+  m_pcmBuffer = NULL;
+  m_queuedSize = 0;
 
   m_eof = false;
 
@@ -54,7 +152,8 @@ void CAudioDecoder::Destroy()
   CSingleLock lock(m_critSection);
   m_status = STATUS_NO_FILE;
 
-  m_pcmBuffer.Destroy();
+  g_pcmBufferPool.Release(m_pcmBuffer);
+  m_pcmBuffer = NULL;
 
   if ( m_codec )
     delete m_codec;
@@ -63,7 +162,7 @@ void CAudioDecoder::Destroy()
   m_canPlay = false;
 }
 
-bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
+bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset, unsigned int decodeAheadMS)
 {
   Destroy();
 
@@ -99,8 +198,20 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     return false;
   }
 
-  /* allocate the pcmBuffer for 2 seconds of audio */
-  m_pcmBuffer.Create(2 * blockSize * m_codec->m_SampleRate);
+  /* get a pcmBuffer for at least 2 seconds of audio, or the whole decode-ahead window */
+  unsigned int bytesPerSecond = blockSize * m_codec->m_SampleRate;
+  unsigned int minSize = PCM_BUFFER_SECONDS * bytesPerSecond;
+  unsigned int wantedSize = std::max(minSize, (unsigned int)((uint64_t)decodeAheadMS * bytesPerSecond / 1000));
+  wantedSize -= wantedSize % blockSize;
+  m_pcmBuffer = g_pcmBufferPool.Get(minSize, wantedSize);
+  if (!m_pcmBuffer)
+  {
+    CLog::Log(LOGERROR, "CAudioDecoder: Unable to allocate %u bytes of pcm buffer", minSize);
+    Destroy();
+    return false;
+  }
+  // playback may start as soon as the usual 2 seconds are there, the rest fills in the background
+  m_queuedSize = (unsigned int)(minSize * 0.9);
 
   // set total time from the given tag
   if (file.HasMusicInfoTag() && file.GetMusicInfoTag()->GetDuration())
@@ -127,9 +238,9 @@ void CAudioDecoder::GetDataFormat(CAEChannelInfo *channelInfo, unsigned int *sam
 
 int64_t CAudioDecoder::Seek(int64_t time)
 {
-  m_pcmBuffer.Clear();
   if (!m_codec)
     return 0;
+  m_pcmBuffer->Clear();
   if (time < 0) time = 0;
   if (time > m_codec->m_TotalTime) time = m_codec->m_TotalTime;
   return m_codec->Seek(time);
@@ -147,9 +258,9 @@ unsigned int CAudioDecoder::GetDataSize()
   if (m_status == STATUS_QUEUING || m_status == STATUS_NO_FILE)
     return 0;
   // check for end of file and end of buffer
-  if (m_status == STATUS_ENDING && m_pcmBuffer.getMaxReadSize() < PACKET_SIZE)
+  if (m_status == STATUS_ENDING && m_pcmBuffer->getMaxReadSize() < PACKET_SIZE)
     m_status = STATUS_ENDED;
-  return std::min(m_pcmBuffer.getMaxReadSize() / (m_codec->m_BitsPerSample >> 3), (unsigned int)OUTPUT_SAMPLES);
+  return std::min(m_pcmBuffer->getMaxReadSize() / (m_codec->m_BitsPerSample >> 3), (unsigned int)OUTPUT_SAMPLES);
 }
 
 void *CAudioDecoder::GetData(unsigned int samples)
@@ -161,15 +272,15 @@ void *CAudioDecoder::GetData(unsigned int samples)
     return NULL;
   }
   
-  if (size > m_pcmBuffer.getMaxReadSize())
+  if (size > m_pcmBuffer->getMaxReadSize())
   {
-    CLog::Log(LOGWARNING, "CAudioDecoder::GetData() more bytes/samples (%i) requested than we have to give (%i)!", size, m_pcmBuffer.getMaxReadSize());
-    size = m_pcmBuffer.getMaxReadSize();
+    CLog::Log(LOGWARNING, "CAudioDecoder::GetData() more bytes/samples (%i) requested than we have to give (%i)!", size, m_pcmBuffer->getMaxReadSize());
+    size = m_pcmBuffer->getMaxReadSize();
   }
 
-  if (m_pcmBuffer.ReadData((char *)m_outputBuffer, size))
+  if (m_pcmBuffer->ReadData((char *)m_outputBuffer, size))
   {
-    if (m_status == STATUS_ENDING && m_pcmBuffer.getMaxReadSize() == 0)
+    if (m_status == STATUS_ENDING && m_pcmBuffer->getMaxReadSize() == 0)
       m_status = STATUS_ENDED;
     
     return m_outputBuffer;
@@ -192,7 +303,7 @@ int CAudioDecoder::ReadSamples(int numsamples)
   CSingleLock lock(m_critSection);
 
   // Read in more data
-  int maxsize = std::min<int>(INPUT_SAMPLES, m_pcmBuffer.getMaxWriteSize() / (m_codec->m_BitsPerSample >> 3));
+  int maxsize = std::min<int>(INPUT_SAMPLES, m_pcmBuffer->getMaxWriteSize() / (m_codec->m_BitsPerSample >> 3));
   numsamples = std::min<int>(numsamples, maxsize);
   numsamples -= (numsamples % m_codec->GetChannelInfo().Count());  // make sure it's divisible by our number of channels
   if ( numsamples )
@@ -203,10 +314,10 @@ int CAudioDecoder::ReadSamples(int numsamples)
     if (result != READ_ERROR && readSize)
     {
       // move it into our buffer
-      m_pcmBuffer.WriteData((char *)m_pcmInputBuffer, readSize);
+      m_pcmBuffer->WriteData((char *)m_pcmInputBuffer, readSize);
 
       // update status
-      if (m_status == STATUS_QUEUING && m_pcmBuffer.getMaxReadSize() > m_pcmBuffer.getSize() * 0.9)
+      if (m_status == STATUS_QUEUING && m_pcmBuffer->getMaxReadSize() > m_queuedSize)
       {
         CLog::Log(LOGINFO, "AudioDecoder: File is queued");
         m_status = STATUS_QUEUED;
@@ -239,6 +350,35 @@ int CAudioDecoder::ReadSamples(int numsamples)
   return RET_SLEEP; // nothing to do
 }
 
+bool CAudioDecoder::DecodeAhead(const volatile bool &abort)
+{
+  while (!abort)
+  {
+    int status = GetStatus();
+    if (status == STATUS_NO_FILE || status == STATUS_ENDING || status == STATUS_ENDED)
+      return true;
+
+    int result = ReadSamples(PACKET_SIZE);
+    if (result == RET_ERROR)
+      return false;
+    if (result == RET_SLEEP)
+      return true;   // buffer is full
+  }
+  return true;
+}
+
+unsigned int CAudioDecoder::GetBufferedTime()
+{
+  CSingleLock lock(m_critSection);
+  if (!m_codec || !m_pcmBuffer)
+    return 0;
+
+  unsigned int bytesPerSecond = (m_codec->m_BitsPerSample >> 3) * m_codec->GetChannelInfo().Count() * m_codec->m_SampleRate;
+  if (bytesPerSecond == 0)
+    return 0;
+  return (unsigned int)((uint64_t)m_pcmBuffer->getMaxReadSize() * 1000 / bytesPerSecond);
+}
+
 float CAudioDecoder::GetReplayGain()
 {
 #define REPLAY_GAIN_DEFAULT_LEVEL 89.0f
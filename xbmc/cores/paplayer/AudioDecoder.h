@@ -56,11 +56,27 @@ public:
   CAudioDecoder();
   ~CAudioDecoder();
 
-  bool Create(const CFileItem &file, int64_t seekOffset);
+  /*! \brief Open the file and allocate the pcm buffer
+   \param file the file to decode
+   \param seekOffset the position in ms to start decoding at
+   \param decodeAheadMS how much audio the pcm buffer should be able to hold ahead of playback,
+          the default of 0 allocates the usual two seconds. Larger windows are capped by the
+          <decodeaheadmemory> advanced setting.
+   */
+  bool Create(const CFileItem &file, int64_t seekOffset, unsigned int decodeAheadMS = 0);
   void Destroy();
 
   int ReadSamples(int numsamples);
 
+  /*! \brief Decode until the pcm buffer is full or the end of the stream is reached
+   \param abort decoding is stopped early when this becomes true
+   \return false on a decoding error
+   */
+  bool DecodeAhead(const volatile bool &abort);
+
+  /*! \brief How much decoded audio is waiting in the pcm buffer, in ms */
+  unsigned int GetBufferedTime();
+
   bool CanSeek() { if (m_codec) return m_codec->CanSeek(); else return false; };
   int64_t Seek(int64_t time);
   int64_t TotalTime();
@@ -77,8 +93,9 @@ public:
   float GetReplayGain();
 
 private:
-  // pcm buffer
-  CRingBuffer m_pcmBuffer;
+  // pcm buffer, borrowed from the buffer pool while a file is open
+  CRingBuffer *m_pcmBuffer;
+  unsigned int m_queuedSize; // bytes to buffer before we report the file as queued
 
   // output buffer (for transferring data from the Pcm Buffer to the rest of the audio chain)
   float m_outputBuffer[OUTPUT_SAMPLES];
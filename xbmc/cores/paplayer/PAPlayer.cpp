@@ -30,12 +30,19 @@
 #include "utils/JobManager.h"
 
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "cores/AudioEngine/AEFactory.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 #include "cores/DataCacheCore.h"
 
 #define TIME_TO_CACHE_NEXT_FILE 5000 /* 5 seconds before end of song, start caching the next song */
+
+/* the next song is prepared early enough to also fill its decode-ahead window */
+static unsigned int TimeToCacheNextFile()
+{
+  return TIME_TO_CACHE_NEXT_FILE + g_advancedSettings.m_audioDecodeAhead * 1000;
+}
 #define FAST_XFADE_TIME           80 /* 80 milliseconds */
 #define MAX_SKIP_XFADE_TIME     2000 /* max 2 seconds crossfade on track skip */
 
@@ -347,8 +354,11 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, b
     m_continueStream = false;
   }
 
+  /* only tracks queued behind a playing one decode ahead, the first track starts right away */
+  bool decodeAhead = job && m_currentStream && !file.IsCDDA();
+
   StreamInfo *si = new StreamInfo();
-  if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75))
+  if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75, decodeAhead ? g_advancedSettings.m_audioDecodeAhead * 1000 : 0))
   {
     CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
 
@@ -384,6 +394,19 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, b
     CThread::Sleep(1);
   }
 
+  /* fill the decode-ahead window so a slow source can't stall the transition */
+  if (decodeAhead && !si->m_decoder.DecodeAhead(m_bStop))
+  {
+    CLog::Log(LOGINFO, "PAPlayer::QueueNextFileEx - Error decoding ahead");
+
+    si->m_decoder.Destroy();
+    delete si;
+    // advance playlist
+    m_callback.OnPlayBackStarted();
+    m_callback.OnQueueNextItem();
+    return false;
+  }
+
   // set m_upcomingCrossfadeMS depending on type of file and user settings
   UpdateCrossfadeTime(file);
 
@@ -402,6 +425,7 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, b
   si->m_volume             = (fadeIn && m_upcomingCrossfadeMS) ? 0.0f : 1.0f;
   si->m_fadeOutTriggered   = false;
   si->m_isSlaved           = false;
+  si->m_readyTime          = 0;
 
   int64_t streamTotalTime = si->m_decoder.TotalTime();
   if (si->m_endOffset)
@@ -411,8 +435,8 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, b
   // cd drives don't really like it to be crossfaded or prepared
   if(!file.IsCDDA())
   {
-    if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-      si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_sampleRate / 1000.0f);
+    if (streamTotalTime >= TimeToCacheNextFile() + m_defaultCrossfadeMS)
+      si->m_prepareNextAtFrame = (int)((streamTotalTime - TimeToCacheNextFile() - m_defaultCrossfadeMS) * si->m_sampleRate / 1000.0f);
   }
 
   if (m_currentStream && (AE_IS_RAW(m_currentStream->m_dataFormat) || AE_IS_RAW(si->m_dataFormat)))
@@ -445,6 +469,10 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, b
 
   /* add the stream to the list */
   CExclusiveLock lock(m_streamsLock);
+  if (m_currentStream)
+    si->m_readyTime = std::max(XbmcThreads::SystemClockMillis(), 1u);
+  else if (job)
+    CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Next stream was not ready before the previous one ended");
   m_streams.push_back(si);
   //update the current stream to start playing the next track at the correct frame.
   UpdateStreamInfoPlayNextAtFrame(m_currentStream, m_upcomingCrossfadeMS);
@@ -720,6 +748,10 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
       si->m_stream->Resume();
     si->m_stream->FadeVolume(0.0f, 1.0f, m_upcomingCrossfadeMS);
     m_callback.OnPlayBackStarted();
+
+    if (si->m_readyTime)
+      CLog::Log(LOGDEBUG, "PAPlayer::ProcessStream - Transition was ready %u ms early, %u ms of audio decoded ahead",
+                XbmcThreads::SystemClockMillis() - si->m_readyTime, si->m_decoder.GetBufferedTime());
   }
 
   /* if we have not started yet and the stream has been primed */
@@ -782,8 +814,8 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
 
       // calculate time when to prepare next stream
       si->m_prepareNextAtFrame = 0;
-      if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-        si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_sampleRate / 1000.0f);
+      if (streamTotalTime >= TimeToCacheNextFile() + m_defaultCrossfadeMS)
+        si->m_prepareNextAtFrame = (int)((streamTotalTime - TimeToCacheNextFile() - m_defaultCrossfadeMS) * si->m_sampleRate / 1000.0f);
 
       si->m_prepareTriggered = false;
       si->m_playNextAtFrame = 0;
@@ -120,6 +120,7 @@ private:
 
     bool              m_isSlaved;            /* true if the stream has been slaved to another */
     bool              m_waitOnDrain;         /* wait for stream being drained in AE */
+    unsigned int      m_readyTime;           /* when the queued stream was ready to play, 0 if it didn't follow another stream */
   } StreamInfo;
 
   typedef std::list<StreamInfo*> StreamList;
@@ -0,0 +1,144 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "cores/paplayer/AudioDecoder.h"
+#include "FileItem.h"
+#include "filesystem/File.h"
+#include "utils/EndianSwap.h"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+#include <vector>
+
+#define TEST_RATE      44100
+#define TEST_CHANNELS  2
+#define TEST_SECONDS   4
+#define TEST_AHEAD_MS  10000
+
+/* writes TEST_SECONDS of 16 bit pcm with every sample set to value */
+static bool WriteWav(const std::string &path, int16_t value)
+{
+  uint32_t samples = TEST_SECONDS * TEST_RATE * TEST_CHANNELS;
+  std::vector<int16_t> data(samples, (int16_t)Endian_SwapLE16(value));
+
+  std::string header;
+  uint32_t fields[] = { 36 + samples * 2, 16, 1 | (TEST_CHANNELS << 16), TEST_RATE,
+                        TEST_RATE * TEST_CHANNELS * 2, (TEST_CHANNELS * 2) | (16 << 16), samples * 2 };
+  const char *tags[] = { "RIFF", "WAVEfmt ", NULL, NULL, NULL, NULL, "data" };
+  for (unsigned int i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+  {
+    if (tags[i])
+      header += tags[i];
+    uint32_t field = Endian_SwapLE32(fields[i]);
+    header.append((const char *)&field, 4);
+  }
+
+  XFILE::CFile file;
+  return file.OpenForWrite(path, true) &&
+         file.Write(header.c_str(), header.size()) == (ssize_t)header.size() &&
+         file.Write(&data[0], samples * 2) == (ssize_t)(samples * 2);
+}
+
+/* reads what is left in the decoder, returns the seconds of audio and whether all of it was silence */
+static double ReadAll(CAudioDecoder &decoder, bool &silent)
+{
+  CAEChannelInfo channels;
+  unsigned int sampleRate, encodedSampleRate;
+  AEDataFormat format;
+  decoder.GetDataFormat(&channels, &sampleRate, &encodedSampleRate, &format);
+  unsigned int bytesPerSample = CAEUtil::DataFormatToBits(format) >> 3;
+
+  uint64_t samples = 0;
+  silent = true;
+  unsigned int size;
+  while ((size = decoder.GetDataSize()) > 0)
+  {
+    const char *data = (const char *)decoder.GetData(size);
+    if (!data)
+      break;
+    for (unsigned int i = 0; i < size * bytesPerSample; i++)
+      silent &= data[i] == 0;
+    samples += size;
+  }
+  return (double)samples / (channels.Count() * sampleRate);
+}
+
+TEST(TestAudioDecoder, DecodeAhead)
+{
+  std::string path = "special://temp/AudioDecoderAhead.wav";
+  ASSERT_TRUE(WriteWav(path, 0x1000));
+  CFileItem item(path, false);
+
+  bool abort = false;
+
+  // the playing track
+  CAudioDecoder current;
+  ASSERT_TRUE(current.Create(item, 0));
+  EXPECT_TRUE(current.DecodeAhead(abort));
+  EXPECT_GE(current.GetStatus(), STATUS_QUEUED);
+
+  // the next track decodes all of itself ahead of the transition
+  CAudioDecoder next;
+  ASSERT_TRUE(next.Create(item, 0, TEST_AHEAD_MS));
+  EXPECT_TRUE(next.DecodeAhead(abort));
+  EXPECT_EQ(STATUS_ENDING, next.GetStatus());
+  EXPECT_GE(next.GetBufferedTime(), (TEST_SECONDS - 1) * 1000u);
+
+  bool silent;
+  EXPECT_NEAR(TEST_SECONDS, ReadAll(next, silent), 0.1);
+  EXPECT_FALSE(silent);
+  EXPECT_EQ(STATUS_ENDED, next.GetStatus());
+
+  current.Destroy();
+  next.Destroy();
+  XFILE::CFile::Delete(path);
+}
+
+TEST(TestAudioDecoder, HandOff)
+{
+  std::string loud = "special://temp/AudioDecoderLoud.wav";
+  std::string silence = "special://temp/AudioDecoderSilence.wav";
+  ASSERT_TRUE(WriteWav(loud, 0x1000));
+  ASSERT_TRUE(WriteWav(silence, 0));
+  bool abort = false;
+
+  // the first track ends with its buffer still full
+  CAudioDecoder first;
+  ASSERT_TRUE(first.Create(CFileItem(loud, false), 0, TEST_AHEAD_MS));
+  EXPECT_TRUE(first.DecodeAhead(abort));
+  EXPECT_GT(first.GetBufferedTime(), 0u);
+  first.Destroy();
+
+  // the buffer it hands to the next track must not play any of it
+  CAudioDecoder second;
+  ASSERT_TRUE(second.Create(CFileItem(silence, false), 0, TEST_AHEAD_MS));
+  EXPECT_EQ(0u, second.GetBufferedTime());
+  EXPECT_TRUE(second.DecodeAhead(abort));
+
+  bool silent;
+  EXPECT_NEAR(TEST_SECONDS, ReadAll(second, silent), 0.1);
+  EXPECT_TRUE(silent);
+
+  second.Destroy();
+  XFILE::CFile::Delete(loud);
+  XFILE::CFile::Delete(silence);
+}
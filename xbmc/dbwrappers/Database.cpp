@@ -23,6 +23,7 @@
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/File.h"
 #include "profiles/ProfilesManager.h"
+#include "media/MediaType.h"
 #include "utils/AutoPtrHandle.h"
 #include "utils/log.h"
 #include "utils/SortUtils.h"
@@ -36,11 +37,51 @@
 #include "mysqldataset.h"
 #endif
 
+#include <ctype.h>
+
 using namespace AUTOPTR;
 using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
 
+// rows of the search index are identified by the id of the item and its kind,
+// docid = id << SEARCH_KIND_BITS | kind
+#define SEARCH_KIND_BITS 4
+
+static const char *SearchKinds[] = { "", MediaTypeMovie, MediaTypeTvShow, MediaTypeEpisode, MediaTypeMusicVideo, "actor", "tag",
+                                     MediaTypeArtist, MediaTypeAlbum, MediaTypeSong };
+
+static int GetSearchKind(const std::string &kind)
+{
+  for (unsigned int i = 1; i < sizeof(SearchKinds) / sizeof(SearchKinds[0]); i++)
+  {
+    if (kind == SearchKinds[i])
+      return i;
+  }
+  CLog::Log(LOGERROR, "%s - unknown kind of search item %s", __FUNCTION__, kind.c_str());
+  return 0;
+}
+
+// the default ft_min_word_len of MyISAM, InnoDB indexes words from 3 characters on
+#define MYSQL_MIN_WORD_LENGTH 4
+
+// characters of an utf-8 string
+static unsigned int GetCharacterCount(const std::string &str)
+{
+  unsigned int count = 0;
+  for (std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+  {
+    if (((unsigned char)*it & 0xc0) != 0x80)
+      count++;
+  }
+  return count;
+}
+
+static std::string GetSearchDocId(const std::string &id, const std::string &kind)
+{
+  return StringUtils::Format("((%s << %i) | %i)", id.c_str(), SEARCH_KIND_BITS, GetSearchKind(kind));
+}
+
 void CDatabase::Filter::AppendField(const std::string &strField)
 {
   if (strField.empty())
@@ -104,6 +145,7 @@ CDatabase::CDatabase(void)
 {
   m_openCount = 0;
   m_sqlite = true;
+  m_fullTextSearch = -1;
   m_bMultiWrite = false;
   m_multipleExecute = false;
 }
@@ -458,6 +500,8 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
   // set SSL configuration regardless if any are empty (all empty means no SSL).
   m_pDB->setSSLConfig(dbSettings.key.c_str(), dbSettings.cert.c_str(), dbSettings.ca.c_str(), dbSettings.capath.c_str(), dbSettings.ciphers.c_str());
 
+  m_fullTextSearch = -1;
+
   // create the datasets
   m_pDS.reset(m_pDB->CreateDataset());
   m_pDS2.reset(m_pDB->CreateDataset());
@@ -735,3 +779,200 @@ bool CDatabase::BuildSQL(const std::string &strBaseDir, const std::string &strQu
 
   return BuildSQL(strQuery, filter, strSQL);
 }
+
+void CDatabase::CreateSearchTable(const std::string &columns)
+{
+  m_fullTextSearch = -1;
+  if (m_sqlite)
+  {
+    // the unicode61 tokenizer folds the case of all letters, not only ascii
+    // ones, but depends on how sqlite was built. prefix indexes speed up the
+    // short prefixes of search as you type.
+    const char *options[] = { ", tokenize=unicode61, prefix=\"2,3\"", ", prefix=\"2,3\"" };
+    for (unsigned int i = 0; i < sizeof(options) / sizeof(options[0]); i++)
+    {
+      try
+      {
+        m_pDS->exec("CREATE VIRTUAL TABLE searchindex USING fts4(" + columns + options[i] + ")");
+        return;
+      }
+      catch (...)
+      {
+      }
+    }
+    CLog::Log(LOGWARNING, "%s - full text search isn't available, searches will be slower", __FUNCTION__);
+  }
+
+  std::string table = "CREATE TABLE searchindex (docid integer primary key";
+  std::vector<std::string> names = StringUtils::Split(columns, ",");
+  for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+    table += ", " + *it + " text";
+  table += ")";
+  m_pDS->exec(table);
+}
+
+void CDatabase::CreateSearchIndex(const std::string &columns)
+{
+  if (m_sqlite)
+    return;
+
+  std::string name = columns.substr(0, columns.find(','));
+  try
+  {
+    m_pDS->exec(PrepareSQL("CREATE FULLTEXT INDEX ix_searchindex_%s ON searchindex (%s)", name.c_str(), columns.c_str()));
+  }
+  catch (...)
+  {
+    // InnoDB only supports full text indexes as of MySQL 5.6
+    CLog::Log(LOGWARNING, "%s - unable to create a full text index on %s, searches will be slower", __FUNCTION__, columns.c_str());
+  }
+}
+
+void CDatabase::CreateSearchTriggers(const std::string &table, const std::string &idField, const std::string &kind, const std::string &columns, const std::string &values)
+{
+  std::vector<std::string> names = StringUtils::Split(columns, ",");
+  std::vector<std::string> fields = StringUtils::Split(values, ",");
+  std::string newValues, assignments, changed;
+  for (unsigned int i = 0; i < names.size() && i < fields.size(); i++)
+  {
+    if (i > 0)
+    {
+      newValues += ", ";
+      assignments += ", ";
+      changed += " OR ";
+    }
+    newValues += "new." + fields[i];
+    assignments += names[i] + "=new." + fields[i];
+    changed += "NOT (new." + fields[i] + " <=> old." + fields[i] + ")";
+  }
+  std::string docId = GetSearchDocId("new." + idField, kind);
+
+  m_pDS->exec(PrepareSQL("CREATE TRIGGER insert_%s_search AFTER INSERT ON %s FOR EACH ROW BEGIN "
+                         "INSERT INTO searchindex (docid, %s) VALUES (%s, %s); "
+                         "END", table.c_str(), table.c_str(), columns.c_str(), docId.c_str(), newValues.c_str()));
+
+  // items are updated often, e.g. when played, so only touch the index when
+  // the text changes. sqlite can limit triggers to columns, MySQL has to check.
+  std::string update = "UPDATE searchindex SET " + assignments + " WHERE docid=" + docId + "; ";
+  if (m_sqlite)
+    m_pDS->exec(PrepareSQL("CREATE TRIGGER update_%s_search AFTER UPDATE OF %s ON %s FOR EACH ROW BEGIN ",
+                           table.c_str(), values.c_str(), table.c_str()) + update + "END");
+  else
+    m_pDS->exec(PrepareSQL("CREATE TRIGGER update_%s_search AFTER UPDATE ON %s FOR EACH ROW BEGIN ",
+                           table.c_str(), table.c_str()) + "IF " + changed + " THEN " + update + "END IF; END");
+}
+
+void CDatabase::FillSearchTable(const std::string &table, const std::string &idField, const std::string &kind, const std::string &columns, const std::string &values)
+{
+  m_pDS->exec(PrepareSQL("INSERT INTO searchindex (docid, %s) SELECT %s, %s FROM %s",
+                         columns.c_str(), GetSearchDocId(idField, kind).c_str(), values.c_str(), table.c_str()));
+}
+
+std::string CDatabase::GetSearchDeleteSQL(const std::string &kind, const std::string &id) const
+{
+  return "DELETE FROM searchindex WHERE docid=" + GetSearchDocId(id, kind) + "; ";
+}
+
+std::string CDatabase::GetSearchClause(const std::string &idField, const std::string &kind, const std::string &columns, const std::string &search) const
+{
+  // split the search into lower case words, which also drops anything the
+  // full text query syntax could take for an operator
+  std::vector<std::string> words;
+  std::string word;
+  for (std::string::const_iterator it = search.begin(); ; ++it)
+  {
+    if (it != search.end() && (isalnum((unsigned char)*it) || (unsigned char)*it >= 0x80))
+      word += tolower((unsigned char)*it);
+    else
+    {
+      if (!word.empty())
+        words.push_back(word);
+      word.clear();
+      if (it == search.end())
+        break;
+    }
+  }
+  // nothing to look for finds nothing
+  if (words.empty())
+    return "0=1";
+
+  std::vector<std::string> names = StringUtils::Split(columns, ",");
+  std::string match;
+  if (HasFullTextSearch() && m_sqlite)
+  {
+    // whether OR or the implicit AND between words binds stronger depends on
+    // how sqlite was built, so every word gets a MATCH of its own. only one
+    // MATCH is allowed per WHERE clause, the other words go in subqueries
+    for (std::vector<std::string>::const_iterator it = words.begin(); it != words.end(); ++it)
+    {
+      std::string query;
+      for (std::vector<std::string>::const_iterator name = names.begin(); name != names.end(); ++name)
+        query += (name == names.begin() ? "" : " OR ") + *name + ":" + *it + "*";
+      if (match.empty())
+        match = PrepareSQL("searchindex MATCH '%s'", query.c_str());
+      else
+        match += PrepareSQL(" AND docid IN (SELECT docid FROM searchindex WHERE searchindex MATCH '%s')", query.c_str());
+    }
+  }
+  else
+  {
+    // MySQL leaves words shorter than ft_min_word_len out of its full text
+    // index, those are looked for with LIKE. stopwords aren't indexed either,
+    // they aren't recognized here and searching for them is unreliable.
+    bool fullText = HasFullTextSearch();
+    std::string query;
+    for (std::vector<std::string>::const_iterator it = words.begin(); it != words.end(); ++it)
+    {
+      if (fullText && GetCharacterCount(*it) >= MYSQL_MIN_WORD_LENGTH)
+      {
+        query += (query.empty() ? "+" : " +") + *it + "*";
+        continue;
+      }
+
+      std::string any;
+      for (std::vector<std::string>::const_iterator name = names.begin(); name != names.end(); ++name)
+      {
+        if (!any.empty())
+          any += " OR ";
+        any += PrepareSQL("%s LIKE '%s%%' OR %s LIKE '%% %s%%'", name->c_str(), it->c_str(), name->c_str(), it->c_str());
+      }
+      match += (match.empty() ? "(" : " AND (") + any + ")";
+    }
+    if (!query.empty())
+      match = PrepareSQL("MATCH(%s) AGAINST('%s' IN BOOLEAN MODE)", columns.c_str(), query.c_str()) + (match.empty() ? "" : " AND " + match);
+  }
+
+  // the derived table makes MySQL search once instead of for every item
+  return StringUtils::Format("%s IN (SELECT docid >> %i FROM (SELECT docid FROM searchindex WHERE %s AND (docid & %i) = %i) AS matches)",
+                             idField.c_str(), SEARCH_KIND_BITS, match.c_str(), (1 << SEARCH_KIND_BITS) - 1, GetSearchKind(kind));
+}
+
+bool CDatabase::HasFullTextSearch() const
+{
+  if (m_fullTextSearch < 0 && NULL != m_pDB.get())
+  {
+    m_fullTextSearch = 0;
+    try
+    {
+      std::auto_ptr<Dataset> ds(m_pDB->CreateDataset());
+      if (m_sqlite)
+      {
+        if (ds->query("SELECT sql FROM sqlite_master WHERE type='table' AND name='searchindex'") && !ds->eof() &&
+            StringUtils::StartsWithNoCase(ds->fv(0).get_asString(), "CREATE VIRTUAL TABLE"))
+          m_fullTextSearch = 1;
+      }
+      else
+      {
+        if (ds->query("SELECT index_name FROM information_schema.statistics "
+                      "WHERE table_schema=DATABASE() AND table_name='searchindex' AND index_type='FULLTEXT'") && !ds->eof())
+          m_fullTextSearch = 1;
+      }
+      ds->close();
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "%s - unable to determine the type of the search index", __FUNCTION__);
+    }
+  }
+  return m_fullTextSearch > 0;
+}
@@ -157,6 +157,18 @@ public:
    */
   bool CommitInsertQueries();
 
+  /*!
+   * @brief Get a condition selecting the items whose text in the search index
+   *        contains words starting with all the words of a search.
+   * @param idField The field holding the id of the items, e.g. movie.idMovie.
+   * @param kind The kind of the items, as passed to CreateSearchTriggers().
+   * @param columns Comma separated columns of the search index to search in.
+   *        On MySQL a full text index on exactly these columns is needed.
+   * @param search The words to look for.
+   * @return The condition, ready to be used in a WHERE clause.
+   */
+  std::string GetSearchClause(const std::string &idField, const std::string &kind, const std::string &columns, const std::string &search) const;
+
   virtual bool GetFilter(CDbUrl &dbUrl, Filter &filter, SortDescription &sorting) { return true; }
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl);
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl, SortDescription &sorting);
@@ -204,6 +216,43 @@ protected:
 
   bool BuildSQL(const std::string &strQuery, const Filter &filter, std::string &strSQL);
 
+  /*! \brief Create the search index table.
+   It holds the searchable text of items of different kinds, one row per item.
+   A full text index (FTS4) is used on SQLite if available, otherwise searches
+   fall back to LIKE on the table, which still saves joining the item tables.
+   \param columns comma separated names of the text columns.
+   */
+  void CreateSearchTable(const std::string &columns);
+
+  /*! \brief Create a full text index over columns of the search index table.
+   Only needed on MySQL, call from CreateAnalytics() for each group of columns
+   that is passed to GetSearchClause().
+   */
+  void CreateSearchIndex(const std::string &columns);
+
+  /*! \brief Create triggers keeping the search index up to date with a table.
+   Call from CreateAnalytics(). Removing items from the index has to be added
+   to the delete trigger of the table with GetSearchDeleteSQL(), as MySQL only
+   allows one trigger per table and event.
+   \param table the table holding the items.
+   \param idField the id column of the table.
+   \param kind name telling the items of different tables apart.
+   \param columns comma separated columns of the search index to fill.
+   \param values comma separated columns of the table to fill them from.
+   */
+  void CreateSearchTriggers(const std::string &table, const std::string &idField, const std::string &kind, const std::string &columns, const std::string &values);
+
+  /*! \brief Add all items of a table to the search index.
+   Used when updating databases, see CreateSearchTriggers() for the parameters.
+   */
+  void FillSearchTable(const std::string &table, const std::string &idField, const std::string &kind, const std::string &columns, const std::string &values);
+
+  /*! \brief Statement removing an item from the search index, for delete triggers.
+   \param kind the kind of the item.
+   \param id the id of the item, e.g. old.idMovie.
+   */
+  std::string GetSearchDeleteSQL(const std::string &kind, const std::string &id) const;
+
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
   std::auto_ptr<dbiplus::Database> m_pDB;
@@ -214,6 +263,9 @@ private:
   void InitSettings(DatabaseSettings &dbSettings);
   bool Connect(const std::string &dbName, const DatabaseSettings &db, bool create);
   void UpdateVersionNumber();
+  bool HasFullTextSearch() const;
+
+  mutable int m_fullTextSearch; ///< \brief whether the search index has a full text index, -1 if not known yet
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
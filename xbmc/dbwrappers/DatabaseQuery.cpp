@@ -31,27 +31,29 @@ using namespace std;
 
 typedef struct
 {
-  char string[15];
+  char string[20];
   CDatabaseQueryRule::SEARCH_OPERATOR op;
   int localizedString;
 } operatorField;
 
 static const operatorField operators[] = {
-  { "contains",        CDatabaseQueryRule::OPERATOR_CONTAINS,          21400 },
-  { "doesnotcontain",  CDatabaseQueryRule::OPERATOR_DOES_NOT_CONTAIN,  21401 },
-  { "is",              CDatabaseQueryRule::OPERATOR_EQUALS,            21402 },
-  { "isnot",           CDatabaseQueryRule::OPERATOR_DOES_NOT_EQUAL,    21403 },
-  { "startswith",      CDatabaseQueryRule::OPERATOR_STARTS_WITH,       21404 },
-  { "endswith",        CDatabaseQueryRule::OPERATOR_ENDS_WITH,         21405 },
-  { "greaterthan",     CDatabaseQueryRule::OPERATOR_GREATER_THAN,      21406 },
-  { "lessthan",        CDatabaseQueryRule::OPERATOR_LESS_THAN,         21407 },
-  { "after",           CDatabaseQueryRule::OPERATOR_AFTER,             21408 },
-  { "before",          CDatabaseQueryRule::OPERATOR_BEFORE,            21409 },
-  { "inthelast",       CDatabaseQueryRule::OPERATOR_IN_THE_LAST,       21410 },
-  { "notinthelast",    CDatabaseQueryRule::OPERATOR_NOT_IN_THE_LAST,   21411 },
-  { "true",            CDatabaseQueryRule::OPERATOR_TRUE,              20122 },
-  { "false",           CDatabaseQueryRule::OPERATOR_FALSE,             20424 },
-  { "between",         CDatabaseQueryRule::OPERATOR_BETWEEN,           21456 }
+  { "contains",            CDatabaseQueryRule::OPERATOR_CONTAINS,              21400 },
+  { "doesnotcontain",      CDatabaseQueryRule::OPERATOR_DOES_NOT_CONTAIN,      21401 },
+  { "is",                  CDatabaseQueryRule::OPERATOR_EQUALS,                21402 },
+  { "isnot",               CDatabaseQueryRule::OPERATOR_DOES_NOT_EQUAL,        21403 },
+  { "startswith",          CDatabaseQueryRule::OPERATOR_STARTS_WITH,           21404 },
+  { "endswith",            CDatabaseQueryRule::OPERATOR_ENDS_WITH,             21405 },
+  { "greaterthan",         CDatabaseQueryRule::OPERATOR_GREATER_THAN,          21406 },
+  { "lessthan",            CDatabaseQueryRule::OPERATOR_LESS_THAN,             21407 },
+  { "after",               CDatabaseQueryRule::OPERATOR_AFTER,                 21408 },
+  { "before",              CDatabaseQueryRule::OPERATOR_BEFORE,                21409 },
+  { "inthelast",           CDatabaseQueryRule::OPERATOR_IN_THE_LAST,           21410 },
+  { "notinthelast",        CDatabaseQueryRule::OPERATOR_NOT_IN_THE_LAST,       21411 },
+  { "true",                CDatabaseQueryRule::OPERATOR_TRUE,                  20122 },
+  { "false",               CDatabaseQueryRule::OPERATOR_FALSE,                 20424 },
+  { "between",             CDatabaseQueryRule::OPERATOR_BETWEEN,               21456 },
+  { "containswords",       CDatabaseQueryRule::OPERATOR_CONTAINS_WORDS,        21416 },
+  { "doesnotcontainwords", CDatabaseQueryRule::OPERATOR_DOES_NOT_CONTAIN_WORDS, 21466 }
 };
 
 static const size_t NUM_OPERATORS = sizeof(operators) / sizeof(operatorField);
@@ -290,6 +292,10 @@ std::string CDatabaseQueryRule::GetOperatorString(SEARCH_OPERATOR op) const
       operatorString = " LIKE '%%%s%%'"; break;
     case OPERATOR_DOES_NOT_CONTAIN:
       operatorString = " LIKE '%%%s%%'"; break;
+    case OPERATOR_CONTAINS_WORDS:
+    case OPERATOR_DOES_NOT_CONTAIN_WORDS:
+      // fields without a search index
+      operatorString = " LIKE '%%%s%%'"; break;
     case OPERATOR_EQUALS:
       if (GetFieldType(m_field) == NUMERIC_FIELD || GetFieldType(m_field) == SECONDS_FIELD)
         operatorString = " = %s";
@@ -341,7 +347,7 @@ std::string CDatabaseQueryRule::GetWhereClause(const CDatabase &db, const std::s
 
   std::string operatorString = GetOperatorString(op);
   std::string negate;
-  if (op == OPERATOR_DOES_NOT_CONTAIN || op == OPERATOR_FALSE ||
+  if (op == OPERATOR_DOES_NOT_CONTAIN || op == OPERATOR_DOES_NOT_CONTAIN_WORDS || op == OPERATOR_FALSE ||
      (op == OPERATOR_DOES_NOT_EQUAL && GetFieldType(m_field) != NUMERIC_FIELD && GetFieldType(m_field) != SECONDS_FIELD))
     negate = " NOT";
 
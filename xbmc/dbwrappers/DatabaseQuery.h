@@ -52,6 +52,8 @@ public:
                          OPERATOR_TRUE,
                          OPERATOR_FALSE,
                          OPERATOR_BETWEEN,
+                         OPERATOR_CONTAINS_WORDS,
+                         OPERATOR_DOES_NOT_CONTAIN_WORDS,
                          OPERATOR_END
                        };
 
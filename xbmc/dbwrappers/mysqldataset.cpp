@@ -23,6 +23,7 @@
 #include <set>
 
 #include "utils/log.h"
+#include "utils/PerformanceTrace.h"
 #include "system.h" // for GetLastError()
 #include "network/WakeOnAccess.h"
 #include "Util.h"
@@ -1429,6 +1430,7 @@ static size_t ci_find(const string& where, const string& what)
 }
 
 int MysqlDataset::exec(const string &sql) {
+  TRACE_SCOPE("MysqlDataset::exec");
   if (!handle()) throw DbErrors("No Database Connection");
   string qry = sql;
   int res = 0;
@@ -1472,6 +1474,7 @@ const void* MysqlDataset::getExecRes() {
 
 
 bool MysqlDataset::query(const std::string &query) {
+  TRACE_SCOPE("MysqlDataset::query");
   if(!handle()) throw DbErrors("No Database Connection");
   std::string qry = query;
   int fs = qry.find("select");
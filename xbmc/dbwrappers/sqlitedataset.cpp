@@ -31,6 +31,7 @@
 
 #include "sqlitedataset.h"
 #include "utils/log.h"
+#include "utils/PerformanceTrace.h"
 #include "system.h" // for Sleep(), OutputDebugString() and GetLastError()
 #include "utils/URIUtils.h"
 
@@ -322,7 +323,8 @@ int SqliteDatabase::drop_analytics(void) {
   result_set res;
 
   CLog::Log(LOGDEBUG, "Cleaning indexes from database %s at %s", db.c_str(), host.c_str());
-  sprintf(sqlcmd, "SELECT name FROM sqlite_master WHERE type == 'index'");
+  // indexes sqlite made for constraints and virtual tables have no sql and can't be dropped
+  sprintf(sqlcmd, "SELECT name FROM sqlite_master WHERE type == 'index' AND sql IS NOT NULL");
   if ((last_err = sqlite3_exec(conn, sqlcmd, &callback, &res, NULL)) != SQLITE_OK) return DB_UNEXPECTED_RESULT;
 
   for (size_t i=0; i < res.records.size(); i++) {
@@ -577,6 +579,7 @@ bool SqliteDataset::dropIndex(const char *table, const char *index)
 
 
 int SqliteDataset::exec(const string &sql) {
+  TRACE_SCOPE("SqliteDataset::exec");
   if (!handle()) throw DbErrors("No Database Connection");
   string qry = sql;
   int res;
@@ -638,6 +641,7 @@ const void* SqliteDataset::getExecRes() {
 
 
 bool SqliteDataset::query(const std::string &query) {
+    TRACE_SCOPE("SqliteDataset::query");
     if(!handle()) throw DbErrors("No Database Connection");
     std::string qry = query;
     int fs = qry.find("select");
@@ -0,0 +1,207 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/Database.h"
+#include "dbwrappers/dataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "media/MediaType.h"
+#include "playlists/SmartPlayList.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+// a table of items with titles in the search index
+class CTestSearchDatabase : public CDatabase
+{
+public:
+  CTestSearchDatabase(int version) : m_version(version) {}
+
+  bool Open()
+  {
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    return Update(settings);
+  }
+
+  void Add(int id, const std::string &title, const std::string &plot = "")
+  {
+    m_pDS->exec(PrepareSQL("INSERT INTO item (idItem, strTitle, strPlot) VALUES (%i, '%s', '%s')", id, title.c_str(), plot.c_str()));
+  }
+
+  // ids of the items found by a search, in order
+  std::string Search(const std::string &search, const std::string &columns = "name")
+  {
+    std::vector<std::string> ids;
+    m_pDS->query("SELECT idItem FROM item WHERE " + GetSearchClause("idItem", MediaTypeMovie, columns, search) + " ORDER BY idItem");
+    while (!m_pDS->eof())
+    {
+      ids.push_back(m_pDS->fv(0).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return StringUtils::Join(ids, ",");
+  }
+
+  int GetVersion() { return GetDBVersion(); }
+  std::auto_ptr<dbiplus::Dataset> &GetDS() { return m_pDS; }
+
+  static void Delete()
+  {
+    for (int version = 1; version <= 2; version++)
+      XFILE::CFile::Delete(StringUtils::Format("special://temp/TestSearchDatabase%i.db", version));
+  }
+
+protected:
+  virtual void CreateTables()
+  {
+    m_pDS->exec("CREATE TABLE item (idItem integer primary key, strTitle text, strPlot text)");
+    CreateSearchTable("name,plot");
+  }
+
+  virtual void CreateAnalytics()
+  {
+    m_pDS->exec("CREATE INDEX ix_item ON item (strTitle)");
+    CreateSearchIndex("name");
+    CreateSearchIndex("name,plot");
+    CreateSearchTriggers("item", "idItem", MediaTypeMovie, "name,plot", "strTitle,strPlot");
+    m_pDS->exec("CREATE TRIGGER delete_item AFTER DELETE ON item FOR EACH ROW BEGIN " +
+                GetSearchDeleteSQL(MediaTypeMovie, "old.idItem") + "END");
+  }
+
+  virtual int GetSchemaVersion() const { return m_version; }
+  virtual const char *GetBaseDBName() const { return "TestSearchDatabase"; }
+
+  int m_version;
+};
+
+TEST(TestDatabase, SearchTriggers)
+{
+  CTestSearchDatabase::Delete();
+  CTestSearchDatabase db(1);
+  ASSERT_TRUE(db.Open());
+
+  db.Add(1, "Batman Begins");
+  db.Add(2, "The Dark Knight");
+  db.Add(3, "Man of Steel");
+  EXPECT_EQ("1", db.Search("bat"));
+  EXPECT_EQ("3", db.Search("MAN"));
+  EXPECT_EQ("2", db.Search("dark kni"));
+  EXPECT_EQ("", db.Search("knight man"));
+
+  db.GetDS()->exec("UPDATE item SET strTitle='The Dark Knight Rises' WHERE idItem=2");
+  EXPECT_EQ("2", db.Search("rises"));
+  db.GetDS()->exec("DELETE FROM item WHERE idItem=1");
+  EXPECT_EQ("", db.Search("batman"));
+
+  db.Close();
+  CTestSearchDatabase::Delete();
+}
+
+TEST(TestDatabase, SearchColumns)
+{
+  CTestSearchDatabase::Delete();
+  CTestSearchDatabase db(1);
+  ASSERT_TRUE(db.Open());
+
+  db.Add(1, "Alpha", "Gamma");
+  db.Add(2, "Beta", "Gamma");
+  db.Add(3, "Alpha", "Beta");
+  db.Add(4, "Gamma", "Delta");
+
+  // every word has to be in one of the columns
+  EXPECT_EQ("3", db.Search("alpha beta", "name,plot"));
+  EXPECT_EQ("1,3", db.Search("alpha", "name,plot"));
+  EXPECT_EQ("", db.Search("alpha beta"));
+  EXPECT_EQ("1,2", db.Search("gamma", "plot"));
+
+  // nothing to look for finds nothing
+  EXPECT_EQ("", db.Search(""));
+  EXPECT_EQ("", db.Search(" -*\"", "name,plot"));
+
+  db.Close();
+  CTestSearchDatabase::Delete();
+}
+
+TEST(TestDatabase, UpdateWithSearchTable)
+{
+  CTestSearchDatabase::Delete();
+  {
+    CTestSearchDatabase db(1);
+    ASSERT_TRUE(db.Open());
+    db.Add(1, "Batman Begins");
+    db.Close();
+  }
+
+  // the full text table has indexes of its own that can't be dropped
+  CTestSearchDatabase db(2);
+  ASSERT_TRUE(db.Open());
+  EXPECT_EQ(2, db.GetVersion());
+  EXPECT_EQ("1", db.Search("batman"));
+
+  // the triggers were made again
+  db.Add(2, "Batman Returns");
+  EXPECT_EQ("1,2", db.Search("batman"));
+
+  db.Close();
+  CTestSearchDatabase::Delete();
+}
+
+TEST(TestDatabase, SmartPlaylistContains)
+{
+  CTestSearchDatabase::Delete();
+  CTestSearchDatabase db(1);
+  ASSERT_TRUE(db.Open());
+
+  CSmartPlaylistRule rule;
+  rule.m_field = FieldTitle;
+  rule.m_parameter.push_back("man");
+
+  // any part of the title, "Batman" contains "man"
+  rule.m_operator = CDatabaseQueryRule::OPERATOR_CONTAINS;
+  std::string where = rule.GetWhereClause(db, "movies");
+  EXPECT_NE(std::string::npos, where.find("LIKE '%man%'"));
+  EXPECT_EQ(std::string::npos, where.find("searchindex"));
+  rule.m_operator = CDatabaseQueryRule::OPERATOR_DOES_NOT_CONTAIN;
+  where = rule.GetWhereClause(db, "movies");
+  EXPECT_NE(std::string::npos, where.find("NOT"));
+  EXPECT_NE(std::string::npos, where.find("LIKE '%man%'"));
+
+  // words starting with "man" through the search index
+  rule.m_operator = CDatabaseQueryRule::OPERATOR_CONTAINS_WORDS;
+  where = rule.GetWhereClause(db, "movies");
+  EXPECT_NE(std::string::npos, where.find("searchindex"));
+  EXPECT_EQ(std::string::npos, where.find("LIKE '%man%'"));
+  rule.m_operator = CDatabaseQueryRule::OPERATOR_DOES_NOT_CONTAIN_WORDS;
+  where = rule.GetWhereClause(db, "movies");
+  EXPECT_EQ(0U, where.find(" NOT"));
+  EXPECT_NE(std::string::npos, where.find("searchindex"));
+
+  // fields that aren't in the search index still match
+  rule.m_field = FieldGenre;
+  rule.m_operator = CDatabaseQueryRule::OPERATOR_CONTAINS_WORDS;
+  where = rule.GetWhereClause(db, "movies");
+  EXPECT_NE(std::string::npos, where.find("LIKE '%man%'"));
+
+  db.Close();
+  CTestSearchDatabase::Delete();
+}
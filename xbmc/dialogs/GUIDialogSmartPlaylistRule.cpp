@@ -418,6 +418,8 @@ void CGUIDialogSmartPlaylistRule::UpdateButtons()
     labels.push_back(OperatorLabel(CDatabaseQueryRule::OPERATOR_DOES_NOT_CONTAIN));
     labels.push_back(OperatorLabel(CDatabaseQueryRule::OPERATOR_STARTS_WITH));
     labels.push_back(OperatorLabel(CDatabaseQueryRule::OPERATOR_ENDS_WITH));
+    labels.push_back(OperatorLabel(CDatabaseQueryRule::OPERATOR_CONTAINS_WORDS));
+    labels.push_back(OperatorLabel(CDatabaseQueryRule::OPERATOR_DOES_NOT_CONTAIN_WORDS));
     break;
 
   case CDatabaseQueryRule::NUMERIC_FIELD:
@@ -51,6 +51,9 @@ using namespace XCURL;
 #define XMIN(a,b) ((a)<(b)?(a):(b))
 #define FITS_INT(a) (((a) <= INT_MAX) && ((a) >= INT_MIN))
 
+/* size of the ranges requested when reading ahead in segments */
+#define SEGMENT_SIZE (1024 * 1024)
+
 curl_proxytype proxyType2CUrlProxyType[] = {
   CURLPROXY_HTTP,
   CURLPROXY_SOCKS4,
@@ -123,6 +126,84 @@ extern "C" size_t header_callback(void *ptr, size_t size, size_t nmemb, void *st
   return state->HeaderCallback(ptr, size, nmemb);
 }
 
+/* a range requested on its own easy handle, next to the stream of the read state */
+class CCurlFile::CReadState::CSegment
+{
+public:
+  CSegment()
+    : m_easyHandle(NULL)
+    , m_start(0)
+    , m_end(0)
+    , m_consumed(0)
+    , m_requested(0)
+    , m_retries(0)
+    , m_checked(false)
+    , m_done(false)
+  { }
+
+  void Request(CURLM* multiHandle, int64_t start, int64_t end)
+  {
+    m_start = start;
+    m_end = end;
+    m_data.clear();
+    m_consumed = 0;
+    m_retries = 0;
+    Request(multiHandle);
+  }
+
+  /* requests what's missing of the range, after a failure that's not all of it */
+  void Request(CURLM* multiHandle)
+  {
+    std::string range = StringUtils::Format("%" PRId64 "-%" PRId64, m_start + (int64_t)m_data.size(), m_end - 1);
+    g_curlInterface.easy_setopt(m_easyHandle, CURLOPT_RANGE, range.c_str());
+    m_checked = false;
+    m_done = false;
+    m_requested = XbmcThreads::SystemClockMillis();
+    g_curlInterface.multi_add_handle(multiHandle, m_easyHandle);
+  }
+
+  size_t Write(char *buffer, size_t size, size_t nitems)
+  {
+    // anything but the range would end up at the wrong place, returning less fails the transfer
+    if (!m_checked)
+    {
+      long response = 0;
+      g_curlInterface.easy_getinfo(m_easyHandle, CURLINFO_RESPONSE_CODE, &response);
+      if (response != 206)
+        return 0;
+      m_checked = true;
+    }
+
+    size_t amount = size * nitems;
+    if (m_data.size() + amount > (size_t)(m_end - m_start))
+      return 0;
+
+    m_data.append(buffer, amount);
+    return amount;
+  }
+
+  CURL_HANDLE*  m_easyHandle;
+  int64_t       m_start;      // the range is [m_start, m_end)
+  int64_t       m_end;
+  std::string   m_data;       // what came in so far, from m_start on
+  size_t        m_consumed;   // how much of it went on to the read buffer
+  unsigned int  m_requested;
+  int           m_retries;
+  bool          m_checked;    // the server answered with the range
+  bool          m_done;
+};
+
+extern "C" size_t segment_write_callback(char *buffer,
+               size_t size,
+               size_t nitems,
+               void *userp)
+{
+  if(userp == NULL) return 0;
+
+  CCurlFile::CReadState::CSegment *segment = (CCurlFile::CReadState::CSegment *)userp;
+  return segment->Write(buffer, size, nitems);
+}
+
 /* fix for silly behavior of realloc */
 static inline void* realloc_simple(void *ptr, size_t size)
 {
@@ -173,6 +254,15 @@ size_t CCurlFile::CReadState::ReadCallback(char *buffer, size_t size, size_t nit
 size_t CCurlFile::CReadState::WriteCallback(char *buffer, size_t size, size_t nitems)
 {
   unsigned int amount = size * nitems;
+  // the segments take over at the end of the stream, returning less ends the transfer there
+  if (m_segmented)
+  {
+    if (m_writePos >= m_streamEnd)
+      return 0;
+    if (m_writePos + amount > m_streamEnd)
+      amount = (unsigned int)(m_streamEnd - m_writePos);
+  }
+  const unsigned int written = amount;
 //  CLog::Log(LOGDEBUG, "CCurlFile::WriteCallback (%p) with %i bytes, readsize = %i, writesize = %i", this, amount, m_buffer.getMaxReadSize(), m_buffer.getMaxWriteSize() - m_overflowSize);
   if (m_overflowSize)
   {
@@ -216,7 +306,8 @@ size_t CCurlFile::CReadState::WriteCallback(char *buffer, size_t size, size_t ni
     memcpy(m_overflowBuffer + m_overflowSize, buffer, amount);
     m_overflowSize += amount;
   }
-  return size * nitems;
+  m_writePos += written;
+  return written;
 }
 
 CCurlFile::CReadState::CReadState()
@@ -236,6 +327,17 @@ CCurlFile::CReadState::CReadState()
   m_isPaused = false;
   m_curlHeaderList = NULL;
   m_curlAliasList = NULL;
+  m_writePos = 0;
+  m_maxSegments = 1;
+  m_segmentCount = 1;
+  m_segmented = false;
+  m_segmentsSettled = false;
+  m_streamEnd = 0;
+  m_nextSegment = 0;
+  m_segmentRate = 0.0;
+  m_roundBytes = 0;
+  m_roundDuration = 0;
+  m_roundSegments = 0;
 }
 
 CCurlFile::CReadState::~CReadState()
@@ -257,6 +359,9 @@ bool CCurlFile::CReadState::Seek(int64_t pos)
     return true;
   }
 
+  if(SeekSegments(pos))
+    return true;
+
   if(pos > m_filePos && pos < m_filePos + m_bufferSize)
   {
     int len = m_buffer.getMaxReadSize();
@@ -311,6 +416,7 @@ long CCurlFile::CReadState::Connect(unsigned int size)
 
   SetResume();
   g_curlInterface.multi_add_handle(m_multiHandle, m_easyHandle);
+  m_writePos = m_filePos;
 
   m_bufferSize = size;
   m_buffer.Destroy();
@@ -343,6 +449,8 @@ long CCurlFile::CReadState::Connect(unsigned int size)
 
 void CCurlFile::CReadState::Disconnect()
 {
+  StopSegments();
+
   if(m_multiHandle && m_easyHandle)
     g_curlInterface.multi_remove_handle(m_multiHandle, m_easyHandle);
 
@@ -351,6 +459,7 @@ void CCurlFile::CReadState::Disconnect()
   m_overflowBuffer = NULL;
   m_overflowSize = 0;
   m_filePos = 0;
+  m_writePos = 0;
   m_fileSize = 0;
   m_bufferSize = 0;
   m_readBuffer = 0;
@@ -404,6 +513,7 @@ CCurlFile::CCurlFile()
   m_skipshout = false;
   m_httpresponse = -1;
   m_acceptCharset = "UTF-8,*;q=0.8"; /* prefer UTF-8 if available */
+  m_maxSegments = 1;
 }
 
 //Has to be called before Open()
@@ -418,6 +528,7 @@ void CCurlFile::Close()
       Write(NULL, 0);
 
   m_state->Disconnect();
+  m_state->m_maxSegments = 1;
   delete m_oldState;
   m_oldState = NULL;
 
@@ -428,6 +539,7 @@ void CCurlFile::Close()
   m_opened = false;
   m_forWrite = false;
   m_inError = false;
+  m_maxSegments = 1;
 }
 
 void CCurlFile::SetCommonOptions(CReadState* state)
@@ -1218,6 +1330,7 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
 
   m_state->m_filePos = nextPos;
   m_state->m_sendRange = true;
+  m_state->m_maxSegments = m_maxSegments;
 
   long response = m_state->Connect(m_bufferSize);
   if(response < 0 && (m_state->m_fileSize == 0 || m_state->m_fileSize != m_state->m_filePos))
@@ -1420,9 +1533,12 @@ unsigned int CCurlFile::CReadState::Read(void* lpBuf, size_t uiBufSize)
 bool CCurlFile::CReadState::FillBuffer(unsigned int want)
 {
   int retry = 0;
-  fd_set fdread;
-  fd_set fdwrite;
-  fd_set fdexcep;
+
+  // once the server has shown it does ranges, the rest comes in segments
+  if (m_maxSegments > 1 && !m_segmented && !m_bFirstLoop)
+    StartSegments();
+  if (m_segmented)
+    return FillSegments(want);
 
   // only attempt to fill buffer if transactions still running and buffer
   // doesnt exceed required size already
@@ -1511,6 +1627,7 @@ bool CCurlFile::CReadState::FillBuffer(unsigned int want)
         free(m_overflowBuffer);
         m_overflowBuffer = NULL;
         m_overflowSize = 0;
+        m_writePos = m_filePos;
 
         // If we got here something is wrong
         if (++retry > g_advancedSettings.m_curlretries)
@@ -1544,47 +1661,8 @@ bool CCurlFile::CReadState::FillBuffer(unsigned int want)
     {
       case CURLM_OK:
       {
-        int maxfd = -1;
-        FD_ZERO(&fdread);
-        FD_ZERO(&fdwrite);
-        FD_ZERO(&fdexcep);
-
-        // get file descriptors from the transfers
-        g_curlInterface.multi_fdset(m_multiHandle, &fdread, &fdwrite, &fdexcep, &maxfd);
-
-        long timeout = 0;
-        if (CURLM_OK != g_curlInterface.multi_timeout(m_multiHandle, &timeout) || timeout == -1 || timeout < 200)
-          timeout = 200;
-
-        XbmcThreads::EndTime endTime(timeout);
-        int rc;
-
-        do
-        {
-          unsigned int time_left = endTime.MillisLeft();
-          struct timeval t = { time_left / 1000, (time_left % 1000) * 1000 };
-
-          // Wait until data is available or a timeout occurs.
-          rc = select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &t);
-#ifdef TARGET_WINDOWS
-        } while(rc == SOCKET_ERROR && WSAGetLastError() == WSAEINTR);
-#else
-        } while(rc == SOCKET_ERROR && errno == EINTR);
-#endif
-
-        if(rc == SOCKET_ERROR)
-        {
-#ifdef TARGET_WINDOWS
-          char buf[256];
-          strerror_s(buf, 256, WSAGetLastError());
-          CLog::Log(LOGERROR, "CCurlFile::FillBuffer - Failed with socket error:%s", buf);
-#else
-          char const * str = strerror(errno);
-          CLog::Log(LOGERROR, "CCurlFile::FillBuffer - Failed with socket error:%s", str);
-#endif
-
+        if (!Select())
           return false;
-        }
       }
       break;
       case CURLM_CALL_MULTI_PERFORM:
@@ -1606,6 +1684,364 @@ bool CCurlFile::CReadState::FillBuffer(unsigned int want)
   return true;
 }
 
+/* waits until the transfers have something to do or a timeout occurs */
+bool CCurlFile::CReadState::Select()
+{
+  fd_set fdread;
+  fd_set fdwrite;
+  fd_set fdexcep;
+  int maxfd = -1;
+  FD_ZERO(&fdread);
+  FD_ZERO(&fdwrite);
+  FD_ZERO(&fdexcep);
+
+  // get file descriptors from the transfers
+  g_curlInterface.multi_fdset(m_multiHandle, &fdread, &fdwrite, &fdexcep, &maxfd);
+
+  long timeout = 0;
+  if (CURLM_OK != g_curlInterface.multi_timeout(m_multiHandle, &timeout) || timeout == -1 || timeout < 200)
+    timeout = 200;
+
+  XbmcThreads::EndTime endTime(timeout);
+  int rc;
+
+  do
+  {
+    unsigned int time_left = endTime.MillisLeft();
+    struct timeval t = { time_left / 1000, (time_left % 1000) * 1000 };
+
+    // Wait until data is available or a timeout occurs.
+    rc = select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &t);
+#ifdef TARGET_WINDOWS
+  } while(rc == SOCKET_ERROR && WSAGetLastError() == WSAEINTR);
+#else
+  } while(rc == SOCKET_ERROR && errno == EINTR);
+#endif
+
+  if(rc == SOCKET_ERROR)
+  {
+#ifdef TARGET_WINDOWS
+    char buf[256];
+    strerror_s(buf, 256, WSAGetLastError());
+    CLog::Log(LOGERROR, "CCurlFile::FillBuffer - Failed with socket error:%s", buf);
+#else
+    char const * str = strerror(errno);
+    CLog::Log(LOGERROR, "CCurlFile::FillBuffer - Failed with socket error:%s", str);
+#endif
+
+    return false;
+  }
+  return true;
+}
+
+/* the stream of the easy handle goes on up to the first segment, further
+ * ranges are requested next to it on the same multi handle */
+bool CCurlFile::CReadState::StartSegments()
+{
+  // not worth it for what's left of short files
+  if (!m_stillRunning || m_fileSize <= 0 || m_fileSize - m_writePos < 2 * SEGMENT_SIZE)
+    return false;
+
+  long response;
+  if (CURLE_OK != g_curlInterface.easy_getinfo(m_easyHandle, CURLINFO_RESPONSE_CODE, &response) || response != 206)
+    return false;
+
+  m_streamEnd = m_writePos + SEGMENT_SIZE;
+  m_nextSegment = m_streamEnd;
+  m_segmentCount = XMIN(2, m_maxSegments);
+  m_segmentsSettled = false;
+  m_segmentRate = 0.0;
+  m_roundBytes = 0;
+  m_roundDuration = 0;
+  m_roundSegments = 0;
+  m_segmented = true;
+
+  CLog::Log(LOGDEBUG, "CCurlFile::StartSegments - Reading on from position %" PRId64 " in segments", m_streamEnd);
+  m_stillRunning = RequestSegments();
+  return true;
+}
+
+void CCurlFile::CReadState::StopSegments()
+{
+  std::vector<CSegment*> segments(m_segments);
+  segments.insert(segments.end(), m_spareSegments.begin(), m_spareSegments.end());
+  for (std::vector<CSegment*>::iterator it = segments.begin(); it != segments.end(); ++it)
+  {
+    if (!(*it)->m_done)
+      g_curlInterface.multi_remove_handle(m_multiHandle, (*it)->m_easyHandle);
+    g_curlInterface.easy_cleanup((*it)->m_easyHandle);
+    delete *it;
+  }
+  m_segments.clear();
+  m_spareSegments.clear();
+  m_segmented = false;
+}
+
+CCurlFile::CReadState::CSegment* CCurlFile::CReadState::AcquireSegment()
+{
+  if (!m_spareSegments.empty())
+  {
+    CSegment* segment = m_spareSegments.back();
+    m_spareSegments.pop_back();
+    return segment;
+  }
+
+  // a copy of the stream's options, not a session of its own as it has to go on this multi handle
+  CURL_HANDLE* easyHandle = g_curlInterface.DllLibCurl::easy_duphandle(m_easyHandle);
+  if (!easyHandle)
+    return NULL;
+
+  g_curlInterface.easy_setopt(easyHandle, CURLOPT_WRITEHEADER, NULL);
+  g_curlInterface.easy_setopt(easyHandle, CURLOPT_HEADERFUNCTION, NULL);
+  g_curlInterface.easy_setopt(easyHandle, CURLOPT_RESUME_FROM_LARGE, (int64_t)0);
+
+  CSegment* segment = new CSegment();
+  segment->m_easyHandle = easyHandle;
+  segment->m_data.reserve(SEGMENT_SIZE);
+  g_curlInterface.easy_setopt(easyHandle, CURLOPT_WRITEDATA, segment);
+  g_curlInterface.easy_setopt(easyHandle, CURLOPT_WRITEFUNCTION, segment_write_callback);
+  return segment;
+}
+
+/* keeps up the requests at a time, with at most two rounds of segments
+ * waiting to be read. returns the number of transfers running */
+int CCurlFile::CReadState::RequestSegments()
+{
+  int running = m_writePos < m_streamEnd ? 1 : 0;
+  for (std::vector<CSegment*>::const_iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+  {
+    if (!(*it)->m_done)
+      running++;
+  }
+
+  while (running < m_segmentCount && (int)m_segments.size() < 2 * m_segmentCount && m_nextSegment < m_fileSize)
+  {
+    CSegment* segment = AcquireSegment();
+    if (!segment)
+    {
+      CLog::Log(LOGERROR, "CCurlFile::RequestSegments - Failed to get a handle for the next segment");
+      break;
+    }
+
+    segment->Request(m_multiHandle, m_nextSegment, XMIN(m_nextSegment + SEGMENT_SIZE, m_fileSize));
+    m_nextSegment = segment->m_end;
+    m_segments.push_back(segment);
+    running++;
+  }
+  return running;
+}
+
+/* like FillBuffer(), with the data coming from the stream and the segments after it */
+bool CCurlFile::CReadState::FillSegments(unsigned int want)
+{
+  while ((unsigned int)m_buffer.getMaxReadSize() < want && m_buffer.getMaxWriteSize() > 0)
+  {
+    if (m_cancelled)
+      return false;
+
+    /* if there is data in overflow buffer, try to use that first */
+    if (m_overflowSize)
+    {
+      unsigned amount = XMIN((unsigned int)m_buffer.getMaxWriteSize(), m_overflowSize);
+      m_buffer.WriteData(m_overflowBuffer, amount);
+
+      if (amount < m_overflowSize)
+        memcpy(m_overflowBuffer, m_overflowBuffer+amount,m_overflowSize-amount);
+
+      m_overflowSize -= amount;
+      m_overflowBuffer = (char*)realloc_simple(m_overflowBuffer, m_overflowSize);
+      continue;
+    }
+
+    if (BufferSegments())
+      continue;
+
+    if (m_writePos >= m_fileSize)
+    {
+      m_stillRunning = 0;
+      return true;
+    }
+
+    int running;
+    CURLMcode result = g_curlInterface.multi_perform(m_multiHandle, &running);
+    if (result != CURLM_OK && result != CURLM_CALL_MULTI_PERFORM)
+    {
+      CLog::Log(LOGERROR, "CCurlFile::FillSegments - Multi perform failed with code %d, aborting", result);
+      return false;
+    }
+
+    if (!FinishSegments())
+      return false;
+
+    m_stillRunning = RequestSegments();
+    if (result == CURLM_CALL_MULTI_PERFORM || BufferSegments())
+      continue;
+
+    if (!m_stillRunning)
+    {
+      CLog::Log(LOGERROR, "CCurlFile::FillSegments - Transfers ended before position %" PRId64, m_writePos);
+      return false;
+    }
+
+    if (!Select())
+      return false;
+  }
+  return true;
+}
+
+/* moves what came in of the segments following on the stream to the read buffer */
+bool CCurlFile::CReadState::BufferSegments()
+{
+  // the stream still has to deliver what goes first
+  if (m_overflowSize || m_writePos < m_streamEnd)
+    return false;
+
+  bool buffered = false;
+  while (!m_segments.empty())
+  {
+    CSegment* segment = m_segments.front();
+    if (segment->m_data.size() > segment->m_consumed)
+    {
+      unsigned int amount = (unsigned int)XMIN((size_t)m_buffer.getMaxWriteSize(), segment->m_data.size() - segment->m_consumed);
+      if (amount == 0)
+        break;
+
+      m_buffer.WriteData(segment->m_data.data() + segment->m_consumed, amount);
+      segment->m_consumed += amount;
+      m_writePos += amount;
+      buffered = true;
+    }
+
+    if (!segment->m_done || segment->m_consumed < segment->m_data.size())
+      break;
+
+    // all of it is in the buffer, the handle goes on with another range
+    m_segments.erase(m_segments.begin());
+    m_spareSegments.push_back(segment);
+  }
+  return buffered;
+}
+
+/* picks up the finished transfers, what's missing of failed ones is requested again */
+bool CCurlFile::CReadState::FinishSegments()
+{
+  int msgs;
+  CURLMsg* msg;
+  while ((msg = g_curlInterface.multi_info_read(m_multiHandle, &msgs)))
+  {
+    if (msg->msg != CURLMSG_DONE)
+      continue;
+
+    CURL_HANDLE* easyHandle = msg->easy_handle;
+    CURLcode result = msg->data.result;
+    g_curlInterface.multi_remove_handle(m_multiHandle, easyHandle);
+
+    if (easyHandle == m_easyHandle)
+    {
+      // cut off where the segments start, anything short of that is requested as a segment of its own
+      if (m_writePos < m_streamEnd)
+      {
+        CLog::Log(LOGNOTICE, "CCurlFile::FinishSegments - Stream ended at position %" PRId64 ", requesting the rest of it", m_writePos);
+        CSegment* segment = AcquireSegment();
+        if (!segment)
+          return false;
+
+        segment->Request(m_multiHandle, m_writePos, m_streamEnd);
+        m_segments.insert(m_segments.begin(), segment);
+        m_streamEnd = m_writePos;
+      }
+      continue;
+    }
+
+    std::vector<CSegment*>::iterator it = m_segments.begin();
+    while (it != m_segments.end() && (*it)->m_easyHandle != easyHandle)
+      ++it;
+    if (it == m_segments.end())
+      continue;
+
+    CSegment* segment = *it;
+    if (result == CURLE_OK && segment->m_data.size() == (size_t)(segment->m_end - segment->m_start))
+    {
+      segment->m_done = true;
+      MeasureSegment(segment);
+      continue;
+    }
+
+    CLog::Log(LOGERROR, "CCurlFile::FinishSegments - Range %" PRId64 "-%" PRId64 " failed at position %" PRId64 ": %s(%d)",
+              segment->m_start, segment->m_end - 1, segment->m_start + (int64_t)segment->m_data.size(),
+              g_curlInterface.easy_strerror(result), result);
+    if (++segment->m_retries > g_advancedSettings.m_curlretries)
+    {
+      CLog::Log(LOGERROR, "CCurlFile::FinishSegments - Reconnect failed!");
+      return false;
+    }
+
+    CLog::Log(LOGNOTICE, "CCurlFile::FinishSegments - Reconnect, (re)try %i", segment->m_retries);
+    segment->Request(m_multiHandle);
+  }
+  return true;
+}
+
+/* skips to a position within the segments following on the read buffer */
+bool CCurlFile::CReadState::SeekSegments(int64_t pos)
+{
+  if (!m_segmented || m_overflowSize || m_writePos < m_streamEnd || pos < m_writePos || pos >= m_nextSegment)
+    return false;
+
+  while (m_segments.front()->m_end <= pos)
+  {
+    CSegment* segment = m_segments.front();
+    if (!segment->m_done)
+    {
+      g_curlInterface.multi_remove_handle(m_multiHandle, segment->m_easyHandle);
+      segment->m_done = true;
+    }
+    m_segments.erase(m_segments.begin());
+    m_spareSegments.push_back(segment);
+  }
+
+  m_segments.front()->m_consumed = (size_t)(pos - m_segments.front()->m_start);
+  m_buffer.Clear();
+  m_filePos = pos;
+  m_writePos = pos;
+  m_stillRunning = RequestSegments();
+  return true;
+}
+
+/* one more request at a time for as long as it pays off. a round is a
+ * segment per request, the rate of a request times the requests at a time
+ * is what they bring together */
+void CCurlFile::CReadState::MeasureSegment(const CSegment* segment)
+{
+  unsigned int duration = XbmcThreads::SystemClockMillis() - segment->m_requested;
+  m_roundBytes += segment->m_end - segment->m_start;
+  m_roundDuration += duration > 0 ? duration : 1;
+  if (++m_roundSegments < m_segmentCount)
+    return;
+
+  double rate = m_roundBytes * 1000.0 / m_roundDuration * m_segmentCount;
+  m_roundBytes = 0;
+  m_roundDuration = 0;
+  m_roundSegments = 0;
+
+  if (!m_segmentsSettled)
+  {
+    // once another one doesn't make a difference the link is busy
+    if (m_segmentRate > 0.0 && rate < m_segmentRate * 1.1)
+    {
+      m_segmentCount--;
+      m_segmentsSettled = true;
+    }
+    else if (m_segmentCount < m_maxSegments)
+      m_segmentCount++;
+    else
+      m_segmentsSettled = true;
+
+    CLog::Log(LOGDEBUG, "CCurlFile::MeasureSegment - %.0f kB/s, %d requests at a time", rate / 1024, m_segmentCount);
+  }
+  m_segmentRate = rate;
+}
+
 void CCurlFile::CReadState::SetReadBuffer(const void* lpBuf, int64_t uiBufSize)
 {
   m_readBuffer = (char*)lpBuf;
@@ -1766,5 +2202,12 @@ int CCurlFile::IoControl(EIoControl request, void* param)
   if(request == IOCTRL_SEEK_POSSIBLE)
     return m_seekable ? 1 : 0;
 
+  // a cache reads on ahead, which several range requests at a time keep up with on slow links
+  if(request == IOCTRL_SET_CACHE && m_seekable && m_multisession && g_advancedSettings.m_curlsegments > 1)
+  {
+    m_maxSegments = g_advancedSettings.m_curlsegments;
+    m_state->m_maxSegments = m_maxSegments;
+  }
+
   return -1;
 }
@@ -23,6 +23,7 @@
 #include "utils/RingBuffer.h"
 #include <map>
 #include <string>
+#include <vector>
 #include "utils/HttpHeader.h"
 
 namespace XCURL
@@ -123,9 +124,25 @@ namespace XFILE
           bool            m_bFirstLoop;
           bool            m_isPaused;
           bool            m_sendRange;
+          int64_t         m_writePos;         // file position of the next byte written into the buffers
 
           char*           m_readBuffer;
 
+          /* reading ahead with several range requests at a time */
+          class CSegment;
+          std::vector<CSegment*> m_segments;      // requested ranges in file order, until they are in the buffer
+          std::vector<CSegment*> m_spareSegments; // handles of finished ranges kept for the next ones
+          int             m_maxSegments;      // most range requests at a time, 1 to stream through one request only
+          int             m_segmentCount;     // range requests at a time for the measured throughput
+          bool            m_segmented;        // past the stream of the easy handle, the data comes in segments
+          bool            m_segmentsSettled;  // another request at a time didn't speed things up
+          int64_t         m_streamEnd;        // the stream of the easy handle is cut off here
+          int64_t         m_nextSegment;      // start of the next range to request
+          double          m_segmentRate;      // bytes per second of the previous round
+          int64_t         m_roundBytes;
+          unsigned int    m_roundDuration;
+          int             m_roundSegments;
+
           /* returned http header */
           CHttpHeader m_httpheader;
           bool        IsHeaderDone(void)
@@ -143,6 +160,17 @@ namespace XFILE
           bool         ReadString(char *szLine, int iLineLength);
           bool         FillBuffer(unsigned int want);
           void         SetReadBuffer(const void* lpBuf, int64_t uiBufSize);
+          bool         Select();
+
+          bool         StartSegments();
+          void         StopSegments();
+          CSegment*    AcquireSegment();
+          int          RequestSegments();
+          bool         FillSegments(unsigned int want);
+          bool         BufferSegments();
+          bool         FinishSegments();
+          bool         SeekSegments(int64_t pos);
+          void         MeasureSegment(const CSegment* segment);
 
           void         SetResume(void);
           long         Connect(unsigned int size);
@@ -191,6 +219,7 @@ namespace XFILE
       bool            m_multisession;
       bool            m_skipshout;
       bool            m_postdataset;
+      int             m_maxSegments;      // range requests at a time when reading ahead for a cache
 
       CRingBuffer     m_buffer;           // our ringhold buffer
       char *          m_overflowBuffer;   // in the rare case we would overflow the above buffer
@@ -148,17 +148,23 @@ bool CDirectory::GetDirectory(const CURL& url, CFileItemList &items, const CHint
     if (!pDirectory.get())
       return false;
 
+    // a paged listing only holds part of the directory, so it must neither
+    // be served from nor stored in the cache
+    bool paged = hints.sorting.limitStart > 0 || hints.sorting.limitEnd > 0;
+    int flags = paged ? hints.flags | DIR_FLAG_BYPASS_CACHE : hints.flags;
+
     // check our cache for this path
-    if (g_directoryCache.GetDirectory(realURL.Get(), items, (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE))
+    if (!paged && g_directoryCache.GetDirectory(realURL.Get(), items, (flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE))
       items.SetURL(url);
     else
     {
       // need to clear the cache (in case the directory fetch fails)
       // and (re)fetch the folder
-      if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
+      if (!(flags & DIR_FLAG_BYPASS_CACHE))
         g_directoryCache.ClearDirectory(realURL.Get());
 
-      pDirectory->SetFlags(hints.flags);
+      pDirectory->SetFlags(flags);
+      pDirectory->SetSorting(hints.sorting);
 
       bool result = false, cancel = false;
       while (!result && !cancel)
@@ -214,7 +220,7 @@ bool CDirectory::GetDirectory(const CURL& url, CFileItemList &items, const CHint
       }
 
       // cache the directory, if necessary
-      if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
+      if (!(flags & DIR_FLAG_BYPASS_CACHE))
         g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url));
     }
 
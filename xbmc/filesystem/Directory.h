@@ -42,6 +42,7 @@ public:
     };
     std::string mask;
     int flags;
+    SortDescription sorting; ///< sorting and limits the caller will apply, see IDirectory::SetSorting
   };
 
   static bool GetDirectory(const CURL& url
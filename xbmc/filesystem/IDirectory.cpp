@@ -109,6 +109,11 @@ void IDirectory::SetFlags(int flags)
   m_flags = flags;
 }
 
+void IDirectory::SetSorting(const SortDescription& sorting)
+{
+  m_sorting = sorting;
+}
+
 bool IDirectory::ProcessRequirements()
 {
   std::string type = m_requirements["type"].asString();
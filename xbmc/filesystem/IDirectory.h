@@ -20,6 +20,7 @@
  */
 
 #include <string>
+#include "utils/SortUtils.h"
 #include "utils/Variant.h"
 
 class CFileItemList;
@@ -123,6 +124,14 @@ public:
   void SetMask(const std::string& strMask);
   void SetFlags(int flags);
 
+  /*! \brief Set the sorting and paging the caller will apply to the listing.
+   Implementations able to sort and limit at the source (e.g. the library databases)
+   may return only the requested page, setting the "total" property of the list to the
+   number of items in the full listing. Others ignore it.
+   \param sorting the sort method, order and limits
+   */
+  void SetSorting(const SortDescription& sorting);
+
   /*! \brief Process additional requirements before the directory fetch is performed.
    Some directory fetches may require authentication, keyboard input etc.  The IDirectory subclass
    should call GetKeyboardInput, SetErrorDialog or RequireAuthentication and then return false 
@@ -167,6 +176,8 @@ protected:
 
   int m_flags; ///< Directory flags - see DIR_FLAG
 
+  SortDescription m_sorting; ///< Sorting and limits specified by SetSorting()
+
   CVariant m_requirements;
 };
 }
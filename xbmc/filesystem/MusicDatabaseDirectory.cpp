@@ -52,7 +52,7 @@ bool CMusicDatabaseDirectory::GetDirectory(const CURL& url, CFileItemList &items
   if (!pNode.get())
     return false;
 
-  bool bResult = pNode->GetChilds(items);
+  bool bResult = pNode->GetChilds(items, m_sorting);
   for (int i=0;i<items.Size();++i)
   {
     CFileItemPtr item = items[i];
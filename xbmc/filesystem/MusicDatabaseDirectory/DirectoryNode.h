@@ -19,6 +19,7 @@
  *
  */
 
+#include "utils/SortUtils.h"
 #include "utils/UrlOptions.h"
 
 class CFileItemList;
@@ -69,7 +70,12 @@ namespace XFILE
 
       NODE_TYPE GetType() const;
 
-      bool GetChilds(CFileItemList& items);
+      /*! \brief Get the child items of this node.
+       \param items the list to fill
+       \param sorting sorting and limits to apply in the database; a paged listing
+       bypasses the disc cache and gets no "* All" folder
+       */
+      bool GetChilds(CFileItemList& items, const SortDescription &sorting = SortDescription());
       virtual NODE_TYPE GetChildType() const;
       virtual std::string GetLocalizedName() const;
 
@@ -90,6 +96,7 @@ namespace XFILE
       virtual bool GetContent(CFileItemList& items) const;
 
       std::string BuildPath() const;
+      const SortDescription& GetSorting() const;
 
     private:
       void AddQueuingFolder(CFileItemList& items) const;
@@ -99,6 +106,7 @@ namespace XFILE
       std::string m_strName;
       CDirectoryNode* m_pParent;
       CUrlOptions m_options;
+      SortDescription m_sorting;
     };
   }
 }
@@ -219,6 +219,13 @@ std::string CDirectoryNode::BuildPath() const
   return strPath;
 }
 
+//  Sorting and limits requested by the caller of GetChilds(),
+//  nodes listing from the database pass them on
+const SortDescription& CDirectoryNode::GetSorting() const
+{
+  return m_sorting;
+}
+
 void CDirectoryNode::AddOptions(const std::string &options)
 {
   if (options.empty())
@@ -250,9 +257,11 @@ NODE_TYPE CDirectoryNode::GetChildType() const
 }
 
 //  Get the child fileitems of this node
-bool CDirectoryNode::GetChilds(CFileItemList& items)
+bool CDirectoryNode::GetChilds(CFileItemList& items, const SortDescription &sorting /* = SortDescription() */)
 {
-  if (CanCache() && items.Load())
+  // a page of the listing can neither be served from nor stored in the disc cache
+  bool paged = sorting.limitStart > 0 || sorting.limitEnd > 0;
+  if (!paged && CanCache() && items.Load())
     return true;
 
   auto_ptr<CDirectoryNode> pNode(CDirectoryNode::CreateNode(GetChildType(), "", this));
@@ -261,8 +270,9 @@ bool CDirectoryNode::GetChilds(CFileItemList& items)
   if (pNode.get())
   {
     pNode->m_options = m_options;
+    pNode->m_sorting = sorting;
     bSuccess=pNode->GetContent(items);
-    if (bSuccess)
+    if (bSuccess && !paged)
     {
       AddQueuingFolder(items);
       if (CanCache())
@@ -0,0 +1,442 @@
+/*
+ *      Copyright (C) 2005-2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "URL.h"
+#include "filesystem/CurlFile.h"
+#include "filesystem/FileCache.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#ifndef TARGET_WINDOWS
+#include <inttypes.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+using namespace XFILE;
+
+#define TEST_FILE_SIZE  (8 * 1024 * 1024)
+#define TEST_LATENCY    50                // milliseconds before the server answers a request
+#define TEST_RATE       (4 * 1024 * 1024) // bytes per second the server sends on a connection
+#define TEST_SEGMENTS   4
+
+/* a stand-in for a distant http server: every request waits for the latency
+ * and every connection is limited to the rate, like a window of tcp over a
+ * long round trip */
+class CRangeServer : public CThread
+{
+public:
+  CRangeServer(unsigned int latency, unsigned int rate)
+    : CThread("RangeServer"),
+      m_socket(INVALID_SOCKET),
+      m_port(0),
+      m_latency(latency),
+      m_rate(rate),
+      m_requests(0),
+      m_active(0),
+      m_maxActive(0)
+  { }
+
+  virtual ~CRangeServer()
+  {
+    Stop();
+  }
+
+  bool Start()
+  {
+    m_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_socket == INVALID_SOCKET)
+      return false;
+
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (bind(m_socket, (struct sockaddr*)&address, sizeof(address)) == SOCKET_ERROR ||
+        listen(m_socket, 16) == SOCKET_ERROR ||
+        getsockname(m_socket, (struct sockaddr*)&address, &length) == SOCKET_ERROR)
+      return false;
+
+    m_port = ntohs(address.sin_port);
+    Create();
+    return true;
+  }
+
+  void Stop()
+  {
+    StopThread();
+    for (std::vector<CConnection*>::iterator it = m_connections.begin(); it != m_connections.end(); ++it)
+      delete *it;
+    m_connections.clear();
+
+    if (m_socket != INVALID_SOCKET)
+      closesocket(m_socket);
+    m_socket = INVALID_SOCKET;
+  }
+
+  std::string GetUrl() const
+  {
+    return StringUtils::Format("http://127.0.0.1:%u/test.bin", m_port);
+  }
+
+  int GetRequests()
+  {
+    CSingleLock lock(m_critSection);
+    return m_requests;
+  }
+
+  int GetMaxActive()
+  {
+    CSingleLock lock(m_critSection);
+    return m_maxActive;
+  }
+
+  static char DataAt(int64_t pos)
+  {
+    return (char)(pos ^ (pos >> 8) ^ (pos >> 16));
+  }
+
+protected:
+  class CConnection : public CThread
+  {
+  public:
+    CConnection(CRangeServer& server, SOCKET socket)
+      : CThread("RangeServerConnection"),
+        m_server(server),
+        m_socket(socket)
+    {
+      Create();
+    }
+
+    virtual ~CConnection()
+    {
+      StopThread();
+      closesocket(m_socket);
+    }
+
+  protected:
+    virtual void Process()
+    {
+      std::string request;
+      while (!m_bStop)
+      {
+        size_t end = request.find("\r\n\r\n");
+        if (end == std::string::npos)
+        {
+          char buffer[1024];
+          if (!m_server.Wait(m_socket))
+            continue;
+          int received = recv(m_socket, buffer, sizeof(buffer), 0);
+          if (received <= 0)
+            break;
+          request.append(buffer, received);
+          continue;
+        }
+
+        std::string header = request.substr(0, end);
+        request.erase(0, end + 4);
+        if (!Respond(header))
+          break;
+      }
+    }
+
+    bool Respond(const std::string& header)
+    {
+      int64_t start = 0;
+      int64_t last = TEST_FILE_SIZE - 1;
+      bool range = false;
+      std::string lower(header);
+      StringUtils::ToLower(lower);
+      size_t pos = lower.find("range: bytes=");
+      if (pos != std::string::npos)
+      {
+        range = true;
+        const char* value = lower.c_str() + pos + 13;
+        char* next;
+        start = strtoll(value, &next, 10);
+        if (*next == '-' && isdigit(next[1]))
+          last = std::min(last, (int64_t)strtoll(next + 1, NULL, 10));
+      }
+
+      std::string response;
+      if (range)
+        response = StringUtils::Format("HTTP/1.1 206 Partial Content\r\n"
+                                       "Content-Range: bytes %" PRId64 "-%" PRId64 "/%d\r\n",
+                                       start, last, TEST_FILE_SIZE);
+      else
+        response = "HTTP/1.1 200 OK\r\n";
+      response += StringUtils::Format("Content-Length: %" PRId64 "\r\n"
+                                      "Content-Type: application/octet-stream\r\n"
+                                      "Accept-Ranges: bytes\r\n\r\n", last + 1 - start);
+
+      XbmcThreads::ThreadSleep(m_server.m_latency);
+      m_server.Begin();
+      bool sent = Send(response.c_str(), response.size());
+      if (sent && header.compare(0, 4, "HEAD") != 0)
+        sent = SendData(start, last + 1);
+      m_server.End();
+      return sent;
+    }
+
+    bool SendData(int64_t start, int64_t end)
+    {
+      char buffer[16 * 1024];
+      unsigned int began = XbmcThreads::SystemClockMillis();
+      for (int64_t pos = start; pos < end && !m_bStop; )
+      {
+        int64_t length = std::min((int64_t)sizeof(buffer), end - pos);
+        for (int64_t i = 0; i < length; i++)
+          buffer[i] = DataAt(pos + i);
+        if (!Send(buffer, (size_t)length))
+          return false;
+        pos += length;
+
+        // hold back to the rate of the connection
+        unsigned int due = (unsigned int)((pos - start) * 1000 / m_server.m_rate);
+        unsigned int elapsed = XbmcThreads::SystemClockMillis() - began;
+        if (due > elapsed)
+          XbmcThreads::ThreadSleep(due - elapsed);
+      }
+      return true;
+    }
+
+    bool Send(const char* data, size_t length)
+    {
+      while (length > 0)
+      {
+        int sent = send(m_socket, data, length, MSG_NOSIGNAL);
+        if (sent <= 0)
+          return false;
+        data += sent;
+        length -= sent;
+      }
+      return true;
+    }
+
+    CRangeServer& m_server;
+    SOCKET m_socket;
+  };
+
+  virtual void Process()
+  {
+    while (!m_bStop)
+    {
+      if (!Wait(m_socket))
+        continue;
+
+      SOCKET socket = accept(m_socket, NULL, NULL);
+      if (socket != INVALID_SOCKET)
+        m_connections.push_back(new CConnection(*this, socket));
+    }
+  }
+
+  /* waits a while for the socket to be readable, so stopping isn't held up */
+  bool Wait(SOCKET socket)
+  {
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(socket, &fds);
+    struct timeval timeout = { 0, 100000 };
+    return select(socket + 1, &fds, NULL, NULL, &timeout) > 0;
+  }
+
+  void Begin()
+  {
+    CSingleLock lock(m_critSection);
+    m_requests++;
+    if (++m_active > m_maxActive)
+      m_maxActive = m_active;
+  }
+
+  void End()
+  {
+    CSingleLock lock(m_critSection);
+    m_active--;
+  }
+
+  SOCKET m_socket;
+  unsigned int m_port;
+  unsigned int m_latency;
+  unsigned int m_rate;
+  std::vector<CConnection*> m_connections;
+  CCriticalSection m_critSection;
+  int m_requests;
+  int m_active;
+  int m_maxActive;
+};
+
+/* reads up to the end position, checking all data on the way */
+static bool ReadAndCheck(IFile& file, int64_t end)
+{
+  std::vector<char> buffer(64 * 1024);
+  int64_t pos = file.GetPosition();
+  while (pos < end)
+  {
+    ssize_t read = file.Read(&buffer[0], (size_t)std::min((int64_t)buffer.size(), end - pos));
+    if (read <= 0)
+    {
+      ADD_FAILURE() << "read failed at position " << pos;
+      return false;
+    }
+
+    for (ssize_t i = 0; i < read; i++)
+    {
+      if (buffer[i] != CRangeServer::DataAt(pos + i))
+      {
+        ADD_FAILURE() << "wrong data at position " << pos + i;
+        return false;
+      }
+    }
+    pos += read;
+  }
+  return true;
+}
+
+class TestCurlFile : public testing::Test
+{
+protected:
+  TestCurlFile()
+    : server(TEST_LATENCY, TEST_RATE),
+      segments(g_advancedSettings.m_curlsegments)
+  { }
+
+  virtual void SetUp()
+  {
+    g_advancedSettings.m_curlsegments = TEST_SEGMENTS;
+    ASSERT_TRUE(server.Start());
+  }
+
+  virtual void TearDown()
+  {
+    server.Stop();
+    g_advancedSettings.m_curlsegments = segments;
+  }
+
+  /* how CFileCache opens its source */
+  bool OpenForCache(CCurlFile& file)
+  {
+    if (!file.Open(CURL(server.GetUrl())))
+      return false;
+    file.IoControl(IOCTRL_SET_CACHE, NULL);
+    return true;
+  }
+
+  CRangeServer server;
+  int segments;
+};
+
+TEST_F(TestCurlFile, Stream)
+{
+  CCurlFile file;
+  ASSERT_TRUE(file.Open(CURL(server.GetUrl())));
+  EXPECT_EQ(TEST_FILE_SIZE, file.GetLength());
+  EXPECT_TRUE(ReadAndCheck(file, TEST_FILE_SIZE));
+  file.Close();
+
+  // without a cache it's the one request
+  EXPECT_EQ(1, server.GetRequests());
+}
+
+TEST_F(TestCurlFile, Segments)
+{
+  CCurlFile file;
+  ASSERT_TRUE(OpenForCache(file));
+  EXPECT_EQ(TEST_FILE_SIZE, file.GetLength());
+  EXPECT_TRUE(ReadAndCheck(file, TEST_FILE_SIZE));
+  file.Close();
+
+  EXPECT_GT(server.GetRequests(), 2);
+  EXPECT_GT(server.GetMaxActive(), 1);
+  EXPECT_LE(server.GetMaxActive(), TEST_SEGMENTS);
+}
+
+TEST_F(TestCurlFile, SeekSegments)
+{
+  CCurlFile file;
+  ASSERT_TRUE(OpenForCache(file));
+  ASSERT_TRUE(ReadAndCheck(file, 1536 * 1024));
+
+  // into the segments read ahead
+  EXPECT_EQ(2560 * 1024 + 123, file.Seek(2560 * 1024 + 123, SEEK_SET));
+  EXPECT_TRUE(ReadAndCheck(file, 2560 * 1024 + 65536));
+
+  // back to where it has to start over
+  EXPECT_EQ(512 * 1024, file.Seek(512 * 1024, SEEK_SET));
+  EXPECT_TRUE(ReadAndCheck(file, 4096 * 1024));
+
+  EXPECT_EQ(TEST_FILE_SIZE - 100000, file.Seek(-100000, SEEK_END));
+  EXPECT_TRUE(ReadAndCheck(file, TEST_FILE_SIZE));
+}
+
+TEST_F(TestCurlFile, FileCache)
+{
+  CFileCache cache;
+  ASSERT_TRUE(cache.Open(CURL(server.GetUrl())));
+  EXPECT_TRUE(ReadAndCheck(cache, TEST_FILE_SIZE));
+  cache.Close();
+
+  EXPECT_GT(server.GetMaxActive(), 1);
+}
+
+// 8 MiB over a throttled local server, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestCurlFile.*
+TEST_F(TestCurlFile, DISABLED_Benchmark)
+{
+  double frequency = (double)CurrentHostFrequency();
+
+  CCurlFile stream;
+  int64_t start = CurrentHostCounter();
+  ASSERT_TRUE(stream.Open(CURL(server.GetUrl())));
+  ASSERT_TRUE(ReadAndCheck(stream, TEST_FILE_SIZE));
+  int64_t streaming = CurrentHostCounter() - start;
+  stream.Close();
+
+  CCurlFile segmented;
+  start = CurrentHostCounter();
+  ASSERT_TRUE(OpenForCache(segmented));
+  ASSERT_TRUE(ReadAndCheck(segmented, TEST_FILE_SIZE));
+  int64_t segmenting = CurrentHostCounter() - start;
+  segmented.Close();
+
+  std::cout << "CurlFile: " << TEST_LATENCY << " ms latency and " << TEST_RATE / 1024 << " kB/s per connection, "
+            << TEST_FILE_SIZE / 1024 * frequency / streaming << " kB/s streaming and "
+            << TEST_FILE_SIZE / 1024 * frequency / segmenting << " kB/s in segments" << std::endl;
+  // the timings depend on the machine and its load, Segments checks that segments are used
+}
@@ -54,6 +54,11 @@ void CGUIBorderedImage::Process(unsigned int currentTime, CDirtyRegionList &dirt
   }
 }
 
+bool CGUIBorderedImage::CanSkipProcess() const
+{
+  return CGUIImage::CanSkipProcess() && m_borderImage.IsStatic();
+}
+
 void CGUIBorderedImage::Render()
 {
   if (!m_borderImage.GetFileName().empty() && m_texture.ReadyToRender())
@@ -34,6 +34,7 @@ public:
   virtual CGUIBorderedImage *Clone() const { return new CGUIBorderedImage(*this); };
 
   virtual void Process(unsigned int currentTime, CDirtyRegionList &dirtyregions);
+  virtual bool CanSkipProcess() const;
   virtual void Render();
   virtual void AllocResources();
   virtual void FreeResources(bool immediately = false);
@@ -27,6 +27,7 @@
 #include "GUIControlProfiler.h"
 #include "input/MouseStat.h"
 #include "Key.h"
+#include "settings/AdvancedSettings.h"
 
 using namespace std;
 
@@ -131,7 +132,17 @@ void CGUIControl::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyreg
 
   if (IsVisible())
   {
-    m_cachedTransform = g_graphicsContext.AddTransform(m_transform);
+    TransformMatrix transform = g_graphicsContext.AddTransform(m_transform);
+    if (!changed && !m_bInvalidated && !m_controlIsDirty && m_hasProcessed && !m_hasCamera &&
+        transform == m_cachedTransform && g_advancedSettings.m_guiSkipUnchangedControls && CanSkipProcess())
+    { // nothing changed since the last frame, so there's nothing to process
+      GUIPROFILER_PROCESS(this, true);
+      g_graphicsContext.RemoveTransform();
+      return;
+    }
+    GUIPROFILER_PROCESS(this, false);
+
+    m_cachedTransform = transform;
     if (m_hasCamera)
       g_graphicsContext.SetCameraPosition(m_camera);
 
@@ -90,6 +90,16 @@ public:
   /*! \brief Returns whether or not we have processed */
   bool HasProcessed() const { return m_hasProcessed; };
 
+  /*! \brief Check whether Process() can be skipped this frame.
+   Only asked when nothing the control depends on has changed since it was last processed:
+   its conditions and info (which mark the control dirty when they change), its animations
+   and its transform. Controls return true if Process() would then leave them as they are,
+   i.e. they don't scroll, fade or load anything by themselves at the moment.
+   \return true if Process() can be skipped, defaults to false.
+   \sa DoProcess
+   */
+  virtual bool CanSkipProcess() const { return false; };
+
   // OnAction() is called by our window when we are the focused control.
   // We should process any control-specific actions in the derived classes,
   // and return true if we have taken care of the action.  Returning false
@@ -26,7 +26,7 @@
 bool CGUIControlProfiler::m_bIsRunning = false;
 
 CGUIControlProfilerItem::CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl)
-: m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_renderTime(0), m_i64VisStart(0), m_i64RenderStart(0)
+: m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_renderTime(0), m_processed(0), m_skipped(0), m_i64VisStart(0), m_i64RenderStart(0)
 {
   if (m_pControl)
   {
@@ -54,6 +54,8 @@ void CGUIControlProfilerItem::Reset(CGUIControlProfiler *pProfiler)
 
   m_visTime = 0;
   m_renderTime = 0;
+  m_processed = 0;
+  m_skipped = 0;
   const unsigned int dwSize = m_vecChildren.size();
   for (unsigned int i=0; i<dwSize; ++i)
     delete m_vecChildren[i];
@@ -82,6 +84,22 @@ void CGUIControlProfilerItem::EndRender(void)
   m_renderTime += (unsigned int)(m_pProfiler->m_fPerfScale * (CurrentHostCounter() - m_i64RenderStart));
 }
 
+void CGUIControlProfilerItem::Process(bool skipped)
+{
+  if (skipped)
+    m_skipped++;
+  else
+    m_processed++;
+}
+
+void CGUIControlProfilerItem::GetProcessCounts(unsigned int &processed, unsigned int &skipped) const
+{
+  processed += m_processed;
+  skipped += m_skipped;
+  for (unsigned int i = 0; i < m_vecChildren.size(); ++i)
+    m_vecChildren[i]->GetProcessCounts(processed, skipped);
+}
+
 void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
 {
   TiXmlElement *xmlControl = new TiXmlElement("control");
@@ -202,6 +220,23 @@ void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
     elem->LinkEndChild(text);
   }
 
+  // how often Process() ran or was skipped for this control and everything in it,
+  // so the entry of a window holds the totals of the window
+  unsigned int processed = 0, skipped = 0;
+  GetProcessCounts(processed, skipped);
+  if (processed || skipped)
+  {
+    TiXmlElement *elem = new TiXmlElement("processed");
+    xmlControl->LinkEndChild(elem);
+    std::string val = StringUtils::Format("%u", processed);
+    elem->LinkEndChild(new TiXmlText(val.c_str()));
+
+    elem = new TiXmlElement("skipped");
+    xmlControl->LinkEndChild(elem);
+    val = StringUtils::Format("%u", skipped);
+    elem->LinkEndChild(new TiXmlText(val.c_str()));
+  }
+
   if (m_vecChildren.size())
   {
     TiXmlElement *xmlChilds = new TiXmlElement("children");
@@ -286,6 +321,12 @@ void CGUIControlProfiler::EndRender(CGUIControl *pControl)
   item->EndRender();
 }
 
+void CGUIControlProfiler::Process(CGUIControl *pControl, bool skipped)
+{
+  CGUIControlProfilerItem *item = FindOrAddControl(pControl);
+  item->Process(skipped);
+}
+
 CGUIControlProfilerItem *CGUIControlProfiler::FindOrAddControl(CGUIControl *pControl)
 {
   if (m_pLastItem)
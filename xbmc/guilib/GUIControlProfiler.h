@@ -39,6 +39,8 @@ public:
   CGUIControl::GUICONTROLTYPES m_ControlType;
   unsigned int m_visTime;
   unsigned int m_renderTime;
+  unsigned int m_processed;
+  unsigned int m_skipped;
   int64_t m_i64VisStart;
   int64_t m_i64RenderStart;
 
@@ -50,8 +52,10 @@ public:
   void EndVisibility(void);
   void BeginRender(void);
   void EndRender(void);
+  void Process(bool skipped);
   void SaveToXML(TiXmlElement *parent);
   unsigned int GetTotalTime(void) const { return m_visTime + m_renderTime; };
+  void GetProcessCounts(unsigned int &processed, unsigned int &skipped) const;
 
   CGUIControlProfilerItem *AddControl(CGUIControl *pControl);
   CGUIControlProfilerItem *FindOrAddControl(CGUIControl *pControl, bool recurse);
@@ -69,6 +73,7 @@ public:
   void EndVisibility(CGUIControl *pControl);
   void BeginRender(CGUIControl *pControl);
   void EndRender(CGUIControl *pControl);
+  void Process(CGUIControl *pControl, bool skipped);
   int GetMaxFrameCount(void) const { return m_iMaxFrameCount; };
   void SetMaxFrameCount(int iMaxFrameCount) { m_iMaxFrameCount = iMaxFrameCount; };
   void SetOutputFile(const std::string &strOutputFile) { m_strOutputFile = strOutputFile; };
@@ -97,5 +102,6 @@ private:
 #define GUIPROFILER_VISIBILITY_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndVisibility(x); }
 #define GUIPROFILER_RENDER_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginRender(x); }
 #define GUIPROFILER_RENDER_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndRender(x); }
+#define GUIPROFILER_PROCESS(x, skipped) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().Process(x, skipped); }
 
 #endif
@@ -27,6 +27,7 @@
 #include "utils/MathUtils.h"
 
 #include "utils/CharsetConverter.h"
+#include "utils/StringUtils.h"
 
 #define ROUND(x) (float)(MathUtils::round_int(x))
 
@@ -283,6 +284,24 @@ void CGUIFont::End()
   m_font->End();
 }
 
+void CGUIFont::PrecacheGlyphs(const std::wstring &characters)
+{
+  if (!m_font)
+    return;
+
+  std::wstring text(characters);
+  if (m_style & FONT_STYLE_UPPERCASE)
+    StringUtils::ToUpper(text);
+  if (m_style & FONT_STYLE_LOWERCASE)
+    StringUtils::ToLower(text);
+
+  vecText utf32;
+  utf32.reserve(text.size());
+  for (std::wstring::const_iterator i = text.begin(); i != text.end(); ++i)
+    utf32.push_back(((m_style & 3) << 24) | (character_t)*i);
+  m_font->PrecacheGlyphs(utf32);
+}
+
 void CGUIFont::SetFont(CGUIFontTTFBase *font)
 {
   if (m_font == font)
@@ -146,6 +146,11 @@ public:
 
   void SetFont(CGUIFontTTFBase* font);
 
+  /*! \brief render the given characters in this font's style ahead of time, in the background.
+   \sa CGUIFontTTFBase::PrecacheGlyphs
+   */
+  void PrecacheGlyphs(const std::wstring &characters);
+
 protected:
   std::string m_strFontName;
   uint32_t m_style;
@@ -0,0 +1,119 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIFontAtlas.h"
+
+#include <algorithm>
+
+CGUIFontAtlas::CGUIFontAtlas()
+{
+  Reset(0);
+}
+
+void CGUIFontAtlas::Reset(unsigned int width)
+{
+  m_width = width;
+  m_height = 0;
+  m_skyline.clear();
+  Segment segment = { 0, 0, width };
+  m_skyline.push_back(segment);
+}
+
+bool CGUIFontAtlas::Fit(size_t i, unsigned int width, unsigned int &y) const
+{
+  if (m_skyline[i].x + width > m_width)
+    return false;
+
+  // the rectangle rests on the highest segment it spans
+  y = 0;
+  unsigned int remaining = width;
+  for (size_t j = i; j < m_skyline.size(); j++)
+  {
+    y = std::max(y, m_skyline[j].y);
+    if (m_skyline[j].width >= remaining)
+      break;
+    remaining -= m_skyline[j].width;
+  }
+  return true;
+}
+
+bool CGUIFontAtlas::Allocate(unsigned int width, unsigned int height, unsigned int maxHeight, unsigned int &x, unsigned int &y)
+{
+  if (width == 0 || height == 0)
+  {
+    x = y = 0;
+    return true;
+  }
+
+  // bottom-left rule: lowest bottom edge first, then the narrowest segment to waste the least
+  size_t best = m_skyline.size();
+  unsigned int bestBottom = 0, bestWidth = 0;
+  for (size_t i = 0; i < m_skyline.size(); i++)
+  {
+    unsigned int top;
+    if (!Fit(i, width, top) || top + height > maxHeight)
+      continue;
+    if (best == m_skyline.size() || top + height < bestBottom ||
+       (top + height == bestBottom && m_skyline[i].width < bestWidth))
+    {
+      best = i;
+      bestBottom = top + height;
+      bestWidth = m_skyline[i].width;
+    }
+  }
+  if (best == m_skyline.size())
+    return false;
+
+  x = m_skyline[best].x;
+  y = bestBottom - height;
+
+  // raise the skyline where the rectangle went, cutting back the segments it covers
+  Segment segment = { x, bestBottom, width };
+  m_skyline.insert(m_skyline.begin() + best, segment);
+  for (size_t i = best + 1; i < m_skyline.size(); )
+  {
+    Segment &next = m_skyline[i];
+    if (next.x >= x + width)
+      break;
+    unsigned int covered = x + width - next.x;
+    if (next.width > covered)
+    {
+      next.x += covered;
+      next.width -= covered;
+      break;
+    }
+    m_skyline.erase(m_skyline.begin() + i);
+  }
+
+  // merge neighbours at the same height
+  for (size_t i = 0; i + 1 < m_skyline.size(); )
+  {
+    if (m_skyline[i].y == m_skyline[i + 1].y)
+    {
+      m_skyline[i].width += m_skyline[i + 1].width;
+      m_skyline.erase(m_skyline.begin() + i + 1);
+    }
+    else
+      i++;
+  }
+
+  m_height = std::max(m_height, bestBottom);
+  return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stddef.h>
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Packs glyph rectangles into a texture of fixed width using a skyline.
+
+ The skyline is the top edge of the area already in use, kept as a list of horizontal
+ segments. A new rectangle goes where it ends up lowest, so glyphs of different heights
+ fill the gaps rows of equally sized cells would leave. Rectangles never move once placed,
+ so the texture only has to grow downwards when the atlas gets taller.
+ */
+class CGUIFontAtlas
+{
+public:
+  CGUIFontAtlas();
+
+  /*! \brief forget all rectangles and start over with an empty atlas of the given width */
+  void Reset(unsigned int width);
+
+  /*! \brief find room for a rectangle
+   \param width width of the rectangle
+   \param height height of the rectangle
+   \param maxHeight the height the atlas may grow to
+   \param x [out] left of the rectangle
+   \param y [out] top of the rectangle
+   \return false if the rectangle doesn't fit within maxHeight
+   */
+  bool Allocate(unsigned int width, unsigned int height, unsigned int maxHeight, unsigned int &x, unsigned int &y);
+
+  /*! \brief the height of the atlas, i.e. the bottom of the lowest rectangle */
+  unsigned int GetHeight() const { return m_height; }
+
+  unsigned int GetWidth() const { return m_width; }
+
+private:
+  struct Segment
+  {
+    unsigned int x, y, width;
+  };
+
+  /*! \brief the top a rectangle would have when placed at the start of segment i, false if it doesn't fit */
+  bool Fit(size_t i, unsigned int width, unsigned int &y) const;
+
+  std::vector<Segment> m_skyline;
+  unsigned int m_width;
+  unsigned int m_height;
+};
@@ -40,6 +40,9 @@
 
 using namespace std;
 
+// characters rendered ahead of time per font, latin-1 included
+#define MAX_PRECACHE_CHARACTERS 512
+
 GUIFontManager::GUIFontManager(void)
 {
   m_canReload = true;
@@ -155,6 +158,8 @@ CGUIFont* GUIFontManager::LoadTTF(const std::string& strFontName, const std::str
   // font file is loaded, create our CGUIFont
   CGUIFont *pNewFont = new CGUIFont(strFontName, iStyle, textColor, shadowColor, lineSpacing, (float)iSize, pFontFile);
   m_vecFonts.push_back(pNewFont);
+  if (!m_precacheCharacters.empty())
+    pNewFont->PrecacheGlyphs(m_precacheCharacters);
 
   // Store the original TTF font info in case we need to reload it in a different resolution
   OrigFontInfo fontInfo;
@@ -236,7 +241,33 @@ void GUIFontManager::ReloadTTFFonts(void)
     }
 
     font->SetFont(pFontFile);
+    if (!m_precacheCharacters.empty())
+      font->PrecacheGlyphs(m_precacheCharacters);
+  }
+}
+
+void GUIFontManager::PrecacheGlyphs(const std::wstring &characters)
+{
+  // latin-1 has the digits and punctuation and covers most western languages
+  m_precacheCharacters.clear();
+  for (wchar_t c = 0x20; c <= 0xff; c++)
+  {
+    if (c < 0x7f || c >= 0xa0)
+      m_precacheCharacters += c;
+  }
+  for (std::wstring::const_iterator i = characters.begin(); i != characters.end(); ++i)
+  {
+    if (*i <= 0xff)
+      continue;
+    if (m_precacheCharacters.size() >= MAX_PRECACHE_CHARACTERS)
+    {
+      CLog::Log(LOGDEBUG, "GUIFontManager::PrecacheGlyphs - leaving %u characters for when they're shown", (unsigned int)(characters.end() - i));
+      break;
+    }
+    m_precacheCharacters += *i;
   }
+  for (vector<CGUIFont*>::iterator i = m_vecFonts.begin(); i != m_vecFonts.end(); ++i)
+    (*i)->PrecacheGlyphs(m_precacheCharacters);
 }
 
 void GUIFontManager::Unload(const std::string& strFontName)
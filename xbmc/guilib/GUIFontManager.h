@@ -76,6 +76,13 @@ public:
   void Clear();
   void FreeFontFile(CGUIFontTTFBase *pFont);
 
+  /*! \brief render latin-1 and the given characters in all our fonts in the background, so that text
+   using them doesn't have to wait for them when it's first shown. Fonts loaded later on get them too.
+   \param characters the characters to render, typically those of the skin's labels. Only the first
+   ones are rendered if there are too many of them.
+   */
+  void PrecacheGlyphs(const std::wstring &characters);
+
   static void SettingOptionsFontsFiller(const CSetting *setting, std::vector< std::pair<std::string, std::string> > &list, std::string &current, void *data);
 
 protected:
@@ -88,6 +95,7 @@ protected:
   std::vector<CGUIFont*> m_vecFonts;
   std::vector<CGUIFontTTFBase*> m_vecFontFiles;
   std::vector<OrigFontInfo> m_vecFontInfo;
+  std::wstring m_precacheCharacters;
   RESOLUTION_INFO m_skinResolution;
   bool m_canReload;
 };
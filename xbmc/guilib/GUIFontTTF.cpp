@@ -29,9 +29,14 @@
 #include "windowing/WindowingFactory.h"
 #include "URL.h"
 #include "filesystem/File.h"
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
 #include "boost/make_shared.hpp"
 
+#include <algorithm>
+#include <iterator>
 #include <math.h>
 
 // stuff for freetype
@@ -52,6 +57,7 @@ using namespace std;
 
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
+#define GLYPHS_PER_JOB 128    // characters rendered by each background job
 
 
 class CFreeTypeLibrary
@@ -79,6 +85,11 @@ public:
       return NULL;
     }
 
+    return OpenFace(m_library, filename, size, aspect, memoryBuf);
+  }
+
+  static FT_Face OpenFace(FT_Library library, const std::string &filename, float size, float aspect, XUTILS::auto_buffer& memoryBuf)
+  {
     FT_Face face;
 
     // ok, now load the font face
@@ -97,11 +108,11 @@ public:
       XFILE::CFile f;
       if (f.LoadFile(realFile, memoryBuf) <= 0)
         return NULL;
-      if (FT_New_Memory_Face(m_library, (const FT_Byte*)memoryBuf.get(), memoryBuf.size(), 0, &face) != 0)
+      if (FT_New_Memory_Face(library, (const FT_Byte*)memoryBuf.get(), memoryBuf.size(), 0, &face) != 0)
         return NULL;
     }
 #ifndef TARGET_WINDOWS
-    else if (FT_New_Face( m_library, realFile.GetFileName().c_str(), 0, &face ))
+    else if (FT_New_Face( library, realFile.GetFileName().c_str(), 0, &face ))
       return NULL;
 #endif // ! TARGET_WINDOWS
 
@@ -152,24 +163,96 @@ private:
 XBMC_GLOBAL_REF(CFreeTypeLibrary, g_freeTypeLibrary); // our freetype library
 #define g_freeTypeLibrary XBMC_GLOBAL_USE(CFreeTypeLibrary)
 
+/*!
+ \brief Renders glyphs for a font on a job manager thread.
+ Freetype objects can't be used from more than one thread, so the job opens the font again
+ with a library of its own. The glyphs are handed over to the font as bitmaps, which it copies
+ to its texture the next time it's used.
+ */
+class CGUIFontRasterizeJob : public CJob
+{
+public:
+  CGUIFontRasterizeJob(const boost::shared_ptr<CGUIFontTTFBase::CRasterizedGlyphs> &output, const std::string &filename,
+                       float height, float aspect, int borderStrength, const vecText &characters)
+    : m_output(output), m_filename(filename), m_height(height), m_aspect(aspect),
+      m_borderStrength(borderStrength), m_characters(characters)
+  {
+  }
+
+  virtual const char *GetType() const { return "fontrasterize"; }
+
+  virtual bool DoWork()
+  {
+    std::vector<SGlyphBitmap> glyphs;
+    FT_Library library = NULL;
+    if (FT_Init_FreeType(&library) == 0)
+    {
+      XUTILS::auto_buffer memoryBuf;
+      FT_Face face = CFreeTypeLibrary::OpenFace(library, m_filename, m_height, m_aspect, memoryBuf);
+      if (face)
+      {
+        FT_Stroker stroker = NULL;
+        if (m_borderStrength && FT_Stroker_New(library, &stroker) == 0)
+          FT_Stroker_Set(stroker, m_borderStrength, FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
+
+        glyphs.reserve(m_characters.size());
+        for (vecText::const_iterator i = m_characters.begin(); i != m_characters.end() && !IsCancelled(); ++i)
+        {
+          glyphs.push_back(SGlyphBitmap());
+          if (!CGUIFontTTFBase::RasterizeGlyph(face, stroker, (wchar_t)(*i & 0xffff), *i >> 16, glyphs.back()))
+            glyphs.pop_back();
+        }
+
+        if (stroker)
+          FT_Stroker_Done(stroker);
+        FT_Done_Face(face);
+      }
+      FT_Done_FreeType(library);
+    }
+
+    CSingleLock lock(m_output->lock);
+    if (!m_output->cancelled)
+      m_output->glyphs.insert(m_output->glyphs.end(), glyphs.begin(), glyphs.end());
+    m_output->completedJobs++;
+    return true;
+  }
+
+private:
+  bool IsCancelled() const
+  {
+    CSingleLock lock(m_output->lock);
+    return m_output->cancelled;
+  }
+
+  boost::shared_ptr<CGUIFontTTFBase::CRasterizedGlyphs> m_output;
+  std::string m_filename;
+  float m_height;
+  float m_aspect;
+  int m_borderStrength;
+  vecText m_characters;   // (style << 16) | letter
+};
+
 CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache(*this), m_dynamicCache(*this)
 {
   m_texture = NULL;
   m_char = NULL;
   m_maxChars = 0;
   m_nestedBeginCount = 0;
+  m_batchRenderer = NULL;
 
   m_vertex.reserve(4*1024);
 
   m_face = NULL;
   m_stroker = NULL;
+  m_aspect = 1.0f;
+  m_borderStrength = 0;
+  m_rasterized.reset(new CRasterizedGlyphs);
   memset(m_charquick, 0, sizeof(m_charquick));
   m_strFileName = strFileName;
   m_referenceCount = 0;
   m_originX = m_originY = 0.0f;
   m_cellBaseLine = m_cellHeight = 0;
   m_numChars = 0;
-  m_posX = m_posY = 0;
   m_textureHeight = m_textureWidth = 0;
   m_textureScaleX = m_textureScaleY = 0.0;
   m_ellipsesWidth = m_height = 0.0f;
@@ -198,6 +281,9 @@ void CGUIFontTTFBase::RemoveReference()
 
 void CGUIFontTTFBase::ClearCharacterCache()
 {
+  // queued text still refers to the glyphs in our texture
+  g_graphicsContext.FlushBatch();
+
   delete(m_texture);
 
   DeleteHardwareTexture();
@@ -208,9 +294,8 @@ void CGUIFontTTFBase::ClearCharacterCache()
   memset(m_charquick, 0, sizeof(m_charquick));
   m_numChars = 0;
   m_maxChars = CHAR_CHUNK;
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  // our texture will be created on first character write.
+  m_atlas.Reset(m_textureWidth);
   m_textureHeight = 0;
 }
 
@@ -223,9 +308,20 @@ void CGUIFontTTFBase::Clear()
   m_char = NULL;
   m_maxChars = 0;
   m_numChars = 0;
-  m_posX = 0;
-  m_posY = 0;
+  m_atlas.Reset(0);
   m_nestedBeginCount = 0;
+  m_batchRenderer = NULL;
+
+  // jobs still running hand their glyphs to the old list, which goes with the last of them
+  {
+    CSingleLock lock(m_rasterized->lock);
+    m_rasterized->cancelled = true;
+  }
+  for (std::vector<unsigned int>::const_iterator i = m_rasterizeJobs.begin(); i != m_rasterizeJobs.end(); ++i)
+    CJobManager::GetInstance().CancelJob(*i);
+  m_rasterizeJobs.clear();
+  m_rasterizeRequested.clear();
+  m_rasterized.reset(new CRasterizedGlyphs);
 
   if (m_face)
     g_freeTypeLibrary.ReleaseFont(m_face);
@@ -287,6 +383,7 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
     m_stroker = g_freeTypeLibrary.GetStroker();
     if (m_stroker)
       FT_Stroker_Set(m_stroker, strength, FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
+    m_borderStrength = (int)strength;
   }
 
   // scale to pixel sizing, rounding so that maximal extent is obtained
@@ -298,6 +395,7 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
   m_cellHeight   = cellAscender - cellDescender;
 
   m_height = height;
+  m_aspect = aspect;
 
   delete(m_texture);
   m_texture = NULL;
@@ -318,9 +416,8 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
     m_textureWidth = g_Windowing.GetMaxTextureSize();
   m_textureScaleX = 1.0f / m_textureWidth;
 
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  // our texture will be created on first character write.
+  m_atlas.Reset(m_textureWidth);
 
   // cache the ellipses width
   Character *ellipse = GetCharacter(L'.');
@@ -331,10 +428,19 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
 
 void CGUIFontTTFBase::Begin()
 {
-  if (m_nestedBeginCount == 0 && m_texture != NULL && FirstBegin())
+  // glyphs rendered in the background can only go into the texture outside of a Begin(), End() block
+  if (m_nestedBeginCount == 0)
+    InstallRasterizedGlyphs();
+
+  if (m_nestedBeginCount == 0 && m_texture != NULL)
   {
-    m_vertexTrans.clear();
-    m_vertex.clear();
+    // batched text is drawn by the graphics context, which brings our texture up to date first
+    m_batchRenderer = CGUIQuadBatcher::IsEnabled() ? GetBatchRenderer() : NULL;
+    if (m_batchRenderer || g_Windowing.IsHeadless() || FirstBegin())
+    {
+      m_vertexTrans.clear();
+      m_vertex.clear();
+    }
   }
   // Keep track of the nested begin/end calls.
   m_nestedBeginCount++;
@@ -348,7 +454,34 @@ void CGUIFontTTFBase::End()
   if (--m_nestedBeginCount > 0)
     return;
 
-  LastEnd();
+  if (m_batchRenderer)
+  {
+    g_Windowing.AddVertices(m_vertex.size());
+    if (m_vertex.empty())
+      return;
+
+    m_batchVertices.resize(m_vertex.size());
+    for (size_t i = 0; i < m_vertex.size(); i++)
+    {
+      const SVertex &in = m_vertex[i];
+      GUIQuadVertex &out = m_batchVertices[i];
+      out.x = in.x; out.y = in.y; out.z = in.z;
+      out.u1 = in.u; out.v1 = in.v;
+      out.u2 = out.v2 = 0;
+      out.r = in.r; out.g = in.g; out.b = in.b; out.a = in.a;
+    }
+    g_graphicsContext.GetQuadBatcher().AddQuads(m_batchRenderer, this, NULL, &m_batchVertices[0], m_vertex.size() / 4);
+    return;
+  }
+
+  // software clipped vertices go out in one call, each translated buffer in its own
+  if (!m_vertex.empty())
+    g_Windowing.AddDrawCall(m_vertex.size());
+  for (size_t i = 0; i < m_vertexTrans.size(); i++)
+    g_Windowing.AddDrawCall(m_vertexTrans[i].vertexBuffer->size * 4);
+
+  if (!g_Windowing.IsHeadless())
+    LastEnd();
 }
 
 void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors, const vecText &text, uint32_t alignment, float maxPixelWidth, bool scrolling)
@@ -565,11 +698,6 @@ float CGUIFontTTFBase::GetLineHeight(float lineSpacing) const
 
 const unsigned int CGUIFontTTFBase::spacing_between_characters_in_texture = 1;
 
-unsigned int CGUIFontTTFBase::GetTextureLineHeight() const
-{
-  return m_cellHeight + spacing_between_characters_in_texture;
-}
-
 CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
 {
   wchar_t letter = (wchar_t)(chr & 0xffff);
@@ -590,60 +718,67 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   // letters are stored based on style and letter
   character_t ch = (style << 16) | letter;
 
-  int low = 0;
-  int high = m_numChars - 1;
-  while (low <= high)
-  {
-    int mid = (low + high) >> 1;
-    if (ch > m_char[mid].letterAndStyle)
-      low = mid + 1;
-    else if (ch < m_char[mid].letterAndStyle)
-      high = mid - 1;
-    else
-      return &m_char[mid];
-  }
-  // if we get to here, then low is where we should insert the new character
+  int index;
+  if (FindCharacter(ch, index))
+    return &m_char[index];
 
-  // increase the size of the buffer if we need it
-  if (m_numChars >= m_maxChars)
-  { // need to increase the size of the buffer
-    Character *newTable = new Character[m_maxChars + CHAR_CHUNK];
-    if (m_char)
-    {
-      memcpy(newTable, m_char, low * sizeof(Character));
-      memcpy(newTable + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-      delete[] m_char;
-    }
-    m_char = newTable;
-    m_maxChars += CHAR_CHUNK;
-
-  }
-  else
-  { // just move the data along as necessary
-    memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-  }
   // render the character to our texture
   // must End() as we can't render text to our texture during a Begin(), End() block
   unsigned int nestedBeginCount = m_nestedBeginCount;
   m_nestedBeginCount = 1;
   if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
-  { // unable to cache character - try clearing them all out and starting over
-    CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
-    ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
+
+  Character *character = NULL;
+  // glyphs rendered in the background only need copying, ours may be amongst them
+  if (InstallRasterizedGlyphs() && FindCharacter(ch, index))
+    character = &m_char[index];
+  else
+  {
+    std::vector<SGlyphBitmap> glyphs(1);
+    if (RasterizeGlyph(m_face, m_stroker, letter, style, glyphs[0]))
     {
-      CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
-      if (nestedBeginCount) Begin();
-      m_nestedBeginCount = nestedBeginCount;
-      return NULL;
+      if (!CacheGlyphs(glyphs, g_Windowing.GetMaxTextureSize()))
+      { // unable to cache character - try clearing them all out and starting over
+        CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
+        ClearCharacterCache();
+        if (!CacheGlyphs(glyphs, g_Windowing.GetMaxTextureSize()))
+          CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
+      }
+      if (FindCharacter(ch, index))
+        character = &m_char[index];
     }
   }
+
   if (nestedBeginCount) Begin();
   m_nestedBeginCount = nestedBeginCount;
 
-  // fixup quick access
+  return character;
+}
+
+bool CGUIFontTTFBase::FindCharacter(character_t letterAndStyle, int &index) const
+{
+  int low = 0;
+  int high = m_numChars - 1;
+  while (low <= high)
+  {
+    int mid = (low + high) >> 1;
+    if (letterAndStyle > m_char[mid].letterAndStyle)
+      low = mid + 1;
+    else if (letterAndStyle < m_char[mid].letterAndStyle)
+      high = mid - 1;
+    else
+    {
+      index = mid;
+      return true;
+    }
+  }
+  // if we get to here, then low is where we should insert the new character
+  index = low;
+  return false;
+}
+
+void CGUIFontTTFBase::UpdateQuickAccess()
+{
   memset(m_charquick, 0, sizeof(m_charquick));
   for(int i=0;i<m_numChars;i++)
   {
@@ -653,34 +788,32 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
       m_charquick[ch] = m_char+i;
     }
   }
-
-  return m_char + low;
 }
 
-bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
+bool CGUIFontTTFBase::RasterizeGlyph(FT_Face face, FT_Stroker stroker, wchar_t letter, uint32_t style, SGlyphBitmap &result)
 {
-  int glyph_index = FT_Get_Char_Index( m_face, letter );
+  int glyph_index = FT_Get_Char_Index( face, letter );
 
   FT_Glyph glyph = NULL;
-  if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
+  if (FT_Load_Glyph( face, glyph_index, FT_LOAD_TARGET_LIGHT ))
   {
     CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, letter);
     return false;
   }
   // make bold if applicable
   if (style & FONT_STYLE_BOLD)
-    EmboldenGlyph(m_face->glyph);
+    EmboldenGlyph(face, face->glyph);
   // and italics if applicable
   if (style & FONT_STYLE_ITALICS)
-    ObliqueGlyph(m_face->glyph);
+    ObliqueGlyph(face->glyph);
   // grab the glyph
-  if (FT_Get_Glyph(m_face->glyph, &glyph))
+  if (FT_Get_Glyph(face->glyph, &glyph))
   {
     CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, letter);
     return false;
   }
-  if (m_stroker)
-    FT_Glyph_StrokeBorder(&glyph, m_stroker, 0, 1);
+  if (stroker)
+    FT_Glyph_StrokeBorder(&glyph, stroker, 0, 1);
   // render the glyph
   if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
   {
@@ -689,82 +822,200 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   }
   FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
   FT_Bitmap bitmap = bitGlyph->bitmap;
-  bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
 
-  if (!isEmptyGlyph)
+  result.letterAndStyle = (style << 16) | letter;
+  result.left = bitGlyph->left;
+  result.top = bitGlyph->top;
+  result.advance = (float)MathUtils::round_int( (float)face->glyph->advance.x / 64 );
+  result.width = bitmap.width;
+  result.rows = bitmap.rows;
+  result.pixels.resize(bitmap.width * bitmap.rows);
+  const unsigned char *source = bitmap.buffer;
+  for (unsigned int y = 0; y < (unsigned int)bitmap.rows; y++)
   {
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
+    memcpy(&result.pixels[y * bitmap.width], source, bitmap.width);
+    source += bitmap.pitch;
+  }
 
-    // check we have enough room for the character
-    if (m_posX + bitGlyph->left + bitmap.width > (int)m_textureWidth)
-    { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
-      m_posX = 0;
-      m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
+  // free the glyph
+  FT_Done_Glyph(glyph);
 
-      if(m_posY + GetTextureLineHeight() >= m_textureHeight)
-      {
-        // create the new larger texture
-        unsigned int newHeight = m_posY + GetTextureLineHeight();
-        // check for max height
-        if (newHeight > g_Windowing.GetMaxTextureSize())
-        {
-          CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, g_Windowing.GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
-          return false;
-        }
+  return true;
+}
 
-        CBaseTexture* newTexture = NULL;
-        newTexture = ReallocTexture(newHeight);
-        if(newTexture == NULL)
-        {
-          FT_Done_Glyph(glyph);
-          CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
-          return false;
-        }
-        m_texture = newTexture;
+bool CGUIFontTTFBase::CacheGlyphs(const std::vector<SGlyphBitmap> &glyphs, unsigned int maxTextureHeight)
+{
+  // find room for all of them first, so that the texture grows at most once
+  std::vector<Character> characters;
+  std::vector<const SGlyphBitmap*> bitmaps;
+  bool cachedAll = true;
+  bool hasPixels = false; // empty glyphs such as a space need no texture
+  for (std::vector<SGlyphBitmap>::const_iterator i = glyphs.begin(); i != glyphs.end(); ++i)
+  {
+    int index;
+    if (FindCharacter(i->letterAndStyle, index))
+      continue;
+
+    unsigned int x = 0, y = 0;
+    if (i->width && i->rows)
+    { // keep some space around each character so that filtering doesn't pick up its neighbours
+      if (!m_atlas.Allocate(i->width + spacing_between_characters_in_texture, i->rows + spacing_between_characters_in_texture,
+                            maxTextureHeight, x, y))
+      {
+        cachedAll = false;
+        break;
       }
+      hasPixels = true;
     }
 
-    if(m_texture == NULL)
+    // set the character in our table
+    Character ch;
+    ch.letterAndStyle = i->letterAndStyle;
+    ch.offsetX = (short)i->left;
+    ch.offsetY = (short)m_cellBaseLine - i->top;
+    ch.left = (float)x;
+    ch.top = (float)y;
+    ch.right = ch.left + i->width;
+    ch.bottom = ch.top + i->rows;
+    ch.advance = i->advance;
+    characters.push_back(ch);
+    bitmaps.push_back(&*i);
+  }
+  if (characters.empty())
+    return cachedAll;
+
+  if (m_atlas.GetHeight() > m_textureHeight)
+  {
+    // at least double the height, so that a growing cache doesn't reallocate for every few characters
+    unsigned int newHeight = std::max(m_atlas.GetHeight(), std::min(m_textureHeight * 2, g_Windowing.GetMaxTextureSize()));
+
+    // the texture coordinates of queued text change with the texture height
+    g_graphicsContext.FlushBatch();
+
+    CBaseTexture* newTexture = ReallocTexture(newHeight);
+    if (newTexture == NULL)
     {
-      FT_Done_Glyph(glyph);
-      CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
+      CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
       return false;
     }
+    m_texture = newTexture;
+  }
+
+  if (m_texture == NULL && hasPixels)
+  {
+    CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
+    return false;
   }
-  // set the character in our table
-  ch->letterAndStyle = (style << 16) | letter;
-  ch->offsetX = (short)bitGlyph->left;
-  ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
-  ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
-  ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
-  ch->right = ch->left + bitmap.width;
-  ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
 
   // we need only render if we actually have some pixels
-  if (!isEmptyGlyph)
+  for (size_t i = 0; i < characters.size(); i++)
   {
+    const SGlyphBitmap &glyph = *bitmaps[i];
+    if (!glyph.width || !glyph.rows)
+      continue;
+
     // ensure our rect will stay inside the texture (it *should* but we need to be certain)
-    unsigned int x1 = max(m_posX + ch->offsetX, 0);
-    unsigned int y1 = max(m_posY + ch->offsetY, 0);
-    unsigned int x2 = min(x1 + bitmap.width, m_textureWidth);
-    unsigned int y2 = min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
-  
-    m_posX += spacing_between_characters_in_texture + (unsigned short)max(ch->right - ch->left + ch->offsetX, ch->advance);
+    unsigned int x1 = (unsigned int)characters[i].left;
+    unsigned int y1 = (unsigned int)characters[i].top;
+    unsigned int x2 = min(x1 + glyph.width, m_textureWidth);
+    unsigned int y2 = min(y1 + glyph.rows, m_textureHeight);
+    CopyCharToTexture(glyph, x1, y1, x2, y2);
   }
-  m_numChars++;
 
-  // free the glyph
-  FT_Done_Glyph(glyph);
+  // merge the new characters into our table, working backwards so that it can be done in place
+  std::sort(characters.begin(), characters.end());
+  int numChars = m_numChars + (int)characters.size();
+  if (numChars > m_maxChars)
+  { // need to increase the size of the buffer
+    int maxChars = (numChars + CHAR_CHUNK - 1) / CHAR_CHUNK * CHAR_CHUNK;
+    Character *newTable = new Character[maxChars];
+    if (m_char)
+    {
+      memcpy(newTable, m_char, m_numChars * sizeof(Character));
+      delete[] m_char;
+    }
+    m_char = newTable;
+    m_maxChars = maxChars;
+  }
+  int from = m_numChars - 1;
+  int to = numChars - 1;
+  for (int added = (int)characters.size() - 1; added >= 0; to--)
+  {
+    if (from >= 0 && characters[added] < m_char[from])
+      m_char[to] = m_char[from--];
+    else
+      m_char[to] = characters[added--];
+  }
+  m_numChars = numChars;
+
+  // fixup quick access
+  UpdateQuickAccess();
+
+  return cachedAll;
+}
+
+bool CGUIFontTTFBase::InstallRasterizedGlyphs()
+{
+  if (m_rasterizeJobs.empty())
+    return false;
 
+  std::vector<SGlyphBitmap> glyphs;
+  {
+    CSingleLock lock(m_rasterized->lock);
+    glyphs.swap(m_rasterized->glyphs);
+    if (m_rasterized->completedJobs == m_rasterizeJobs.size())
+    { // that was the last of them
+      m_rasterized->completedJobs = 0;
+      m_rasterizeJobs.clear();
+      m_rasterizeRequested.clear();
+    }
+  }
+  if (glyphs.empty())
+    return false;
+
+  // leave room for characters that turn up later, they'd clear the cache if it were full
+  CacheGlyphs(glyphs, g_Windowing.GetMaxTextureSize() / 2);
   return true;
 }
 
+void CGUIFontTTFBase::PrecacheGlyphs(const vecText &characters)
+{
+  if (!m_face)
+    return;
+
+  // the characters we don't have yet, stored as (style << 16) | letter as in our table
+  vecText missing;
+  for (vecText::const_iterator i = characters.begin(); i != characters.end(); ++i)
+  {
+    wchar_t letter = (wchar_t)(*i & 0xffff);
+    character_t style = (*i & 0x3000000) >> 24;
+    int index;
+    if (letter != L'\r' && !FindCharacter((style << 16) | letter, index))
+      missing.push_back((style << 16) | letter);
+  }
+  std::sort(missing.begin(), missing.end());
+  missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+
+  // and that aren't on their way already
+  vecText request;
+  std::set_difference(missing.begin(), missing.end(), m_rasterizeRequested.begin(), m_rasterizeRequested.end(), std::back_inserter(request));
+  if (request.empty())
+    return;
+
+  vecText requested;
+  std::set_union(m_rasterizeRequested.begin(), m_rasterizeRequested.end(), request.begin(), request.end(), std::back_inserter(requested));
+  m_rasterizeRequested.swap(requested);
+
+  // split them up so that the job manager renders them on several threads
+  for (size_t start = 0; start < request.size(); start += GLYPHS_PER_JOB)
+  {
+    vecText chunk(request.begin() + start, request.begin() + std::min(start + GLYPHS_PER_JOB, request.size()));
+    CJob *job = new CGUIFontRasterizeJob(m_rasterized, m_strFilename, m_height, m_aspect, m_borderStrength, chunk);
+    m_rasterizeJobs.push_back(CJobManager::GetInstance().AddJob(job, NULL));
+  }
+  CLog::Log(LOGDEBUG, "%s: rendering %u characters of %s in the background", __FUNCTION__, (unsigned int)request.size(), m_strFileName.c_str());
+}
+
 void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX, std::vector<SVertex> &vertices)
 {
   // actual image width isn't same as the character width as that is
@@ -927,14 +1178,14 @@ void CGUIFontTTFBase::ObliqueGlyph(FT_GlyphSlot slot)
 
 
 // Embolden code - original taken from freetype2 (ftsynth.c)
-void CGUIFontTTFBase::EmboldenGlyph(FT_GlyphSlot slot)
+void CGUIFontTTFBase::EmboldenGlyph(FT_Face face, FT_GlyphSlot slot)
 {
   if ( slot->format != FT_GLYPH_FORMAT_OUTLINE )
     return;
 
   /* some reasonable strength */
-  FT_Pos strength = FT_MulFix( m_face->units_per_EM,
-                    m_face->size->metrics.y_scale ) / 24;
+  FT_Pos strength = FT_MulFix( face->units_per_EM,
+                    face->size->metrics.y_scale ) / 24;
 
   FT_BBox bbox_before, bbox_after;
   FT_Outline_Get_CBox( &slot->outline, &bbox_before );
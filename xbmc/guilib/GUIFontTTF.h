@@ -31,8 +31,12 @@
 #include <stdint.h>
 #include <vector>
 
+#include "boost/shared_ptr.hpp"
+#include "threads/CriticalSection.h"
 #include "utils/auto_buffer.h"
 #include "Geometry.h"
+#include "GUIFontAtlas.h"
+#include "GUIQuadBatcher.h"
 
 // forward definition
 class CBaseTexture;
@@ -71,12 +75,26 @@ struct SVertex
 };
 
 
+/*!
+ \ingroup textures
+ \brief A glyph rendered by freetype, ready to go into the font texture.
+ */
+struct SGlyphBitmap
+{
+  character_t letterAndStyle;      // (style << 16) | letter
+  int left, top;                   // offset of the bitmap from the pen position, top is above the base line
+  float advance;
+  unsigned int width, rows;
+  std::vector<unsigned char> pixels; // width * rows, 8bit alpha
+};
+
 #include "GUIFontCache.h"
 
 
 class CGUIFontTTFBase
 {
   friend class CGUIFont;
+  friend class CGUIFontRasterizeJob;
 
 public:
 
@@ -102,10 +120,16 @@ protected:
     float left, top, right, bottom;
     float advance;
     character_t letterAndStyle;
+    bool operator<(const Character &right) const { return letterAndStyle < right.letterAndStyle; }
   };
   void AddReference();
   void RemoveReference();
 
+  /*! \brief have the given characters rendered by the job manager, ready to be used by the time they're drawn.
+   Characters already cached are skipped. Must be called from the thread that renders with this font.
+   */
+  void PrecacheGlyphs(const vecText &characters);
+
   float GetTextWidthInternal(vecText::const_iterator start, vecText::const_iterator end);
   float GetCharWidthInternal(character_t ch);
   float GetTextHeight(float lineSpacing, int numLines) const;
@@ -121,29 +145,30 @@ protected:
 
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
-  bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  bool FindCharacter(character_t letterAndStyle, int &index) const;
+  static bool RasterizeGlyph(FT_Face face, FT_Stroker stroker, wchar_t letter, uint32_t style, SGlyphBitmap &glyph);
+  bool CacheGlyphs(const std::vector<SGlyphBitmap> &glyphs, unsigned int maxTextureHeight);
+  bool InstallRasterizedGlyphs();
+  void UpdateQuickAccess();
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
 
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
-  virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
+  virtual bool CopyCharToTexture(const SGlyphBitmap &glyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
   virtual void DeleteHardwareTexture() = 0;
+  /*! \brief renderer for text queued on the graphics context, NULL if the backend can't draw batches */
+  virtual GUIQuadRenderFunc GetBatchRenderer() const { return NULL; }
 
   // modifying glyphs
-  void EmboldenGlyph(FT_GlyphSlot slot);
+  static void EmboldenGlyph(FT_Face face, FT_GlyphSlot slot);
   static void ObliqueGlyph(FT_GlyphSlot slot);
 
   CBaseTexture* m_texture;        // texture that holds our rendered characters (8bit alpha only)
 
   unsigned int m_textureWidth;       // width of our texture
   unsigned int m_textureHeight;      // heigth of our texture
-  int m_posX;                        // current position in the texture
-  int m_posY;
+  CGUIFontAtlas m_atlas;             // where the characters are in the texture
 
-  /*! \brief the height of each line in the texture.
-   Accounts for spacing between lines to avoid characters overlapping.
-   */
-  unsigned int GetTextureLineHeight() const;
   static const unsigned int spacing_between_characters_in_texture;
 
   color_t m_color;
@@ -163,6 +188,23 @@ protected:
   // freetype stuff
   FT_Face    m_face;
   FT_Stroker m_stroker;
+  float      m_aspect;
+  int        m_borderStrength;   // in 26.6 fixed point, 0 without a border
+
+  /*! \brief glyphs rendered by background jobs.
+   Shared with the jobs as they may finish after the font is gone.
+   */
+  struct CRasterizedGlyphs
+  {
+    CRasterizedGlyphs() : completedJobs(0), cancelled(false) {}
+    CCriticalSection lock;
+    std::vector<SGlyphBitmap> glyphs;
+    unsigned int completedJobs;
+    bool cancelled;
+  };
+  boost::shared_ptr<CRasterizedGlyphs> m_rasterized;
+  std::vector<unsigned int> m_rasterizeJobs;  // ids of the jobs we're waiting on
+  vecText m_rasterizeRequested;                // sorted characters the jobs are rendering
 
   float m_originX;
   float m_originY;
@@ -181,6 +223,9 @@ protected:
   std::vector<CTranslatedVertices> m_vertexTrans;
   std::vector<SVertex> m_vertex;
 
+  GUIQuadRenderFunc m_batchRenderer;          // set between Begin() and End() if our text goes to the batcher
+  std::vector<GUIQuadVertex> m_batchVertices;
+
   float    m_textureScaleX;
   float    m_textureScaleY;
 
@@ -91,6 +91,7 @@ bool CGUIFontTTFGL::FirstBegin()
 
   if (m_textureStatus == TEXTURE_UPDATED)
   {
+    g_Windowing.AddTextureUpload((m_updateY2 - m_updateY1) * m_texture->GetPitch());
     glBindTexture(GL_TEXTURE_2D, m_nTexture);
     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_updateY1, m_texture->GetWidth(), m_updateY2 - m_updateY1, GL_ALPHA, GL_UNSIGNED_BYTE,
         m_texture->GetPixels() + m_updateY1 * m_texture->GetPitch());
@@ -146,6 +147,39 @@ bool CGUIFontTTFGL::FirstBegin()
   return true;
 }
 
+#ifdef HAS_GL
+GUIQuadRenderFunc CGUIFontTTFGL::GetBatchRenderer() const
+{
+  return RenderBatch;
+}
+
+void CGUIFontTTFGL::RenderBatch(const CGUIQuadBatch &batch)
+{
+  CGUIFontTTFGL *font = (CGUIFontTTFGL *)batch.m_state;
+  if (!font->FirstBegin())
+    return;
+
+  const GUIQuadVertex *vertices = &batch.m_vertices[0];
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+  glColorPointer   (4, GL_UNSIGNED_BYTE, sizeof(GUIQuadVertex), (const char*)vertices + offsetof(GUIQuadVertex, r));
+  glVertexPointer  (3, GL_FLOAT        , sizeof(GUIQuadVertex), (const char*)vertices + offsetof(GUIQuadVertex, x));
+  glTexCoordPointer(2, GL_FLOAT        , sizeof(GUIQuadVertex), (const char*)vertices + offsetof(GUIQuadVertex, u1));
+  glEnableClientState(GL_COLOR_ARRAY);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  glDrawArrays(GL_QUADS, 0, batch.m_vertices.size());
+  glPopClientAttrib();
+
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glDisable(GL_TEXTURE_2D);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glDisable(GL_TEXTURE_2D);
+}
+#endif
+
 void CGUIFontTTFGL::LastEnd()
 {
 #ifdef HAS_GL
@@ -335,17 +369,15 @@ CBaseTexture* CGUIFontTTFGL::ReallocTexture(unsigned int& newHeight)
   return newTexture;
 }
 
-bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+bool CGUIFontTTFGL::CopyCharToTexture(const SGlyphBitmap &glyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
 {
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-
-  unsigned char* source = (unsigned char*) bitmap.buffer;
+  const unsigned char* source = &glyph.pixels[0];
   unsigned char* target = (unsigned char*) m_texture->GetPixels() + y1 * m_texture->GetPitch() + x1;
 
   for (unsigned int y = y1; y < y2; y++)
   {
     memcpy(target, source, x2-x1);
-    source += bitmap.width;
+    source += glyph.width;
     target += m_texture->GetPitch();
   }
   
@@ -45,6 +45,9 @@ public:
 
   virtual bool FirstBegin();
   virtual void LastEnd();
+#ifdef HAS_GL
+  static void RenderBatch(const CGUIQuadBatch &batch);
+#endif
 #if HAS_GLES
   virtual CVertexBuffer CreateVertexBuffer(const std::vector<SVertex> &vertices) const;
   virtual void DestroyVertexBuffer(CVertexBuffer &bufferHandle) const;
@@ -54,8 +57,11 @@ public:
 
 protected:
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight);
-  virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2);
+  virtual bool CopyCharToTexture(const SGlyphBitmap &glyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2);
   virtual void DeleteHardwareTexture();
+#ifdef HAS_GL
+  virtual GUIQuadRenderFunc GetBatchRenderer() const;
+#endif
 
 #if HAS_GLES
 #define ELEMENT_ARRAY_MAX_CHAR_INDEX (1000)
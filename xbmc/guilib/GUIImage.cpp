@@ -170,6 +170,12 @@ void CGUIImage::Process(unsigned int currentTime, CDirtyRegionList &dirtyregions
   CGUIControl::Process(currentTime, dirtyregions);
 }
 
+bool CGUIImage::CanSkipProcess() const
+{
+  // crossfades are timed from frame to frame, so those images keep processing
+  return !m_crossFadeTime && m_texture.IsStatic() && !m_texture.FailedToAlloc();
+}
+
 void CGUIImage::Render()
 {
   if (!IsVisible()) return;
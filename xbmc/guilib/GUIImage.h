@@ -71,6 +71,7 @@ public:
   virtual CGUIImage *Clone() const { return new CGUIImage(*this); };
 
   virtual void Process(unsigned int currentTime, CDirtyRegionList &dirtyregions);
+  virtual bool CanSkipProcess() const;
   virtual void Render();
   virtual void UpdateVisibility(const CGUIListItem *item = NULL);
   virtual bool OnAction(const CAction &action) ;
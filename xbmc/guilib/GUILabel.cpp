@@ -90,15 +90,20 @@ bool CGUILabel::Process(unsigned int currentTime)
 {
   // TODO Add the correct processing
 
-  bool overFlows = (m_renderRect.Width() + 0.5f < m_textLayout.GetTextWidth()); // 0.5f to deal with floating point rounding issues
-  bool renderSolid = (m_color == COLOR_DISABLED);
-
-  if (overFlows && m_scrolling && !renderSolid)
+  if (IsScrolling())
     return m_textLayout.UpdateScrollinfo(m_scrollInfo);
 
   return false;
 }
 
+bool CGUILabel::IsScrolling() const
+{
+  bool overFlows = (m_renderRect.Width() + 0.5f < m_textLayout.GetTextWidth()); // 0.5f to deal with floating point rounding issues
+  bool renderSolid = (m_color == COLOR_DISABLED);
+
+  return overFlows && m_scrolling && !renderSolid;
+}
+
 void CGUILabel::Render()
 {
   color_t color = GetColor();
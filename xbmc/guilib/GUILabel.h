@@ -103,6 +103,11 @@ public:
    */
   bool Process(unsigned int currentTime);
 
+  /*! \brief Check whether the label is scrolling its text
+   \return true if the text overflows the label and scrolls, which Process() has to keep updating
+   */
+  bool IsScrolling() const;
+
   /*! \brief Render the label on screen
    */
   void Render();
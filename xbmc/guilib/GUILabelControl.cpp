@@ -142,6 +142,11 @@ CRect CGUILabelControl::CalcRenderRegion() const
   return m_label.GetRenderRect();
 }
 
+bool CGUILabelControl::CanSkipProcess() const
+{
+  return !m_label.IsScrolling();
+}
+
 void CGUILabelControl::Render()
 {
   m_label.Render();
@@ -0,0 +1,138 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "GUIQuadBatcher.h"
+#include "settings/AdvancedSettings.h"
+#include "windowing/WindowingFactory.h"
+
+#include <float.h>
+
+// how many batches back we look for one to merge a quad into.
+// Bounds the cost of queueing a quad when many small textures (thumbs) are on screen.
+#define MAX_BATCH_LOOKBACK 32
+
+CGUIQuadBatch::CGUIQuadBatch()
+{
+  m_render = NULL;
+  m_state = NULL;
+  m_diffuse = NULL;
+}
+
+void CGUIQuadBatch::Reset(GUIQuadRenderFunc render, void *state, CBaseTexture *diffuse)
+{
+  m_render = render;
+  m_state = state;
+  m_diffuse = diffuse;
+  m_bounds = CRect();
+  m_vertices.clear();
+}
+
+bool CGUIQuadBatch::Matches(GUIQuadRenderFunc render, void *state, CBaseTexture *diffuse) const
+{
+  return m_render == render && m_state == state && m_diffuse == diffuse;
+}
+
+CGUIQuadBatcher::CGUIQuadBatcher()
+{
+  m_used = 0;
+  m_flushing = false;
+}
+
+bool CGUIQuadBatcher::IsEnabled()
+{
+#if defined(HAS_GL)
+  return g_advancedSettings.m_guiBatchRendering;
+#else
+  return false;
+#endif
+}
+
+CGUIQuadBatch *CGUIQuadBatcher::FindBatch(GUIQuadRenderFunc render, void *state, CBaseTexture *diffuse, const CRect &bounds)
+{
+  unsigned int lookback = 0;
+  for (unsigned int i = m_used; i > 0 && lookback < MAX_BATCH_LOOKBACK; i--, lookback++)
+  {
+    CGUIQuadBatch &batch = m_batches[i - 1];
+    if (batch.Matches(render, state, diffuse))
+      return &batch;
+    // the quad has to be drawn after this batch, so it can't move any further forward
+    CRect overlap(batch.m_bounds);
+    if (!overlap.Intersect(bounds).IsEmpty())
+      break;
+  }
+
+  if (m_used == m_batches.size())
+    m_batches.push_back(CGUIQuadBatch());
+  CGUIQuadBatch &batch = m_batches[m_used++];
+  batch.Reset(render, state, diffuse);
+  return &batch;
+}
+
+void CGUIQuadBatcher::AddQuad(GUIQuadRenderFunc render, void *state, CBaseTexture *diffuse, const GUIQuadVertex *vertices)
+{
+  AddQuads(render, state, diffuse, vertices, 1);
+}
+
+void CGUIQuadBatcher::AddQuads(GUIQuadRenderFunc render, void *state, CBaseTexture *diffuse, const GUIQuadVertex *vertices, unsigned int count)
+{
+  if (!count)
+    return;
+
+  CRect bounds(vertices[0].x, vertices[0].y, vertices[0].x, vertices[0].y);
+  for (unsigned int i = 0; i < count * 4; i++)
+  {
+    if (vertices[i].z != 0)
+    { // the camera moves quads that aren't at z = 0, keep them where they are in the draw order
+      bounds = CRect(-FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX);
+      break;
+    }
+    if (vertices[i].x < bounds.x1) bounds.x1 = vertices[i].x;
+    if (vertices[i].x > bounds.x2) bounds.x2 = vertices[i].x;
+    if (vertices[i].y < bounds.y1) bounds.y1 = vertices[i].y;
+    if (vertices[i].y > bounds.y2) bounds.y2 = vertices[i].y;
+  }
+
+  CGUIQuadBatch *batch = FindBatch(render, state, diffuse, bounds);
+  batch->m_bounds.Union(bounds);
+  batch->m_vertices.insert(batch->m_vertices.end(), vertices, vertices + count * 4);
+
+  g_Windowing.AddBatchedQuads(count);
+}
+
+void CGUIQuadBatcher::Flush()
+{
+  // a renderer may end up back here through the graphics context
+  if (m_flushing || !m_used)
+    return;
+
+  m_flushing = true;
+  bool headless = g_Windowing.IsHeadless();
+  for (unsigned int i = 0; i < m_used; i++)
+  {
+    CGUIQuadBatch &batch = m_batches[i];
+    g_Windowing.AddDrawCall();
+    if (!headless && batch.m_render)
+      batch.m_render(batch);
+    batch.m_vertices.clear();
+  }
+  m_used = 0;
+  m_flushing = false;
+}
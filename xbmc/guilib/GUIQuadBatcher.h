@@ -0,0 +1,102 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Geometry.h"
+#include <vector>
+
+class CBaseTexture;
+
+/*!
+ \brief A vertex of a batched quad in final screen coordinates.
+ u1,v1 address the texture, u2,v2 the diffuse texture (if any).
+ */
+struct GUIQuadVertex
+{
+  float x, y, z;
+  float u1, v1;
+  float u2, v2;
+  unsigned char r, g, b, a;
+};
+
+class CGUIQuadBatch;
+
+/*!
+ \brief Draws a batch of quads that share the same render state.
+ Set up by the backend that queued the quads.
+ */
+typedef void (*GUIQuadRenderFunc)(const CGUIQuadBatch &batch);
+
+/*!
+ \brief Quads sharing a renderer, state (texture or font) and diffuse texture.
+ */
+class CGUIQuadBatch
+{
+public:
+  CGUIQuadBatch();
+  void Reset(GUIQuadRenderFunc render, void *state, CBaseTexture *diffuse);
+  bool Matches(GUIQuadRenderFunc render, void *state, CBaseTexture *diffuse) const;
+
+  GUIQuadRenderFunc m_render;
+  void *m_state;
+  CBaseTexture *m_diffuse;
+  CRect m_bounds;
+  std::vector<GUIQuadVertex> m_vertices;
+};
+
+/*!
+ \brief Collects the quads of a render pass and draws them with as few draw calls as possible.
+
+ Quads queued with the same render state are merged into a single batch, even when quads
+ with a different state were queued in between - as long as the quad doesn't overlap any of
+ those, moving it earlier in the draw order can't change what ends up on screen. The search
+ for a matching batch stops at the first overlapping one, which keeps painter's order intact.
+
+ Everything queued has to be drawn before the render state it depends on changes (camera,
+ viewport, scissors) or before anything is drawn past the batcher, see CGraphicContext::FlushBatch().
+ */
+class CGUIQuadBatcher
+{
+public:
+  CGUIQuadBatcher();
+
+  /*! \brief whether quads should be queued here rather than drawn straight away.
+   Controlled by <gui><batchrendering> and only available on backends that can draw batches.
+   */
+  static bool IsEnabled();
+
+  /*! \brief queue a quad of 4 vertices (top-left, top-right, bottom-right, bottom-left) */
+  void AddQuad(GUIQuadRenderFunc render, void *state, CBaseTexture *diffuse, const GUIQuadVertex *vertices);
+
+  /*! \brief queue a number of quads, 4 vertices each */
+  void AddQuads(GUIQuadRenderFunc render, void *state, CBaseTexture *diffuse, const GUIQuadVertex *vertices, unsigned int count);
+
+  /*! \brief draw everything queued, in order */
+  void Flush();
+
+  bool IsEmpty() const { return m_used == 0; }
+
+private:
+  CGUIQuadBatch *FindBatch(GUIQuadRenderFunc render, void *state, CBaseTexture *diffuse, const CRect &bounds);
+
+  std::vector<CGUIQuadBatch> m_batches; ///< batches are reused from frame to frame to keep their vertex memory
+  unsigned int m_used;
+  bool m_flushing;
+};
@@ -22,7 +22,9 @@
 #include "GraphicContext.h"
 #include "TextureManager.h"
 #include "GUILargeTextureManager.h"
+#include "Texture.h"
 #include "utils/MathUtils.h"
+#include "windowing/WindowingFactory.h"
 
 using namespace std;
 
@@ -83,6 +85,9 @@ CGUITextureBase::CGUITextureBase(float posX, float posY, float width, float heig
   m_isAllocated = NO;
   m_invalid = true;
   m_use_cache = true;
+
+  m_batchRenderer = NULL;
+  m_batchColor = 0;
 }
 
 CGUITextureBase::CGUITextureBase(const CGUITextureBase &right) :
@@ -120,6 +125,9 @@ CGUITextureBase::CGUITextureBase(const CGUITextureBase &right) :
 
   m_isAllocated = NO;
   m_invalid = true;
+
+  m_batchRenderer = NULL;
+  m_batchColor = 0;
 }
 
 CGUITextureBase::~CGUITextureBase(void)
@@ -183,8 +191,19 @@ void CGUITextureBase::Render()
 
   color = g_graphicsContext.MergeAlpha(color);
 
-  // setup our renderer
-  Begin(color);
+  // setup our renderer. Batched quads are drawn by the graphics context later on,
+  // a headless render system only records what would have been drawn
+  bool headless = g_Windowing.IsHeadless();
+  m_batchRenderer = CGUIQuadBatcher::IsEnabled() ? GetBatchRenderer() : NULL;
+  m_batchColor = color;
+  if (headless || m_batchRenderer)
+  {
+    m_texture.m_textures[m_currentFrame]->LoadToGPU();
+    if (m_diffuse.size())
+      m_diffuse.m_textures[0]->LoadToGPU();
+  }
+  else
+    Begin(color);
 
   // compute the texture coordinates
   float u1, u2, u3, v1, v2, v3;
@@ -235,7 +254,13 @@ void CGUITextureBase::Render()
   }
 
   // close off our renderer
-  End();
+  if (!m_batchRenderer)
+  {
+    if (!headless)
+      End();
+    g_Windowing.AddDrawCall();
+  }
+  m_batchRenderer = NULL;
 
   if (m_vertex.Width() > m_width || m_vertex.Height() > m_height)
     g_graphicsContext.RestoreClipRegion();
@@ -284,7 +309,50 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
   if (y[2] == y[0]) y[2] += 1.0f; if (x[2] == x[0]) x[2] += 1.0f;
   if (y[3] == y[1]) y[3] += 1.0f; if (x[3] == x[1]) x[3] += 1.0f;
 
-  Draw(x, y, z, texture, diffuse, orientation);
+  g_Windowing.AddVertices(4);
+  if (m_batchRenderer)
+    Queue(x, y, z, texture, diffuse, orientation);
+  else if (!g_Windowing.IsHeadless())
+    Draw(x, y, z, texture, diffuse, orientation);
+}
+
+void CGUITextureBase::Queue(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
+{
+  GUIQuadVertex vertices[4];
+  for (int i = 0; i < 4; i++)
+  {
+    vertices[i].x = x[i];
+    vertices[i].y = y[i];
+    vertices[i].z = z[i];
+    vertices[i].r = (unsigned char)GET_R(m_batchColor);
+    vertices[i].g = (unsigned char)GET_G(m_batchColor);
+    vertices[i].b = (unsigned char)GET_B(m_batchColor);
+    vertices[i].a = (unsigned char)GET_A(m_batchColor);
+  }
+
+  // same corners as the immediate mode backends use, the diffuse texture follows m_info.orientation
+  vertices[0].u1 = texture.x1; vertices[0].v1 = texture.y1;
+  vertices[1].u1 = (orientation & 4) ? texture.x1 : texture.x2; vertices[1].v1 = (orientation & 4) ? texture.y2 : texture.y1;
+  vertices[2].u1 = texture.x2; vertices[2].v1 = texture.y2;
+  vertices[3].u1 = (orientation & 4) ? texture.x2 : texture.x1; vertices[3].v1 = (orientation & 4) ? texture.y1 : texture.y2;
+
+  CBaseTexture *diffuseTexture = NULL;
+  if (m_diffuse.size())
+  {
+    diffuseTexture = m_diffuse.m_textures[0];
+    bool swap = (m_info.orientation & 4) != 0;
+    vertices[0].u2 = diffuse.x1; vertices[0].v2 = diffuse.y1;
+    vertices[1].u2 = swap ? diffuse.x1 : diffuse.x2; vertices[1].v2 = swap ? diffuse.y2 : diffuse.y1;
+    vertices[2].u2 = diffuse.x2; vertices[2].v2 = diffuse.y2;
+    vertices[3].u2 = swap ? diffuse.x2 : diffuse.x1; vertices[3].v2 = swap ? diffuse.y1 : diffuse.y2;
+  }
+  else
+  {
+    for (int i = 0; i < 4; i++)
+      vertices[i].u2 = vertices[i].v2 = 0;
+  }
+
+  g_graphicsContext.GetQuadBatcher().AddQuad(m_batchRenderer, m_texture.m_textures[m_currentFrame], diffuseTexture, vertices);
 }
 
 bool CGUITextureBase::AllocResources()
@@ -556,6 +624,13 @@ bool CGUITextureBase::ReadyToRender() const
   return m_texture.size() > 0;
 }
 
+bool CGUITextureBase::IsStatic() const
+{
+  if (m_info.filename.empty())
+    return true;
+  return m_texture.size() == 1 && !m_invalid;
+}
+
 void CGUITextureBase::OrientateTexture(CRect &rect, float width, float height, int orientation)
 {
   switch (orientation & 3)
@@ -32,6 +32,7 @@
 #include "Geometry.h"
 #include "system.h" // HAS_GL, HAS_DX, etc
 #include "GUIInfoTypes.h"
+#include "GUIQuadBatcher.h"
 
 typedef uint32_t color_t;
 
@@ -122,12 +123,16 @@ public:
   bool IsAllocated() const { return m_isAllocated != NO; };
   bool FailedToAlloc() const { return m_isAllocated == NORMAL_FAILED || m_isAllocated == LARGE_FAILED; };
   bool ReadyToRender() const;
+  /*! \brief whether Process() has nothing left to do: the texture is loaded (or there is none),
+   isn't animated and its size is up to date */
+  bool IsStatic() const;
 protected:
   bool CalculateSize();
   void LoadDiffuseImage();
   bool AllocateOnDemand();
   bool UpdateAnimFrame();
   void Render(float left, float top, float bottom, float right, float u1, float v1, float u2, float v2, float u3, float v3);
+  void Queue(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
   static void OrientateTexture(CRect &rect, float width, float height, int orientation);
 
   // functions that our implementation classes handle
@@ -136,6 +141,8 @@ protected:
   virtual void Begin(color_t color) {};
   virtual void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)=0;
   virtual void End() {};
+  /*! \brief renderer for quads queued on the graphics context, NULL if the backend can't draw batches */
+  virtual GUIQuadRenderFunc GetBatchRenderer() const { return NULL; };
 
   bool m_visible;
   color_t m_diffuseColor;
@@ -171,6 +178,9 @@ protected:
 
   CTextureArray m_diffuse;
   CTextureArray m_texture;
+
+  GUIQuadRenderFunc m_batchRenderer; ///< set while rendering if our quads go to the batcher
+  color_t m_batchColor;
 };
 
 
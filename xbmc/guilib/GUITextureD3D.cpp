@@ -180,6 +180,8 @@ void CGUITextureD3D::Draw(float *x, float *y, float *z, const CRect &texture, co
 
 void CGUITextureD3D::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  g_Windowing.AddDrawCall(4);
+
   struct CUSTOMVERTEX {
       FLOAT x, y, z;
       DWORD color;
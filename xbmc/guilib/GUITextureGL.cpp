@@ -26,6 +26,7 @@
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "guilib/Geometry.h"
+#include "guilib/GraphicContext.h"
 #include "windowing/WindowingFactory.h"
 
 #if defined(HAS_GL)
@@ -36,24 +37,10 @@ CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height,
   memset(m_col, 0, sizeof(m_col));
 }
 
-void CGUITextureGL::Begin(color_t color)
+// binds texture (and diffuse) and sets up the texture environment for diffuse coloring
+static void SetupTextureState(CBaseTexture *texture, CBaseTexture *diffuse)
 {
-  int range, unit = 0;
-  if(g_Windowing.UseLimitedColor())
-    range = 235 - 16;
-  else
-    range = 255 -  0;
-
-  m_col[0] = GET_R(color) * range / 255;
-  m_col[1] = GET_G(color) * range / 255;
-  m_col[2] = GET_B(color) * range / 255;
-  m_col[3] = GET_A(color);
-
-  CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
-  texture->LoadToGPU();
-  if (m_diffuse.size())
-    m_diffuse.m_textures[0]->LoadToGPU();
-
+  int unit = 0;
   texture->BindToUnit(unit++);
 
   glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
@@ -75,9 +62,9 @@ void CGUITextureGL::Begin(color_t color)
   glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
   VerifyGLState();
 
-  if (m_diffuse.size())
+  if (diffuse)
   {
-    m_diffuse.m_textures[0]->BindToUnit(unit++);
+    diffuse->BindToUnit(unit++);
     glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
     glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
     glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
@@ -109,15 +96,10 @@ void CGUITextureGL::Begin(color_t color)
     glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE0_ALPHA    , GL_PREVIOUS);
     VerifyGLState();
   }
-
-  //glDisable(GL_TEXTURE_2D); // uncomment these 2 lines to switch to wireframe rendering
-  //glBegin(GL_LINE_LOOP);
-  glBegin(GL_QUADS);
 }
 
-void CGUITextureGL::End()
+static void ResetTextureState()
 {
-  glEnd();
   glActiveTexture(GL_TEXTURE2_ARB);
   glBindTexture(GL_TEXTURE_2D, 0);
   glDisable(GL_TEXTURE_2D);
@@ -129,6 +111,84 @@ void CGUITextureGL::End()
   glDisable(GL_TEXTURE_2D);
 }
 
+void CGUITextureGL::Begin(color_t color)
+{
+  int range;
+  if(g_Windowing.UseLimitedColor())
+    range = 235 - 16;
+  else
+    range = 255 -  0;
+
+  m_col[0] = GET_R(color) * range / 255;
+  m_col[1] = GET_G(color) * range / 255;
+  m_col[2] = GET_B(color) * range / 255;
+  m_col[3] = GET_A(color);
+
+  CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
+  texture->LoadToGPU();
+  if (m_diffuse.size())
+    m_diffuse.m_textures[0]->LoadToGPU();
+
+  SetupTextureState(texture, m_diffuse.size() ? m_diffuse.m_textures[0] : NULL);
+
+  //glDisable(GL_TEXTURE_2D); // uncomment these 2 lines to switch to wireframe rendering
+  //glBegin(GL_LINE_LOOP);
+  glBegin(GL_QUADS);
+}
+
+void CGUITextureGL::End()
+{
+  glEnd();
+  ResetTextureState();
+}
+
+GUIQuadRenderFunc CGUITextureGL::GetBatchRenderer() const
+{
+  return RenderBatch;
+}
+
+void CGUITextureGL::RenderBatch(const CGUIQuadBatch &batch)
+{
+  CBaseTexture *texture = (CBaseTexture *)batch.m_state;
+  SetupTextureState(texture, batch.m_diffuse);
+
+  const GUIQuadVertex *vertices = &batch.m_vertices[0];
+  std::vector<GUIQuadVertex> limited;
+  if(g_Windowing.UseLimitedColor())
+  { // scale the colors into the limited range, the texture environment adds the offset
+    limited = batch.m_vertices;
+    for (size_t i = 0; i < limited.size(); i++)
+    {
+      limited[i].r = limited[i].r * (235 - 16) / 255;
+      limited[i].g = limited[i].g * (235 - 16) / 255;
+      limited[i].b = limited[i].b * (235 - 16) / 255;
+    }
+    vertices = &limited[0];
+  }
+
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+  glVertexPointer(3, GL_FLOAT        , sizeof(GUIQuadVertex), (const char*)vertices + offsetof(GUIQuadVertex, x));
+  glColorPointer (4, GL_UNSIGNED_BYTE, sizeof(GUIQuadVertex), (const char*)vertices + offsetof(GUIQuadVertex, r));
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+
+  glClientActiveTexture(GL_TEXTURE0_ARB);
+  glTexCoordPointer(2, GL_FLOAT, sizeof(GUIQuadVertex), (const char*)vertices + offsetof(GUIQuadVertex, u1));
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  if (batch.m_diffuse)
+  {
+    glClientActiveTexture(GL_TEXTURE1_ARB);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(GUIQuadVertex), (const char*)vertices + offsetof(GUIQuadVertex, u2));
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  }
+
+  glDrawArrays(GL_QUADS, 0, batch.m_vertices.size());
+
+  glPopClientAttrib();
+  ResetTextureState();
+}
+
 void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
 {
   // Top-left vertex (corner)
@@ -178,6 +238,15 @@ void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, con
 
 void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  g_graphicsContext.FlushBatch();
+  g_Windowing.AddDrawCall(4);
+  if (g_Windowing.IsHeadless())
+  {
+    if (texture)
+      texture->LoadToGPU();
+    return;
+  }
+
   if (texture)
   {
     texture->LoadToGPU();
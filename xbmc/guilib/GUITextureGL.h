@@ -37,10 +37,12 @@ class CGUITextureGL : public CGUITextureBase
 public:
   CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo& texture);
   static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
+  static void RenderBatch(const CGUIQuadBatch &batch);
 protected:
   void Begin(color_t color);
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
   void End();
+  GUIQuadRenderFunc GetBatchRenderer() const;
 private:
   GLubyte m_col[4];
 };
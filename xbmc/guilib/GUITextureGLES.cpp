@@ -219,6 +219,8 @@ void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, c
 
 void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  g_Windowing.AddDrawCall(4);
+
   if (texture)
   {
     texture->LoadToGPU();
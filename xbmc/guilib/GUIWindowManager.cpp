@@ -153,6 +153,9 @@ using namespace std;
 using namespace PVR;
 using namespace PERIPHERALS;
 
+// time in ms that may be spent on thread messages per frame
+#define THREAD_MESSAGE_TIME_BUDGET 20
+
 CGUIWindowManager::CGUIWindowManager(void)
 {
   m_pCallback = NULL;
@@ -163,6 +166,12 @@ CGUIWindowManager::CGUIWindowManager(void)
 
 CGUIWindowManager::~CGUIWindowManager(void)
 {
+  // messages that were never dispatched
+  CSingleLock lock(m_critSection);
+  CollectThreadMessages();
+  for (list< pair<CGUIMessage*,int> >::iterator it = m_vecThreadMessages.begin(); it != m_vecThreadMessages.end(); ++it)
+    delete it->first;
+  m_vecThreadMessages.clear();
 }
 
 void CGUIWindowManager::Initialize()
@@ -908,6 +917,9 @@ void CGUIWindowManager::RenderPass() const
     if ((*it)->IsDialogRunning())
       (*it)->DoRender();
   }
+
+  // draw whatever is still queued while the textures it refers to are known to be around
+  g_graphicsContext.FlushBatch();
 }
 
 void CGUIWindowManager::RenderEx() const
@@ -1160,10 +1172,27 @@ int CGUIWindowManager::GetTopMostModalDialogID(bool ignoreClosing /*= false*/) c
 
 void CGUIWindowManager::SendThreadMessage(CGUIMessage& message, int window /*= 0*/)
 {
-  CSingleLock lock(m_critSection);
+  // no lock here, senders neither wait for each other nor for a dispatch in progress
+  XbmcThreads::CMPSCQueue< pair<CGUIMessage*,int> >::Node* node = m_threadMessageQueue.Alloc();
+  node->value.first = new CGUIMessage(message);
+  node->value.second = window;
+  m_threadMessageQueue.Push(node);
+}
+
+void CGUIWindowManager::CollectThreadMessages()
+{
+  // m_critSection must be held, which makes the caller the only consumer of the queue
+  XbmcThreads::CMPSCQueue< pair<CGUIMessage*,int> >::Node* node;
+  while ((node = m_threadMessageQueue.Pop()))
+  {
+    m_vecThreadMessages.push_back(node->value);
+    m_threadMessageQueue.Free(node);
+  }
+}
 
-  CGUIMessage* msg = new CGUIMessage(message);
-  m_vecThreadMessages.push_back( pair<CGUIMessage*,int>(msg,window) );
+XbmcThreads::CMPSCQueue< pair<CGUIMessage*,int> >::Stats CGUIWindowManager::GetThreadMessageStats() const
+{
+  return m_threadMessageQueue.GetStats();
 }
 
 void CGUIWindowManager::DispatchThreadMessages()
@@ -1185,9 +1214,13 @@ void CGUIWindowManager::DispatchThreadMessages()
   //    be processed by the current loop in DispatchThreadMessages(), prevent dead loop.
   // 5. If possible, queued messages can be removed by certain filter condition
   //    and not break above.
+  // 6. Messages left when the time budget of the frame is used up are kept for
+  //    the next frame, so a burst of messages does not stall rendering.
 
   CSingleLock lock(m_critSection);
+  CollectThreadMessages();
 
+  XbmcThreads::EndTime budget(THREAD_MESSAGE_TIME_BUDGET);
   for(int msgCount = m_vecThreadMessages.size(); !m_vecThreadMessages.empty() && msgCount > 0; --msgCount)
   {
     // pop up one message per time to make messages be processed by order.
@@ -1207,12 +1240,17 @@ void CGUIWindowManager::DispatchThreadMessages()
     delete pMsg;
 
     lock.Enter();
+
+    if (budget.IsTimePast())
+      break;
   }
 }
 
 int CGUIWindowManager::RemoveThreadMessageByMessageIds(int *pMessageIDList)
 {
   CSingleLock lock(m_critSection);
+  CollectThreadMessages();
+
   int removedMsgCount = 0;
   for (std::list < std::pair<CGUIMessage*,int> >::iterator it = m_vecThreadMessages.begin();
        it != m_vecThreadMessages.end();)
@@ -34,6 +34,7 @@
 #include "DirtyRegionTracker.h"
 #include "utils/GlobalsHandling.h"
 #include "guilib/WindowIDs.h"
+#include "threads/MPSCQueue.h"
 #include <list>
 
 class CGUIDialog;
@@ -135,6 +136,8 @@ public:
   // method to removed queued messages with message id in the requested message id list.
   // pMessageIDList: point to first integer of a 0 ends integer array.
   int RemoveThreadMessageByMessageIds(int *pMessageIDList);
+  // depth and latency of the thread message queue, for the debug overlay.
+  XbmcThreads::CMPSCQueue< std::pair<CGUIMessage*,int> >::Stats GetThreadMessageStats() const;
   void AddMsgTarget( IMsgTargetCallback* pMsgTarget );
   int GetActiveWindow() const;
   int GetActiveWindowID();
@@ -164,6 +167,7 @@ private:
   void ClearWindowHistory();
   void CloseWindowSync(CGUIWindow *window, int nextWindowID = 0);
   CGUIWindow *GetTopMostDialog() const;
+  void CollectThreadMessages();
 
   friend class CApplicationMessenger;
   void ActivateWindow_Internal(int windowID, const std::vector<std::string> &params, bool swappingWindows);
@@ -181,6 +185,9 @@ private:
   std::stack<int> m_windowHistory;
 
   IWindowManagerCallback* m_pCallback;
+  // thread messages are pushed lock free into m_threadMessageQueue and moved
+  // to m_vecThreadMessages by whoever holds m_critSection, see DispatchThreadMessages()
+  XbmcThreads::CMPSCQueue< std::pair<CGUIMessage*,int> > m_threadMessageQueue;
   std::list < std::pair<CGUIMessage*,int> > m_vecThreadMessages;
   CCriticalSection m_critSection;
   std::vector <IMsgTargetCallback*> m_vecMsgTargets;
@@ -240,6 +240,7 @@ bool CGraphicContext::SetViewPort(float fx, float fy, float fwidth, float fheigh
 
   CRect newviewport((float)newLeft, (float)newTop, (float)newRight, (float)newBottom);
 
+  FlushBatch();
   m_viewStack.push(newviewport);
 
   newviewport = StereoCorrection(newviewport);
@@ -254,6 +255,7 @@ void CGraphicContext::RestoreViewPort()
 {
   if (m_viewStack.size() <= 1) return;
 
+  FlushBatch();
   m_viewStack.pop();
   CRect viewport = StereoCorrection(m_viewStack.top());
   g_Windowing.SetViewPort(viewport);
@@ -291,6 +293,7 @@ CRect CGraphicContext::StereoCorrection(const CRect &rect) const
 
 void CGraphicContext::SetScissors(const CRect &rect)
 {
+  FlushBatch();
   m_scissors = rect;
   m_scissors.Intersect(CRect(0,0,(float)m_iScreenWidth, (float)m_iScreenHeight));
   g_Windowing.SetScissors(StereoCorrection(m_scissors));
@@ -298,6 +301,7 @@ void CGraphicContext::SetScissors(const CRect &rect)
 
 void CGraphicContext::ResetScissors()
 {
+  FlushBatch();
   m_scissors.SetRect(0, 0, (float)m_iScreenWidth, (float)m_iScreenHeight);
   g_Windowing.SetScissors(StereoCorrection(m_scissors));
 }
@@ -492,6 +496,24 @@ void CGraphicContext::SetVideoResolutionInternal(RESOLUTION res, bool forceUpdat
   Unlock();
 }
 
+void CGraphicContext::SetHeadlessResolution(RESOLUTION res)
+{
+  Lock();
+
+  ResetScreenParameters(res);
+  RESOLUTION_INFO info = GetResInfo(res);
+
+  m_iScreenWidth  = info.iWidth;
+  m_iScreenHeight = info.iHeight;
+  m_iScreenId     = info.iScreen;
+  m_scissors.SetRect(0, 0, (float)m_iScreenWidth, (float)m_iScreenHeight);
+  m_Resolution    = res;
+
+  SetRenderingResolution(info, false);
+
+  Unlock();
+}
+
 RESOLUTION CGraphicContext::GetVideoResolution() const
 {
   return m_Resolution;
@@ -693,11 +715,13 @@ void CGraphicContext::ResetScreenParameters(RESOLUTION res)
 
 void CGraphicContext::Clear(color_t color)
 {
+  FlushBatch();
   g_Windowing.ClearBuffers(color);
 }
 
 void CGraphicContext::CaptureStateBlock()
 {
+  FlushBatch();
   g_Windowing.CaptureStateBlock();
 }
 
@@ -843,6 +867,7 @@ void CGraphicContext::SetRenderingResolution(const RESOLUTION_INFO &res, bool ne
 
 void CGraphicContext::SetStereoView(RENDER_STEREO_VIEW view)
 {
+  FlushBatch();
   m_stereoView = view;
 
   while(!m_viewStack.empty())
@@ -934,6 +959,7 @@ CRect CGraphicContext::generateAABB(const CRect &rect) const
 //       to cut down on one setting)
 void CGraphicContext::UpdateCameraPosition(const CPoint &camera)
 {
+  FlushBatch();
   g_Windowing.SetCameraPosition(camera, m_iScreenWidth, m_iScreenHeight);
 }
 
@@ -1029,6 +1055,8 @@ void CGraphicContext::SetMediaDir(const std::string &strMediaDir)
 
 void CGraphicContext::Flip(const CDirtyRegionList& dirty)
 {
+  FlushBatch();
+  g_Windowing.EndFrameStats();
   g_Windowing.PresentRender(dirty);
 
   if(m_stereoMode != m_nextStereoMode)
@@ -1041,14 +1069,21 @@ void CGraphicContext::Flip(const CDirtyRegionList& dirty)
 
 void CGraphicContext::ApplyHardwareTransform()
 {
+  FlushBatch();
   g_Windowing.ApplyHardwareTransform(m_finalTransform.matrix);
 }
 
 void CGraphicContext::RestoreHardwareTransform()
 {
+  FlushBatch();
   g_Windowing.RestoreHardwareTransform();
 }
 
+void CGraphicContext::FlushBatch()
+{
+  m_quadBatcher.Flush();
+}
+
 void CGraphicContext::GetAllowedResolutions(vector<RESOLUTION> &res)
 {
   res.clear();
@@ -47,6 +47,7 @@
 #include "Resolution.h"
 #include "utils/GlobalsHandling.h"
 #include "DirtyRegion.h"
+#include "GUIQuadBatcher.h"
 #include "settings/lib/ISettingCallback.h"
 #include "rendering/RenderSystem.h"
 
@@ -107,6 +108,10 @@ public:
   void SetCalibrating(bool bOnOff);
   bool IsValidResolution(RESOLUTION res);
   void SetVideoResolution(RESOLUTION res, bool forceUpdate = false);
+  /*! \brief Set up the screen of a headless render system, no window is created or resized
+   \sa CRenderSystemBase::SetHeadless
+   */
+  void SetHeadlessResolution(RESOLUTION res);
   RESOLUTION GetVideoResolution() const;
   void ResetOverscan(RESOLUTION res, OVERSCAN &overscan);
   void ResetOverscan(RESOLUTION_INFO &resinfo);
@@ -139,6 +144,17 @@ public:
   void SetScalingResolution(const RESOLUTION_INFO &res, bool needsScaling);    ///< Sets scaling up for skin loading etc.
   float GetScalingPixelRatio() const;
   void Flip(const CDirtyRegionList& dirty);
+
+  /*! \brief Quads of the current render pass waiting to be drawn.
+   \sa CGUIQuadBatcher
+   */
+  CGUIQuadBatcher &GetQuadBatcher() { return m_quadBatcher; }
+
+  /*! \brief Draw all quads queued so far.
+   Has to be called before drawing anything that doesn't go through the batcher.
+   The graphics context already does so before it changes any render state.
+   */
+  void FlushBatch();
   void InvertFinalCoords(float &x, float &y) const;
   inline float ScaleFinalXCoord(float x, float y) const XBMC_FORCE_INLINE { return m_finalTransform.matrix.TransformXCoord(x, y, 0); }
   inline float ScaleFinalYCoord(float x, float y) const XBMC_FORCE_INLINE { return m_finalTransform.matrix.TransformYCoord(x, y, 0); }
@@ -280,6 +296,7 @@ private:
   RENDER_STEREO_MODE m_nextStereoMode;
 
   CRect m_scissors;
+  CGUIQuadBatcher m_quadBatcher;
 };
 
 /*!
@@ -27,17 +27,225 @@
 #include "utils/URIUtils.h"
 #include "utils/POUtils.h"
 #include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/Atomics.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Crc32.h"
 #include "utils/StringUtils.h"
 
+#include <algorithm>
+#include <string.h>
+
+// bump whenever the format or the way strings are loaded changes
+#define STRING_CACHE_VERSION   1
+#define STRING_CACHE_FOLDER    "special://temp/strings/"
+
+// ids spread further apart than this would waste too much memory in the table
+#define MAX_STRING_TABLE_SLOTS 0x100000
+
+// how long replaced tables are kept for readers that might still use their strings
+#define RETIRED_TABLE_TIMEOUT  10000
+
+static const char StringCacheMagic[4] = { 'X', 'L', 'S', 'T' };
+
+struct StringCacheHeader
+{
+  char     magic[4];
+  uint32_t version;
+  uint32_t sourcesLength; // the description of the strings files follows the header
+  uint32_t first;
+  uint32_t slots;         // the index follows the description
+  uint32_t strings;       // the strings follow the index, each with its length in front
+  uint32_t size;          // of everything after the header
+  uint32_t crc;           // of everything after the header
+};
+
+void CLocalizeStrings::CTable::Build(const StringMap& strings)
+{
+  m_first = 0;
+  m_index.clear();
+  m_strings.clear();
+  if (strings.empty())
+    return;
+
+  m_first = strings.begin()->first;
+  uint32_t last = strings.rbegin()->first;
+  if (last - m_first >= MAX_STRING_TABLE_SLOTS)
+  {
+    CLog::Log(LOGERROR, "LocalizeStrings: ids from %u to %u are too far apart, ignoring the ones above %u",
+              m_first, last, m_first + MAX_STRING_TABLE_SLOTS - 1);
+    last = m_first + MAX_STRING_TABLE_SLOTS - 1;
+  }
+
+  m_index.resize(last - m_first + 1, 0);
+  m_strings.reserve(strings.size());
+  for (ciStrings it = strings.begin(); it != strings.end() && it->first <= last; ++it)
+  {
+    m_strings.push_back(it->second.strTranslated);
+    m_index[it->first - m_first] = m_strings.size();
+  }
+}
+
+void CLocalizeStrings::CTable::GetStrings(StringMap& strings) const
+{
+  for (uint32_t slot = 0; slot < m_index.size(); slot++)
+  {
+    if (m_index[slot])
+      strings[m_first + slot].strTranslated = m_strings[m_index[slot] - 1];
+  }
+}
+
+static bool ReadUInt32(const char*& pos, const char* end, uint32_t& value)
+{
+  if (end - pos < (ptrdiff_t)sizeof(value))
+    return false;
+  memcpy(&value, pos, sizeof(value));
+  pos += sizeof(value);
+  return true;
+}
+
+bool CLocalizeStrings::CTable::Load(const std::string& filename, const std::string& sources)
+{
+  XFILE::CFile file;
+  XFILE::auto_buffer buffer;
+  if (file.LoadFile(filename, buffer) < (ssize_t)sizeof(StringCacheHeader))
+    return false;
+
+  StringCacheHeader header;
+  memcpy(&header, buffer.get(), sizeof(header));
+  const char* pos = buffer.get() + sizeof(header);
+  const char* end = buffer.get() + buffer.size();
+  if (memcmp(header.magic, StringCacheMagic, sizeof(header.magic)) != 0 ||
+      header.version != STRING_CACHE_VERSION ||
+      header.size != (uint32_t)(end - pos) ||
+      header.sourcesLength != sources.size() ||
+      header.slots > MAX_STRING_TABLE_SLOTS ||
+      header.strings > header.slots)
+    return false;
+
+  // the strings files changed since the table was cached
+  if (sources.compare(0, sources.size(), pos, header.sourcesLength) != 0)
+    return false;
+
+  Crc32 crc;
+  crc.Compute(pos, header.size);
+  if ((uint32_t)crc != header.crc)
+  {
+    CLog::Log(LOGWARNING, "LocalizeStrings: ignoring damaged cache %s", filename.c_str());
+    return false;
+  }
+  pos += header.sourcesLength;
+
+  if ((size_t)(end - pos) < header.slots * sizeof(uint32_t))
+    return false;
+  m_first = header.first;
+  m_index.resize(header.slots);
+  if (header.slots)
+    memcpy(&m_index[0], pos, header.slots * sizeof(uint32_t));
+  pos += header.slots * sizeof(uint32_t);
+
+  m_strings.resize(header.strings);
+  for (uint32_t i = 0; i < header.strings; i++)
+  {
+    uint32_t length;
+    if (!ReadUInt32(pos, end, length) || (uint32_t)(end - pos) < length)
+      return false;
+    m_strings[i].assign(pos, length);
+    pos += length;
+  }
+
+  for (uint32_t slot = 0; slot < header.slots; slot++)
+  {
+    if (m_index[slot] > header.strings)
+      return false;
+  }
+  return true;
+}
+
+bool CLocalizeStrings::CTable::Save(const std::string& filename, const std::string& sources) const
+{
+  std::string data(sources);
+  if (!m_index.empty())
+    data.append((const char*)&m_index[0], m_index.size() * sizeof(uint32_t));
+  for (std::vector<std::string>::const_iterator it = m_strings.begin(); it != m_strings.end(); ++it)
+  {
+    uint32_t length = it->size();
+    data.append((const char*)&length, sizeof(length));
+    data.append(*it);
+  }
+
+  StringCacheHeader header;
+  memcpy(header.magic, StringCacheMagic, sizeof(header.magic));
+  header.version = STRING_CACHE_VERSION;
+  header.sourcesLength = sources.size();
+  header.first = m_first;
+  header.slots = m_index.size();
+  header.strings = m_strings.size();
+  header.size = data.size();
+  Crc32 crc;
+  crc.Compute(data.c_str(), data.size());
+  header.crc = crc;
+
+  // write to a temporary file first so that nobody reads a half written table
+  std::string tempFile = filename + ".tmp";
+  XFILE::CFile file;
+  if (!file.OpenForWrite(tempFile, true))
+    return false;
+  bool written = file.Write(&header, sizeof(header)) == sizeof(header) &&
+                 file.Write(data.c_str(), data.size()) == (ssize_t)data.size();
+  file.Close();
+
+  // not every platform renames over an existing file
+  if (written && XFILE::CFile::Exists(filename))
+    XFILE::CFile::Delete(filename);
+  if (!written || !XFILE::CFile::Rename(tempFile, filename))
+  {
+    XFILE::CFile::Delete(tempFile);
+    return false;
+  }
+  return true;
+}
+
 CLocalizeStrings::CLocalizeStrings(void)
+  : m_table(new CTable)
 {
 
 }
 
 CLocalizeStrings::~CLocalizeStrings(void)
 {
+  delete m_table;
+  for (std::vector<CTable*>::iterator it = m_retired.begin(); it != m_retired.end(); ++it)
+    delete *it;
+}
 
+void CLocalizeStrings::Publish(CTable* table)
+{
+  // casptr() is a full barrier, so readers only ever see complete tables
+  void* previous;
+  do
+  {
+    previous = (void*)m_table;
+  } while (casptr((void* volatile*)&m_table, previous, table) != previous);
+
+  // Get() hands out references, which callers copy right away
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  std::vector<CTable*>::iterator it = m_retired.begin();
+  while (it != m_retired.end())
+  {
+    if (now - (*it)->m_retired > RETIRED_TABLE_TIMEOUT)
+    {
+      delete *it;
+      it = m_retired.erase(it);
+    }
+    else
+      ++it;
+  }
+
+  CTable* retired = (CTable*)previous;
+  retired->m_retired = now;
+  m_retired.push_back(retired);
 }
 
 std::string CLocalizeStrings::ToUTF8(const std::string& strEncoding, const std::string& str)
@@ -58,23 +266,34 @@ void CLocalizeStrings::ClearSkinStrings()
 
 bool CLocalizeStrings::LoadSkinStrings(const std::string& path, const std::string& language)
 {
-  ClearSkinStrings();
+  CSingleLock lock(m_critSection);
+
+  // the skin strings are few, so they are added to the current table rather than cached
+  StringMap strings;
+  m_table->GetStrings(strings);
+  for (iStrings it = strings.lower_bound(31000); it != strings.end() && it->first <= 31999; )
+    strings.erase(it++);
+
   // load the skin strings in.
+  bool loaded = true;
   std::string encoding;
-  if (!LoadStr2Mem(path, language, encoding))
+  if (!LoadStr2Mem(strings, path, language, encoding))
   {
     if (StringUtils::EqualsNoCase(language, SOURCE_LANGUAGE)) // no fallback, nothing to do
-      return false;
+      loaded = false;
   }
 
   // load the fallback
   if (!StringUtils::EqualsNoCase(language, SOURCE_LANGUAGE))
-    LoadStr2Mem(path, SOURCE_LANGUAGE, encoding);
+    LoadStr2Mem(strings, path, SOURCE_LANGUAGE, encoding);
 
-  return true;
+  CTable* table = new CTable;
+  table->Build(strings);
+  Publish(table);
+  return loaded;
 }
 
-bool CLocalizeStrings::LoadStr2Mem(const std::string &pathname_in, const std::string &language,
+bool CLocalizeStrings::LoadStr2Mem(StringMap &strings, const std::string &pathname_in, const std::string &language,
                                    std::string &encoding, uint32_t offset /* = 0 */)
 {
   std::string pathname = CSpecialProtocol::TranslatePathConvertCase(pathname_in + language);
@@ -86,16 +305,16 @@ bool CLocalizeStrings::LoadStr2Mem(const std::string &pathname_in, const std::st
     return false;
   }
 
-  if (LoadPO(URIUtils::AddFileToFolder(pathname, "strings.po"), encoding, offset,
+  if (LoadPO(strings, URIUtils::AddFileToFolder(pathname, "strings.po"), encoding, offset,
              StringUtils::EqualsNoCase(language, SOURCE_LANGUAGE)))
     return true;
 
   CLog::Log(LOGDEBUG, "LocalizeStrings: no strings.po file exist at %s, fallback to strings.xml",
             pathname.c_str());
-  return LoadXML(URIUtils::AddFileToFolder(pathname, "strings.xml"), encoding, offset);
+  return LoadXML(strings, URIUtils::AddFileToFolder(pathname, "strings.xml"), encoding, offset);
 }
 
-bool CLocalizeStrings::LoadPO(const std::string &filename, std::string &encoding,
+bool CLocalizeStrings::LoadPO(StringMap &strings, const std::string &filename, std::string &encoding,
                               uint32_t offset /* = 0 */, bool bSourceLanguage)
 {
   CPODocument PODoc;
@@ -109,25 +328,25 @@ bool CLocalizeStrings::LoadPO(const std::string &filename, std::string &encoding
     uint32_t id;
     if (PODoc.GetEntryType() == ID_FOUND)
     {
-      bool bStrInMem = m_strings.find((id = PODoc.GetEntryID()) + offset) != m_strings.end();
+      bool bStrInMem = strings.find((id = PODoc.GetEntryID()) + offset) != strings.end();
       PODoc.ParseEntry(bSourceLanguage);
 
       if (bSourceLanguage && !PODoc.GetMsgid().empty())
       {
-        if (bStrInMem && (m_strings[id + offset].strOriginal.empty() ||
-            PODoc.GetMsgid() == m_strings[id + offset].strOriginal))
+        if (bStrInMem && (strings[id + offset].strOriginal.empty() ||
+            PODoc.GetMsgid() == strings[id + offset].strOriginal))
           continue;
         else if (bStrInMem)
           CLog::Log(LOGDEBUG,
                     "POParser: id:%i was recently re-used in the English string file, which is not yet "
                     "changed in the translated file. Using the English string instead", id);
-        m_strings[id + offset].strTranslated = PODoc.GetMsgid();
+        strings[id + offset].strTranslated = PODoc.GetMsgid();
         counter++;
       }
       else if (!bSourceLanguage && !bStrInMem && !PODoc.GetMsgstr().empty())
       {
-        m_strings[id + offset].strTranslated = PODoc.GetMsgstr();
-        m_strings[id + offset].strOriginal = PODoc.GetMsgid();
+        strings[id + offset].strTranslated = PODoc.GetMsgstr();
+        strings[id + offset].strOriginal = PODoc.GetMsgid();
         counter++;
       }
     }
@@ -150,7 +369,8 @@ bool CLocalizeStrings::LoadPO(const std::string &filename, std::string &encoding
   return true;
 }
 
-bool CLocalizeStrings::LoadXML(const std::string &filename, std::string &encoding, uint32_t offset /* = 0 */)
+bool CLocalizeStrings::LoadXML(StringMap &strings, const std::string &filename, std::string &encoding,
+                               uint32_t offset /* = 0 */)
 {
   CXBMCTinyXML xmlDoc;
   if (!xmlDoc.LoadFile(filename))
@@ -175,84 +395,166 @@ bool CLocalizeStrings::LoadXML(const std::string &filename, std::string &encodin
     if (attrId && !pChild->NoChildren())
     {
       uint32_t id = atoi(attrId) + offset;
-      if (m_strings.find(id) == m_strings.end())
-        m_strings[id].strTranslated = pChild->FirstChild()->Value();
+      if (strings.find(id) == strings.end())
+        strings[id].strTranslated = pChild->FirstChild()->Value();
     }
     pChild = pChild->NextSiblingElement("string");
   }
   return true;
 }
 
-bool CLocalizeStrings::Load(const std::string& strPathName, const std::string& strLanguage)
+bool CLocalizeStrings::LoadLanguage(const std::string& strPathName, const std::string& strLanguage,
+                                    StringMap& strings)
 {
   bool bLoadFallback = !StringUtils::EqualsNoCase(strLanguage, SOURCE_LANGUAGE);
 
   std::string encoding;
-  CSingleLock lock(m_critSection);
-  Clear();
-
-  if (!LoadStr2Mem(strPathName, strLanguage, encoding))
+  if (!LoadStr2Mem(strings, strPathName, strLanguage, encoding))
   {
     // try loading the fallback
-    if (!bLoadFallback || !LoadStr2Mem(strPathName, SOURCE_LANGUAGE, encoding))
+    if (!bLoadFallback || !LoadStr2Mem(strings, strPathName, SOURCE_LANGUAGE, encoding))
       return false;
 
     bLoadFallback = false;
   }
 
   if (bLoadFallback)
-    LoadStr2Mem(strPathName, SOURCE_LANGUAGE, encoding);
+    LoadStr2Mem(strings, strPathName, SOURCE_LANGUAGE, encoding);
 
   // fill in the constant strings
-  m_strings[20022].strTranslated = "";
-  m_strings[20027].strTranslated = "°F";
-  m_strings[20028].strTranslated = "K";
-  m_strings[20029].strTranslated = "°C";
-  m_strings[20030].strTranslated = "°Ré";
-  m_strings[20031].strTranslated = "°Ra";
-  m_strings[20032].strTranslated = "°Rø";
-  m_strings[20033].strTranslated = "°De";
-  m_strings[20034].strTranslated = "°N";
-
-  m_strings[20200].strTranslated = "km/h";
-  m_strings[20201].strTranslated = "m/min";
-  m_strings[20202].strTranslated = "m/s";
-  m_strings[20203].strTranslated = "ft/h";
-  m_strings[20204].strTranslated = "ft/min";
-  m_strings[20205].strTranslated = "ft/s";
-  m_strings[20206].strTranslated = "mph";
-  m_strings[20207].strTranslated = "kts";
-  m_strings[20208].strTranslated = "Beaufort";
-  m_strings[20209].strTranslated = "inch/s";
-  m_strings[20210].strTranslated = "yard/s";
-  m_strings[20211].strTranslated = "Furlong/Fortnight";
+  strings[20022].strTranslated = "";
+  strings[20027].strTranslated = "°F";
+  strings[20028].strTranslated = "K";
+  strings[20029].strTranslated = "°C";
+  strings[20030].strTranslated = "°Ré";
+  strings[20031].strTranslated = "°Ra";
+  strings[20032].strTranslated = "°Rø";
+  strings[20033].strTranslated = "°De";
+  strings[20034].strTranslated = "°N";
+
+  strings[20200].strTranslated = "km/h";
+  strings[20201].strTranslated = "m/min";
+  strings[20202].strTranslated = "m/s";
+  strings[20203].strTranslated = "ft/h";
+  strings[20204].strTranslated = "ft/min";
+  strings[20205].strTranslated = "ft/s";
+  strings[20206].strTranslated = "mph";
+  strings[20207].strTranslated = "kts";
+  strings[20208].strTranslated = "Beaufort";
+  strings[20209].strTranslated = "inch/s";
+  strings[20210].strTranslated = "yard/s";
+  strings[20211].strTranslated = "Furlong/Fortnight";
 
   return true;
 }
 
+std::string CLocalizeStrings::GetSources(const std::string& strPathName, const std::string& strLanguage)
+{
+  std::vector<std::string> languages;
+  languages.push_back(strLanguage);
+  if (!StringUtils::EqualsNoCase(strLanguage, SOURCE_LANGUAGE))
+    languages.push_back(SOURCE_LANGUAGE);
+
+  std::string sources;
+  for (std::vector<std::string>::const_iterator language = languages.begin(); language != languages.end(); ++language)
+  {
+    std::string pathname = CSpecialProtocol::TranslatePathConvertCase(strPathName + *language);
+    const char* files[] = { "strings.po", "strings.xml" };
+    for (unsigned int i = 0; i < sizeof(files) / sizeof(files[0]); i++)
+    {
+      std::string filename = URIUtils::AddFileToFolder(pathname, files[i]);
+      struct __stat64 st;
+      if (XFILE::CFile::Stat(filename, &st) == 0)
+        sources += StringUtils::Format("%s|%" PRId64 "|%" PRId64 "\n", filename.c_str(),
+                                       (int64_t)st.st_mtime, (int64_t)st.st_size);
+    }
+  }
+  return sources;
+}
+
+std::string CLocalizeStrings::GetCacheFile(const std::string& strPathName, const std::string& strLanguage)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(CSpecialProtocol::TranslatePath(strPathName) + "|" + strLanguage);
+  return StringUtils::Format(STRING_CACHE_FOLDER "%08x.bin", (uint32_t)crc);
+}
+
+bool CLocalizeStrings::Load(const std::string& strPathName, const std::string& strLanguage)
+{
+  CSingleLock lock(m_critSection);
+
+  std::string sources = GetSources(strPathName, strLanguage);
+  std::string cacheFile = GetCacheFile(strPathName, strLanguage);
+  CTable* table = new CTable;
+  if (!sources.empty() && table->Load(cacheFile, sources))
+  {
+    CLog::Log(LOGDEBUG, "LocalizeStrings: loaded %u strings for %s from %s",
+              (unsigned int)table->m_strings.size(), strLanguage.c_str(), cacheFile.c_str());
+    Publish(table);
+    return true;
+  }
+
+  StringMap strings;
+  if (!LoadLanguage(strPathName, strLanguage, strings))
+  {
+    table->Build(StringMap());
+    Publish(table);
+    return false;
+  }
+
+  table->Build(strings);
+  if (!sources.empty())
+  {
+    if (!XFILE::CDirectory::Exists(STRING_CACHE_FOLDER))
+      XFILE::CDirectory::Create(STRING_CACHE_FOLDER);
+    if (!table->Save(cacheFile, sources))
+      CLog::Log(LOGDEBUG, "LocalizeStrings: unable to cache the strings in %s", cacheFile.c_str());
+  }
+  Publish(table);
+  return true;
+}
+
 const std::string& CLocalizeStrings::Get(uint32_t dwCode) const
 {
-  ciStrings i = m_strings.find(dwCode);
-  if (i == m_strings.end())
+  const std::string* str = m_table->Find(dwCode);
+  if (str == NULL)
   {
     return StringUtils::Empty;
   }
-  return i->second.strTranslated;
+  return *str;
+}
+
+void CLocalizeStrings::GetCharacters(std::wstring &characters, uint32_t start, uint32_t end) const
+{
+  const CTable* table = m_table;
+  std::string text;
+  for (uint32_t code = std::max(start, table->m_first); code <= end && code - table->m_first < table->m_index.size(); code++)
+  {
+    const std::string* str = table->Find(code);
+    if (str)
+      text += *str;
+  }
+
+  g_charsetConverter.utf8ToW(text, characters, false);
+  std::sort(characters.begin(), characters.end());
+  characters.erase(std::unique(characters.begin(), characters.end()), characters.end());
 }
 
 void CLocalizeStrings::Clear()
 {
-  m_strings.clear();
+  CSingleLock lock(m_critSection);
+  Publish(new CTable);
 }
 
 void CLocalizeStrings::Clear(uint32_t start, uint32_t end)
 {
-  iStrings it = m_strings.begin();
-  while (it != m_strings.end())
-  {
-    if (it->first >= start && it->first <= end)
-      m_strings.erase(it++);
-    else
-      ++it;
-  }
+  CSingleLock lock(m_critSection);
+  StringMap strings;
+  m_table->GetStrings(strings);
+  for (iStrings it = strings.lower_bound(start); it != strings.end() && it->first <= end; )
+    strings.erase(it++);
+
+  CTable* table = new CTable;
+  table->Build(strings);
+  Publish(table);
 }
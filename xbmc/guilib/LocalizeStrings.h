@@ -32,6 +32,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 /*!
@@ -53,51 +54,122 @@ class CLocalizeStrings
 public:
   CLocalizeStrings(void);
   virtual ~CLocalizeStrings(void);
+  /*! \brief Loads the strings of a language, with English for the strings it lacks.
+   The strings are compiled into a table that is cached on disk and reused for as
+   long as the strings files it was built from don't change.
+   \param strPathName The directory holding a subdirectory for each language.
+   \param strLanguage The language to load.
+   \return false if neither the language nor English could be loaded.
+   */
   bool Load(const std::string& strPathName, const std::string& strLanguage);
   bool LoadSkinStrings(const std::string& path, const std::string& language);
   void ClearSkinStrings();
+
+  /*! \brief Looks up a string without locking.
+   The returned reference stays valid for a while after the strings are replaced,
+   so it should be copied rather than kept.
+   \param code The id of the string.
+   \return the string, or an empty string if there is none with that id.
+   */
   const std::string& Get(uint32_t code) const;
+
+  /*! \brief the characters used by the loaded strings with ids from start to end
+   \param characters [out] each character once, sorted
+   */
+  void GetCharacters(std::wstring &characters, uint32_t start, uint32_t end) const;
   void Clear();
 protected:
+  typedef std::map<uint32_t, LocStr> StringMap;
+
+  /*! \brief Immutable table of the loaded strings, indexed by id.
+   Tables are never changed once they are in use, loading strings builds a new
+   one which then replaces the current table.
+   */
+  class CTable
+  {
+  public:
+    CTable() : m_first(0), m_retired(0) {}
+
+    const std::string* Find(uint32_t code) const
+    {
+      uint32_t slot = code - m_first;
+      if (slot >= m_index.size() || m_index[slot] == 0)
+        return NULL;
+      return &m_strings[m_index[slot] - 1];
+    }
+
+    void Build(const StringMap& strings);
+    void GetStrings(StringMap& strings) const;
+    bool Load(const std::string& filename, const std::string& sources);
+    bool Save(const std::string& filename, const std::string& sources) const;
+
+    uint32_t m_first;                   // lowest id in the table
+    std::vector<uint32_t> m_index;      // number of the string for each id from m_first on, 0 if there is none
+    std::vector<std::string> m_strings; // the strings in order of their ids
+    unsigned int m_retired;             // when the table was replaced
+  };
+
   void Clear(uint32_t start, uint32_t end);
 
-  /*! \brief Loads language ids and strings to memory map m_strings.
+  /*! \brief Makes a table the current one.
+   The previous table is kept around for a while as readers might still use it.
+   \param table The new table, owned by this object from now on.
+   */
+  void Publish(CTable* table);
+
+  /*! \brief Loads the strings of a language with the English fallback.
+   \return false if neither the language nor English could be loaded.
+   */
+  bool LoadLanguage(const std::string& strPathName, const std::string& strLanguage, StringMap& strings);
+
+  /*! \brief Describes the strings files of a language and its fallback.
+   A cached table is only used if its description matches the current one.
+   */
+  static std::string GetSources(const std::string& strPathName, const std::string& strLanguage);
+  static std::string GetCacheFile(const std::string& strPathName, const std::string& strLanguage);
+
+  /*! \brief Loads language ids and strings to a memory map.
    * It tries to load a strings.po file first. If doesn't exist, it loads a strings.xml file instead.
+   \param strings The map to add the strings to.
    \param pathname The directory name, where we look for the strings file.
    \param language We load the strings for this language. Fallback language is always English.
    \param encoding Encoding of the strings. For PO files we only use utf-8.
    \param offset An offset value to place strings from the id value.
    \return false if no strings.po or strings.xml file was loaded.
    */
-  bool LoadStr2Mem(const std::string &pathname, const std::string &language,
+  bool LoadStr2Mem(StringMap &strings, const std::string &pathname, const std::string &language,
                    std::string &encoding, uint32_t offset = 0);
 
-  /*! \brief Tries to load ids and strings from a strings.po file to m_strings map.
+  /*! \brief Tries to load ids and strings from a strings.po file to a memory map.
    * It should only be called from the LoadStr2Mem function to have a fallback.
+   \param strings The map to add the strings to.
    \param pathname The directory name, where we look for the strings file.
    \param encoding Encoding of the strings. For PO files we only use utf-8.
    \param offset An offset value to place strings from the id value.
    \param bSourceLanguage If we are loading the source English strings.po.
    \return false if no strings.po file was loaded.
    */
-  bool LoadPO(const std::string &filename, std::string &encoding, uint32_t offset = 0,
-              bool bSourceLanguage = false);
+  bool LoadPO(StringMap &strings, const std::string &filename, std::string &encoding,
+              uint32_t offset = 0, bool bSourceLanguage = false);
 
-  /*! \brief Tries to load ids and strings from a strings.xml file to m_strings map.
+  /*! \brief Tries to load ids and strings from a strings.xml file to a memory map.
    * It should only be called from the LoadStr2Mem function to try a PO file first.
+   \param strings The map to add the strings to.
    \param pathname The directory name, where we look for the strings file.
    \param encoding Encoding of the strings.
    \param offset An offset value to place strings from the id value.
    \return false if no strings.xml file was loaded.
    */
-  bool LoadXML(const std::string &filename, std::string &encoding, uint32_t offset = 0);
+  bool LoadXML(StringMap &strings, const std::string &filename, std::string &encoding,
+               uint32_t offset = 0);
 
   static std::string ToUTF8(const std::string &encoding, const std::string &str);
-  std::map<uint32_t, LocStr> m_strings;
-  typedef std::map<uint32_t, LocStr>::const_iterator ciStrings;
-  typedef std::map<uint32_t, LocStr>::iterator       iStrings;
+  typedef StringMap::const_iterator ciStrings;
+  typedef StringMap::iterator       iStrings;
 
-  CCriticalSection m_critSection;
+  const CTable* volatile m_table;  // read without locking, replaced by Publish()
+  std::vector<CTable*> m_retired;  // previous tables that might still be in use
+  CCriticalSection m_critSection;  // serializes loading
 };
 
 /*!
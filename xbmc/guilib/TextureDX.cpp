@@ -90,6 +90,8 @@ void CDXTexture::LoadToGPU()
     }
   }
 
+  g_Windowing.AddTextureUpload(GetPitch() * GetRows());
+
   D3DLOCKED_RECT lr;
   if (m_texture.LockRect( 0, &lr, NULL, D3DLOCK_DISCARD ))
   {
@@ -61,6 +61,17 @@ void CGLTexture::LoadToGPU()
     // nothing to load - probably same image (no change)
     return;
   }
+
+  g_Windowing.AddTextureUpload(GetPitch() * GetRows());
+  if (g_Windowing.IsHeadless())
+  {
+    // no GPU to upload to, drop the pixels as if they had been uploaded
+    delete [] m_pixels;
+    m_pixels = NULL;
+    m_loadedToGPU = true;
+    return;
+  }
+
   if (m_texture == 0)
   {
     // Have OpenGL generate a texture object handle for us
@@ -0,0 +1,70 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "guilib/GUIImage.h"
+#include "guilib/GraphicContext.h"
+#include "settings/AdvancedSettings.h"
+
+class TestImage : public CGUIImage
+{
+public:
+  TestImage() : CGUIImage(0, 1, 0, 0, 100, 100, CTextureInfo()), m_processed(0) {}
+  virtual void Process(unsigned int currentTime, CDirtyRegionList &dirtyregions)
+  {
+    m_processed++;
+    CGUIImage::Process(currentTime, dirtyregions);
+  }
+  unsigned int m_processed;
+};
+
+TEST(TestGUIControl, SkipsUnchangedProcess)
+{
+  TestImage image;
+  CDirtyRegionList dirty;
+  image.DoProcess(0, dirty);
+  image.DoProcess(16, dirty);
+  EXPECT_EQ(1u, image.m_processed);
+
+  // moving the control processes it again, once
+  image.SetPosition(10, 10);
+  image.DoProcess(32, dirty);
+  image.DoProcess(48, dirty);
+  EXPECT_EQ(2u, image.m_processed);
+
+  // as does moving its parent, and moving it back
+  g_graphicsContext.SetOrigin(5, 5);
+  image.DoProcess(64, dirty);
+  g_graphicsContext.RestoreOrigin();
+  image.DoProcess(72, dirty);
+  EXPECT_EQ(4u, image.m_processed);
+
+  // or marking it dirty
+  image.MarkDirtyRegion();
+  image.DoProcess(80, dirty);
+  image.DoProcess(88, dirty);
+  EXPECT_EQ(5u, image.m_processed);
+
+  g_advancedSettings.m_guiSkipUnchangedControls = false;
+  image.DoProcess(96, dirty);
+  g_advancedSettings.m_guiSkipUnchangedControls = true;
+  EXPECT_EQ(6u, image.m_processed);
+}
@@ -0,0 +1,117 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUIFontAtlas.h"
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+
+struct AtlasRect
+{
+  unsigned int x, y, width, height;
+};
+
+static bool Overlaps(const AtlasRect &a, const AtlasRect &b)
+{
+  return a.x < b.x + b.width && b.x < a.x + a.width &&
+         a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+TEST(TestGUIFontAtlas, FillsRows)
+{
+  CGUIFontAtlas atlas;
+  atlas.Reset(100);
+
+  unsigned int x, y;
+  for (unsigned int i = 0; i < 10; i++)
+  {
+    EXPECT_TRUE(atlas.Allocate(10, 20, 1000, x, y));
+    EXPECT_EQ(i * 10, x);
+    EXPECT_EQ(0u, y);
+  }
+  EXPECT_EQ(20u, atlas.GetHeight());
+
+  // the first row is full, so the next one goes below
+  EXPECT_TRUE(atlas.Allocate(10, 20, 1000, x, y));
+  EXPECT_EQ(0u, x);
+  EXPECT_EQ(20u, y);
+  EXPECT_EQ(40u, atlas.GetHeight());
+}
+
+TEST(TestGUIFontAtlas, FillsGaps)
+{
+  CGUIFontAtlas atlas;
+  atlas.Reset(100);
+
+  unsigned int x, y;
+  EXPECT_TRUE(atlas.Allocate(50, 40, 1000, x, y));
+  EXPECT_TRUE(atlas.Allocate(50, 10, 1000, x, y));
+  EXPECT_EQ(50u, x);
+
+  // a short rectangle goes on top of the short one rather than starting a new row
+  EXPECT_TRUE(atlas.Allocate(50, 10, 1000, x, y));
+  EXPECT_EQ(50u, x);
+  EXPECT_EQ(10u, y);
+  EXPECT_EQ(40u, atlas.GetHeight());
+}
+
+TEST(TestGUIFontAtlas, RespectsLimits)
+{
+  CGUIFontAtlas atlas;
+  atlas.Reset(64);
+
+  unsigned int x, y;
+  EXPECT_FALSE(atlas.Allocate(65, 1, 1000, x, y));
+  EXPECT_TRUE(atlas.Allocate(64, 30, 32, x, y));
+  EXPECT_FALSE(atlas.Allocate(1, 3, 32, x, y));
+  EXPECT_TRUE(atlas.Allocate(1, 2, 32, x, y));
+  EXPECT_EQ(32u, atlas.GetHeight());
+
+  atlas.Reset(64);
+  EXPECT_EQ(0u, atlas.GetHeight());
+  EXPECT_TRUE(atlas.Allocate(64, 32, 32, x, y));
+}
+
+TEST(TestGUIFontAtlas, NoOverlaps)
+{
+  CGUIFontAtlas atlas;
+  atlas.Reset(256);
+
+  srand(1);
+  std::vector<AtlasRect> rects;
+  unsigned int area = 0;
+  for (unsigned int i = 0; i < 500; i++)
+  {
+    AtlasRect rect;
+    rect.width = 1 + rand() % 24;
+    rect.height = 1 + rand() % 32;
+    ASSERT_TRUE(atlas.Allocate(rect.width, rect.height, 4096, rect.x, rect.y));
+    EXPECT_LE(rect.x + rect.width, 256u);
+    EXPECT_LE(rect.y + rect.height, atlas.GetHeight());
+    for (std::vector<AtlasRect>::const_iterator j = rects.begin(); j != rects.end(); ++j)
+      EXPECT_FALSE(Overlaps(rect, *j));
+    rects.push_back(rect);
+    area += rect.width * rect.height;
+  }
+
+  // glyphs of mixed sizes shouldn't waste more space than they take up
+  EXPECT_LT(atlas.GetHeight() * 256, area * 2);
+}
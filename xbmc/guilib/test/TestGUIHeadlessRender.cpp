@@ -0,0 +1,310 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// gtest has to come before the windowing headers, X11 defines None
+#include "gtest/gtest.h"
+
+#include "FileItem.h"
+#include "guilib/GUIControlFactory.h"
+#include "guilib/GUIFont.h"
+#include "guilib/GUIFontManager.h"
+#include "guilib/GUIMessage.h"
+#include "guilib/GUITexture.h"
+#include "guilib/GraphicContext.h"
+#include "guilib/Key.h"
+#include "settings/AdvancedSettings.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "windowing/WindowingFactory.h"
+
+#include <iostream>
+
+#define TEST_FRAMES      10
+#define TEST_ITEMS       50
+#define BENCHMARK_FRAMES 600
+#define BENCHMARK_ITEMS  5000
+
+// a list view as skins have it: background, thumb, overlay and two labels per item
+static const char *listXML =
+  "<control type=\"list\" id=\"50\">"
+  "  <posx>0</posx><posy>0</posy><width>1920</width><height>1080</height>"
+  "  <scrolltime>200</scrolltime>"
+  "  <itemlayout height=\"54\" width=\"1920\">"
+  "    <control type=\"image\"><width>1920</width><height>54</height><texture border=\"5\">TEXTURE</texture></control>"
+  "    <control type=\"image\"><posx>4</posx><width>46</width><height>46</height><texture>TEXTURE</texture></control>"
+  "    <control type=\"image\"><posx>30</posx><posy>30</posy><width>20</width><height>20</height><texture>TEXTURE</texture></control>"
+  "    <control type=\"label\"><posx>60</posx><width>1300</width><height>54</height><font>font13</font><label>$INFO[ListItem.Label]</label></control>"
+  "    <control type=\"label\"><posx>1900</posx><width>400</width><height>54</height><font>font13</font><align>right</align><label>$INFO[ListItem.Label2]</label></control>"
+  "  </itemlayout>"
+  "  <focusedlayout height=\"54\" width=\"1920\">"
+  "    <control type=\"image\"><width>1920</width><height>54</height><texture border=\"5\">TEXTURE</texture></control>"
+  "    <control type=\"image\"><posx>4</posx><width>46</width><height>46</height><texture>TEXTURE</texture></control>"
+  "    <control type=\"label\"><posx>60</posx><width>1300</width><height>54</height><font>font13</font><label>$INFO[ListItem.Label]</label><scroll>true</scroll></control>"
+  "    <control type=\"label\"><posx>1900</posx><width>400</width><height>54</height><font>font13</font><align>right</align><label>$INFO[ListItem.Label2]</label></control>"
+  "  </focusedlayout>"
+  "</control>";
+
+// a thumbnail view: a grid of large images with a label below each
+static const char *panelXML =
+  "<control type=\"panel\" id=\"51\">"
+  "  <posx>0</posx><posy>0</posy><width>1920</width><height>1080</height>"
+  "  <scrolltime>200</scrolltime>"
+  "  <itemlayout height=\"270\" width=\"240\">"
+  "    <control type=\"image\"><posx>10</posx><posy>10</posy><width>220</width><height>220</height><texture>TEXTURE</texture></control>"
+  "    <control type=\"label\"><posx>120</posx><posy>230</posy><width>220</width><height>30</height><font>font13</font><align>center</align><label>$INFO[ListItem.Label]</label></control>"
+  "  </itemlayout>"
+  "  <focusedlayout height=\"270\" width=\"240\">"
+  "    <control type=\"image\"><posx>0</posx><posy>0</posy><width>240</width><height>240</height><texture border=\"5\">TEXTURE</texture></control>"
+  "    <control type=\"image\"><posx>10</posx><posy>10</posy><width>220</width><height>220</height><texture>TEXTURE</texture></control>"
+  "    <control type=\"label\"><posx>120</posx><posy>230</posy><width>220</width><height>30</height><font>font13</font><align>center</align><label>$INFO[ListItem.Label]</label><scroll>true</scroll></control>"
+  "  </focusedlayout>"
+  "</control>";
+
+class TestGUIHeadlessRender : public testing::Test
+{
+protected:
+  TestGUIHeadlessRender()
+  {
+    g_Windowing.SetHeadless(true);
+    g_graphicsContext.SetHeadlessResolution(RES_HDTV_1080i);
+    g_fontManager.LoadTTF("font13", XBMC_REF_FILE_PATH("media/Fonts/teletext.ttf"), 0xFFFFFFFF, 0, 30, FONT_STYLE_NORMAL);
+    m_texture = XBMC_REF_FILE_PATH("media/icon48x48.png");
+  }
+
+  ~TestGUIHeadlessRender()
+  {
+    g_fontManager.Unload("font13");
+    g_Windowing.EndFrameStats();
+    g_Windowing.SetHeadless(false);
+  }
+
+  CGUIControl *CreateControl(const char *xml, int itemCount)
+  {
+    std::string controlXML(xml);
+    StringUtils::Replace(controlXML, "TEXTURE", m_texture);
+
+    CXBMCTinyXML doc;
+    if (!doc.Parse(controlXML))
+      return NULL;
+
+    CGUIControlFactory factory;
+    CRect rect(0, 0, 1920, 1080);
+    CGUIControl *control = factory.Create(0, rect, doc.RootElement());
+    if (!control)
+      return NULL;
+
+    control->AllocResources();
+    control->SetFocus(true);
+
+    CFileItemList items;
+    for (int i = 0; i < itemCount; i++)
+    {
+      CFileItemPtr item(new CFileItem(StringUtils::Format("Item number %i with a longish label", i)));
+      item->SetLabel2(StringUtils::Format("%i:%02i", i / 60, i % 60));
+      items.Add(item);
+    }
+    CGUIMessage msg(GUI_MSG_LABEL_BIND, 0, control->GetID(), 0, 0, &items);
+    control->OnMessage(msg);
+    return control;
+  }
+
+  struct ScrollResult
+  {
+    int64_t processTime, renderTime;
+    uint64_t drawCalls, vertices, batched, uploads;
+  };
+
+  /* scroll down through the items, one step per frame at 60 fps */
+  bool Scroll(const char *xml, unsigned int frames, int itemCount, ScrollResult &result)
+  {
+    CGUIControl *control = CreateControl(xml, itemCount);
+    if (!control)
+      return false;
+
+    int64_t processTime = 0, renderTime = 0;
+    uint64_t drawCalls = 0, vertices = 0, batched = 0, uploads = 0;
+    for (unsigned int frame = 0; frame < frames; frame++)
+    {
+      control->OnAction(CAction(ACTION_MOVE_DOWN));
+
+      CDirtyRegionList dirty;
+      int64_t start = CurrentHostCounter();
+      control->DoProcess(frame * 16, dirty);
+      int64_t processed = CurrentHostCounter();
+      control->DoRender();
+      g_graphicsContext.FlushBatch();
+      int64_t rendered = CurrentHostCounter();
+
+      g_Windowing.EndFrameStats();
+      const RenderStats &stats = g_Windowing.GetFrameStats();
+      processTime += processed - start;
+      renderTime += rendered - processed;
+      drawCalls += stats.drawCalls;
+      vertices += stats.vertices;
+      batched += stats.batchedQuads;
+      uploads += stats.textureUploads;
+    }
+
+    control->FreeResources(true);
+    delete control;
+
+    result.processTime = processTime;
+    result.renderTime = renderTime;
+    result.drawCalls = drawCalls;
+    result.vertices = vertices;
+    result.batched = batched;
+    result.uploads = uploads;
+    return true;
+  }
+
+  void Benchmark(const char *name, const char *xml)
+  {
+    ScrollResult result;
+    ASSERT_TRUE(Scroll(xml, BENCHMARK_FRAMES, BENCHMARK_ITEMS, result));
+
+    double frequency = (double)CurrentHostFrequency();
+    std::cout << "GUI " << name << ": process " << result.processTime * 1000.0 / frequency / BENCHMARK_FRAMES
+              << " ms/frame, render " << result.renderTime * 1000.0 / frequency / BENCHMARK_FRAMES
+              << " ms/frame, " << result.drawCalls / BENCHMARK_FRAMES << " draw calls/frame, "
+              << result.vertices / BENCHMARK_FRAMES << " vertices/frame, "
+              << result.batched / BENCHMARK_FRAMES << " batched quads/frame, "
+              << result.uploads << " texture uploads" << std::endl;
+  }
+
+  std::string m_texture;
+};
+
+TEST_F(TestGUIHeadlessRender, RecordsDrawCalls)
+{
+  CGUITexture texture(0, 0, 100, 100, CTextureInfo(m_texture));
+  texture.AllocResources();
+  texture.Process(0);
+
+  g_Windowing.EndFrameStats();
+  texture.Render();
+  g_graphicsContext.FlushBatch();
+  g_Windowing.EndFrameStats();
+  EXPECT_EQ(1u, g_Windowing.GetFrameStats().drawCalls);
+  EXPECT_EQ(4u, g_Windowing.GetFrameStats().vertices);
+  EXPECT_EQ(1u, g_Windowing.GetFrameStats().textureUploads);
+
+  // the texture stays "on the GPU"
+  texture.Render();
+  g_graphicsContext.FlushBatch();
+  g_Windowing.EndFrameStats();
+  EXPECT_EQ(1u, g_Windowing.GetFrameStats().drawCalls);
+  EXPECT_EQ(0u, g_Windowing.GetFrameStats().textureUploads);
+
+  texture.FreeResources(true);
+}
+
+TEST_F(TestGUIHeadlessRender, BatchesQuads)
+{
+  if (!CGUIQuadBatcher::IsEnabled())
+    return;
+
+  std::string other = XBMC_REF_FILE_PATH("media/icon32x32.png");
+  CGUITexture left(0, 0, 100, 100, CTextureInfo(m_texture));
+  CGUITexture middle(200, 0, 100, 100, CTextureInfo(other));
+  CGUITexture right(400, 0, 100, 100, CTextureInfo(m_texture));
+  CGUITexture above(50, 50, 100, 100, CTextureInfo(other));
+  CGUITexture top(75, 75, 100, 100, CTextureInfo(m_texture));
+  CGUITexture *textures[] = { &left, &middle, &right, &above, &top };
+  for (unsigned int i = 0; i < sizeof(textures) / sizeof(textures[0]); i++)
+  {
+    textures[i]->AllocResources();
+    textures[i]->Process(0);
+  }
+
+  // right doesn't overlap middle, so it goes out with left
+  g_Windowing.EndFrameStats();
+  left.Render();
+  middle.Render();
+  right.Render();
+  g_graphicsContext.FlushBatch();
+  g_Windowing.EndFrameStats();
+  EXPECT_EQ(2u, g_Windowing.GetFrameStats().drawCalls);
+  EXPECT_EQ(3u, g_Windowing.GetFrameStats().batchedQuads);
+
+  // top has to be drawn over above, which is drawn over left
+  left.Render();
+  above.Render();
+  top.Render();
+  g_graphicsContext.FlushBatch();
+  g_Windowing.EndFrameStats();
+  EXPECT_EQ(3u, g_Windowing.GetFrameStats().drawCalls);
+
+  // nothing is batched when turned off
+  g_advancedSettings.m_guiBatchRendering = false;
+  left.Render();
+  middle.Render();
+  right.Render();
+  g_graphicsContext.FlushBatch();
+  g_Windowing.EndFrameStats();
+  g_advancedSettings.m_guiBatchRendering = true;
+  EXPECT_EQ(3u, g_Windowing.GetFrameStats().drawCalls);
+  EXPECT_EQ(0u, g_Windowing.GetFrameStats().batchedQuads);
+
+  for (unsigned int i = 0; i < sizeof(textures) / sizeof(textures[0]); i++)
+    textures[i]->FreeResources(true);
+}
+
+TEST_F(TestGUIHeadlessRender, CachesEmptyGlyph)
+{
+  // a size nothing else uses, so the font starts without a texture
+  CGUIFont *font = g_fontManager.LoadTTF("font17", XBMC_REF_FILE_PATH("media/Fonts/teletext.ttf"), 0xFFFFFFFF, 0, 17, FONT_STYLE_NORMAL);
+  ASSERT_TRUE(font != NULL);
+
+  // a space has no pixels, it doesn't need one either
+  EXPECT_GT(font->GetCharWidth(L' '), 0.0f);
+  EXPECT_GT(font->GetCharWidth(L'A'), 0.0f);
+  g_fontManager.Unload("font17");
+}
+
+TEST_F(TestGUIHeadlessRender, RendersList)
+{
+  ScrollResult result;
+  ASSERT_TRUE(Scroll(listXML, TEST_FRAMES, TEST_ITEMS, result));
+  EXPECT_GT(result.drawCalls, 0u);
+  EXPECT_GT(result.vertices, 0u);
+}
+
+TEST_F(TestGUIHeadlessRender, RendersPanel)
+{
+  ScrollResult result;
+  ASSERT_TRUE(Scroll(panelXML, TEST_FRAMES, TEST_ITEMS, result));
+  EXPECT_GT(result.drawCalls, 0u);
+  EXPECT_GT(result.vertices, 0u);
+}
+
+// scrolls through BENCHMARK_ITEMS items for BENCHMARK_FRAMES frames, too slow
+// for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestGUIHeadlessRender.*
+TEST_F(TestGUIHeadlessRender, DISABLED_ListBenchmark)
+{
+  Benchmark("list", listXML);
+}
+
+TEST_F(TestGUIHeadlessRender, DISABLED_PanelBenchmark)
+{
+  Benchmark("panel", panelXML);
+}
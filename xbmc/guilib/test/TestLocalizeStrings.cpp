@@ -0,0 +1,174 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/LocalizeStrings.h"
+#include "filesystem/File.h"
+#include "utils/TimeUtils.h"
+
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <iostream>
+
+#define BENCHMARK_LOADS   5
+#define BENCHMARK_LOOKUPS 1000000
+
+class CTestLocalizeStrings : public CLocalizeStrings
+{
+public:
+  typedef CLocalizeStrings::StringMap StringMap;
+  typedef CLocalizeStrings::ciStrings ciStrings;
+
+  static std::string LanguagePath()
+  {
+    return XBMC_REF_FILE_PATH("/language/");
+  }
+
+  static std::string SkinLanguagePath()
+  {
+    return XBMC_REF_FILE_PATH("/addons/skin.confluence/language/");
+  }
+
+  // loading without a cached table, the way it was always done
+  static void DeleteCache(const std::string& language)
+  {
+    XFILE::CFile::Delete(GetCacheFile(LanguagePath(), language));
+  }
+
+  // the lookup all strings went through before they were compiled into a table
+  void LoadMap(const std::string& language, StringMap& strings)
+  {
+    LoadLanguage(LanguagePath(), language, strings);
+  }
+};
+
+TEST(TestLocalizeStrings, Load)
+{
+  CTestLocalizeStrings::DeleteCache("German");
+  CTestLocalizeStrings strings;
+  ASSERT_TRUE(strings.Load(CTestLocalizeStrings::LanguagePath(), "German"));
+
+  EXPECT_STREQ("Programme", strings.Get(0).c_str());
+  EXPECT_STREQ("Bilder", strings.Get(1).c_str());
+  // not translated, so the English string is used
+  EXPECT_STREQ("Skip steps", strings.Get(13556).c_str());
+  EXPECT_STREQ("km/h", strings.Get(20200).c_str());
+  EXPECT_STREQ("", strings.Get(99999).c_str());
+  EXPECT_STREQ("", strings.Get(0xffffffff).c_str());
+
+  // a language without strings falls back to English
+  EXPECT_TRUE(strings.Load(CTestLocalizeStrings::LanguagePath(), "NoSuchLanguage-"));
+  EXPECT_STREQ("Programs", strings.Get(0).c_str());
+  EXPECT_FALSE(strings.Load("special://temp/", "NoSuchLanguage-"));
+  EXPECT_STREQ("", strings.Get(0).c_str());
+}
+
+TEST(TestLocalizeStrings, Cache)
+{
+  CTestLocalizeStrings::DeleteCache("German");
+  CTestLocalizeStrings parsed, cached;
+  ASSERT_TRUE(parsed.Load(CTestLocalizeStrings::LanguagePath(), "German"));
+  ASSERT_TRUE(cached.Load(CTestLocalizeStrings::LanguagePath(), "German"));
+
+  for (uint32_t id = 0; id < 40000; id++)
+    EXPECT_EQ(parsed.Get(id), cached.Get(id)) << "string " << id;
+
+  std::wstring parsedCharacters, cachedCharacters;
+  parsed.GetCharacters(parsedCharacters, 0, 40000);
+  cached.GetCharacters(cachedCharacters, 0, 40000);
+  EXPECT_TRUE(parsedCharacters == cachedCharacters);
+}
+
+TEST(TestLocalizeStrings, SkinStrings)
+{
+  CTestLocalizeStrings strings;
+  ASSERT_TRUE(strings.Load(CTestLocalizeStrings::LanguagePath(), "English"));
+  ASSERT_TRUE(strings.LoadSkinStrings(CTestLocalizeStrings::SkinLanguagePath(), "German"));
+
+  EXPECT_STRNE("", strings.Get(31000).c_str());
+  EXPECT_STREQ("Programs", strings.Get(0).c_str());
+
+  // the characters of the skin's strings are a part of all of them
+  std::wstring skinCharacters, allCharacters;
+  strings.GetCharacters(skinCharacters, 31000, 31999);
+  strings.GetCharacters(allCharacters, 0, 40000);
+  EXPECT_FALSE(skinCharacters.empty());
+  EXPECT_TRUE(std::includes(allCharacters.begin(), allCharacters.end(), skinCharacters.begin(), skinCharacters.end()));
+
+  strings.ClearSkinStrings();
+  EXPECT_STREQ("", strings.Get(31000).c_str());
+  EXPECT_STREQ("Programs", strings.Get(0).c_str());
+}
+
+// 5 loads and a million lookups, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestLocalizeStrings.*
+TEST(TestLocalizeStrings, DISABLED_Benchmark)
+{
+  double frequency = (double)CurrentHostFrequency();
+
+  int64_t parsing = 0;
+  for (int i = 0; i < BENCHMARK_LOADS; i++)
+  {
+    CTestLocalizeStrings::DeleteCache("German");
+    CTestLocalizeStrings strings;
+    int64_t start = CurrentHostCounter();
+    ASSERT_TRUE(strings.Load(CTestLocalizeStrings::LanguagePath(), "German"));
+    parsing += CurrentHostCounter() - start;
+  }
+
+  CTestLocalizeStrings strings;
+  int64_t caching = 0;
+  for (int i = 0; i < BENCHMARK_LOADS; i++)
+  {
+    int64_t start = CurrentHostCounter();
+    ASSERT_TRUE(strings.Load(CTestLocalizeStrings::LanguagePath(), "German"));
+    caching += CurrentHostCounter() - start;
+  }
+
+  std::cout << "LocalizeStrings: loading German takes " << parsing * 1000.0 / frequency / BENCHMARK_LOADS
+            << " ms from the strings files and " << caching * 1000.0 / frequency / BENCHMARK_LOADS
+            << " ms from the cache" << std::endl;
+
+  // ids from the whole range, including the many that have no string
+  CTestLocalizeStrings::StringMap map;
+  strings.LoadMap("German", map);
+  size_t length = 0;
+  int64_t start = CurrentHostCounter();
+  for (uint32_t i = 0; i < BENCHMARK_LOOKUPS; i++)
+  {
+    CTestLocalizeStrings::ciStrings it = map.find(i % 40000);
+    if (it != map.end())
+      length += it->second.strTranslated.size();
+  }
+  int64_t mapLookups = CurrentHostCounter() - start;
+
+  size_t tableLength = 0;
+  start = CurrentHostCounter();
+  for (uint32_t i = 0; i < BENCHMARK_LOOKUPS; i++)
+    tableLength += strings.Get(i % 40000).size();
+  int64_t tableLookups = CurrentHostCounter() - start;
+  EXPECT_EQ(length, tableLength);
+
+  std::cout << "LocalizeStrings: Get() takes " << mapLookups * 1000000000.0 / frequency / BENCHMARK_LOOKUPS
+            << " ns with a map and " << tableLookups * 1000000000.0 / frequency / BENCHMARK_LOOKUPS
+            << " ns with the table" << std::endl;
+}
@@ -52,6 +52,8 @@
 #include "storage/MediaManager.h"
 #include "utils/RssManager.h"
 #include "utils/JSONVariantParser.h"
+#include "utils/PerformanceTrace.h"
+#include "cores/VideoRenderers/VideoTelemetry.h"
 #include "PartyModeManager.h"
 #include "profiles/ProfilesManager.h"
 #include "settings/DisplaySettings.h"
@@ -224,6 +226,8 @@ const BUILT_IN commands[] = {
 #endif
   { "VideoLibrary.Search",        false,  "Brings up a search dialog which will search the library" },
   { "ToggleDebug",                false,  "Enables/disables debug mode" },
+  { "Tracing",                    true,   "Records what the threads are doing. Params can be: start, stop or dump with an optional file, special://logpath/trace.json by default" },
+  { "VideoTelemetry",             true,   "Timings of the most recent video frames. Params can be: reset or dump with an optional file, special://logpath/videotelemetry.csv by default" },
   { "StartPVRManager",            false,  "(Re)Starts the PVR manager" },
   { "StopPVRManager",             false,  "Stops the PVR manager" },
 #if defined(TARGET_ANDROID)
@@ -1826,6 +1830,22 @@ int CBuiltins::Execute(const std::string& execString)
     CSettings::Get().SetBool("debug.showloginfo", !debug);
     g_advancedSettings.SetDebugMode(!debug);
   }
+  else if (execute == "tracing" && !params.empty())
+  {
+    if (StringUtils::EqualsNoCase(params[0], "start"))
+      CPerformanceTrace::Start();
+    else if (StringUtils::EqualsNoCase(params[0], "stop"))
+      CPerformanceTrace::Stop();
+    else if (StringUtils::EqualsNoCase(params[0], "dump"))
+      CPerformanceTrace::Dump(params.size() > 1 ? params[1] : "special://logpath/trace.json");
+  }
+  else if (execute == "videotelemetry" && !params.empty())
+  {
+    if (StringUtils::EqualsNoCase(params[0], "reset"))
+      g_videoTelemetry.Reset();
+    else if (StringUtils::EqualsNoCase(params[0], "dump"))
+      g_videoTelemetry.Dump(params.size() > 1 ? params[1] : "special://logpath/videotelemetry.csv");
+  }
   else if (execute == "startpvrmanager")
   {
     g_application.StartPVRManager();
@@ -19,6 +19,8 @@
  *
  */
 
+#include <string>
+
 class ILanguageInvoker;
 
 class ILanguageInvocationHandler
@@ -38,5 +40,11 @@ public:
   virtual void OnScriptEnded(ILanguageInvoker *invoker) { }
   virtual void OnScriptFinalized(ILanguageInvoker *invoker) { }
 
+  /*!
+   \brief The add-on was updated, disabled or uninstalled, nothing kept from
+   earlier runs of its scripts may be used again.
+   */
+  virtual void OnAddonChanged(const std::string &addonId) { }
+
   virtual ILanguageInvoker* CreateInvoker() = 0;
 };
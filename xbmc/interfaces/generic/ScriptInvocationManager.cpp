@@ -261,6 +261,20 @@ bool CScriptInvocationManager::IsRunning(int scriptId) const
   return !invokerThread.done;
 }
 
+void CScriptInvocationManager::OnAddonChanged(const std::string &addonId)
+{
+  // handlers are registered once per extension
+  std::set<ILanguageInvocationHandler*> handlers;
+  {
+    CSingleLock lock(m_critSection);
+    for (LanguageInvocationHandlerMap::iterator it = m_invocationHandlers.begin(); it != m_invocationHandlers.end(); ++it)
+      handlers.insert(it->second);
+  }
+
+  for (std::set<ILanguageInvocationHandler*>::iterator it = handlers.begin(); it != handlers.end(); ++it)
+    (*it)->OnAddonChanged(addonId);
+}
+
 void CScriptInvocationManager::OnScriptEnded(int scriptId)
 {
   if (scriptId < 0)
@@ -51,6 +51,8 @@ public:
 
   bool IsRunning(int scriptId) const;
 
+  void OnAddonChanged(const std::string &addonId);
+
 protected:
   friend class CLanguageInvokerThread;
 
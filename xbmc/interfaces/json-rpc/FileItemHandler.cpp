@@ -44,11 +44,67 @@
 #include "pvr/timers/PVRTimerInfoTag.h"
 #include "epg/Epg.h"
 #include "epg/EpgContainer.h"
+#include "utils/JSONStreamWriter.h"
 
 using namespace MUSIC_INFO;
 using namespace JSONRPC;
 using namespace XFILE;
 
+/*!
+ \brief Writes the items of a list once the method has returned, so that the
+ list never has to exist as a whole in the output.
+
+ The items are filled right away while the method runs, the thumb loader and
+ the database aren't touched any more while the response is being sent.
+ */
+class CFileItemHandler::CStreamedFileItemList : public IStreamedResult
+{
+public:
+  CStreamedFileItemList(const char *ID, bool allowFile, const CFileItemList &items, int start, int end, const std::set<std::string> &fields)
+    : m_current(0),
+      m_begun(false)
+  {
+    CThumbLoader *thumbLoader = CreateThumbLoader(items.Get(start));
+
+    m_objects.resize(end - start);
+    for (int i = start; i < end; i++)
+      FillFileItem(ID, allowFile, items.Get(i), fields, m_objects[i - start], thumbLoader);
+
+    delete thumbLoader;
+  }
+
+  virtual bool WriteNext(CJSONStreamWriter &writer)
+  {
+    if (!m_begun)
+    {
+      m_begun = true;
+      return writer.BeginArray();
+    }
+
+    // a handful of items per call keeps the output between calls well below a chunk
+    for (int count = 0; count < ItemsPerWrite && m_current < m_objects.size(); count++, m_current++)
+    {
+      if (!writer.Value(m_objects[m_current]))
+        return false;
+      // what has been written isn't needed any more
+      m_objects[m_current] = CVariant();
+    }
+
+    if (m_current < m_objects.size())
+      return true;
+
+    writer.EndArray();
+    return false;
+  }
+
+private:
+  static const int ItemsPerWrite = 8;
+
+  std::vector<CVariant> m_objects;
+  size_t m_current;
+  bool m_begun;
+};
+
 bool CFileItemHandler::GetField(const std::string &field, const CVariant &info, const CFileItemPtr &item, CVariant &result, bool &fetchedArt, CThumbLoader *thumbLoader /* = NULL */)
 {
   if (result.isMember(field) && !result[field].empty())
@@ -223,18 +279,6 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
     end = items.Size();
   }
 
-  CThumbLoader *thumbLoader = NULL;
-  if (end - start > 0)
-  {
-    if (items.Get(start)->HasVideoInfoTag())
-      thumbLoader = new CVideoThumbLoader();
-    else if (items.Get(start)->HasMusicInfoTag())
-      thumbLoader = new CMusicThumbLoader();
-
-    if (thumbLoader != NULL)
-      thumbLoader->OnLoaderStart();
-  }
-
   std::set<std::string> fields;
   if (parameterObject.isMember("properties") && parameterObject["properties"].isArray())
   {
@@ -242,6 +286,18 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
       fields.insert(field->asString());
   }
 
+  if (end - start <= 0)
+    return;
+
+  // if the list goes straight into the response the items are only serialized while it's being sent
+  if (resultname != NULL && CJSONRPC::CanStreamResult(result))
+  {
+    CJSONRPC::StreamResult(result, resultname, new CStreamedFileItemList(ID, allowFile, items, start, end, fields));
+    return;
+  }
+
+  CThumbLoader *thumbLoader = CreateThumbLoader(items.Get(start));
+
   for (int i = start; i < end; i++)
   {
     CFileItemPtr item = items.Get(i);
@@ -251,6 +307,20 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
   delete thumbLoader;
 }
 
+CThumbLoader* CFileItemHandler::CreateThumbLoader(const CFileItemPtr &item)
+{
+  CThumbLoader *thumbLoader = NULL;
+  if (item->HasVideoInfoTag())
+    thumbLoader = new CVideoThumbLoader();
+  else if (item->HasMusicInfoTag())
+    thumbLoader = new CMusicThumbLoader();
+
+  if (thumbLoader != NULL)
+    thumbLoader->OnLoaderStart();
+
+  return thumbLoader;
+}
+
 void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const CVariant &validFields, CVariant &result, bool append /* = true */, CThumbLoader *thumbLoader /* = NULL */)
 {
   std::set<std::string> fields;
@@ -266,6 +336,19 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
 void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const std::set<std::string> &validFields, CVariant &result, bool append /* = true */, CThumbLoader *thumbLoader /* = NULL */)
 {
   CVariant object;
+  FillFileItem(ID, allowFile, item, validFields, object, thumbLoader);
+
+  if (resultname)
+  {
+    if (append)
+      result[resultname].emplace_back().swap(object);
+    else
+      result[resultname].swap(object);
+  }
+}
+
+void CFileItemHandler::FillFileItem(const char *ID, bool allowFile, const CFileItemPtr &item, const std::set<std::string> &validFields, CVariant &object, CThumbLoader *thumbLoader /* = NULL */)
+{
   std::set<std::string> fields(validFields.begin(), validFields.end());
 
   if (item.get())
@@ -378,14 +461,6 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
   }
   else
     object = CVariant(CVariant::VariantTypeNull);
-
-  if (resultname)
-  {
-    if (append)
-      result[resultname].append(object);
-    else
-      result[resultname] = object;
-  }
 }
 
 bool CFileItemHandler::FillFileItemList(const CVariant &parameterObject, CFileItemList &list)
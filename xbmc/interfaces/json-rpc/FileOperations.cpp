@@ -101,7 +101,17 @@ JSONRPC_STATUS CFileOperations::GetDirectory(const std::string &method, ITranspo
     extensions = g_advancedSettings.m_pictureExtensions;
   }
 
-  if (CDirectory::GetDirectory(strPath, items, extensions))
+  CDirectory::CHints hints;
+  hints.mask = extensions;
+
+  // let the library databases sort the listing and only return the requested items
+  if (URIUtils::IsMusicDb(strPath) || URIUtils::IsVideoDb(strPath))
+  {
+    ParseSorting(parameterObject, hints.sorting.sortBy, hints.sorting.sortOrder, hints.sorting.sortAttributes);
+    ParseLimits(parameterObject, hints.sorting.limitStart, hints.sorting.limitEnd);
+  }
+
+  if (CDirectory::GetDirectory(strPath, items, hints))
   {
     // we might need to get additional information for music items
     if (media == "music")
@@ -160,7 +170,11 @@ JSONRPC_STATUS CFileOperations::GetDirectory(const std::string &method, ITranspo
       param["properties"].append("file");
     param["properties"].append("filetype");
 
-    HandleFileItemList("id", true, "files", filteredFiles, param, result);
+    // a listing paged by the library is already sorted and limited
+    if (items.HasProperty("total") && items.GetProperty("total").asInteger() > items.Size())
+      HandleFileItemList("id", true, "files", filteredFiles, param, result, (int)items.GetProperty("total").asInteger(), false);
+    else
+      HandleFileItemList("id", true, "files", filteredFiles, param, result);
 
     return OK;
   }
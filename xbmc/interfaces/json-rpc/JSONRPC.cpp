@@ -27,6 +27,8 @@
 #include "interfaces/AnnouncementManager.h"
 #include "playlists/SmartPlayList.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/ThreadLocal.h"
+#include "utils/JSONStreamWriter.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
@@ -38,6 +40,141 @@ using namespace std;
 
 bool CJSONRPC::m_initialized = false;
 
+namespace
+{
+  /*!
+   \brief The result of the method MethodCall() is executing on this thread
+   and the members of it that are streamed
+   */
+  struct StreamContext
+  {
+    const CVariant *result;
+    CJSONRPCResponse::StreamedMembers *streamed;
+  };
+
+  XbmcThreads::ThreadLocal<StreamContext> streamContext;
+
+  void DeleteStreamed(CJSONRPCResponse::StreamedMembers &streamed)
+  {
+    for (CJSONRPCResponse::StreamedMembers::iterator member = streamed.begin(); member != streamed.end(); ++member)
+      delete member->second;
+    streamed.clear();
+  }
+}
+
+CJSONRPCResponse::CJSONRPCResponse()
+  : m_batch(false),
+    m_begun(false),
+    m_current(0),
+    m_member(0),
+    m_memberBegun(false)
+{ }
+
+CJSONRPCResponse::~CJSONRPCResponse()
+{
+  for (std::vector<Response>::iterator response = m_responses.begin(); response != m_responses.end(); ++response)
+    DeleteStreamed(response->streamed);
+}
+
+void CJSONRPCResponse::Add(CVariant &response, StreamedMembers &streamed)
+{
+  m_responses.push_back(Response());
+  m_responses.back().response.swap(response);
+  m_responses.back().streamed.swap(streamed);
+}
+
+bool CJSONRPCResponse::IsStreamed() const
+{
+  for (std::vector<Response>::const_iterator response = m_responses.begin(); response != m_responses.end(); ++response)
+  {
+    if (!response->streamed.empty())
+      return true;
+  }
+  return false;
+}
+
+bool CJSONRPCResponse::WriteNext(CJSONStreamWriter &writer)
+{
+  if (writer.HasFailed())
+    return false;
+
+  if (!m_begun)
+  {
+    m_begun = true;
+    if (m_batch && !writer.BeginArray())
+      return false;
+  }
+
+  if (m_current < m_responses.size())
+  {
+    const Response &response = m_responses[m_current];
+    bool more = false;
+    if (response.streamed.empty())
+      writer.Value(response.response);
+    else
+      more = WriteStreamed(writer, response);
+
+    if (!more)
+    {
+      m_current++;
+      m_member = 0;
+      m_memberBegun = false;
+    }
+    return !writer.HasFailed();
+  }
+
+  if (m_batch)
+    writer.EndArray();
+  writer.Flush();
+  return false;
+}
+
+bool CJSONRPCResponse::WriteStreamed(CJSONStreamWriter &writer, const Response &response)
+{
+  if (m_member == 0 && !m_memberBegun)
+  {
+    // everything that has been built by the method goes first
+    writer.BeginObject();
+    for (CVariant::const_iterator_map member = response.response.begin_map(); member != response.response.end_map(); ++member)
+    {
+      if (member->first == "result")
+        continue;
+      writer.Key(member->first);
+      writer.Value(member->second);
+    }
+
+    const CVariant &result = response.response["result"];
+    writer.Key("result");
+    writer.BeginObject();
+    for (CVariant::const_iterator_map member = result.begin_map(); member != result.end_map(); ++member)
+    {
+      writer.Key(member->first);
+      writer.Value(member->second);
+    }
+  }
+
+  if (m_member < response.streamed.size())
+  {
+    const StreamedMembers::value_type &member = response.streamed[m_member];
+    if (!m_memberBegun)
+    {
+      writer.Key(member.first);
+      m_memberBegun = true;
+    }
+
+    if (!member.second->WriteNext(writer))
+    {
+      m_member++;
+      m_memberBegun = false;
+    }
+    return true;
+  }
+
+  writer.EndObject();
+  writer.EndObject();
+  return false;
+}
+
 void CJSONRPC::Initialize()
 {
   if (m_initialized)
@@ -103,6 +240,9 @@ void CJSONRPC::Initialize()
 
   for (unsigned int index = 0; index < size; index++)
     CJSONServiceDescription::AddNotification(JSONRPC_SERVICE_NOTIFICATIONS[index]);
+
+  // now that all types are known
+  CJSONServiceDescription::CompileValidators();
   
   m_initialized = true;
   CLog::Log(LOGINFO, "JSONRPC v%s: Successfully initialized", CJSONServiceDescription::GetVersion());
@@ -229,13 +369,27 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const std::string &method, ITransportLayer *t
 
 std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client)
 {
-  CVariant inputroot, outputroot, result;
-  bool hasResponse = false;
+  CJSONRPCResponse response;
+  MethodCall(inputString, transport, client, response);
+
+  std::string str;
+  if (!response.IsEmpty())
+  {
+    CJSONStringOutput output(str);
+    CJSONStreamWriter writer(output, g_advancedSettings.m_jsonOutputCompact);
+    while (response.WriteNext(writer)) ;
+  }
+  return str;
+}
+
+void CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client, CJSONRPCResponse &response)
+{
+  CJSONRPCResponse::StreamedMembers streamed;
 
   if(g_advancedSettings.CanLogComponent(LOGJSONRPC))
     CLog::Log(LOGDEBUG, "JSONRPC: Incoming request: %s", inputString.c_str());
 
-  inputroot = CJSONVariantParser::Parse((unsigned char *)inputString.c_str(), inputString.length());
+  CVariant inputroot = CJSONVariantParser::Parse((unsigned char *)inputString.c_str(), inputString.length());
   if (!inputroot.isNull())
   {
     if (inputroot.isArray())
@@ -243,37 +397,60 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
       if (inputroot.size() <= 0)
       {
         CLog::Log(LOGERROR, "JSONRPC: Empty batch call\n");
-        BuildResponse(inputroot, InvalidRequest, CVariant(), outputroot);
-        hasResponse = true;
+        CVariant outputroot, result;
+        BuildResponse(inputroot, InvalidRequest, result, outputroot);
+        response.Add(outputroot, streamed);
       }
       else
       {
+        response.m_batch = true;
         for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
         {
-          CVariant response;
-          if (HandleMethodCall(*itr, response, transport, client))
-          {
-            outputroot.append(response);
-            hasResponse = true;
-          }
+          CVariant outputroot;
+          if (HandleMethodCall(*itr, outputroot, streamed, transport, client))
+            response.Add(outputroot, streamed);
+          else
+            DeleteStreamed(streamed);
         }
       }
     }
     else
-      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client);
+    {
+      CVariant outputroot;
+      if (HandleMethodCall(inputroot, outputroot, streamed, transport, client))
+        response.Add(outputroot, streamed);
+      else
+        DeleteStreamed(streamed);
+    }
   }
   else
   {
     CLog::Log(LOGERROR, "JSONRPC: Failed to parse '%s'\n", inputString.c_str());
-    BuildResponse(inputroot, ParseError, CVariant(), outputroot);
-    hasResponse = true;
+    CVariant outputroot, result;
+    BuildResponse(inputroot, ParseError, result, outputroot);
+    response.Add(outputroot, streamed);
   }
+}
 
-  std::string str = hasResponse ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
-  return str;
+bool CJSONRPC::CanStreamResult(const CVariant &result)
+{
+  StreamContext *context = streamContext.get();
+  return context != NULL && context->result == &result;
 }
 
-bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
+void CJSONRPC::StreamResult(CVariant &result, const std::string &key, IStreamedResult *value)
+{
+  StreamContext *context = streamContext.get();
+  if (context == NULL || context->result != &result)
+  {
+    delete value;
+    return;
+  }
+
+  context->streamed->push_back(std::make_pair(key, value));
+}
+
+bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, CJSONRPCResponse::StreamedMembers &streamed, ITransportLayer *transport, IClient *client)
 {
   JSONRPC_STATUS errorCode = OK;
   CVariant result;
@@ -290,7 +467,17 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     CVariant params;
 
     if ((errorCode = CJSONServiceDescription::CheckCall(methodName.c_str(), request["params"], transport, client, isNotification, method, params)) == OK)
+    {
+      // let the method hand parts of its result to the response
+      StreamContext context = { &result, &streamed };
+      StreamContext *outerContext = streamContext.get();
+      streamContext.set(&context);
       errorCode = method(methodName, transport, client, params, result);
+      streamContext.set(outerContext);
+
+      if (errorCode != OK)
+        DeleteStreamed(streamed);
+    }
     else
       result = params;
   }
@@ -310,7 +497,7 @@ inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
   return inputroot.isObject() && inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
 }
 
-inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response)
+inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant& result, CVariant& response)
 {
   response["jsonrpc"] = "2.0";
   response["id"] = request.isObject() && request.isMember("id") ? request["id"] : CVariant();
@@ -318,7 +505,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
   switch (code)
   {
     case OK:
-      response["result"] = result;
+      response["result"].swap(result);
       break;
     case ACK:
       response["result"] = "OK";
@@ -331,7 +518,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
       response["error"]["code"] = InvalidParams;
       response["error"]["message"] = "Invalid params.";
       if (!result.isNull())
-        response["error"]["data"] = result;
+        response["error"]["data"].swap(result);
       break;
     case MethodNotFound:
       response["error"]["code"] = MethodNotFound;
@@ -23,13 +23,93 @@
 #include <map>
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
 #include "interfaces/IAnnouncer.h"
 
+class CJSONStreamWriter;
+
 namespace JSONRPC
 {
+  /*!
+   \ingroup jsonrpc
+   \brief Member of a method's result that is written straight into the
+   response instead of being built as a CVariant first.
+   \sa CJSONRPC::StreamResult()
+   */
+  class IStreamedResult
+  {
+  public:
+    virtual ~IStreamedResult() { }
+
+    /*!
+     \brief Writes the next part of the value
+     \param writer Writer of the response
+     \return True if there's more to write, false once the value is complete
+     or writing failed
+
+     The value is written in several steps so that transports which send
+     the response while it is generated don't have to buffer all of it.
+     */
+    virtual bool WriteNext(CJSONStreamWriter &writer) = 0;
+  };
+
+  /*!
+   \ingroup jsonrpc
+   \brief Response to a JSON-RPC request, which is written while it's sent.
+   \sa CJSONRPC::MethodCall()
+   */
+  class CJSONRPCResponse
+  {
+  public:
+    typedef std::vector<std::pair<std::string, IStreamedResult*> > StreamedMembers;
+
+    CJSONRPCResponse();
+    ~CJSONRPCResponse();
+
+    /*!
+     \brief Whether there's nothing to send back, e.g. for notifications
+     */
+    bool IsEmpty() const { return m_responses.empty(); }
+
+    /*!
+     \brief Whether a method handed a member of its result to StreamResult()
+     */
+    bool IsStreamed() const;
+
+    /*!
+     \brief Writes the next part of the response
+     \return True if there's more to write, false once the response is
+     complete or writing failed
+
+     The writer is flushed once the response is complete.
+     */
+    bool WriteNext(CJSONStreamWriter &writer);
+
+  private:
+    friend class CJSONRPC;
+    CJSONRPCResponse(const CJSONRPCResponse&);
+    CJSONRPCResponse& operator=(const CJSONRPCResponse&);
+
+    struct Response
+    {
+      CVariant response;
+      StreamedMembers streamed;
+    };
+
+    void Add(CVariant &response, StreamedMembers &streamed);
+    bool WriteStreamed(CJSONStreamWriter &writer, const Response &response);
+
+    std::vector<Response> m_responses;
+    bool m_batch;
+    bool m_begun;
+    size_t m_current;
+    size_t m_member;
+    bool m_memberBegun;
+  };
+
   /*!
    \ingroup jsonrpc
    \brief JSON RPC handler
@@ -63,6 +143,39 @@ namespace JSONRPC
      */
     static std::string MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client);
 
+    /*
+     \brief Handles an incoming JSON-RPC request without building the response as a whole
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \param response [out] JSON-RPC response, to be written to the client by the transport
+
+     The called methods are executed right away, but members of their
+     results that have been handed to StreamResult() are only produced
+     while the response is written.
+     */
+    static void MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client, CJSONRPCResponse &response);
+
+    /*
+     \brief Whether a member of the given result may be handed to StreamResult()
+     \param result Result of the method being executed
+
+     Only the result a method has been called with by MethodCall() can have
+     streamed members, any other CVariant has to be filled in as usual.
+     */
+    static bool CanStreamResult(const CVariant &result);
+
+    /*
+     \brief Has a member of a method's result written by the given object
+     \param result Result of the method being executed
+     \param key Name of the member
+     \param value Writes the member once the method succeeded, deleted by the response
+
+     Must only be used if CanStreamResult() returned true for the result.
+     The method must not touch the member afterwards.
+     */
+    static void StreamResult(CVariant &result, const std::string &key, IStreamedResult *value);
+
     static JSONRPC_STATUS Introspect(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -73,10 +186,10 @@ namespace JSONRPC
   
   private:
     static void setup();
-    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    static bool HandleMethodCall(const CVariant& request, CVariant& response, CJSONRPCResponse::StreamedMembers &streamed, ITransportLayer *transport, IClient *client);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
-    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
+    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant& result, CVariant& response);
 
     static bool m_initialized;
   };
@@ -0,0 +1,488 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <string.h>
+
+#include "JSONSchemaValidator.h"
+#include "JSONServiceDescription.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+using namespace JSONRPC;
+
+CJSONSchemaValidator::CJSONSchemaValidator(const std::vector<JSONSchemaTypeDefinitionPtr> &parameters)
+{
+  std::map<const JSONSchemaTypeDefinition*, size_t> compiled;
+  compile(parameters, m_parameters, compiled);
+}
+
+JSONRPC_STATUS CJSONSchemaValidator::Check(const CVariant &requestParameters, CVariant &outputParameters, CVariant &errorData) const
+{
+  // Count the number of actually handled (present) parameters
+  unsigned int handled = 0;
+
+  for (unsigned int position = 0; position < m_parameters.size(); position++)
+  {
+    const JSONSchemaTypeDefinition &definition = *m_types[m_parameters[position]].definition;
+
+    // Parameters can be passed by name or by position
+    const CVariant *parameter = NULL;
+    if (requestParameters.isObject() && requestParameters.isMember(definition.name))
+      parameter = &requestParameters[definition.name];
+    else if (requestParameters.isArray() && requestParameters.size() > position)
+      parameter = &requestParameters[position];
+
+    if (parameter != NULL)
+    {
+      CVariant parameterError;
+      JSONRPC_STATUS status = check(m_parameters[position], *parameter, outputParameters[definition.name], parameterError);
+      if (status != OK)
+      {
+        errorData["stack"].swap(parameterError);
+        return status;
+      }
+
+      handled++;
+    }
+    // If the parameter has not been provided but is optional
+    // we can use its default value
+    else if (definition.optional)
+      outputParameters[definition.name] = definition.defaultValue;
+    else
+    {
+      errorData["stack"]["name"] = definition.name;
+      SchemaValueTypeToJson(definition.type, errorData["stack"]["type"]);
+      errorData["stack"]["message"] = "Missing parameter";
+      return InvalidParams;
+    }
+  }
+
+  // Check if there were unnecessary parameters
+  if (handled < requestParameters.size())
+  {
+    errorData["message"] = "Too many parameters";
+    return InvalidParams;
+  }
+
+  return OK;
+}
+
+size_t CJSONSchemaValidator::compile(const JSONSchemaTypeDefinitionPtr &definition, std::map<const JSONSchemaTypeDefinition*, size_t> &compiled)
+{
+  // types referenced from several places (or from themselves) are only compiled once
+  std::map<const JSONSchemaTypeDefinition*, size_t>::const_iterator it = compiled.find(definition.get());
+  if (it != compiled.end())
+    return it->second;
+
+  // this is what JSONSchemaTypeDefinition::Check() would do the first time it is called
+  if (definition->referencedType != NULL && !definition->referencedTypeSet)
+    definition->Set(definition->referencedType);
+
+  size_t index = m_types.size();
+  m_types.push_back(Type());
+  compiled[definition.get()] = index;
+
+  // compiling the referenced types adds to m_types so don't hold on to m_types[index]
+  Type type;
+  type.definition = definition;
+  compile(definition->unionTypes, type.unionTypes, compiled);
+  compile(definition->extends, type.extends, compiled);
+  compile(definition->items, type.items, compiled);
+  compile(definition->additionalItems, type.additionalItems, compiled);
+
+  for (JSONSchemaTypeDefinition::CJsonSchemaPropertiesMap::JSONSchemaPropertiesIterator property = definition->properties.begin(); property != definition->properties.end(); ++property)
+  {
+    Property compiledProperty;
+    compiledProperty.name = property->second->name;
+    compiledProperty.type = compile(property->second, compiled);
+    type.properties.push_back(compiledProperty);
+  }
+  std::sort(type.properties.begin(), type.properties.end(), propertyLess);
+
+  if (definition->hasAdditionalProperties && definition->additionalProperties != NULL)
+    type.additionalProperties = compile(definition->additionalProperties, compiled);
+  else
+    type.additionalProperties = NoType;
+
+  type.stringEnums = !definition->enums.empty();
+  for (std::vector<CVariant>::const_iterator enumValue = definition->enums.begin(); enumValue != definition->enums.end() && type.stringEnums; ++enumValue)
+  {
+    if (enumValue->isString())
+      type.enumStrings.push_back(enumValue->asString());
+    else
+      type.stringEnums = false;
+  }
+  if (type.stringEnums)
+    std::sort(type.enumStrings.begin(), type.enumStrings.end());
+  else
+    type.enumStrings.clear();
+
+  m_types[index] = type;
+  return index;
+}
+
+void CJSONSchemaValidator::compile(const std::vector<JSONSchemaTypeDefinitionPtr> &definitions, std::vector<size_t> &types, std::map<const JSONSchemaTypeDefinition*, size_t> &compiled)
+{
+  for (std::vector<JSONSchemaTypeDefinitionPtr>::const_iterator definition = definitions.begin(); definition != definitions.end(); ++definition)
+    types.push_back(compile(*definition, compiled));
+}
+
+JSONRPC_STATUS CJSONSchemaValidator::check(size_t index, const CVariant &value, CVariant &outputValue, CVariant &errorData) const
+{
+  const Type &type = m_types[index];
+  const JSONSchemaTypeDefinition &definition = *type.definition;
+
+  // Let's check the type of the provided parameter
+  if (!IsType(value, definition.type))
+    return fail(type, errorData, StringUtils::Format("Invalid type %s received", ValueTypeToString(value.type())));
+  else if (value.isNull() && !HasType(definition.type, NullValue))
+    return fail(type, errorData, "Received value is null");
+
+  // Let's check if we have to handle a union type
+  if (!type.unionTypes.empty())
+  {
+    bool ok = false;
+    for (std::vector<size_t>::const_iterator unionType = type.unionTypes.begin(); unionType != type.unionTypes.end(); ++unionType)
+    {
+      CVariant dummyError;
+      CVariant testOutput = outputValue;
+      if (check(*unionType, value, testOutput, dummyError) == OK)
+      {
+        ok = true;
+        outputValue.swap(testOutput);
+        break;
+      }
+    }
+
+    if (!ok)
+      return fail(type, errorData, "Received value does not match any of the union type definitions");
+  }
+
+  // If this type extends other types the value has to match those first
+  for (std::vector<size_t>::const_iterator extended = type.extends.begin(); extended != type.extends.end(); ++extended)
+  {
+    JSONRPC_STATUS status = check(*extended, value, outputValue, errorData);
+    if (status != OK)
+    {
+      const std::string &extendedID = m_types[*extended].definition->ID;
+      CLog::Log(LOGDEBUG, "JSONRPC: Value does not match extended type %s of type %s", extendedID.c_str(), definition.name.c_str());
+      errorData["message"] = StringUtils::Format("value does not match extended type %s", extendedID.c_str());
+      return status;
+    }
+  }
+
+  if (HasType(definition.type, ArrayValue) && value.isArray())
+    return checkArray(type, value, outputValue, errorData);
+
+  if (HasType(definition.type, ObjectValue) && value.isObject())
+    return checkObject(type, value, outputValue, errorData);
+
+  // It's neither an array nor an object
+
+  // If it can only take certain values ("enum")
+  // we need to check against those
+  if (!definition.enums.empty() && !checkEnum(type, value))
+  {
+    CLog::Log(LOGDEBUG, "JSONRPC: Value does not match any of the enum values in type %s", definition.name.c_str());
+    return fail(type, errorData, "Received value does not match any of the defined enum values");
+  }
+
+  // If we have a number or an integer type, we need
+  // to check the minimum and maximum values
+  if ((HasType(definition.type, NumberValue) && value.isDouble()) || (HasType(definition.type, IntegerValue) && value.isInteger()))
+  {
+    double numberValue;
+    if (value.isDouble())
+      numberValue = value.asDouble();
+    else
+      numberValue = (double)value.asInteger();
+
+    if ((definition.exclusiveMinimum && numberValue <= definition.minimum) || (!definition.exclusiveMinimum && numberValue < definition.minimum) ||
+        (definition.exclusiveMaximum && numberValue >= definition.maximum) || (!definition.exclusiveMaximum && numberValue > definition.maximum))
+    {
+      CLog::Log(LOGDEBUG, "JSONRPC: Value does not lay between minimum and maximum in type %s", definition.name.c_str());
+      if (value.isDouble())
+        return fail(type, errorData, StringUtils::Format("Value between %f (%s) and %f (%s) expected but %f received",
+          definition.minimum, definition.exclusiveMinimum ? "exclusive" : "inclusive", definition.maximum, definition.exclusiveMaximum ? "exclusive" : "inclusive", numberValue));
+      else
+        return fail(type, errorData, StringUtils::Format("Value between %d (%s) and %d (%s) expected but %d received",
+          (int)definition.minimum, definition.exclusiveMinimum ? "exclusive" : "inclusive", (int)definition.maximum, definition.exclusiveMaximum ? "exclusive" : "inclusive", (int)numberValue));
+    }
+
+    if (HasType(definition.type, IntegerValue) && definition.divisibleBy > 0 && ((int)numberValue % definition.divisibleBy) != 0)
+    {
+      CLog::Log(LOGDEBUG, "JSONRPC: Value does not meet divisibleBy requirements in type %s", definition.name.c_str());
+      return fail(type, errorData, StringUtils::Format("Value should be divisible by %d but %d received", definition.divisibleBy, (int)numberValue));
+    }
+  }
+
+  // If we have a string, we need to check the length
+  if (HasType(definition.type, StringValue) && value.isString())
+  {
+    int size = value.size();
+    if (size < definition.minLength)
+    {
+      CLog::Log(LOGDEBUG, "JSONRPC: Value does not meet minLength requirements in type %s", definition.name.c_str());
+      return fail(type, errorData, StringUtils::Format("Value should have a minimum length of %d but has a length of %d", definition.minLength, size));
+    }
+
+    if (definition.maxLength >= 0 && size > definition.maxLength)
+    {
+      CLog::Log(LOGDEBUG, "JSONRPC: Value does not meet maxLength requirements in type %s", definition.name.c_str());
+      return fail(type, errorData, StringUtils::Format("Value should have a maximum length of %d but has a length of %d", definition.maxLength, size));
+    }
+  }
+
+  // Otherwise it can have any value
+  outputValue = value;
+  return OK;
+}
+
+JSONRPC_STATUS CJSONSchemaValidator::checkArray(const Type &type, const CVariant &value, CVariant &outputValue, CVariant &errorData) const
+{
+  const JSONSchemaTypeDefinition &definition = *type.definition;
+
+  outputValue = CVariant(CVariant::VariantTypeArray);
+
+  // Check the number of items against minItems and maxItems
+  if ((definition.minItems > 0 && value.size() < definition.minItems) || (definition.maxItems > 0 && value.size() > definition.maxItems))
+  {
+    CLog::Log(LOGDEBUG, "JSONRPC: Number of array elements does not match minItems and/or maxItems in type %s", definition.name.c_str());
+    if (definition.minItems > 0 && definition.maxItems > 0)
+      return fail(type, errorData, StringUtils::Format("Between %d and %d array items expected but %d received", definition.minItems, definition.maxItems, value.size()));
+    else if (definition.minItems > 0)
+      return fail(type, errorData, StringUtils::Format("At least %d array items expected but only %d received", definition.minItems, value.size()));
+    else
+      return fail(type, errorData, StringUtils::Format("Only %d array items expected but %d received", definition.maxItems, value.size()));
+  }
+
+  if (type.items.empty())
+    outputValue = value;
+  else if (type.items.size() == 1)
+  {
+    for (unsigned int arrayIndex = 0; arrayIndex < value.size(); arrayIndex++)
+    {
+      CVariant itemError;
+      JSONRPC_STATUS status = check(type.items[0], value[arrayIndex], outputValue.emplace_back(), itemError);
+      if (status != OK)
+      {
+        CLog::Log(LOGDEBUG, "JSONRPC: Array element at index %u does not match in type %s", arrayIndex, definition.name.c_str());
+        errorData["property"].swap(itemError);
+        return fail(type, errorData, StringUtils::Format("array element at index %u does not match", arrayIndex));
+      }
+    }
+  }
+  // Tuple typing: every element must match the
+  // type at the same position in "items"
+  else
+  {
+    if (value.size() < type.items.size() || (value.size() != type.items.size() && type.additionalItems.empty()))
+    {
+      CLog::Log(LOGDEBUG, "JSONRPC: One of the array elements does not match in type %s", definition.name.c_str());
+      return fail(type, errorData, StringUtils::Format("%" PRIuS" array elements expected but %d received", type.items.size(), value.size()));
+    }
+
+    unsigned int arrayIndex;
+    for (arrayIndex = 0; arrayIndex < type.items.size(); arrayIndex++)
+    {
+      CVariant itemError;
+      JSONRPC_STATUS status = check(type.items[arrayIndex], value[arrayIndex], outputValue.emplace_back(), itemError);
+      if (status != OK)
+      {
+        CLog::Log(LOGDEBUG, "JSONRPC: Array element at index %u does not match with items schema in type %s", arrayIndex, definition.name.c_str());
+        errorData["property"].swap(itemError);
+        describe(type, errorData);
+        return status;
+      }
+    }
+
+    // The rest of the elements have to match one of "additionalItems"
+    for (; arrayIndex < value.size(); arrayIndex++)
+    {
+      CVariant &item = outputValue.emplace_back();
+      bool ok = false;
+      for (std::vector<size_t>::const_iterator additionalItem = type.additionalItems.begin(); additionalItem != type.additionalItems.end(); ++additionalItem)
+      {
+        CVariant dummyError;
+        if (check(*additionalItem, value[arrayIndex], item, dummyError) == OK)
+        {
+          ok = true;
+          break;
+        }
+      }
+
+      if (!ok)
+      {
+        CLog::Log(LOGDEBUG, "JSONRPC: Array contains non-conforming additional items in type %s", definition.name.c_str());
+        return fail(type, errorData, StringUtils::Format("Array element at index %u does not match the \"additionalItems\" schema", arrayIndex));
+      }
+    }
+  }
+
+  // If every array element is unique we need to check each one
+  if (definition.uniqueItems)
+  {
+    for (unsigned int checkingIndex = 0; checkingIndex < outputValue.size(); checkingIndex++)
+    {
+      for (unsigned int checkedIndex = checkingIndex + 1; checkedIndex < outputValue.size(); checkedIndex++)
+      {
+        if (outputValue[checkingIndex] == outputValue[checkedIndex])
+        {
+          CLog::Log(LOGDEBUG, "JSONRPC: Not unique array element at index %u and %u in type %s", checkingIndex, checkedIndex, definition.name.c_str());
+          return fail(type, errorData, StringUtils::Format("Array element at index %u is not unique (same as array element at index %u)", checkingIndex, checkedIndex));
+        }
+      }
+    }
+  }
+
+  return OK;
+}
+
+JSONRPC_STATUS CJSONSchemaValidator::checkObject(const Type &type, const CVariant &value, CVariant &outputValue, CVariant &errorData) const
+{
+  const JSONSchemaTypeDefinition &definition = *type.definition;
+
+  // The properties and the members of the value are both sorted
+  // by name so they can be matched up walking them side by side
+  unsigned int handled = 0;
+  CVariant::const_iterator_map member = value.begin_map();
+  CVariant::const_iterator_map membersEnd = value.end_map();
+  for (std::vector<Property>::const_iterator property = type.properties.begin(); property != type.properties.end(); ++property)
+  {
+    while (member != membersEnd && member->first < property->name)
+      ++member;
+
+    if (member != membersEnd && member->first == property->name)
+    {
+      CVariant propertyError;
+      JSONRPC_STATUS status = check(property->type, member->second, outputValue[property->name], propertyError);
+      if (status != OK)
+      {
+        CLog::Log(LOGDEBUG, "JSONRPC: Invalid property \"%s\" in type %s", property->name.c_str(), definition.name.c_str());
+        errorData["property"].swap(propertyError);
+        describe(type, errorData);
+        return status;
+      }
+      handled++;
+      ++member;
+      continue;
+    }
+
+    const JSONSchemaTypeDefinition &propertyDefinition = *m_types[property->type].definition;
+    if (propertyDefinition.optional)
+      outputValue[property->name] = propertyDefinition.defaultValue;
+    else
+    {
+      describe(type, errorData);
+      errorData["property"]["name"] = property->name;
+      errorData["property"]["type"] = SchemaValueTypeToString(propertyDefinition.type);
+      errorData["message"] = "Missing property";
+      return InvalidParams;
+    }
+  }
+
+  if (handled == value.size())
+    return OK;
+
+  // If additional properties are allowed they must match the defined schema
+  if (type.additionalProperties == NoType)
+    return fail(type, errorData, "Unexpected additional properties received");
+
+  bool anyValue = m_types[type.additionalProperties].definition->type == AnyValue;
+  std::vector<Property>::const_iterator property = type.properties.begin();
+  for (member = value.begin_map(); member != membersEnd; ++member)
+  {
+    while (property != type.properties.end() && property->name < member->first)
+      ++property;
+    if (property != type.properties.end() && property->name == member->first)
+      continue;
+
+    if (anyValue)
+    {
+      outputValue[member->first] = member->second;
+      continue;
+    }
+
+    CVariant propertyError;
+    JSONRPC_STATUS status = check(type.additionalProperties, member->second, outputValue[member->first], propertyError);
+    if (status != OK)
+    {
+      CLog::Log(LOGDEBUG, "JSONRPC: Invalid additional property \"%s\" in type %s", member->first.c_str(), definition.name.c_str());
+      errorData["property"].swap(propertyError);
+      describe(type, errorData);
+      return status;
+    }
+  }
+
+  return OK;
+}
+
+bool CJSONSchemaValidator::checkEnum(const Type &type, const CVariant &value) const
+{
+  if (type.stringEnums)
+  {
+    if (!value.isString())
+      return false;
+
+    const char *string = value.c_str();
+    size_t first = 0, last = type.enumStrings.size();
+    while (first < last)
+    {
+      size_t middle = (first + last) / 2;
+      int compare = strcmp(type.enumStrings[middle].c_str(), string);
+      if (compare == 0)
+        return true;
+      if (compare < 0)
+        first = middle + 1;
+      else
+        last = middle;
+    }
+    return false;
+  }
+
+  const std::vector<CVariant> &enums = type.definition->enums;
+  for (std::vector<CVariant>::const_iterator enumValue = enums.begin(); enumValue != enums.end(); ++enumValue)
+  {
+    if (*enumValue == value)
+      return true;
+  }
+
+  return false;
+}
+
+bool CJSONSchemaValidator::propertyLess(const Property &left, const Property &right)
+{
+  return left.name < right.name;
+}
+
+JSONRPC_STATUS CJSONSchemaValidator::fail(const Type &type, CVariant &errorData, const std::string &message)
+{
+  describe(type, errorData);
+  errorData["message"] = message;
+  return InvalidParams;
+}
+
+void CJSONSchemaValidator::describe(const Type &type, CVariant &errorData)
+{
+  if (!type.definition->name.empty())
+    errorData["name"] = type.definition->name;
+  SchemaValueTypeToJson(type.definition->type, errorData["type"]);
+}
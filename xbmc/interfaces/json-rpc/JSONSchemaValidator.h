@@ -0,0 +1,107 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "JSONUtils.h"
+
+namespace JSONRPC
+{
+  class JSONSchemaTypeDefinition;
+  typedef boost::shared_ptr<JSONSchemaTypeDefinition> JSONSchemaTypeDefinitionPtr;
+
+  /*!
+   \ingroup jsonrpc
+   \brief Checks the parameters of a json rpc method call
+   against a precompiled form of the method's parameter
+   definitions.
+
+   JSONSchemaTypeDefinition::Check() walks the type definitions
+   as they were parsed: it resolves referenced types when it
+   first comes across them, describes every value it checks in
+   the error data just in case and compares enum values one by
+   one. The validator does the work that doesn't depend on the
+   checked value once: every type definition reachable from the
+   parameters is resolved and becomes one entry of a flat list
+   which refers to other entries by index, object properties are
+   sorted so they can be matched against the members of a value
+   and string enums are looked up in a sorted list. Error data is
+   only put together for the value that failed.
+
+   The validator has to be compiled once all types have been
+   added as referenced types may still be incomplete before.
+   */
+  class CJSONSchemaValidator : protected CJSONUtils
+  {
+  public:
+    CJSONSchemaValidator(const std::vector<JSONSchemaTypeDefinitionPtr> &parameters);
+
+    /*!
+     \brief Checks the given parameters of a method call
+     \param requestParameters Parameters from the request
+     \param outputParameters Cleaned up parameters
+     \param errorData Description of the failing parameter
+     \return OK if the parameters are valid otherwise an appropriate error code
+     */
+    JSONRPC_STATUS Check(const CVariant &requestParameters, CVariant &outputParameters, CVariant &errorData) const;
+
+  private:
+    static const size_t NoType = (size_t)-1;
+
+    struct Property
+    {
+      std::string name;
+      size_t type;
+    };
+
+    struct Type
+    {
+      JSONSchemaTypeDefinitionPtr definition;
+      std::vector<size_t> unionTypes;
+      std::vector<size_t> extends;
+      std::vector<size_t> items;
+      std::vector<size_t> additionalItems;
+      std::vector<Property> properties;
+      size_t additionalProperties;
+      bool stringEnums;
+      std::vector<std::string> enumStrings;
+    };
+
+    size_t compile(const JSONSchemaTypeDefinitionPtr &definition, std::map<const JSONSchemaTypeDefinition*, size_t> &compiled);
+    void compile(const std::vector<JSONSchemaTypeDefinitionPtr> &definitions, std::vector<size_t> &types, std::map<const JSONSchemaTypeDefinition*, size_t> &compiled);
+
+    JSONRPC_STATUS check(size_t index, const CVariant &value, CVariant &outputValue, CVariant &errorData) const;
+    JSONRPC_STATUS checkArray(const Type &type, const CVariant &value, CVariant &outputValue, CVariant &errorData) const;
+    JSONRPC_STATUS checkObject(const Type &type, const CVariant &value, CVariant &outputValue, CVariant &errorData) const;
+    bool checkEnum(const Type &type, const CVariant &value) const;
+
+    static bool propertyLess(const Property &left, const Property &right);
+
+    static JSONRPC_STATUS fail(const Type &type, CVariant &errorData, const std::string &message);
+    static void describe(const Type &type, CVariant &errorData);
+
+    std::vector<Type> m_types;
+    std::vector<size_t> m_parameters;
+  };
+}
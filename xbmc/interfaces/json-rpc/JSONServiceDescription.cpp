@@ -64,6 +64,7 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
   { "Player.GetPlayers",                            CPlayerOperations::GetPlayers },
   { "Player.GetProperties",                         CPlayerOperations::GetProperties },
   { "Player.GetItem",                               CPlayerOperations::GetItem },
+  { "Player.GetVideoTelemetry",                     CPlayerOperations::GetVideoTelemetry },
 
   { "Player.PlayPause",                             CPlayerOperations::PlayPause },
   { "Player.Stop",                                  CPlayerOperations::Stop },
@@ -1267,6 +1268,19 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
     {
       methodCall = method;
 
+      if (validator)
+      {
+        CVariant errorData;
+        JSONRPC_STATUS status = validator->Check(requestParameters, outputParameters, errorData);
+        if (status != OK)
+        {
+          // Return the error data object in the outputParameters reference
+          errorData["method"] = name;
+          outputParameters.swap(errorData);
+        }
+        return status;
+      }
+
       // Count the number of actually handled (present)
       // parameters
       unsigned int handled = 0;
@@ -1859,6 +1873,11 @@ JSONRPC_STATUS CJSONServiceDescription::CheckCall(const char* const method, cons
   return MethodNotFound;
 }
 
+void CJSONServiceDescription::CompileValidators()
+{
+  m_actionMap.compile();
+}
+
 JSONSchemaTypeDefinitionPtr CJSONServiceDescription::GetType(const std::string &identification)
 {
   std::map<std::string, JSONSchemaTypeDefinitionPtr>::iterator iter = m_types.find(identification);
@@ -2008,6 +2027,12 @@ CJSONServiceDescription::CJsonRpcMethodMap::CJsonRpcMethodMap():
 {
 }
 
+void CJSONServiceDescription::CJsonRpcMethodMap::compile()
+{
+  for (std::map<std::string, JsonRpcMethod>::iterator it = m_actionmap.begin(); it != m_actionmap.end(); ++it)
+    it->second.validator.reset(new CJSONSchemaValidator(it->second.parameters));
+}
+
 void CJSONServiceDescription::CJsonRpcMethodMap::clear()
 {
   m_actionmap.clear();
@@ -25,6 +25,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include "JSONUtils.h"
+#include "JSONSchemaValidator.h"
 
 namespace JSONRPC
 {
@@ -273,6 +274,11 @@ namespace JSONRPC
      \brief Definition of the return value
      */
     JSONSchemaTypeDefinitionPtr returns;
+    /*!
+     \brief Precompiled form of the parameter definitions
+     used to check calls (once it has been compiled)
+     */
+    boost::shared_ptr<CJSONSchemaValidator> validator;
   
   private:
     bool parseParameter(const CVariant &value, JSONSchemaTypeDefinitionPtr parameter);
@@ -392,6 +398,16 @@ namespace JSONRPC
     
     static JSONSchemaTypeDefinitionPtr GetType(const std::string &identification);
 
+    /*!
+     \brief Compiles the parameter definitions of all methods
+     added so far into validators used by CheckCall()
+
+     Has to be called after all types have been added. Methods
+     added afterwards are checked against their type definitions
+     directly.
+     */
+    static void CompileValidators();
+
     static void Cleanup();
 
   private:
@@ -416,6 +432,7 @@ namespace JSONRPC
       JsonRpcMethodIterator find(const std::string& key) const;
       JsonRpcMethodIterator end() const;
 
+      void compile();
       void clear();
     private:
       std::map<std::string, JsonRpcMethod> m_actionmap;
@@ -44,9 +44,11 @@
 #include "pvr/channels/PVRChannelGroupsContainer.h"
 #include "pvr/recordings/PVRRecordings.h"
 #include "cores/IPlayer.h"
+#include "cores/VideoRenderers/VideoTelemetry.h"
 #include "cores/playercorefactory/PlayerCoreConfig.h"
 #include "cores/playercorefactory/PlayerCoreFactory.h"
 #include "settings/MediaSettings.h"
+#include "video/VideoReferenceClock.h"
 
 using namespace JSONRPC;
 using namespace PLAYLIST;
@@ -281,6 +283,22 @@ JSONRPC_STATUS CPlayerOperations::GetItem(const std::string &method, ITransportL
   return OK;
 }
 
+JSONRPC_STATUS CPlayerOperations::GetVideoTelemetry(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  g_videoTelemetry.GetSummary(result);
+
+  int missedVblanks = 0;
+  double clockSpeed, refreshRate;
+  if (!g_VideoReferenceClock.GetClockInfo(missedVblanks, clockSpeed, refreshRate))
+    missedVblanks = 0;
+  result["missedvblanks"] = missedVblanks;
+
+  if (parameterObject["reset"].asBoolean())
+    g_videoTelemetry.Reset();
+
+  return OK;
+}
+
 JSONRPC_STATUS CPlayerOperations::PlayPause(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CGUIWindowSlideShow *slideshow = NULL;
@@ -38,14 +38,16 @@ JSONRPC_STATUS CProfilesOperations::GetProfiles(const std::string &method, ITran
     listItems.Add(item);
   }
 
-  HandleFileItemList("profileid", false, "profiles", listItems, parameterObject, result);
+  // the lock modes are added to the list afterwards, so it can't be streamed
+  CVariant profiles(CVariant::VariantTypeObject);
+  HandleFileItemList("profileid", false, "profiles", listItems, parameterObject, profiles);
 
   for (CVariant::const_iterator_array propertyiter = parameterObject["properties"].begin_array(); propertyiter != parameterObject["properties"].end_array(); ++propertyiter)
   {
     if (propertyiter->isString() &&
         propertyiter->asString() == "lockmode")
     {
-      for (CVariant::iterator_array profileiter = result["profiles"].begin_array(); profileiter != result["profiles"].end_array(); ++profileiter)
+      for (CVariant::iterator_array profileiter = profiles["profiles"].begin_array(); profileiter != profiles["profiles"].end_array(); ++profileiter)
       {
         std::string profilename = (*profileiter)["label"].asString();
         int index = CProfilesManager::Get().GetProfileIndex(profilename);
@@ -60,6 +62,8 @@ JSONRPC_STATUS CProfilesOperations::GetProfiles(const std::string &method, ITran
       break;
     }
   }
+
+  result = profiles;
   return OK;
 }
 
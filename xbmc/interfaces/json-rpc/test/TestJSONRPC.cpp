@@ -0,0 +1,181 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/json-rpc/JSONRPC.h"
+#include "interfaces/json-rpc/JSONServiceDescription.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+#include <string.h>
+
+#define BENCHMARK_PASSES 200
+
+using namespace JSONRPC;
+
+/* what a couple of remote control apps sent while a movie was playing,
+   most of it polling the player state several times a second */
+static const char *RecordedTraffic[] = {
+  "{\"jsonrpc\":\"2.0\",\"method\":\"Player.GetActivePlayers\",\"id\":1}",
+  "{\"jsonrpc\":\"2.0\",\"method\":\"Player.GetProperties\",\"params\":{\"playerid\":1,\"properties\":[\"percentage\",\"time\",\"totaltime\",\"speed\",\"position\",\"playlistid\",\"repeat\",\"shuffled\",\"canseek\",\"subtitleenabled\",\"currentsubtitle\",\"currentaudiostream\",\"audiostreams\",\"subtitles\",\"live\"]},\"id\":2}",
+  "{\"jsonrpc\":\"2.0\",\"method\":\"Player.GetItem\",\"params\":{\"playerid\":1,\"properties\":[\"title\",\"artist\",\"albumartist\",\"album\",\"showtitle\",\"season\",\"episode\",\"thumbnail\",\"fanart\",\"file\",\"duration\",\"streamdetails\",\"year\",\"genre\",\"rating\"]},\"id\":3}",
+  "{\"jsonrpc\":\"2.0\",\"method\":\"Application.GetProperties\",\"params\":{\"properties\":[\"volume\",\"muted\"]},\"id\":4}",
+  "{\"jsonrpc\":\"2.0\",\"method\":\"Player.GetProperties\",\"params\":{\"playerid\":1,\"properties\":[\"percentage\",\"time\",\"totaltime\",\"speed\"]},\"id\":5}",
+  "{\"jsonrpc\":\"2.0\",\"method\":\"GUI.GetProperties\",\"params\":{\"properties\":[\"currentwindow\",\"fullscreen\"]},\"id\":6}",
+  "{\"jsonrpc\":\"2.0\",\"method\":\"Player.GetProperties\",\"params\":[1,[\"time\",\"speed\"]],\"id\":7}",
+  "{\"jsonrpc\":\"2.0\",\"method\":\"JSONRPC.Ping\",\"id\":8}",
+  "{\"jsonrpc\":\"2.0\",\"method\":\"Player.GetProperties\",\"params\":{\"playerid\":1,\"properties\":[\"percentage\",\"time\",\"totaltime\",\"speed\"]},\"id\":9}",
+  "{\"jsonrpc\":\"2.0\",\"method\":\"Player.Seek\",\"params\":{\"playerid\":1,\"value\":{\"hours\":0,\"minutes\":12,\"seconds\":3,\"milliseconds\":0}},\"id\":10}",
+  "{\"jsonrpc\":\"2.0\",\"method\":\"Player.SetSubtitle\",\"params\":{\"playerid\":1,\"subtitle\":\"next\",\"enable\":true},\"id\":11}",
+  "{\"jsonrpc\":\"2.0\",\"method\":\"VideoLibrary.GetMovies\",\"params\":{\"sort\":{\"method\":\"nosuchmethod\"}},\"id\":12}",
+  "{\"jsonrpc\":\"2.0\",\"method\":\"Player.GetProperties\",\"params\":{\"playerid\":1,\"properties\":[\"percentage\",\"time\",\"totaltime\",\"speed\"]},\"id\":13}",
+  "{\"jsonrpc\":\"2.0\",\"method\":\"JSONRPC.Version\",\"id\":14}"
+};
+
+class CTestTransport : public ITransportLayer
+{
+public:
+  virtual bool PrepareDownload(const char *path, CVariant &details, std::string &protocol) { return false; }
+  virtual bool Download(const char *path, CVariant &result) { return false; }
+  virtual int GetCapabilities() { return Response; }
+};
+
+class CTestClient : public IClient
+{
+public:
+  virtual int GetPermissionFlags() { return OPERATION_PERMISSION_ALL; }
+  virtual int GetAnnouncementFlags() { return 0; }
+  virtual bool SetAnnouncementFlags(int flags) { return true; }
+};
+
+class TestJSONRPC : public testing::Test
+{
+protected:
+  TestJSONRPC() { CJSONRPC::Initialize(); }
+  virtual ~TestJSONRPC() { CJSONRPC::Cleanup(); }
+
+  JSONRPC_STATUS CheckCall(const char *method, const std::string &parameters, CVariant &outputParameters)
+  {
+    MethodCall methodCall;
+    CVariant requestParameters = CJSONVariantParser::Parse((const unsigned char *)parameters.c_str(), parameters.size());
+    return CJSONServiceDescription::CheckCall(method, requestParameters, &transport, &client, false, methodCall, outputParameters);
+  }
+
+  CTestTransport transport;
+  CTestClient client;
+};
+
+TEST_F(TestJSONRPC, FillsInDefaults)
+{
+  CVariant output;
+  EXPECT_EQ(OK, CheckCall("videolibrary.getmovies", "{}", output));
+  EXPECT_EQ(0, output["limits"]["start"].asInteger());
+  EXPECT_EQ(-1, output["limits"]["end"].asInteger());
+  EXPECT_TRUE(output["properties"].isArray());
+  EXPECT_STREQ("none", output["sort"]["method"].c_str());
+  EXPECT_STREQ("ascending", output["sort"]["order"].c_str());
+
+  // positional parameters end up under their names
+  output = CVariant();
+  EXPECT_EQ(OK, CheckCall("player.getproperties", "[1, [\"time\", \"speed\"]]", output));
+  EXPECT_EQ(1, output["playerid"].asInteger());
+  EXPECT_EQ(2u, output["properties"].size());
+}
+
+TEST_F(TestJSONRPC, RejectsInvalidParameters)
+{
+  CVariant output;
+  EXPECT_EQ(InvalidParams, CheckCall("player.getproperties", "{\"playerid\": 1}", output));
+  EXPECT_STREQ("Player.GetProperties", output["method"].c_str());
+  EXPECT_STREQ("properties", output["stack"]["name"].c_str());
+  EXPECT_STREQ("Missing parameter", output["stack"]["message"].c_str());
+
+  output = CVariant();
+  EXPECT_EQ(InvalidParams, CheckCall("player.getproperties", "{\"playerid\": 1, \"properties\": [\"time\", \"nosuchproperty\"]}", output));
+  EXPECT_STREQ("properties", output["stack"]["name"].c_str());
+  EXPECT_STREQ("Received value does not match any of the defined enum values", output["stack"]["property"]["message"].c_str());
+
+  output = CVariant();
+  EXPECT_EQ(InvalidParams, CheckCall("player.getproperties", "{\"playerid\": 1, \"properties\": [\"time\", \"time\"]}", output));
+
+  output = CVariant();
+  EXPECT_EQ(InvalidParams, CheckCall("player.getproperties", "{\"playerid\": \"one\", \"properties\": [\"time\"]}", output));
+  EXPECT_STREQ("playerid", output["stack"]["name"].c_str());
+
+  output = CVariant();
+  EXPECT_EQ(InvalidParams, CheckCall("player.getproperties", "{\"playerid\": 1, \"properties\": [\"time\"], \"extra\": 1}", output));
+  EXPECT_STREQ("Too many parameters", output["message"].c_str());
+
+  output = CVariant();
+  EXPECT_EQ(InvalidParams, CheckCall("videolibrary.getmovies", "{\"limits\": {\"start\": 0, \"junk\": 1}}", output));
+  EXPECT_STREQ("Unexpected additional properties received", output["stack"]["message"].c_str());
+
+  output = CVariant();
+  EXPECT_EQ(MethodNotFound, CheckCall("nosuch.method", "{}", output));
+}
+
+// 200 passes over the recorded traffic, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestJSONRPC.*
+TEST_F(TestJSONRPC, DISABLED_Benchmark)
+{
+  size_t requests = sizeof(RecordedTraffic) / sizeof(RecordedTraffic[0]);
+  double frequency = (double)CurrentHostFrequency();
+
+  // validation only
+  std::vector<std::pair<std::string, CVariant> > calls;
+  for (size_t i = 0; i < requests; i++)
+  {
+    CVariant request = CJSONVariantParser::Parse((const unsigned char *)RecordedTraffic[i], strlen(RecordedTraffic[i]));
+    std::string method = request["method"].asString();
+    StringUtils::ToLower(method);
+    calls.push_back(std::make_pair(method, request["params"]));
+  }
+
+  int64_t start = CurrentHostCounter();
+  for (int pass = 0; pass < BENCHMARK_PASSES; pass++)
+  {
+    for (size_t i = 0; i < calls.size(); i++)
+    {
+      MethodCall methodCall;
+      CVariant outputParameters;
+      CJSONServiceDescription::CheckCall(calls[i].first.c_str(), calls[i].second, &transport, &client, false, methodCall, outputParameters);
+    }
+  }
+  int64_t validated = CurrentHostCounter() - start;
+
+  // complete requests
+  start = CurrentHostCounter();
+  for (int pass = 0; pass < BENCHMARK_PASSES; pass++)
+  {
+    for (size_t i = 0; i < requests; i++)
+      EXPECT_FALSE(CJSONRPC::MethodCall(RecordedTraffic[i], &transport, &client).empty());
+  }
+  int64_t handled = CurrentHostCounter() - start;
+
+  size_t total = BENCHMARK_PASSES * requests;
+  std::cout << "JSON-RPC recorded traffic: " << total << " requests, "
+            << validated * 1000000.0 / frequency / total << " us validation and "
+            << handled * 1000000.0 / frequency / total << " us in total per request, "
+            << (int)(total * frequency / handled) << " requests/s" << std::endl;
+}
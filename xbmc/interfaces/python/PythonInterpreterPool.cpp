@@ -0,0 +1,174 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#if (defined HAVE_CONFIG_H) && (!defined TARGET_WINDOWS)
+  #include "config.h"
+#endif
+
+// python.h should always be included first before any other includes
+#include <Python.h>
+
+#include "PythonInterpreterPool.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+static CCriticalSection s_critical;
+static std::vector<CPythonInterpreterPool::Interpreter> s_interpreters;
+
+// setup time statistics, cold and warm
+static unsigned int s_setupCount[2] = { 0, 0 };
+static int64_t s_setupTime[2] = { 0, 0 };
+
+bool CPythonInterpreterPool::IsEnabled()
+{
+  return g_advancedSettings.m_pythonInterpreterPool > 0;
+}
+
+bool CPythonInterpreterPool::Acquire(const std::string &key, Interpreter &interpreter)
+{
+  CSingleLock lock(s_critical);
+  for (std::vector<Interpreter>::iterator it = s_interpreters.begin(); it != s_interpreters.end(); ++it)
+  {
+    if (it->key == key)
+    {
+      interpreter = *it;
+      s_interpreters.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CPythonInterpreterPool::Release(const Interpreter &interpreter)
+{
+  if (!IsEnabled() || interpreter.interp == NULL)
+    return false;
+
+  Interpreter evicted;
+  {
+    CSingleLock lock(s_critical);
+    // only one warm interpreter per add-on, a second one would hardly be used
+    for (std::vector<Interpreter>::const_iterator it = s_interpreters.begin(); it != s_interpreters.end(); ++it)
+    {
+      if (it->key == interpreter.key)
+        return false;
+    }
+
+    if (s_interpreters.size() >= (unsigned int)g_advancedSettings.m_pythonInterpreterPool)
+    {
+      std::vector<Interpreter>::iterator oldest = s_interpreters.begin();
+      for (std::vector<Interpreter>::iterator it = s_interpreters.begin(); it != s_interpreters.end(); ++it)
+      {
+        if (it->lastUsed < oldest->lastUsed)
+          oldest = it;
+      }
+      evicted = *oldest;
+      s_interpreters.erase(oldest);
+    }
+
+    s_interpreters.push_back(interpreter);
+    s_interpreters.back().lastUsed = XbmcThreads::SystemClockMillis();
+  }
+
+  if (evicted.interp != NULL)
+    End(evicted);
+
+  return true;
+}
+
+void CPythonInterpreterPool::Clear()
+{
+  std::vector<Interpreter> interpreters;
+  {
+    CSingleLock lock(s_critical);
+    interpreters.swap(s_interpreters);
+  }
+  End(interpreters);
+}
+
+void CPythonInterpreterPool::Remove(const std::string &addon)
+{
+  std::vector<Interpreter> interpreters;
+  {
+    CSingleLock lock(s_critical);
+    for (std::vector<Interpreter>::iterator it = s_interpreters.begin(); it != s_interpreters.end(); )
+    {
+      if (it->addons.find(addon) != it->addons.end())
+      {
+        interpreters.push_back(*it);
+        it = s_interpreters.erase(it);
+      }
+      else
+        ++it;
+    }
+  }
+  End(interpreters);
+}
+
+bool CPythonInterpreterPool::IsEmpty()
+{
+  CSingleLock lock(s_critical);
+  return s_interpreters.empty();
+}
+
+std::string CPythonInterpreterPool::AddSetupTime(bool warm, int64_t setup)
+{
+  CSingleLock lock(s_critical);
+  s_setupCount[warm]++;
+  s_setupTime[warm] += setup;
+
+  double frequency = (double)CurrentHostFrequency() / 1000.0;
+  return StringUtils::Format("%s interpreter ready after %.1f ms (cold %.1f ms in %u runs, warm %.1f ms in %u runs)",
+                             warm ? "warm" : "cold", setup / frequency,
+                             s_setupCount[0] ? s_setupTime[0] / frequency / s_setupCount[0] : 0.0, s_setupCount[0],
+                             s_setupCount[1] ? s_setupTime[1] / frequency / s_setupCount[1] : 0.0, s_setupCount[1]);
+}
+
+void CPythonInterpreterPool::End(std::vector<Interpreter> &interpreters)
+{
+  if (interpreters.empty())
+    return;
+
+  PyEval_AcquireLock();
+  for (std::vector<Interpreter>::iterator it = interpreters.begin(); it != interpreters.end(); ++it)
+    End(*it);
+  PyEval_ReleaseLock();
+}
+
+void CPythonInterpreterPool::End(Interpreter &interpreter)
+{
+  CLog::Log(LOGDEBUG, "CPythonInterpreterPool: ending the interpreter of %s", interpreter.key.c_str());
+
+  PyThreadState* state = PyThreadState_New(interpreter.interp);
+  PyThreadState_Swap(state);
+  Py_XDECREF(interpreter.mainDict);
+  Py_EndInterpreter(state);
+
+  if (interpreter.languageHook->HasRegisteredAddonClasses())
+    CLog::Log(LOGWARNING, "CPythonInterpreterPool: the interpreter of %s has left classes in memory that we couldn't clean up",
+              interpreter.key.c_str());
+  interpreter.languageHook->UnregisterMe();
+  interpreter.interp = NULL;
+  interpreter.mainDict = NULL;
+}
@@ -0,0 +1,97 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/python/LanguageHook.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Keeps the interpreters of finished plugin runs around for the next
+ run of the same plugin.
+ A warm interpreter already has the xbmc modules and the modules of other
+ add-ons the plugin imported before loaded, so a run only has to execute the
+ plugin's script again instead of setting up a new interpreter from scratch.
+ The plugin's own modules are imported again by every run.
+
+ The pool is off unless <python><interpreterpool> in advancedsettings.xml
+ gives the number of interpreters to keep. The least recently used one is
+ ended when the pool is full.
+ */
+class CPythonInterpreterPool
+{
+public:
+  struct Interpreter
+  {
+    Interpreter() : interp(NULL), mainDict(NULL), lastUsed(0) {}
+
+    std::string key;
+    std::set<std::string> addons; // key and the module add-ons it imports from
+    PyInterpreterState* interp;
+    XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook> languageHook;
+    PyObject* mainDict; // copy of __main__ right after initialization
+    std::string pythonPath; // in system/Python encoding
+    unsigned int lastUsed;
+  };
+
+  static bool IsEnabled();
+
+  /*!
+   \brief Take the warm interpreter kept for key out of the pool.
+   \return false if there is none
+   */
+  static bool Acquire(const std::string &key, Interpreter &interpreter);
+
+  /*!
+   \brief Put an interpreter back for the next run.
+   Must be called holding the GIL without a current thread state, and the
+   interpreter must not have any thread states left.
+   \return false if it can't be kept, the caller has to end it then
+   */
+  static bool Release(const Interpreter &interpreter);
+
+  /*!
+   \brief End all pooled interpreters, e.g. before Python is finalized.
+   Must be called without holding the GIL.
+   */
+  static void Clear();
+
+  /*!
+   \brief End the interpreters that use an add-on, e.g. when it was updated.
+   Must be called without holding the GIL.
+   */
+  static void Remove(const std::string &addon);
+
+  static bool IsEmpty();
+
+  /*!
+   \brief Account the time an invocation took to get its interpreter ready.
+   \param warm whether it came from the pool
+   \param setup time in CurrentHostCounter() ticks
+   \return a summary of cold and warm setup times for the log
+   */
+  static std::string AddSetupTime(bool warm, int64_t setup);
+
+private:
+  static void End(Interpreter &interpreter);
+  static void End(std::vector<Interpreter> &interpreters);
+};
@@ -39,6 +39,7 @@
 #include "interfaces/legacy/Addon.h"
 #include "interfaces/python/LanguageHook.h"
 #include "interfaces/python/PyContext.h"
+#include "interfaces/python/PythonInterpreterPool.h"
 #include "interfaces/python/pythreadstate.h"
 #include "interfaces/python/swig.h"
 #include "interfaces/python/XBPython.h"
@@ -48,6 +49,7 @@
 #endif // defined(TARGET_WINDOWS)
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
 
 #ifdef TARGET_WINDOWS
@@ -96,6 +98,38 @@ static const std::string getListOfAddonClassesAsString(XBMCAddon::AddonClass::Re
   return message;
 }
 
+// drops the modules loaded from below path (in system encoding) from sys.modules,
+// so that the next run in the same interpreter imports them again
+static void removeModulesFrom(const std::string& path)
+{
+  PyObject *modules = PyImport_GetModuleDict();
+  std::vector<PyObject*> names;
+  PyObject *name, *module;
+  Py_ssize_t pos = 0;
+  while (PyDict_Next(modules, &pos, &name, &module))
+  {
+    if (module == NULL || !PyModule_Check(module) ||
+        !PyString_Check(name) || strcmp(PyString_AsString(name), "__main__") == 0)
+      continue;
+
+    const char *filename = PyModule_GetFilename(module);
+    if (filename == NULL)
+    {
+      // built-in modules have no __file__
+      PyErr_Clear();
+      continue;
+    }
+    if (StringUtils::StartsWith(filename, path))
+      names.push_back(name);
+  }
+
+  for (std::vector<PyObject*>::iterator it = names.begin(); it != names.end(); ++it)
+  {
+    if (PyDict_DelItem(modules, *it) != 0)
+      PyErr_Clear();
+  }
+}
+
 CPythonInvoker::CPythonInvoker(ILanguageInvocationHandler *invocationHandler)
   : ILanguageInvoker(invocationHandler),
     m_argc(0), m_argv(NULL),
@@ -157,10 +191,17 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
 
   CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): start processing", GetId(), m_sourceFile.c_str());
   int m_Py_file_input = Py_file_input;
+  int64_t setupStart = CurrentHostCounter();
+
+  // plugins can be run in the interpreter kept from their last run
+  bool isPlugin = m_addon && m_addon->Type() == ADDON::ADDON_PLUGIN;
+  CPythonInterpreterPool::Interpreter interpreter;
+  bool warm = isPlugin && CPythonInterpreterPool::IsEnabled() &&
+              CPythonInterpreterPool::Acquire(m_addon->ID(), interpreter);
 
   // get the global lock
   PyEval_AcquireLock();
-  PyThreadState* state = Py_NewInterpreter();
+  PyThreadState* state = warm ? PyThreadState_New(interpreter.interp) : Py_NewInterpreter();
   if (state == NULL)
   {
     PyEval_ReleaseLock();
@@ -170,10 +211,17 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   // swap in my thread state
   PyThreadState_Swap(state);
 
-  XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook> languageHook(new XBMCAddon::Python::PythonLanguageHook(state->interp));
+  XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook> languageHook(warm ? interpreter.languageHook.get() : new XBMCAddon::Python::PythonLanguageHook(state->interp));
   languageHook->RegisterMe();
 
-  onInitialization();
+  if (!warm)
+    onInitialization();
+  else
+  {
+    PyObject *m = PyImport_AddModule((char*)"xbmc");
+    if (m == NULL || PyObject_SetAttrString(m, (char*)"abortRequested", PyBool_FromLong(0)))
+      CLog::Log(LOGERROR, "CPythonInvoker(%d, %s): failed to reset abortRequested", GetId(), m_sourceFile.c_str());
+  }
   setState(InvokerStateInitialized);
 
   std::string realFilename(CSpecialProtocol::TranslatePath(m_sourceFile));
@@ -186,47 +234,10 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   // this is used for python so it will search modules from script path first
   std::string scriptDir = URIUtils::GetDirectory(realFilename);
   URIUtils::RemoveSlashAtEnd(scriptDir);
-  addPath(scriptDir);
-
-  // add all addon module dependecies to path
-  if (m_addon)
-  {
-    std::set<std::string> paths;
-    getAddonModuleDeps(m_addon, paths);
-    for (std::set<std::string>::const_iterator it = paths.begin(); it != paths.end(); ++it)
-      addPath(*it);
-  }
-  else
-  { // for backwards compatibility.
-    // we don't have any addon so just add all addon modules installed
-    CLog::Log(LOGWARNING, "CPythonInvoker(%d): Script invoked without an addon. Adding all addon "
-        "modules installed to python path as fallback. This behaviour will be removed in future "
-        "version.", GetId());
-    ADDON::VECADDONS addons;
-    ADDON::CAddonMgr::Get().GetAddons(ADDON::ADDON_SCRIPT_MODULE, addons);
-    for (unsigned int i = 0; i < addons.size(); ++i)
-      addPath(CSpecialProtocol::TranslatePath(addons[i]->LibPath()));
-  }
-
-  // we want to use sys.path so it includes site-packages
-  // if this fails, default to using Py_GetPath
-  PyObject *sysMod(PyImport_ImportModule((char*)"sys")); // must call Py_DECREF when finished
-  PyObject *sysModDict(PyModule_GetDict(sysMod)); // borrowed ref, no need to delete
-  PyObject *pathObj(PyDict_GetItemString(sysModDict, "path")); // borrowed ref, no need to delete
-
-  if (pathObj != NULL && PyList_Check(pathObj))
-  {
-    for (int i = 0; i < PyList_Size(pathObj); i++)
-    {
-      PyObject *e = PyList_GetItem(pathObj, i); // borrowed ref, no need to delete
-      if (e != NULL && PyString_Check(e))
-        addNativePath(PyString_AsString(e)); // returns internal data, don't delete or modify
-    }
-  }
+  if (warm)
+    m_pythonPath = interpreter.pythonPath;
   else
-    addNativePath(Py_GetPath());
-
-  Py_DECREF(sysMod); // release ref to sysMod
+    initializePath(scriptDir);
 
   // set current directory and python's path.
   if (m_argv != NULL)
@@ -245,6 +256,20 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   PyObject* module = PyImport_AddModule((char*)"__main__");
   PyObject* moduleDict = PyModule_GetDict(module);
 
+  // a warm interpreter starts over with the __main__ it had after
+  // initialization, the modules the plugin imported stay loaded
+  if (warm)
+  {
+    PyDict_Clear(moduleDict);
+    PyDict_Update(moduleDict, interpreter.mainDict);
+  }
+  else if (isPlugin)
+    interpreter.mainDict = PyDict_Copy(moduleDict);
+
+  if (isPlugin)
+    CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): %s", GetId(), m_sourceFile.c_str(),
+              CPythonInterpreterPool::AddSetupTime(warm, CurrentHostCounter() - setupStart).c_str());
+
   // when we are done initing we store thread state so we can be aborted
   PyThreadState_Swap(NULL);
   PyEval_ReleaseLock();
@@ -401,16 +426,56 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
       PyRun_SimpleString(GC_SCRIPT) == -1)
     CLog::Log(LOGERROR, "CPythonInvoker(%d, %s): failed to run the gc to clean up after running prior to shutting down the Interpreter", GetId(), m_sourceFile.c_str());
 
-  Py_EndInterpreter(state);
+  // keep the interpreter of a plugin that finished cleanly for its next run
+  bool pooled = false;
+  if (isPlugin && interpreter.mainDict != NULL && stateToSet == InvokerStateDone && !m_stop)
+  {
+    interpreter.key = m_addon->ID();
+    interpreter.interp = state->interp;
+    interpreter.languageHook = languageHook;
+    interpreter.pythonPath = m_pythonPath;
+    if (interpreter.addons.empty())
+    {
+      std::set<std::string> paths;
+      getAddonModuleDeps(m_addon, paths, &interpreter.addons);
+      interpreter.addons.insert(interpreter.key);
+    }
 
-  // If we still have objects left around, produce an error message detailing what's been left behind
-  if (languageHook->HasRegisteredAddonClasses())
-    CLog::Log(LOGWARNING, "CPythonInvoker(%d, %s): the python script \"%s\" has left several "
-      "classes in memory that we couldn't clean up. The classes include: %s",
-      GetId(), m_sourceFile.c_str(), m_sourceFile.c_str(), getListOfAddonClassesAsString(languageHook).c_str());
+    // the plugin's own modules are imported again by the next run, like
+    // they would be in a new interpreter
+    std::string addonPath(CSpecialProtocol::TranslatePath(m_addon->Path()));
+    URIUtils::AddSlashAtEnd(addonPath);
+#ifdef TARGET_WINDOWS
+    g_charsetConverter.utf8ToSystem(addonPath, true);
+#endif
+    removeModulesFrom(addonPath);
 
-  // unregister the language hook
-  languageHook->UnregisterMe();
+    PyThreadState_Clear(state);
+    PyThreadState_Swap(NULL);
+    PyThreadState_Delete(state);
+    pooled = CPythonInterpreterPool::Release(interpreter);
+    if (!pooled)
+    {
+      state = PyThreadState_New(interpreter.interp);
+      PyThreadState_Swap(state);
+    }
+  }
+
+  if (!pooled)
+  {
+    if (interpreter.mainDict != NULL)
+      Py_DECREF(interpreter.mainDict);
+    Py_EndInterpreter(state);
+
+    // If we still have objects left around, produce an error message detailing what's been left behind
+    if (languageHook->HasRegisteredAddonClasses())
+      CLog::Log(LOGWARNING, "CPythonInvoker(%d, %s): the python script \"%s\" has left several "
+        "classes in memory that we couldn't clean up. The classes include: %s",
+        GetId(), m_sourceFile.c_str(), m_sourceFile.c_str(), getListOfAddonClassesAsString(languageHook).c_str());
+
+    // unregister the language hook
+    languageHook->UnregisterMe();
+  }
 
   PyEval_ReleaseLock();
 
@@ -607,7 +672,52 @@ bool CPythonInvoker::initializeModule(PythonModuleInitialization module)
   return true;
 }
 
-void CPythonInvoker::getAddonModuleDeps(const ADDON::AddonPtr& addon, std::set<std::string>& paths)
+void CPythonInvoker::initializePath(const std::string& scriptDir)
+{
+  addPath(scriptDir);
+
+  // add all addon module dependecies to path
+  if (m_addon)
+  {
+    std::set<std::string> paths;
+    getAddonModuleDeps(m_addon, paths);
+    for (std::set<std::string>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+      addPath(*it);
+  }
+  else
+  { // for backwards compatibility.
+    // we don't have any addon so just add all addon modules installed
+    CLog::Log(LOGWARNING, "CPythonInvoker(%d): Script invoked without an addon. Adding all addon "
+        "modules installed to python path as fallback. This behaviour will be removed in future "
+        "version.", GetId());
+    ADDON::VECADDONS addons;
+    ADDON::CAddonMgr::Get().GetAddons(ADDON::ADDON_SCRIPT_MODULE, addons);
+    for (unsigned int i = 0; i < addons.size(); ++i)
+      addPath(CSpecialProtocol::TranslatePath(addons[i]->LibPath()));
+  }
+
+  // we want to use sys.path so it includes site-packages
+  // if this fails, default to using Py_GetPath
+  PyObject *sysMod(PyImport_ImportModule((char*)"sys")); // must call Py_DECREF when finished
+  PyObject *sysModDict(PyModule_GetDict(sysMod)); // borrowed ref, no need to delete
+  PyObject *pathObj(PyDict_GetItemString(sysModDict, "path")); // borrowed ref, no need to delete
+
+  if (pathObj != NULL && PyList_Check(pathObj))
+  {
+    for (int i = 0; i < PyList_Size(pathObj); i++)
+    {
+      PyObject *e = PyList_GetItem(pathObj, i); // borrowed ref, no need to delete
+      if (e != NULL && PyString_Check(e))
+        addNativePath(PyString_AsString(e)); // returns internal data, don't delete or modify
+    }
+  }
+  else
+    addNativePath(Py_GetPath());
+
+  Py_DECREF(sysMod); // release ref to sysMod
+}
+
+void CPythonInvoker::getAddonModuleDeps(const ADDON::AddonPtr& addon, std::set<std::string>& paths, std::set<std::string>* ids /* = NULL */)
 {
   ADDON::ADDONDEPS deps = addon->GetDeps();
   for (ADDON::ADDONDEPS::const_iterator it = deps.begin(); it != deps.end(); ++it)
@@ -621,7 +731,9 @@ void CPythonInvoker::getAddonModuleDeps(const ADDON::AddonPtr& addon, std::set<s
       {
         // add it and its dependencies
         paths.insert(path);
-        getAddonModuleDeps(dependency, paths);
+        if (ids)
+          ids->insert(dependency->ID());
+        getAddonModuleDeps(dependency, paths, ids);
       }
     }
   }
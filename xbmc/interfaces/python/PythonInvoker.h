@@ -64,9 +64,10 @@ protected:
 private:
   void initializeModules(const std::map<std::string, PythonModuleInitialization> &modules);
   bool initializeModule(PythonModuleInitialization module);
+  void initializePath(const std::string& scriptDir);
   void addPath(const std::string& path); // add path in UTF-8 encoding
   void addNativePath(const std::string& path); // add path in system/Python encoding
-  void getAddonModuleDeps(const ADDON::AddonPtr& addon, std::set<std::string>& paths);
+  void getAddonModuleDeps(const ADDON::AddonPtr& addon, std::set<std::string>& paths, std::set<std::string>* ids = NULL);
 
   std::string m_pythonPath;
   void *m_threadState;
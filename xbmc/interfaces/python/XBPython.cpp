@@ -53,9 +53,13 @@
 #include "interfaces/legacy/AddonUtils.h"
 #include "interfaces/python/AddonPythonInvoker.h"
 #include "interfaces/python/PythonInvoker.h"
+#include "interfaces/python/PythonInterpreterPool.h"
 
 using namespace ANNOUNCEMENT;
 
+// how long python stays loaded while plugin interpreters are kept warm
+#define PYTHON_POOL_IDLE_TIMEOUT 300000 // ms
+
 XBPython::XBPython()
 {
   m_bInitialized      = false;
@@ -465,6 +469,7 @@ void XBPython::Finalize()
     m_mainThreadState = NULL; // clear the main thread state before releasing the lock
     {
       CSingleExit exit(m_critSection);
+      CPythonInterpreterPool::Clear();
       PyEval_AcquireLock();
       PyThreadState_Swap(curTs);
 
@@ -528,8 +533,11 @@ void XBPython::Process()
     //delete scripts which are done
     tmpvec.clear(); // boost releases the XBPyThreads which, if deleted, calls OnScriptFinalized
 
+    // warm plugin interpreters are worth keeping python loaded a while longer
+    unsigned int idleTimeout = CPythonInterpreterPool::IsEmpty() ? 10000 : PYTHON_POOL_IDLE_TIMEOUT;
+
     CSingleLock l2(m_critSection);
-    if(m_iDllScriptCounter == 0 && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 )
+    if(m_iDllScriptCounter == 0 && (XbmcThreads::SystemClockMillis() - m_endtime) > idleTimeout )
     {
       Finalize();
     }
@@ -704,6 +712,12 @@ void XBPython::OnScriptFinalized(ILanguageInvoker *invoker)
   m_endtime = XbmcThreads::SystemClockMillis();
 }
 
+void XBPython::OnAddonChanged(const std::string &addonId)
+{
+  // the next run has to start from the add-on's new files and settings
+  CPythonInterpreterPool::Remove(addonId);
+}
+
 ILanguageInvoker* XBPython::CreateInvoker()
 {
   return new CAddonPythonInvoker(this);
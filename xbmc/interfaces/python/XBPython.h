@@ -99,6 +99,7 @@ public:
   virtual void OnScriptAbortRequested(ILanguageInvoker *invoker);
   virtual void OnScriptEnded(ILanguageInvoker *invoker);
   virtual void OnScriptFinalized(ILanguageInvoker *invoker);
+  virtual void OnAddonChanged(const std::string &addonId);
   virtual ILanguageInvoker* CreateInvoker();
 
   bool WaitForEvent(CEvent& hEvent, unsigned int milliseconds);
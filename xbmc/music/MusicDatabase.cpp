@@ -74,7 +74,20 @@ using namespace MUSICDATABASEDIRECTORY;
 using ADDON::AddonPtr;
 
 #define RECENTLY_PLAYED_LIMIT 25
-#define MIN_FULL_SEARCH_LENGTH 3
+
+// the items kept in the search index and the columns their names come from
+static const struct
+{
+  const char *table;
+  const char *idField;
+  const char *kind;
+  const char *column;
+} MusicSearchItems[] =
+{
+  { "artist", "idArtist", MediaTypeArtist, "strArtist" },
+  { "album",  "idAlbum",  MediaTypeAlbum,  "strAlbum" },
+  { "song",   "idSong",   MediaTypeSong,   "strTitle" },
+};
 
 #ifdef HAS_DVD_DRIVE
 using namespace CDDB;
@@ -178,6 +191,9 @@ void CMusicDatabase::CreateTables()
   CLog::Log(LOGINFO, "create art table");
   m_pDS->exec("CREATE TABLE art(art_id INTEGER PRIMARY KEY, media_id INTEGER, media_type TEXT, type TEXT, url TEXT)");
 
+  CLog::Log(LOGINFO, "create search index");
+  CreateSearchTable("name");
+
   // Add 'Karaoke' genre
   AddGenre( "Karaoke" );
 }
@@ -226,6 +242,8 @@ void CMusicDatabase::CreateAnalytics()
 
   m_pDS->exec("CREATE INDEX ix_art ON art(media_id, media_type(20), type(20))");
 
+  CreateSearchIndex("name");
+
   CLog::Log(LOGINFO, "create triggers");
   m_pDS->exec("CREATE TRIGGER tgrDeleteAlbum AFTER delete ON album FOR EACH ROW BEGIN"
               "  DELETE FROM song WHERE song.idAlbum = old.idAlbum;"
@@ -233,19 +251,24 @@ void CMusicDatabase::CreateAnalytics()
               "  DELETE FROM album_genre WHERE album_genre.idAlbum = old.idAlbum;"
               "  DELETE FROM albuminfosong WHERE albuminfosong.idAlbumInfo=old.idAlbum;"
               "  DELETE FROM art WHERE media_id=old.idAlbum AND media_type='album';"
+              "  " + GetSearchDeleteSQL(MediaTypeAlbum, "old.idAlbum") +
               " END");
   m_pDS->exec("CREATE TRIGGER tgrDeleteArtist AFTER delete ON artist FOR EACH ROW BEGIN"
               "  DELETE FROM album_artist WHERE album_artist.idArtist = old.idArtist;"
               "  DELETE FROM song_artist WHERE song_artist.idArtist = old.idArtist;"
               "  DELETE FROM discography WHERE discography.idArtist = old.idArtist;"
               "  DELETE FROM art WHERE media_id=old.idArtist AND media_type='artist';"
+              "  " + GetSearchDeleteSQL(MediaTypeArtist, "old.idArtist") +
               " END");
   m_pDS->exec("CREATE TRIGGER tgrDeleteSong AFTER delete ON song FOR EACH ROW BEGIN"
               "  DELETE FROM song_artist WHERE song_artist.idSong = old.idSong;"
               "  DELETE FROM song_genre WHERE song_genre.idSong = old.idSong;"
               "  DELETE FROM karaokedata WHERE karaokedata.idSong = old.idSong;"
               "  DELETE FROM art WHERE media_id=old.idSong AND media_type='song';"
+              "  " + GetSearchDeleteSQL(MediaTypeSong, "old.idSong") +
               " END");
+  for (unsigned int i = 0; i < sizeof(MusicSearchItems) / sizeof(MusicSearchItems[0]); i++)
+    CreateSearchTriggers(MusicSearchItems[i].table, MusicSearchItems[i].idField, MusicSearchItems[i].kind, "name", MusicSearchItems[i].column);
 
   // we create views last to ensure all indexes are rolled in
   CreateViews();
@@ -1783,15 +1806,8 @@ bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList &art
     if (NULL == m_pDS.get()) return false;
 
     std::string strVariousArtists = g_localizeStrings.Get(340).c_str();
-    std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from artist "
-                                "where (strArtist like '%s%%' or strArtist like '%% %s%%') and strArtist <> '%s' "
-                                , search.c_str(), search.c_str(), strVariousArtists.c_str() );
-    else
-      strSQL=PrepareSQL("select * from artist "
-                                "where strArtist like '%s%%' and strArtist <> '%s' "
-                                , search.c_str(), strVariousArtists.c_str() );
+    std::string strSQL = PrepareSQL("select * from artist where strArtist <> '%s' and ", strVariousArtists.c_str()) +
+                         GetSearchClause("artist.idArtist", MediaTypeArtist, "name", search);
 
     if (!m_pDS->query(strSQL.c_str())) return false;
     if (m_pDS->num_rows() == 0)
@@ -2207,11 +2223,7 @@ bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList &items
     if (!baseUrl.FromString("musicdb://songs/"))
       return false;
 
-    std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' or strTitle like '%% %s%%' limit 1000", search.c_str(), search.c_str());
-    else
-      strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' limit 1000", search.c_str());
+    std::string strSQL = "select * from songview where " + GetSearchClause("songview.idSong", MediaTypeSong, "name", search) + " limit 1000";
 
     if (!m_pDS->query(strSQL.c_str())) return false;
     if (m_pDS->num_rows() == 0) return false;
@@ -2243,11 +2255,7 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList &albu
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%' or strAlbum like '%% %s%%'", search.c_str(), search.c_str());
-    else
-      strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%'", search.c_str());
+    std::string strSQL = "select * from albumview where " + GetSearchClause("albumview.idAlbum", MediaTypeAlbum, "name", search);
 
     if (!m_pDS->query(strSQL.c_str())) return false;
 
@@ -3181,13 +3189,17 @@ bool CMusicDatabase::GetArtistsByWhere(const std::string& strBaseDir, const Filt
     if (!BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
+    // Apply the sorting and limiting directly here if there's no special sorting
+    // or the sorting can be done by the database
+    std::string orderClause = SortUtils::BuildOrderClause(sortDescription, MediaTypeArtist);
+    bool pagedByDatabase = false;
     if (extFilter.limit.empty() &&
-        sortDescription.sortBy == SortByNone &&
+       (sortDescription.sortBy == SortByNone || (!orderClause.empty() && extFilter.order.empty())) &&
        (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      strSQLExtra += orderClause + DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      pagedByDatabase = true;
     }
 
     strSQL = PrepareSQL(strSQL.c_str(), !extFilter.fields.empty() && extFilter.fields.compare("*") != 0 ? extFilter.fields.c_str() : "artistview.*") + strSQLExtra;
@@ -3219,7 +3231,7 @@ bool CMusicDatabase::GetArtistsByWhere(const std::string& strBaseDir, const Filt
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeArtist, m_pDS, results))
+    if (!SortUtils::SortFromDataset(pagedByDatabase ? SortDescription() : sortDescription, MediaTypeArtist, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -3340,13 +3352,17 @@ bool CMusicDatabase::GetAlbumsByWhere(const std::string &baseDir, const Filter &
     if (!BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
+    // Apply the sorting and limiting directly here if there's no special sorting
+    // or the sorting can be done by the database
+    std::string orderClause = SortUtils::BuildOrderClause(sortDescription, MediaTypeAlbum);
+    bool pagedByDatabase = false;
     if (extFilter.limit.empty() &&
-        sortDescription.sortBy == SortByNone &&
+       (sortDescription.sortBy == SortByNone || (!orderClause.empty() && extFilter.order.empty())) &&
        (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      strSQLExtra += orderClause + DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      pagedByDatabase = true;
     }
 
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "albumview.*") + strSQLExtra;
@@ -3383,7 +3399,7 @@ bool CMusicDatabase::GetAlbumsByWhere(const std::string &baseDir, const Filter &
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeAlbum, m_pDS, results))
+    if (!SortUtils::SortFromDataset(pagedByDatabase ? SortDescription() : sortDescription, MediaTypeAlbum, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -3453,13 +3469,17 @@ bool CMusicDatabase::GetSongsByWhere(const std::string &baseDir, const Filter &f
     if (!BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
+    // Apply the sorting and limiting directly here if there's no special sorting
+    // or the sorting can be done by the database
+    std::string orderClause = SortUtils::BuildOrderClause(sortDescription, MediaTypeSong);
+    bool pagedByDatabase = false;
     if (extFilter.limit.empty() &&
-        sortDescription.sortBy == SortByNone &&
+       (sortDescription.sortBy == SortByNone || (!orderClause.empty() && extFilter.order.empty())) &&
        (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      strSQLExtra += orderClause + DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      pagedByDatabase = true;
     }
 
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "songview.*") + strSQLExtra;
@@ -3483,7 +3503,7 @@ bool CMusicDatabase::GetSongsByWhere(const std::string &baseDir, const Filter &f
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeSong, m_pDS, results))
+    if (!SortUtils::SortFromDataset(pagedByDatabase ? SortDescription() : sortDescription, MediaTypeSong, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -3921,11 +3941,17 @@ void CMusicDatabase::UpdateTables(int version)
     m_pDS->exec("UPDATE karaokedata SET strKaraLyrFileCRC=NULL");
     m_pDS->exec("UPDATE album SET idThumb=NULL");
   }
+  if (version < 49)
+  {
+    CreateSearchTable("name");
+    for (unsigned int i = 0; i < sizeof(MusicSearchItems) / sizeof(MusicSearchItems[0]); i++)
+      FillSearchTable(MusicSearchItems[i].table, MusicSearchItems[i].idField, MusicSearchItems[i].kind, "name", MusicSearchItems[i].column);
+  }
 }
 
 int CMusicDatabase::GetSchemaVersion() const
 {
-  return 48;
+  return 49;
 }
 
 unsigned int CMusicDatabase::GetSongIDs(const Filter &filter, vector<pair<int,int> > &songIDs)
@@ -4201,42 +4227,30 @@ int CMusicDatabase::GetGenreByName(const std::string& strGenre)
   return -1;
 }
 
-bool CMusicDatabase::GetRandomSong(CFileItem* item, int& idSong, const Filter &filter)
+bool CMusicDatabase::GetPartyModeSong(CFileItem* item, int idSong)
 {
   try
   {
-    idSong = -1;
-
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    // We don't use PrepareSQL here, as the WHERE clause is already formatted
-    std::string strSQL = PrepareSQL("select %s from songview ", !filter.fields.empty() ? filter.fields.c_str() : "*");
-    Filter extFilter = filter;
-    extFilter.AppendOrder(PrepareSQL("RANDOM()"));
-    extFilter.limit = "1";
-
-    if (!CDatabase::BuildSQL(strSQL, extFilter, strSQL))
-      return false;
-
+    // party mode has drawn the song from the matching ids already
+    std::string strSQL = PrepareSQL("select * from songview where idSong = %i", idSong);
     CLog::Log(LOGDEBUG, "%s query = %s", __FUNCTION__, strSQL.c_str());
-    // run query
     if (!m_pDS->query(strSQL.c_str()))
       return false;
-    int iRowsFound = m_pDS->num_rows();
-    if (iRowsFound != 1)
+    if (m_pDS->num_rows() != 1)
     {
       m_pDS->close();
       return false;
     }
     GetFileItemFromDataset(item, CMusicDbUrl());
-    idSong = m_pDS->fv("songview.idSong").get_asInt();
     m_pDS->close();
     return true;
   }
   catch(...)
   {
-    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, filter.where.c_str());
+    CLog::Log(LOGERROR, "%s(%i) failed", __FUNCTION__, idSong);
   }
   return false;
 }
@@ -28,6 +28,7 @@
 #include "settings/AdvancedSettings.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "interfaces/AnnouncementManager.h"
+#include "utils/JSONStreamWriter.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
 #include "threads/SingleLock.h"
@@ -489,6 +490,7 @@ CTCPServer::CTCPClient::CTCPClient()
   m_endBrackets = 0;
   m_beginChar = 0;
   m_endChar = 0;
+  m_sendingResponse = false;
 
   m_addrlen = sizeof(m_cliaddr);
 }
@@ -520,14 +522,77 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
   return true;
 }
 
+class CTCPServer::CTCPClient::CResponseOutput : public IJSONStreamOutput
+{
+public:
+  CResponseOutput(CTCPClient &client) : m_client(client) { }
+
+  virtual bool Write(const char *data, size_t size) { return m_client.SendData(data, (unsigned int)size); }
+
+private:
+  CTCPClient &m_client;
+};
+
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
+{
+  {
+    CSingleLock lock (m_critSection);
+    // a response that's being written must not be interrupted, this goes out after it
+    if (m_sendingResponse)
+    {
+      m_deferredData.append(data, size);
+      return;
+    }
+  }
+
+  SendData(data, size);
+}
+
+bool CTCPServer::CTCPClient::SendData(const char *data, unsigned int size)
 {
   unsigned int sent = 0;
   do
   {
     CSingleLock lock (m_critSection);
-    sent += send(m_socket, data + sent, size - sent, 0);
+    int res = send(m_socket, data + sent, size - sent, 0);
+    if (res < 0)
+      return false;
+    sent += res;
   } while (sent < size);
+
+  return true;
+}
+
+void CTCPServer::CTCPClient::SendResponse(CJSONRPCResponse &response)
+{
+  if (response.IsEmpty())
+    return;
+
+  {
+    CSingleLock lock (m_critSection);
+    m_sendingResponse = true;
+  }
+
+  // send every chunk as soon as it's been written instead of building the whole response first
+  CResponseOutput output(*this);
+  CJSONStreamWriter writer(output, g_advancedSettings.m_jsonOutputCompact);
+  while (response.WriteNext(writer)) ;
+
+  // and whatever has been sent to the client in the meantime
+  while (true)
+  {
+    std::string deferred;
+    {
+      CSingleLock lock (m_critSection);
+      if (m_deferredData.empty())
+      {
+        m_sendingResponse = false;
+        break;
+      }
+      deferred.swap(m_deferredData);
+    }
+    SendData(deferred.c_str(), deferred.size());
+  }
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -558,8 +623,9 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        CJSONRPCResponse response;
+        CJSONRPC::MethodCall(m_buffer, host, this, response);
+        SendResponse(response);
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -590,6 +656,8 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_beginChar         = client.m_beginChar;
   m_endChar           = client.m_endChar;
   m_buffer            = client.m_buffer;
+  m_sendingResponse   = client.m_sendingResponse;
+  m_deferredData      = client.m_deferredData;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
@@ -634,6 +702,20 @@ void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
     CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
 }
 
+void CTCPServer::CWebSocketClient::SendResponse(CJSONRPCResponse &response)
+{
+  if (response.IsEmpty())
+    return;
+
+  // every response has to go out as a single message
+  std::string data;
+  CJSONStringOutput output(data);
+  CJSONStreamWriter writer(output, g_advancedSettings.m_jsonOutputCompact);
+  while (response.WriteNext(writer)) ;
+
+  Send(data.c_str(), data.size());
+}
+
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
 {
   bool send;
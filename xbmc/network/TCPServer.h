@@ -32,6 +32,8 @@
 
 namespace JSONRPC
 {
+  class CJSONRPCResponse;
+
   class CTCPServer : public ITransportLayer, public JSONRPC::IJSONRPCAnnouncer, public CThread
   {
   public:
@@ -68,6 +70,7 @@ namespace JSONRPC
       virtual bool SetAnnouncementFlags(int flags);
 
       virtual void Send(const char *data, unsigned int size);
+      virtual void SendResponse(JSONRPC::CJSONRPCResponse &response);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
@@ -81,12 +84,17 @@ namespace JSONRPC
 
     protected:
       void Copy(const CTCPClient& client);
+      bool SendData(const char *data, unsigned int size);
     private:
+      class CResponseOutput;
+
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
       std::string m_buffer;
+      bool m_sendingResponse;
+      std::string m_deferredData;
     };
 
     class CWebSocketClient : public CTCPClient
@@ -99,6 +107,7 @@ namespace JSONRPC
       ~CWebSocketClient();
 
       virtual void Send(const char *data, unsigned int size);
+      virtual void SendResponse(JSONRPC::CJSONRPCResponse &response);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
@@ -56,6 +56,12 @@
 
 #define HEADER_NEWLINE        "\r\n"
 
+#define STREAM_BLOCK_SIZE     16384
+
+#ifndef MHD_SIZE_UNKNOWN
+#define MHD_SIZE_UNKNOWN      -1
+#endif
+
 using namespace std;
 
 typedef struct ConnectionHandler
@@ -460,6 +466,10 @@ int CWebServer::HandleRequest(IHTTPRequestHandler *handler)
       ret = CreateFileDownloadResponse(handler, response);
       break;
 
+    case HTTPStreamedDownload:
+      ret = CreateStreamedDownloadResponse(handler, response);
+      break;
+
     case HTTPMemoryDownloadNoFreeNoCopy:
     case HTTPMemoryDownloadNoFreeCopy:
     case HTTPMemoryDownloadFreeNoCopy:
@@ -853,6 +863,46 @@ int CWebServer::CreateFileDownloadResponse(IHTTPRequestHandler *handler, struct
   return MHD_YES;
 }
 
+int CWebServer::CreateStreamedDownloadResponse(IHTTPRequestHandler *handler, struct MHD_Response *&response)
+{
+  if (handler == NULL)
+    return MHD_NO;
+
+  const HTTPRequest &request = handler->GetRequest();
+  std::auto_ptr<IHTTPResponseStream> stream(handler->GetResponseStream());
+  if (stream.get() == NULL)
+  {
+    CLog::Log(LOGERROR, "CWebServer: no content for the streamed HTTP response for %s", request.url.c_str());
+    return MHD_NO;
+  }
+
+  if (request.method == HEAD)
+  {
+    response = MHD_create_response_from_data(0, NULL, MHD_NO, MHD_NO);
+    if (response == NULL)
+    {
+      CLog::Log(LOGERROR, "CWebServer: failed to create a HTTP HEAD response for %s", request.url.c_str());
+      return MHD_NO;
+    }
+
+    return MHD_YES;
+  }
+
+  // without a length the response is sent chunked, or up to the end of the connection for HTTP/1.0
+  response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN, STREAM_BLOCK_SIZE,
+                                               &CWebServer::StreamReaderCallback,
+                                               stream.get(),
+                                               &CWebServer::StreamReaderFreeCallback);
+  if (response == NULL)
+  {
+    CLog::Log(LOGERROR, "CWebServer: failed to create a streamed HTTP response for %s", request.url.c_str());
+    return MHD_NO;
+  }
+
+  stream.release(); // ownership was passed to mhd
+  return MHD_YES;
+}
+
 int CWebServer::CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response)
 {
   size_t payloadSize = 0;
@@ -1034,6 +1084,40 @@ void CWebServer::ContentReaderFreeCallback(void *cls)
 #endif
 }
 
+#if (MHD_VERSION >= 0x00090200)
+ssize_t CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, size_t max)
+#elif (MHD_VERSION >= 0x00040001)
+int CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, int max)
+#else   //libmicrohttpd < 0.4.0
+int CWebServer::StreamReaderCallback(void *cls, size_t pos, char *buf, int max)
+#endif
+{
+  IHTTPResponseStream *stream = (IHTTPResponseStream *)cls;
+  if (stream == NULL)
+    return -1;
+
+  int read = stream->Read(buf, static_cast<size_t>(max));
+#ifdef WEBSERVER_DEBUG
+  CLog::Log(LOGDEBUG, "webserver [OUT] streamed %d bytes at %" PRIu64, read, static_cast<uint64_t>(pos));
+#endif
+
+  if (read > 0)
+    return read;
+#ifdef MHD_CONTENT_READER_END_OF_STREAM
+  if (read < 0)
+    return MHD_CONTENT_READER_END_WITH_ERROR;
+  return MHD_CONTENT_READER_END_OF_STREAM;
+#else
+  return -1;
+#endif
+}
+
+void CWebServer::StreamReaderFreeCallback(void *cls)
+{
+  IHTTPResponseStream *stream = (IHTTPResponseStream *)cls;
+  delete stream;
+}
+
 struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
 {
   unsigned int timeout = 60 * 60 * 24;
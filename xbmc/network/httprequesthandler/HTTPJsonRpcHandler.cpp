@@ -23,11 +23,64 @@
 #include "interfaces/json-rpc/JSONServiceDescription.h"
 #include "interfaces/json-rpc/JSONUtils.h"
 #include "network/WebServer.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/JSONStreamWriter.h"
 #include "utils/JSONVariantWriter.h"
 #include "utils/log.h"
 
 #define MAX_STRING_POST_SIZE 20000
 
+/*!
+ \brief Writes a JSON-RPC response as the webserver asks for more of it, so
+ that only a few chunks of it are held in memory at a time.
+ */
+class CHTTPJsonRpcResponseStream : public IHTTPResponseStream, private IJSONStreamOutput
+{
+public:
+  CHTTPJsonRpcResponseStream()
+    : m_writer(*this, g_advancedSettings.m_jsonOutputCompact),
+      m_complete(false)
+  { }
+
+  JSONRPC::CJSONRPCResponse& GetResponse() { return m_response; }
+
+  virtual int Read(char *buffer, size_t size)
+  {
+    while (m_buffer.size() < size && !m_complete)
+    {
+      if (!m_response.WriteNext(m_writer))
+      {
+        m_complete = true;
+        if (m_writer.HasFailed())
+          return -1;
+      }
+    }
+
+    size_t length = std::min(size, m_buffer.size());
+    memcpy(buffer, m_buffer.c_str(), length);
+    m_buffer.erase(0, length);
+
+    return static_cast<int>(length);
+  }
+
+private:
+  virtual bool Write(const char *data, size_t size)
+  {
+    m_buffer.append(data, size);
+    return true;
+  }
+
+  JSONRPC::CJSONRPCResponse m_response;
+  CJSONStreamWriter m_writer;
+  std::string m_buffer;
+  bool m_complete;
+};
+
+CHTTPJsonRpcHandler::~CHTTPJsonRpcHandler()
+{
+  delete m_responseStream;
+}
+
 bool CHTTPJsonRpcHandler::CanHandleRequest(const HTTPRequest &request)
 {
   return (request.url.compare("/jsonrpc") == 0);
@@ -67,7 +120,32 @@ int CHTTPJsonRpcHandler::HandleRequest()
   }
 
   if (isRequest)
-    m_responseData = JSONRPC::CJSONRPC::MethodCall(m_requestData, m_request.webserver, &client);
+  {
+    std::auto_ptr<CHTTPJsonRpcResponseStream> stream(new CHTTPJsonRpcResponseStream());
+    JSONRPC::CJSONRPC::MethodCall(m_requestData, m_request.webserver, &client, stream->GetResponse());
+    m_requestData.clear();
+
+    // only lists handed to StreamResult() are worth sending chunked, any
+    // other response is small and is sent in one piece
+    if (stream->GetResponse().IsStreamed())
+    {
+      m_responseStream = stream.release();
+
+      m_response.type = HTTPStreamedDownload;
+      m_response.status = MHD_HTTP_OK;
+      m_response.contentType = "application/json";
+
+      return MHD_YES;
+    }
+
+    // nothing to send back for notifications
+    if (!stream->GetResponse().IsEmpty())
+    {
+      CJSONStringOutput output(m_responseData);
+      CJSONStreamWriter writer(output, g_advancedSettings.m_jsonOutputCompact);
+      while (stream->GetResponse().WriteNext(writer)) ;
+    }
+  }
   else
   {
     // get the whole output of JSONRPC.Introspect
@@ -96,6 +174,14 @@ HttpResponseRanges CHTTPJsonRpcHandler::GetResponseData() const
   return ranges;
 }
 
+IHTTPResponseStream* CHTTPJsonRpcHandler::GetResponseStream()
+{
+  IHTTPResponseStream *stream = m_responseStream;
+  m_responseStream = NULL;
+
+  return stream;
+}
+
 #if (MHD_VERSION >= 0x00040001)
 bool CHTTPJsonRpcHandler::appendPostData(const char *data, size_t size)
 #else
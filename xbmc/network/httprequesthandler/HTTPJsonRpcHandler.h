@@ -27,8 +27,8 @@
 class CHTTPJsonRpcHandler : public IHTTPRequestHandler
 {
 public:
-  CHTTPJsonRpcHandler() { }
-  virtual ~CHTTPJsonRpcHandler() { }
+  CHTTPJsonRpcHandler() : m_responseStream(NULL) { }
+  virtual ~CHTTPJsonRpcHandler();
   
   virtual IHTTPRequestHandler* Create(const HTTPRequest &request) { return new CHTTPJsonRpcHandler(request); }
   virtual bool CanHandleRequest(const HTTPRequest &request);
@@ -36,12 +36,14 @@ public:
   virtual int HandleRequest();
 
   virtual HttpResponseRanges GetResponseData() const;
+  virtual IHTTPResponseStream* GetResponseStream();
 
   virtual int GetPriority() const { return 2; }
 
 protected:
   explicit CHTTPJsonRpcHandler(const HTTPRequest &request)
-    : IHTTPRequestHandler(request)
+    : IHTTPRequestHandler(request),
+      m_responseStream(NULL)
   { }
 
 #if (MHD_VERSION >= 0x00040001)
@@ -54,6 +56,7 @@ private:
   std::string m_requestData;
   std::string m_responseData;
   CHttpResponseRange m_responseRange;
+  IHTTPResponseStream *m_responseStream;
 
   class CHTTPClient : public JSONRPC::IClient
   {
@@ -62,7 +62,9 @@ typedef enum HTTPResponseType
   HTTPMemoryDownloadFreeNoCopy,
   // creates a HTTP response from a buffer by copying followed by freeing the buffer
   // the buffer must have been malloc'ed and not new'ed
-  HTTPMemoryDownloadFreeCopy
+  HTTPMemoryDownloadFreeCopy,
+  // creates a HTTP response of unknown length whose content is produced while it's sent
+  HTTPStreamedDownload
 } HTTPResponseType;
 
 typedef struct HTTPRequest
@@ -83,6 +85,22 @@ typedef struct HTTPResponseDetails {
   uint64_t totalLength;
 } HTTPResponseDetails;
 
+class IHTTPResponseStream
+{
+public:
+  virtual ~IHTTPResponseStream() { }
+
+  /*!
+   * \brief Fills the given buffer with the next part of the response.
+   *
+   * \param buffer Buffer to fill
+   * \param size Size of the buffer
+   * \return Number of bytes written to the buffer, 0 once the response is
+   * complete or -1 if it can't be completed.
+   */
+  virtual int Read(char *buffer, size_t size) = 0;
+};
+
 class IHTTPRequestHandler
 {
 public:
@@ -168,6 +186,13 @@ public:
   */
   virtual std::string GetResponseFile() const { return ""; }
 
+  /*!
+  * \brief Returns the producer of the response content, which is taken over by the caller.
+  *
+  * \details This is only used if the response type is HTTPStreamedDownload.
+  */
+  virtual IHTTPResponseStream* GetResponseStream() { return NULL; }
+
   /*!
   * \brief Returns the HTTP request handled by the HTTP request handler.
   */
@@ -649,6 +649,7 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
       load = items.Load();
     }
 
+    bool paged = false;
     if (!load) {
         // cache anything that takes more than a second to retrieve
         unsigned int time = XbmcThreads::SystemClockMillis();
@@ -677,11 +678,26 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
                              + g_advancedSettings.m_videoExtensions + "|"
                              + g_advancedSettings.m_musicExtensions + "|"
                              + g_advancedSettings.m_discStubExtensions;
-            CDirectory::GetDirectory((const char*)parent_id, items, supported);
-            DefaultSortItems(items);
+            CDirectory::CHints hints;
+            hints.mask = supported;
+
+            // let the library databases sort the listing and only build the
+            // requested page instead of every item in it
+            if (URIUtils::IsMusicDb((const char*)parent_id) || URIUtils::IsVideoDb((const char*)parent_id)) {
+                NPT_UInt32 max_count = (requested_count == 0)?m_MaxReturnedItems:min((unsigned long)requested_count, (unsigned long)m_MaxReturnedItems);
+                hints.sorting = GetDefaultSorting(items);
+                hints.sorting.limitStart = starting_index;
+                hints.sorting.limitEnd = starting_index + max_count;
+            }
+
+            CDirectory::GetDirectory((const char*)parent_id, items, hints);
+            paged = IsPaged(items);
+            if (!paged)
+                DefaultSortItems(items);
         }
 
-        if (items.CacheToDiscAlways() || (items.CacheToDiscIfSlow() && (XbmcThreads::SystemClockMillis() - time) > 1000 )) {
+        // a page of the listing must not be cached in place of the full listing
+        if (!paged && (items.CacheToDiscAlways() || (items.CacheToDiscIfSlow() && (XbmcThreads::SystemClockMillis() - time) > 1000 ))) {
             NPT_AutoLock lock(m_CacheMutex);
             items.Save();
         }
@@ -768,10 +784,16 @@ CUPnPServer::BuildResponse(PLT_ActionReference&          action,
     // won't return more than UPNP_MAX_RETURNED_ITEMS items at a time to keep things smooth
     // 0 requested means as many as possible
     NPT_UInt32 max_count  = (requested_count == 0)?m_MaxReturnedItems:min((unsigned long)requested_count, (unsigned long)m_MaxReturnedItems);
+    NPT_Cardinal total = items.Size();
+
+    // a listing paged by the library only holds the requested items
+    if (IsPaged(items)) {
+        total = (NPT_Cardinal)items.GetProperty("total").asInteger();
+        starting_index = 0;
+    }
     NPT_UInt32 stop_index = min((unsigned long)(starting_index + max_count), (unsigned long)items.Size()); // don't return more than we can
 
     NPT_Cardinal count = 0;
-    NPT_Cardinal total = items.Size();
     NPT_String didl = didl_header;
     PLT_MediaObjectReference object;
     for (unsigned long i=starting_index; i<stop_index; ++i) {
@@ -1291,16 +1313,31 @@ CUPnPServer::SortItems(CFileItemList& items, const char* sort_criteria)
   return sorted;
 }
 
-void
-CUPnPServer::DefaultSortItems(CFileItemList& items)
+SortDescription
+CUPnPServer::GetDefaultSorting(const CFileItemList& items)
 {
+  SortDescription sorting;
   CGUIViewState* viewState = CGUIViewState::GetViewState(items.IsVideoDb() ? WINDOW_VIDEO_NAV : -1, items);
   if (viewState)
   {
-    SortDescription sorting = viewState->GetSortMethod();
-    items.Sort(sorting.sortBy, sorting.sortOrder, sorting.sortAttributes);
+    sorting = viewState->GetSortMethod();
     delete viewState;
   }
+  return sorting;
+}
+
+void
+CUPnPServer::DefaultSortItems(CFileItemList& items)
+{
+  SortDescription sorting = GetDefaultSorting(items);
+  items.Sort(sorting.sortBy, sorting.sortOrder, sorting.sortAttributes);
+}
+
+bool
+CUPnPServer::IsPaged(const CFileItemList& items)
+{
+  // the library sets the size of the full listing when it only returned a page of it
+  return items.HasProperty("total") && items.GetProperty("total").asInteger() > items.Size();
 }
 
 NPT_Result
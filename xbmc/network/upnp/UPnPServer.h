@@ -123,7 +123,9 @@ private:
 
     // class methods
     static bool SortItems(CFileItemList& items, const char* sort_criteria);
+    static SortDescription GetDefaultSorting(const CFileItemList& items);
     static void DefaultSortItems(CFileItemList& items);
+    static bool IsPaged(const CFileItemList& items);
     static NPT_String GetParentFolder(NPT_String file_path) {
         int index = file_path.ReverseFind("\\");
         if (index == -1) return "";
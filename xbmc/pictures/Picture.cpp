@@ -24,6 +24,7 @@
 #endif
 
 #include "Picture.h"
+#include "PictureTransforms.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "FileItem.h"
@@ -32,14 +33,11 @@
 #include "utils/URIUtils.h"
 #include "guilib/Texture.h"
 #include "guilib/imagefactory.h"
-#include "cores/FFmpeg.h"
 #if defined(HAS_OMXPLAYER)
 #include "cores/omxplayer/OMXImage.h"
 #endif
 
-extern "C" {
-#include "libswscale/swscale.h"
-}
+#include <algorithm>
 
 using namespace XFILE;
 
@@ -328,22 +326,8 @@ void CPicture::GetScale(unsigned int width, unsigned int height, unsigned int &o
 bool CPicture::ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
                           uint8_t *out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch)
 {
-  struct SwsContext *context = sws_getContext(in_width, in_height, PIX_FMT_BGRA,
-                                                         out_width, out_height, PIX_FMT_BGRA,
-                                                         SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
-
-  uint8_t *src[] = { in_pixels, 0, 0, 0 };
-  int     srcStride[] = { (int)in_pitch, 0, 0, 0 };
-  uint8_t *dst[] = { out_pixels , 0, 0, 0 };
-  int     dstStride[] = { (int)out_pitch, 0, 0, 0 };
-
-  if (context)
-  {
-    sws_scale(context, src, srcStride, 0, in_height, dst, dstStride);
-    sws_freeContext(context);
-    return true;
-  }
-  return false;
+  return CPictureScaler::Scale(in_pixels, in_width, in_height, in_pitch,
+                               out_pixels, out_width, out_height, out_pitch);
 }
 
 bool CPicture::OrientateImage(uint32_t *&pixels, unsigned int &width, unsigned int &height, int orientation)
@@ -384,11 +368,7 @@ bool CPicture::FlipHorizontal(uint32_t *&pixels, unsigned int &width, unsigned i
 {
   // this can be done in-place easily enough
   for (unsigned int y = 0; y < height; ++y)
-  {
-    uint32_t *line = pixels + y * width;
-    for (unsigned int x = 0; x < width / 2; ++x)
-      std::swap(line[x], line[width - 1 - x]);
-  }
+    PictureTransforms::ReverseRow(pixels + y * width, width);
   return true;
 }
 
@@ -399,8 +379,7 @@ bool CPicture::FlipVertical(uint32_t *&pixels, unsigned int &width, unsigned int
   {
     uint32_t *line1 = pixels + y * width;
     uint32_t *line2 = pixels + (height - 1 - y) * width;
-    for (unsigned int x = 0; x < width; ++x)
-      std::swap(*line1++, *line2++);
+    std::swap_ranges(line1, line1 + width, line2);
   }
   return true;
 }
@@ -409,62 +388,21 @@ bool CPicture::Rotate180CCW(uint32_t *&pixels, unsigned int &width, unsigned int
 {
   // this can be done in-place easily enough
   for (unsigned int y = 0; y < height / 2; ++y)
-  {
-    uint32_t *line1 = pixels + y * width;
-    uint32_t *line2 = pixels + (height - 1 - y) * width + width - 1;
-    for (unsigned int x = 0; x < width; ++x)
-      std::swap(*line1++, *line2--);
-  }
+    PictureTransforms::SwapReverseRows(pixels + y * width, pixels + (height - 1 - y) * width, width);
   if (height % 2)
   { // height is odd, so flip the middle row as well
-    uint32_t *line = pixels + (height - 1)/2 * width;
-    for (unsigned int x = 0; x < width / 2; ++x)
-      std::swap(line[x], line[width - 1 - x]);
+    PictureTransforms::ReverseRow(pixels + (height - 1)/2 * width, width);
   }
   return true;
 }
 
-bool CPicture::Rotate90CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+bool CPicture::TransposeImage(uint32_t *&pixels, unsigned int &width, unsigned int &height, bool mirrorX, bool mirrorY)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
-  if (dest)
-  {
-    unsigned int d_height = width, d_width = height;
-    for (unsigned int y = 0; y < d_height; y++)
-    {
-      const uint32_t *src = pixels + (d_height - 1 - y); // y-th col from right, starting at top
-      uint32_t *dst = dest + d_width * y;                // y-th row from top, starting at left
-      for (unsigned int x = 0; x < d_width; x++)
-      {
-        *dst++ = *src;
-        src += width;
-      }
-    }
-    delete[] pixels;
-    pixels = dest;
-    std::swap(width, height);
-    return true;
-  }
-  return false;
-}
-
-bool CPicture::Rotate270CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height)
-{
-  uint32_t *dest = new uint32_t[width * height * 4];
+  uint32_t *dest = new uint32_t[width * height];
   if (!dest)
     return false;
 
-  unsigned int d_height = width, d_width = height;
-  for (unsigned int y = 0; y < d_height; y++)
-  {
-    const uint32_t *src = pixels + width * (d_width - 1) + y; // y-th col from left, starting at bottom
-    uint32_t *dst = dest + d_width * y;                       // y-th row from top, starting at left
-    for (unsigned int x = 0; x < d_width; x++)
-    {
-      *dst++ = *src;
-      src -= width;
-    }
-  }
+  PictureTransforms::Transpose(pixels, width, height, dest, mirrorX, mirrorY);
 
   delete[] pixels;
   pixels = dest;
@@ -472,50 +410,25 @@ bool CPicture::Rotate270CCW(uint32_t *&pixels, unsigned int &width, unsigned int
   return true;
 }
 
-bool CPicture::Transpose(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+bool CPicture::Rotate90CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
-  if (!dest)
-    return false;
+  // each row of the result is a column of the source, starting from the right
+  return TransposeImage(pixels, width, height, true, false);
+}
 
-  unsigned int d_height = width, d_width = height;
-  for (unsigned int y = 0; y < d_height; y++)
-  {
-    const uint32_t *src = pixels + y;   // y-th col from left, starting at top
-    uint32_t *dst = dest + d_width * y; // y-th row from top, starting at left
-    for (unsigned int x = 0; x < d_width; x++)
-    {
-      *dst++ = *src;
-      src += width;
-    }
-  }
+bool CPicture::Rotate270CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+{
+  // each row of the result is a column of the source read from the bottom up
+  return TransposeImage(pixels, width, height, false, true);
+}
 
-  delete[] pixels;
-  pixels = dest;
-  std::swap(width, height);
-  return true;
+bool CPicture::Transpose(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+{
+  return TransposeImage(pixels, width, height, false, false);
 }
 
 bool CPicture::TransposeOffAxis(uint32_t *&pixels, unsigned int &width, unsigned int &height)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
-  if (!dest)
-    return false;
-
-  unsigned int d_height = width, d_width = height;
-  for (unsigned int y = 0; y < d_height; y++)
-  {
-    const uint32_t *src = pixels + width * (d_width - 1) + (d_height - 1 - y); // y-th col from right, starting at bottom
-    uint32_t *dst = dest + d_width * y;                                        // y-th row, starting at left
-    for (unsigned int x = 0; x < d_width; x++)
-    {
-      *dst++ = *src;
-      src -= width;
-    }
-  }
-
-  delete[] pixels;
-  pixels = dest;
-  std::swap(width, height);
-  return true;
+  // each row of the result is a column of the source read from the bottom up, starting from the right
+  return TransposeImage(pixels, width, height, true, true);
 }
@@ -62,6 +62,7 @@ private:
   static bool Rotate180CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height);
   static bool Transpose(uint32_t *&pixels, unsigned int &width, unsigned int &height);
   static bool TransposeOffAxis(uint32_t *&pixels, unsigned int &width, unsigned int &height);
+  static bool TransposeImage(uint32_t *&pixels, unsigned int &width, unsigned int &height, bool mirrorX, bool mirrorY);
 };
 
 //this class calls CreateThumbnailFromSurface in a CJob, so a png file can be written without halting the render thread
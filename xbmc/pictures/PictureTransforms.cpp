@@ -0,0 +1,280 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PictureTransforms.h"
+#include "cores/FFmpeg.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+extern "C" {
+#include "libswscale/swscale.h"
+}
+
+// size of the tiles the transposing kernels work on. 64x64 pixels is 16kB
+// for each of the source and destination tile, which keeps both in L1/L2
+#define TRANSPOSE_TILE_SIZE 64
+
+// maximum number of idle scaler contexts that are kept around
+#define MAX_SCALER_CONTEXTS 4
+
+#if defined(__SSE2__)
+typedef __m128i pixel4;
+
+static inline pixel4 Load4(const uint32_t *p)            { return _mm_loadu_si128((const __m128i *)p); }
+static inline void   Store4(uint32_t *p, pixel4 v)       { _mm_storeu_si128((__m128i *)p, v); }
+static inline pixel4 Reverse4(pixel4 v)                  { return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3)); }
+
+static inline void Transpose4(pixel4 &r0, pixel4 &r1, pixel4 &r2, pixel4 &r3)
+{
+  pixel4 t0 = _mm_unpacklo_epi32(r0, r1); // a0 b0 a1 b1
+  pixel4 t1 = _mm_unpacklo_epi32(r2, r3); // c0 d0 c1 d1
+  pixel4 t2 = _mm_unpackhi_epi32(r0, r1); // a2 b2 a3 b3
+  pixel4 t3 = _mm_unpackhi_epi32(r2, r3); // c2 d2 c3 d3
+  r0 = _mm_unpacklo_epi64(t0, t1);        // a0 b0 c0 d0
+  r1 = _mm_unpackhi_epi64(t0, t1);        // a1 b1 c1 d1
+  r2 = _mm_unpacklo_epi64(t2, t3);        // a2 b2 c2 d2
+  r3 = _mm_unpackhi_epi64(t2, t3);        // a3 b3 c3 d3
+}
+#define HAS_PIXEL4
+#elif defined(__ARM_NEON__)
+typedef uint32x4_t pixel4;
+
+static inline pixel4 Load4(const uint32_t *p)            { return vld1q_u32(p); }
+static inline void   Store4(uint32_t *p, pixel4 v)       { vst1q_u32(p, v); }
+static inline pixel4 Reverse4(pixel4 v)
+{
+  v = vrev64q_u32(v);                             // x1 x0 x3 x2
+  return vcombine_u32(vget_high_u32(v), vget_low_u32(v));
+}
+
+static inline void Transpose4(pixel4 &r0, pixel4 &r1, pixel4 &r2, pixel4 &r3)
+{
+  uint32x4x2_t t01 = vtrnq_u32(r0, r1);           // a0 b0 a2 b2, a1 b1 a3 b3
+  uint32x4x2_t t23 = vtrnq_u32(r2, r3);           // c0 d0 c2 d2, c1 d1 c3 d3
+  r0 = vcombine_u32(vget_low_u32(t01.val[0]),  vget_low_u32(t23.val[0]));
+  r1 = vcombine_u32(vget_low_u32(t01.val[1]),  vget_low_u32(t23.val[1]));
+  r2 = vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]));
+  r3 = vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]));
+}
+#define HAS_PIXEL4
+#endif
+
+/* Transpose a 4x4 block of pixels.
+ src points at the top left pixel of the block, dest at the destination
+ of the first column of the block. Consecutive columns are written destStride
+ pixels apart (negative when mirroring horizontally). When reverse is set the
+ block is written from right to left, and dest points at the leftmost pixel. */
+static inline void TransposeBlock(const uint32_t *src, unsigned int srcStride, uint32_t *dest, ptrdiff_t destStride, bool reverse)
+{
+#if defined(HAS_PIXEL4)
+  pixel4 r0 = Load4(src);
+  pixel4 r1 = Load4(src + srcStride);
+  pixel4 r2 = Load4(src + 2 * srcStride);
+  pixel4 r3 = Load4(src + 3 * srcStride);
+  Transpose4(r0, r1, r2, r3);
+  if (reverse)
+  {
+    r0 = Reverse4(r0);
+    r1 = Reverse4(r1);
+    r2 = Reverse4(r2);
+    r3 = Reverse4(r3);
+  }
+  Store4(dest, r0);
+  Store4(dest + destStride, r1);
+  Store4(dest + 2 * destStride, r2);
+  Store4(dest + 3 * destStride, r3);
+#else
+  for (unsigned int k = 0; k < 4; k++)
+  {
+    uint32_t *d = dest + k * destStride;
+    for (unsigned int i = 0; i < 4; i++)
+      d[reverse ? 3 - i : i] = src[i * srcStride + k];
+  }
+#endif
+}
+
+void PictureTransforms::Transpose(const uint32_t *src, unsigned int width, unsigned int height, uint32_t *dest, bool mirrorX, bool mirrorY)
+{
+  const unsigned int d_width = height;
+  const ptrdiff_t rowStride = mirrorX ? -(ptrdiff_t)d_width : (ptrdiff_t)d_width;
+
+  // the part of the image made up of whole 4x4 blocks, processed tile by tile
+  const unsigned int width4 = width & ~3;
+  const unsigned int height4 = height & ~3;
+  for (unsigned int ty = 0; ty < height4; ty += TRANSPOSE_TILE_SIZE)
+  {
+    const unsigned int ty_end = std::min(ty + TRANSPOSE_TILE_SIZE, height4);
+    for (unsigned int tx = 0; tx < width4; tx += TRANSPOSE_TILE_SIZE)
+    {
+      const unsigned int tx_end = std::min(tx + TRANSPOSE_TILE_SIZE, width4);
+      for (unsigned int y = ty; y < ty_end; y += 4)
+      {
+        const unsigned int d_x = mirrorY ? height - 4 - y : y;
+        for (unsigned int x = tx; x < tx_end; x += 4)
+        {
+          const unsigned int d_y = mirrorX ? width - 1 - x : x;
+          TransposeBlock(src + y * width + x, width, dest + d_y * d_width + d_x, rowStride, mirrorY);
+        }
+      }
+    }
+  }
+
+  // leftover columns on the right and rows at the bottom
+  for (unsigned int y = 0; y < height; y++)
+  {
+    const unsigned int d_x = mirrorY ? height - 1 - y : y;
+    const unsigned int x_start = y < height4 ? width4 : 0;
+    const uint32_t *s = src + y * width;
+    for (unsigned int x = x_start; x < width; x++)
+    {
+      const unsigned int d_y = mirrorX ? width - 1 - x : x;
+      dest[d_y * d_width + d_x] = s[x];
+    }
+  }
+}
+
+void PictureTransforms::ReverseRow(uint32_t *line, unsigned int width)
+{
+  unsigned int x = 0;
+#if defined(HAS_PIXEL4)
+  for (; 2 * x + 8 <= width; x += 4)
+  {
+    pixel4 left  = Load4(line + x);
+    pixel4 right = Load4(line + width - 4 - x);
+    Store4(line + x, Reverse4(right));
+    Store4(line + width - 4 - x, Reverse4(left));
+  }
+#endif
+  for (; x < width / 2; ++x)
+    std::swap(line[x], line[width - 1 - x]);
+}
+
+void PictureTransforms::SwapReverseRows(uint32_t *line1, uint32_t *line2, unsigned int width)
+{
+  unsigned int x = 0;
+#if defined(HAS_PIXEL4)
+  for (; x + 4 <= width; x += 4)
+  {
+    pixel4 a = Load4(line1 + x);
+    pixel4 b = Load4(line2 + width - 4 - x);
+    Store4(line1 + x, Reverse4(b));
+    Store4(line2 + width - 4 - x, Reverse4(a));
+  }
+#endif
+  for (; x < width; ++x)
+    std::swap(line1[x], line2[width - 1 - x]);
+}
+
+CPictureScaler::CPictureScaler()
+{
+}
+
+CPictureScaler::~CPictureScaler()
+{
+  FreeAll();
+}
+
+CPictureScaler &CPictureScaler::Get()
+{
+  static CPictureScaler sScaler;
+  return sScaler;
+}
+
+bool CPictureScaler::Scale(const uint8_t *in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
+                           uint8_t *out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch)
+{
+  CPictureScaler &scaler = Get();
+  SwsContext *context = scaler.Acquire(in_width, in_height, out_width, out_height);
+  if (!context)
+    return false;
+
+  uint8_t *src[] = { (uint8_t *)in_pixels, 0, 0, 0 };
+  int     srcStride[] = { (int)in_pitch, 0, 0, 0 };
+  uint8_t *dst[] = { out_pixels , 0, 0, 0 };
+  int     dstStride[] = { (int)out_pitch, 0, 0, 0 };
+
+  sws_scale(context, src, srcStride, 0, in_height, dst, dstStride);
+
+  scaler.Release(in_width, in_height, out_width, out_height, context);
+  return true;
+}
+
+void CPictureScaler::Clear()
+{
+  Get().FreeAll();
+}
+
+SwsContext *CPictureScaler::Acquire(unsigned int in_width, unsigned int in_height, unsigned int out_width, unsigned int out_height)
+{
+  {
+    CSingleLock lock(m_critSection);
+    for (std::vector<ScalerContext>::reverse_iterator i = m_contexts.rbegin(); i != m_contexts.rend(); ++i)
+    {
+      if (i->in_width == in_width && i->in_height == in_height &&
+          i->out_width == out_width && i->out_height == out_height)
+      {
+        SwsContext *context = i->context;
+        m_contexts.erase(--i.base());
+        return context;
+      }
+    }
+  }
+
+  // nothing suitable is idle, create a new one outside of the lock
+  return sws_getContext(in_width, in_height, PIX_FMT_BGRA,
+                        out_width, out_height, PIX_FMT_BGRA,
+                        SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
+}
+
+void CPictureScaler::Release(unsigned int in_width, unsigned int in_height, unsigned int out_width, unsigned int out_height, SwsContext *context)
+{
+  SwsContext *expired = NULL;
+  {
+    CSingleLock lock(m_critSection);
+    ScalerContext entry = { in_width, in_height, out_width, out_height, context };
+    m_contexts.push_back(entry);
+    if (m_contexts.size() > MAX_SCALER_CONTEXTS)
+    {
+      expired = m_contexts.front().context;
+      m_contexts.erase(m_contexts.begin());
+    }
+  }
+  if (expired)
+    sws_freeContext(expired);
+}
+
+void CPictureScaler::FreeAll()
+{
+  std::vector<ScalerContext> contexts;
+  {
+    CSingleLock lock(m_critSection);
+    contexts.swap(m_contexts);
+  }
+  for (std::vector<ScalerContext>::iterator i = contexts.begin(); i != contexts.end(); ++i)
+    sws_freeContext(i->context);
+}
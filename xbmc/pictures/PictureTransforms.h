@@ -0,0 +1,106 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+
+struct SwsContext;
+
+/*! \brief Pixel kernels used when caching images.
+ All kernels work on tightly packed 32bit pixels (pitch == width).
+ The transposing kernels walk the image in cache sized tiles and use SSE2/NEON
+ 4x4 register transposes where available, so that neither the reads nor the
+ writes stride across the whole image for every pixel.
+ */
+namespace PictureTransforms
+{
+  /*! \brief Transpose an image into a new buffer, optionally mirroring it.
+   The destination is height x width pixels. Pixel (x, y) of the destination
+   is taken from (mirrorX ? width-1-y : y, mirrorY ? height-1-x : x) of the source.
+   This covers EXIF orientations 4 (transpose), 5 (rotate 270), 6 (transverse)
+   and 7 (rotate 90).
+   \param src source pixels, width x height
+   \param width width of the source image in pixels
+   \param height height of the source image in pixels
+   \param dest destination buffer of at least width * height pixels, must not overlap src
+   \param mirrorX take destination rows from the right hand side of the source
+   \param mirrorY take destination columns from the bottom of the source
+   */
+  void Transpose(const uint32_t *src, unsigned int width, unsigned int height, uint32_t *dest, bool mirrorX, bool mirrorY);
+
+  /*! \brief Reverse the order of the pixels in a row, in place
+   \param line the pixels to reverse
+   \param width number of pixels in the row
+   */
+  void ReverseRow(uint32_t *line, unsigned int width);
+
+  /*! \brief Swap two rows, reversing both of them, in place
+   \param line1 the first row
+   \param line2 the second row
+   \param width number of pixels in each row
+   */
+  void SwapReverseRows(uint32_t *line1, uint32_t *line2, unsigned int width);
+}
+
+/*! \brief Scales BGRA images using swscale, keeping the scaler contexts around.
+ Creating a swscale context computes the filter coefficients for the given
+ sizes, which costs as much as the scale itself for thumbnail sized outputs.
+ The texture cache tends to produce many images with identical dimensions
+ (all photos from the same camera, all fanart at the same resolution), so a
+ small pool of contexts keyed by input and output size is kept and handed out
+ to the caching jobs.
+ */
+class CPictureScaler
+{
+public:
+  /*! \brief Scale a BGRA image
+   \return true if the image was scaled, false if no scaler could be created
+   */
+  static bool Scale(const uint8_t *in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
+                    uint8_t *out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch);
+
+  /*! \brief Free all pooled scaler contexts
+   */
+  static void Clear();
+
+private:
+  CPictureScaler();
+  ~CPictureScaler();
+  static CPictureScaler &Get();
+
+  struct ScalerContext
+  {
+    unsigned int in_width;
+    unsigned int in_height;
+    unsigned int out_width;
+    unsigned int out_height;
+    SwsContext  *context;
+  };
+
+  SwsContext *Acquire(unsigned int in_width, unsigned int in_height, unsigned int out_width, unsigned int out_height);
+  void Release(unsigned int in_width, unsigned int in_height, unsigned int out_width, unsigned int out_height, SwsContext *context);
+  void FreeAll();
+
+  CCriticalSection           m_critSection;
+  std::vector<ScalerContext> m_contexts; ///< idle contexts, most recently used last
+};
@@ -806,6 +806,7 @@ void CSlideShowPic::Render(float *x, float *y, CBaseTexture* pTexture, color_t c
 
 #elif defined(HAS_GL)
   g_graphicsContext.BeginPaint();
+  g_graphicsContext.FlushBatch();
   if (pTexture)
   {
     int unit = 0;
@@ -0,0 +1,149 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "pictures/PictureTransforms.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+// straightforward per pixel version of PictureTransforms::Transpose
+static void ReferenceTranspose(const uint32_t *src, unsigned int width, unsigned int height, uint32_t *dest, bool mirrorX, bool mirrorY)
+{
+  for (unsigned int y = 0; y < width; y++)
+  {
+    for (unsigned int x = 0; x < height; x++)
+    {
+      unsigned int sx = mirrorX ? width - 1 - y : y;
+      unsigned int sy = mirrorY ? height - 1 - x : x;
+      dest[y * height + x] = src[sy * width + sx];
+    }
+  }
+}
+
+static void FillPixels(std::vector<uint32_t> &pixels)
+{
+  for (unsigned int i = 0; i < pixels.size(); i++)
+    pixels[i] = i * 2654435761U;
+}
+
+static double ElapsedMs(int64_t start)
+{
+  return (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency();
+}
+
+TEST(TestPictureTransforms, Transpose)
+{
+  // sizes chosen to cover whole blocks, partial blocks and multiple tiles
+  static const unsigned int sizes[][2] = { { 1, 1 }, { 3, 5 }, { 4, 4 }, { 7, 9 }, { 64, 64 }, { 130, 67 }, { 67, 130 } };
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+  {
+    unsigned int width = sizes[s][0], height = sizes[s][1];
+    std::vector<uint32_t> src(width * height);
+    FillPixels(src);
+    for (int mode = 0; mode < 4; mode++)
+    {
+      bool mirrorX = (mode & 1) != 0, mirrorY = (mode & 2) != 0;
+      std::vector<uint32_t> expected(width * height), actual(width * height);
+      ReferenceTranspose(&src[0], width, height, &expected[0], mirrorX, mirrorY);
+      PictureTransforms::Transpose(&src[0], width, height, &actual[0], mirrorX, mirrorY);
+      EXPECT_TRUE(expected == actual) << width << "x" << height << " mirrorX=" << mirrorX << " mirrorY=" << mirrorY;
+    }
+  }
+}
+
+TEST(TestPictureTransforms, ReverseRow)
+{
+  for (unsigned int width = 0; width < 20; width++)
+  {
+    std::vector<uint32_t> line(width), expected(width);
+    FillPixels(line);
+    for (unsigned int x = 0; x < width; x++)
+      expected[x] = line[width - 1 - x];
+    if (width)
+      PictureTransforms::ReverseRow(&line[0], width);
+    EXPECT_TRUE(expected == line) << "width " << width;
+  }
+}
+
+TEST(TestPictureTransforms, SwapReverseRows)
+{
+  for (unsigned int width = 1; width < 20; width++)
+  {
+    std::vector<uint32_t> line1(width), line2(width);
+    FillPixels(line1);
+    for (unsigned int x = 0; x < width; x++)
+      line2[x] = ~line1[x];
+    std::vector<uint32_t> expected1(line2.rbegin(), line2.rend());
+    std::vector<uint32_t> expected2(line1.rbegin(), line1.rend());
+    PictureTransforms::SwapReverseRows(&line1[0], &line2[0], width);
+    EXPECT_TRUE(expected1 == line1) << "width " << width;
+    EXPECT_TRUE(expected2 == line2) << "width " << width;
+  }
+}
+
+// times the transforms on 12 and 24 megapixel images, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestPictureTransforms.*
+TEST(TestPictureTransforms, DISABLED_Benchmark)
+{
+  // typical 12 and 24 megapixel camera images
+  static const unsigned int sizes[][2] = { { 4000, 3000 }, { 6000, 4000 } };
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+  {
+    unsigned int width = sizes[s][0], height = sizes[s][1];
+    std::vector<uint32_t> src(width * height), dest(width * height);
+    FillPixels(src);
+
+    int64_t start = CurrentHostCounter();
+    ReferenceTranspose(&src[0], width, height, &dest[0], true, false);
+    double reference = ElapsedMs(start);
+
+    start = CurrentHostCounter();
+    PictureTransforms::Transpose(&src[0], width, height, &dest[0], true, false);
+    double blocked = ElapsedMs(start);
+
+    std::cout << "Rotate " << width << "x" << height << ": per pixel " << reference
+              << " ms, blocked " << blocked << " ms" << std::endl;
+  }
+}
+
+TEST(TestPictureTransforms, ScalerReuse)
+{
+  static const unsigned int in_width = 4000, in_height = 3000;
+  static const unsigned int out_width = 1920, out_height = 1440;
+  std::vector<uint32_t> src(in_width * in_height), dest(out_width * out_height);
+  FillPixels(src);
+
+  CPictureScaler::Clear();
+  int64_t start = CurrentHostCounter();
+  EXPECT_TRUE(CPictureScaler::Scale((uint8_t *)&src[0], in_width, in_height, in_width * 4,
+                                    (uint8_t *)&dest[0], out_width, out_height, out_width * 4));
+  double cold = ElapsedMs(start);
+
+  start = CurrentHostCounter();
+  EXPECT_TRUE(CPictureScaler::Scale((uint8_t *)&src[0], in_width, in_height, in_width * 4,
+                                    (uint8_t *)&dest[0], out_width, out_height, out_width * 4));
+  double warm = ElapsedMs(start);
+  CPictureScaler::Clear();
+
+  std::cout << "Scale " << in_width << "x" << in_height << " -> " << out_width << "x" << out_height
+            << ": new context " << cold << " ms, pooled context " << warm << " ms" << std::endl;
+}
@@ -714,9 +714,79 @@ std::string CSmartPlaylistRule::FormatLinkQuery(const char *field, const char *t
                              field, table, table, table, field, table, field, mediaField.c_str(), table, parameter.c_str(), field, mediaType.c_str());
 }
 
+std::string CSmartPlaylistRule::FormatLinkSearchQuery(const char *field, const char *table, const MediaType& mediaType, const std::string& mediaField, const std::string& search, const CDatabase &db)
+{
+  std::string linkId = StringUtils::Format("%s_link.%s_id", field, table);
+  return StringUtils::Format(" EXISTS (SELECT 1 FROM %s_link"
+                             "         WHERE %s_link.media_id=%s AND %s_link.media_type = '%s' AND %s)",
+                             field, field, mediaField.c_str(), field, mediaType.c_str(),
+                             db.GetSearchClause(linkId, table, "name", search).c_str());
+}
+
+std::string CSmartPlaylistRule::FormatSearchQuery(const std::string &negate, const std::string &param,
+                                                  const CDatabase &db, const std::string &strType) const
+{
+  std::string id = GetField(FieldId, strType);
+  std::string query;
+  if (strType == "songs")
+  {
+    if (m_field == FieldTitle)
+      query = db.GetSearchClause(id, MediaTypeSong, "name", param);
+    else if (m_field == FieldAlbum)
+      query = db.GetSearchClause("songview.idAlbum", MediaTypeAlbum, "name", param);
+    else if (m_field == FieldArtist)
+      return negate + " EXISTS (SELECT 1 FROM song_artist WHERE song_artist.idSong = " + id + " AND " + db.GetSearchClause("song_artist.idArtist", MediaTypeArtist, "name", param) + ")";
+    else if (m_field == FieldAlbumArtist)
+      return negate + " EXISTS (SELECT 1 FROM album_artist WHERE album_artist.idAlbum = songview.idAlbum AND " + db.GetSearchClause("album_artist.idArtist", MediaTypeArtist, "name", param) + ")";
+  }
+  else if (strType == "albums")
+  {
+    if (m_field == FieldAlbum)
+      query = db.GetSearchClause(id, MediaTypeAlbum, "name", param);
+    else if (m_field == FieldAlbumArtist)
+      return negate + " EXISTS (SELECT 1 FROM album_artist WHERE album_artist.idAlbum = " + id + " AND " + db.GetSearchClause("album_artist.idArtist", MediaTypeArtist, "name", param) + ")";
+  }
+  else if (strType == "artists")
+  {
+    if (m_field == FieldArtist)
+      query = db.GetSearchClause(id, MediaTypeArtist, "name", param);
+  }
+  else if (strType == "movies" || strType == "tvshows" || strType == "episodes" || strType == "musicvideos")
+  {
+    MediaType mediaType = MediaTypes::FromString(strType);
+    if (m_field == FieldTitle)
+      query = db.GetSearchClause(id, mediaType, "name", param);
+    else if (m_field == FieldPlot)
+      query = db.GetSearchClause(id, mediaType, VIDEODB_SEARCH_PLOT, param);
+    else if (m_field == FieldActor && mediaType != MediaTypeMusicVideo)
+      return negate + FormatLinkSearchQuery("actor", "actor", mediaType, id, param, db);
+    else if ((m_field == FieldArtist || m_field == FieldAlbumArtist) && mediaType == MediaTypeMusicVideo)
+      return negate + FormatLinkSearchQuery("actor", "actor", mediaType, id, param, db);
+    else if (m_field == FieldDirector)
+      return negate + FormatLinkSearchQuery("director", "actor", mediaType, id, param, db);
+    else if (m_field == FieldWriter && (mediaType == MediaTypeMovie || mediaType == MediaTypeEpisode))
+      return negate + FormatLinkSearchQuery("writer", "actor", mediaType, id, param, db);
+    else if (m_field == FieldTag && mediaType != MediaTypeEpisode)
+      return negate + FormatLinkSearchQuery("tag", "tag", mediaType, id, param, db);
+  }
+
+  if (query.empty())
+    return query;
+  return negate + " (" + query + ")";
+}
+
 std::string CSmartPlaylistRule::FormatWhereClause(const std::string &negate, const std::string &oper, const std::string &param,
                                                  const CDatabase &db, const std::string &strType) const
 {
+  // words in titles, names and plots are looked up in the search index.
+  // it matches word starts, "contains" keeps matching any substring with LIKE.
+  if (m_operator == OPERATOR_CONTAINS_WORDS || m_operator == OPERATOR_DOES_NOT_CONTAIN_WORDS)
+  {
+    std::string query = FormatSearchQuery(negate, param, db, strType);
+    if (!query.empty())
+      return query;
+  }
+
   std::string parameter = FormatParameter(oper, param, db, strType);
 
   std::string query;
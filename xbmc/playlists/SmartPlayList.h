@@ -77,6 +77,8 @@ protected:
 private:
   std::string GetVideoResolutionQuery(const std::string &parameter) const;
   static std::string FormatLinkQuery(const char *field, const char *table, const MediaType& mediaType, const std::string& mediaField, const std::string& parameter);
+  static std::string FormatLinkSearchQuery(const char *field, const char *table, const MediaType& mediaType, const std::string& mediaField, const std::string& search, const CDatabase &db);
+  std::string FormatSearchQuery(const std::string &negate, const std::string &param, const CDatabase &db, const std::string &strType) const;
 };
 
 class CSmartPlaylistRuleCombination : public CDatabaseQueryRuleCombination
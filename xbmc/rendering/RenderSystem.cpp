@@ -32,6 +32,7 @@ CRenderSystemBase::CRenderSystemBase()
   m_renderCaps = 0;
   m_renderQuirks = 0;
   m_minDXTPitch = 0;
+  m_headless = false;
 }
 
 CRenderSystemBase::~CRenderSystemBase()
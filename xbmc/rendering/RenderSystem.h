@@ -85,6 +85,18 @@ enum RENDER_STEREO_MODE
 };
 
 
+/*! \brief What the GUI render pass handed to the render system */
+struct RenderStats
+{
+  RenderStats() : drawCalls(0), vertices(0), batchedQuads(0), textureUploads(0), textureBytes(0) {}
+
+  unsigned int drawCalls;      ///< draw calls issued
+  unsigned int vertices;       ///< vertices submitted by those draw calls
+  unsigned int batchedQuads;   ///< quads that went through the GUI batcher
+  unsigned int textureUploads; ///< textures uploaded to the GPU
+  uint64_t     textureBytes;   ///< bytes of texture data uploaded
+};
+
 class CRenderSystemBase
 {
 public:
@@ -148,6 +160,27 @@ public:
   unsigned int GetMinDXTPitch() const { return m_minDXTPitch; }
   unsigned int GetRenderQuirks() const { return m_renderQuirks; }
 
+  /*! \brief Run without a GPU or window.
+   In headless mode the render system is never created and the GUI render paths only
+   record what they would have drawn, so GUI performance can be measured on machines
+   without a GPU. Only supported by the OpenGL render system.
+   */
+  void SetHeadless(bool headless) { m_headless = headless; }
+  bool IsHeadless() const { return m_headless; }
+
+  void AddDrawCall(unsigned int vertices = 0) { m_renderStats.drawCalls++; m_renderStats.vertices += vertices; }
+  void AddVertices(unsigned int vertices) { m_renderStats.vertices += vertices; }
+  void AddBatchedQuads(unsigned int quads) { m_renderStats.batchedQuads += quads; }
+  void AddTextureUpload(unsigned int bytes) { m_renderStats.textureUploads++; m_renderStats.textureBytes += bytes; }
+
+  /*! \brief Close the statistics of the current frame.
+   \sa GetFrameStats
+   */
+  void EndFrameStats() { m_frameStats = m_renderStats; m_renderStats = RenderStats(); }
+
+  /*! \brief Statistics of the last completed frame */
+  const RenderStats& GetFrameStats() const { return m_frameStats; }
+
 protected:
   bool                m_bRenderCreated;
   RenderingSystemType m_enumRenderingSystem;
@@ -164,6 +197,10 @@ protected:
   unsigned int m_renderQuirks;
   RENDER_STEREO_VIEW m_stereoView;
   RENDER_STEREO_MODE m_stereoMode;
+
+  bool         m_headless;
+  RenderStats  m_renderStats;
+  RenderStats  m_frameStats;
 };
 
 #endif // RENDER_SYSTEM_H
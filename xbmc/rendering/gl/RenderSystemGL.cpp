@@ -654,6 +654,9 @@ void CRenderSystemGL::SetStereoMode(RENDER_STEREO_MODE mode, RENDER_STEREO_VIEW
 {
   CRenderSystemBase::SetStereoMode(mode, view);
 
+  if (!m_bRenderCreated)
+    return;
+
   glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
   glDisable(GL_POLYGON_STIPPLE);
   glDrawBuffer(GL_BACK);
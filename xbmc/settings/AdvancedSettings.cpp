@@ -114,6 +114,8 @@ void CAdvancedSettings::Initialize()
   //default hold time of 25 ms, this allows a 20 hertz sine to pass undistorted
   m_limiterHold = 0.025f;
   m_limiterRelease = 0.1f;
+  m_audioDecodeAhead = 10;
+  m_audioDecodeAheadMemory = 32;
 
   m_omxHWAudioDecode = false;
   m_omxDecodeStartWithValidFrame = false;
@@ -334,6 +336,7 @@ void CAdvancedSettings::Initialize()
   m_curlconnecttimeout = 10;
   m_curllowspeedtime = 20;
   m_curlretries = 2;
+  m_curlsegments = 1;             //Range requests at a time when caching http
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
 
@@ -385,6 +388,8 @@ void CAdvancedSettings::Initialize()
   m_readBufferFactor = 1.0f;
   m_addonPackageFolderSize = 200;
 
+  m_pythonInterpreterPool = 0;
+
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
 
@@ -394,6 +399,8 @@ void CAdvancedSettings::Initialize()
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
   m_guiDirtyRegionNoFlipTimeout = 0;
+  m_guiBatchRendering = true;
+  m_guiSkipUnchangedControls = true;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
 
@@ -518,6 +525,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
 
     XMLUtils::GetFloat(pElement, "limiterhold", m_limiterHold, 0.0f, 100.0f);
     XMLUtils::GetFloat(pElement, "limiterrelease", m_limiterRelease, 0.001f, 100.0f);
+
+    XMLUtils::GetInt(pElement, "decodeahead", m_audioDecodeAhead, 0, 60);
+    XMLUtils::GetInt(pElement, "decodeaheadmemory", m_audioDecodeAheadMemory, 1, 512);
   }
 
   pElement = pRootElement->FirstChildElement("omx");
@@ -821,12 +831,19 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curlclienttimeout", m_curlconnecttimeout, 1, 1000);
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
+    XMLUtils::GetInt(pElement, "curlsegments", m_curlsegments, 1, 16);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_networkBufferMode, 0, 3);
     XMLUtils::GetFloat(pElement, "readbufferfactor", m_readBufferFactor);
   }
 
+  pElement = pRootElement->FirstChildElement("python");
+  if (pElement)
+  {
+    XMLUtils::GetInt(pElement, "interpreterpool", m_pythonInterpreterPool, 0, 32);
+  }
+
   pElement = pRootElement->FirstChildElement("jsonrpc");
   if (pElement)
   {
@@ -1198,6 +1215,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetInt(pElement, "nofliptimeout",             m_guiDirtyRegionNoFlipTimeout);
+    XMLUtils::GetBoolean(pElement, "batchrendering",        m_guiBatchRendering);
+    XMLUtils::GetBoolean(pElement, "skipunchangedcontrols", m_guiSkipUnchangedControls);
   }
 
   // load in the settings overrides
@@ -143,6 +143,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_dvdplayerIgnoreDTSinWAV;
     float m_limiterHold;
     float m_limiterRelease;
+    int m_audioDecodeAhead;        ///< seconds of the next track to decode before the transition
+    int m_audioDecodeAheadMemory;  ///< cap in MB for the pcm buffers of all queued tracks
 
     bool  m_omxHWAudioDecode;
     bool  m_omxDecodeStartWithValidFrame;
@@ -325,6 +327,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curlconnecttimeout;
     int m_curllowspeedtime;
     int m_curlretries;
+    int m_curlsegments;
     bool m_curlDisableIPV6;
 
     bool m_fullScreen;
@@ -377,12 +380,16 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     int  m_guiDirtyRegionNoFlipTimeout;
+    bool m_guiBatchRendering;
+    bool m_guiSkipUnchangedControls;
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemBufferSize;
     unsigned int m_networkBufferMode;
     float m_readBufferFactor;
 
+    int m_pythonInterpreterPool; ///< number of warm plugin interpreters to keep, 0 disables the pool
+
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
 
@@ -148,6 +148,25 @@ long long cas2(volatile long long* pAddr, long long expectedVal, long long swapV
 #endif
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Pointer-width atomic compare-and-swap
+// Returns previous value of *pAddr
+///////////////////////////////////////////////////////////////////////////
+void* casptr(void* volatile* pAddr, void* expectedVal, void* swapVal)
+{
+#if defined(HAS_BUILTIN_SYNC_VAL_COMPARE_AND_SWAP)
+  return(__sync_val_compare_and_swap(pAddr, expectedVal, swapVal));
+
+#elif defined(TARGET_WINDOWS)
+  // a long is 32 bit on Win64
+  return InterlockedCompareExchangePointer(pAddr, swapVal, expectedVal);
+
+#else // a pointer fits into a long on all other platforms
+  return (void*)cas((volatile long*)pAddr, (long)expectedVal, (long)swapVal);
+
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // 32-bit atomic increment
 // Returns new value of *pAddr
@@ -26,6 +26,7 @@ long cas(volatile long *pAddr, long expectedVal, long swapVal);
 #if !defined(__ppc__) && !defined(__powerpc__) && !defined(__arm__)
 long long cas2(volatile long long* pAddr, long long expectedVal, long long swapVal);
 #endif
+void* casptr(void* volatile* pAddr, void* expectedVal, void* swapVal);
 long AtomicIncrement(volatile long* pAddr);
 long AtomicDecrement(volatile long* pAddr);
 long AtomicAdd(volatile long* pAddr, long amount);
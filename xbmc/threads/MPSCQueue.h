@@ -0,0 +1,226 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "threads/Atomics.h"
+#include "threads/SystemClock.h"
+
+#include <stddef.h>
+
+namespace XbmcThreads
+{
+  /**
+   * A multiple producer, single consumer FIFO.
+   *
+   * Push() may be called from any thread and never blocks. Pop() must only be
+   * called by one thread at a time, usually the one owning the queue.
+   *
+   * Values live in nodes which come from a small pool, so a steady stream of
+   * messages does not hit the heap. Popped nodes belong to the caller until
+   * they are handed back with Free(), which allows processing them while the
+   * queue is used again, e.g. by a nested message loop. Values in returned
+   * nodes are not reset, so resources they hold stay alive until the node is
+   * reused.
+   *
+   * This is the intrusive queue by Dmitry Vyukov. It only needs an atomic
+   * exchange, done with casptr() which is a full barrier on all platforms.
+   */
+  template<class T> class CMPSCQueue
+  {
+  public:
+    class Node
+    {
+    public:
+      T value;
+    private:
+      friend class CMPSCQueue;
+      Node() : m_next(NULL), m_queued(0) {}
+      Node* volatile m_next;
+      unsigned int m_queued;
+    };
+
+    struct Stats
+    {
+      long depth;                 // values currently queued
+      long maxDepth;              // highest depth seen when popping
+      unsigned int processed;     // values popped
+      unsigned int totalLatency;  // ms the popped values spent in the queue
+      unsigned int maxLatency;    // longest ms a single value spent in the queue
+    };
+
+    CMPSCQueue(unsigned int poolSize = 64) : m_head(&m_stub), m_tail(&m_stub),
+      m_free(NULL), m_freeCount(0), m_poolSize(poolSize), m_poolLock(0), m_pushed(0)
+    {
+      m_stats.depth = 0;
+      m_stats.maxDepth = 0;
+      m_stats.processed = 0;
+      m_stats.totalLatency = 0;
+      m_stats.maxLatency = 0;
+    }
+
+    ~CMPSCQueue()
+    {
+      Node* node;
+      while ((node = Pop()))
+        delete node;
+      while (m_free)
+      {
+        node = m_free;
+        m_free = node->m_next;
+        delete node;
+      }
+    }
+
+    /**
+     * Get an empty node to fill and Push(). Can be called from any thread.
+     */
+    Node* Alloc()
+    {
+      {
+        CAtomicSpinLock lock(m_poolLock);
+        if (m_free)
+        {
+          Node* node = m_free;
+          m_free = node->m_next;
+          m_freeCount--;
+          return node;
+        }
+      }
+      return new Node();
+    }
+
+    /**
+     * Hand back a node that was popped or never pushed. Can be called from any thread.
+     */
+    void Free(Node* node)
+    {
+      {
+        CAtomicSpinLock lock(m_poolLock);
+        if (m_freeCount < m_poolSize)
+        {
+          node->m_next = m_free;
+          m_free = node;
+          m_freeCount++;
+          return;
+        }
+      }
+      delete node;
+    }
+
+    /**
+     * Append a node to the queue. Can be called from any thread.
+     */
+    void Push(Node* node)
+    {
+      node->m_next = NULL;
+      node->m_queued = SystemClockMillis();
+      AtomicIncrement(&m_pushed);
+      Link(node);
+    }
+
+    /**
+     * Take the oldest node off the queue, or NULL if there is none. Only one
+     * thread may pop at a time. A node whose producer is still in the middle
+     * of pushing it may not be returned yet, the next call will.
+     */
+    Node* Pop()
+    {
+      Node* tail = m_tail;
+      Node* next = tail->m_next;
+      if (tail == &m_stub)
+      {
+        if (!next)
+          return NULL;
+        m_tail = next;
+        tail = next;
+        next = next->m_next;
+      }
+
+      if (!next)
+      {
+        // tail is the last node, put the stub behind it so it can be taken
+        if (tail != m_head)
+          return NULL;
+        m_stub.m_next = NULL;
+        Link(&m_stub);
+        next = tail->m_next;
+        if (!next)
+          return NULL;
+      }
+
+      m_tail = next;
+      UpdateStats(tail);
+      return tail;
+    }
+
+    /**
+     * Statistics about queue depth and latency. Values may be slightly off
+     * while other threads push.
+     */
+    Stats GetStats() const
+    {
+      Stats stats = m_stats;
+      stats.depth = (long)((unsigned int)m_pushed - stats.processed);
+      return stats;
+    }
+
+  private:
+    CMPSCQueue(const CMPSCQueue&);
+    CMPSCQueue& operator=(const CMPSCQueue&);
+
+    void Link(Node* node)
+    {
+      Node* prev;
+      do
+      {
+        prev = m_head;
+      } while (casptr((void* volatile*)&m_head, prev, node) != prev);
+      // the node is complete, as casptr() is a barrier, and can be made visible
+      prev->m_next = node;
+    }
+
+    void UpdateStats(const Node* node)
+    {
+      // only the consumer counts popped values, which saves an atomic operation
+      long depth = (long)((unsigned int)m_pushed - m_stats.processed);
+      if (depth > m_stats.maxDepth)
+        m_stats.maxDepth = depth;
+
+      unsigned int latency = SystemClockMillis() - node->m_queued;
+      m_stats.processed++;
+      m_stats.totalLatency += latency;
+      if (latency > m_stats.maxLatency)
+        m_stats.maxLatency = latency;
+    }
+
+    Node* volatile m_head;
+    Node* m_tail;
+    Node m_stub;
+
+    Node* m_free;
+    unsigned int m_freeCount;
+    unsigned int m_poolSize;
+    long m_poolLock;
+
+    volatile long m_pushed;
+    Stats m_stats;
+  };
+}
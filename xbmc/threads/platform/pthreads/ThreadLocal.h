@@ -27,12 +27,15 @@ namespace XbmcThreads
   /**
    * A thin wrapper around pthreads thread specific storage
    * functionality.
+   *
+   * onExit, when given, is called with the value of a thread that
+   * exits while its value is set.
    */
   template <typename T> class ThreadLocal
   {
     pthread_key_t key;
   public:
-    inline ThreadLocal() : key(0) { pthread_key_create(&key,NULL); }
+    inline explicit ThreadLocal(void (*onExit)(void*) = NULL) : key(0) { pthread_key_create(&key,onExit); }
 
     inline ~ThreadLocal() { pthread_key_delete(key); }
 
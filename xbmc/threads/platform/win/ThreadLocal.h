@@ -28,19 +28,41 @@ namespace XbmcThreads
   /**
    * A thin wrapper around windows thread specific storage
    * functionality.
+   *
+   * onExit, when given, is called with the value of a thread that
+   * exits while its value is set. TLS has no callbacks, the fiber
+   * local storage slot holding this object calls it.
    */
   template <typename T> class ThreadLocal
   {
     DWORD key;
+    DWORD exitKey;
+    void (*onExit)(void*);
+
+    static void WINAPI ThreadExit(PVOID local)
+    {
+       // runs on the exiting thread, its TLS is still there
+       ThreadLocal* self = (ThreadLocal*)local;
+       T* val = self ? self->get() : NULL;
+       if (val && self->onExit)
+          self->onExit(val);
+    }
+
   public:
-    inline ThreadLocal()
+    inline explicit ThreadLocal(void (*exitFunc)(void*) = NULL) : exitKey(FLS_OUT_OF_INDEXES), onExit(exitFunc)
     {
        if ((key = TlsAlloc()) == TLS_OUT_OF_INDEXES)
           throw XbmcCommons::UncheckedException("Ran out of Windows TLS Indexes. Windows Error Code %d",(int)GetLastError());
+       if (onExit && (exitKey = FlsAlloc(ThreadExit)) == FLS_OUT_OF_INDEXES)
+          throw XbmcCommons::UncheckedException("Ran out of Windows FLS Indexes. Windows Error Code %d",(int)GetLastError());
     }
 
     inline ~ThreadLocal() 
     {
+       // FlsFree calls back for every thread, those threads are still running
+       onExit = NULL;
+       if (exitKey != FLS_OUT_OF_INDEXES)
+          FlsFree(exitKey);
        if (!TlsFree(key))
           throw XbmcCommons::UncheckedException("Failed to free Tls %d, Windows Error Code %d",(int)key, (int)GetLastError());
     }
@@ -49,6 +71,8 @@ namespace XbmcThreads
     {
        if (!TlsSetValue(key,(LPVOID)val))
           throw XbmcCommons::UncheckedException("Failed to set Tls %d, Windows Error Code %d",(int)key, (int)GetLastError());
+       if (exitKey != FLS_OUT_OF_INDEXES)
+          FlsSetValue(exitKey,val ? (PVOID)this : NULL);
     }
 
     inline T* get() { return (T*)TlsGetValue(key); }
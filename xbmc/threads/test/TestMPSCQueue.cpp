@@ -0,0 +1,237 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TestHelpers.h"
+#include "threads/MPSCQueue.h"
+#include "threads/SingleLock.h"
+#include "utils/TimeUtils.h"
+
+#include <iostream>
+#include <queue>
+#include <vector>
+
+#define TESTNUM 100000l
+#define NUMTHREADS 4l
+
+typedef XbmcThreads::CMPSCQueue<long> Queue;
+
+class DoPush : public IRunnable
+{
+  Queue& queue;
+  long id;
+public:
+  inline DoPush(Queue& q, long i) : queue(q), id(i) {}
+
+  virtual void Run()
+  {
+    for (long i = 0; i < TESTNUM; i++)
+    {
+      Queue::Node* node = queue.Alloc();
+      node->value = id * TESTNUM + i;
+      queue.Push(node);
+    }
+  }
+};
+
+// what the message queues used before
+class LockedQueue
+{
+public:
+  void Push(long value)
+  {
+    CSingleLock lock(m_section);
+    m_queue.push(new long(value));
+  }
+  bool Pop(long& value)
+  {
+    CSingleLock lock(m_section);
+    if (m_queue.empty())
+      return false;
+    long* item = m_queue.front();
+    m_queue.pop();
+    lock.Leave();
+    value = *item;
+    delete item;
+    return true;
+  }
+private:
+  CCriticalSection m_section;
+  std::queue<long*> m_queue;
+};
+
+class DoLockedPush : public IRunnable
+{
+  LockedQueue& queue;
+public:
+  inline DoLockedPush(LockedQueue& q) : queue(q) {}
+
+  virtual void Run()
+  {
+    for (long i = 0; i < TESTNUM; i++)
+      queue.Push(i);
+  }
+};
+
+TEST(TestMPSCQueue, Order)
+{
+  Queue queue;
+  EXPECT_TRUE(queue.Pop() == NULL);
+
+  for (long i = 0; i < 10; i++)
+  {
+    Queue::Node* node = queue.Alloc();
+    node->value = i;
+    queue.Push(node);
+  }
+  EXPECT_EQ(10, queue.GetStats().depth);
+
+  for (long i = 0; i < 10; i++)
+  {
+    Queue::Node* node = queue.Pop();
+    ASSERT_TRUE(node != NULL);
+    EXPECT_EQ(i, node->value);
+    queue.Free(node);
+  }
+  EXPECT_TRUE(queue.Pop() == NULL);
+
+  Queue::Stats stats = queue.GetStats();
+  EXPECT_EQ(0, stats.depth);
+  EXPECT_EQ(10, stats.maxDepth);
+  EXPECT_EQ(10u, stats.processed);
+}
+
+TEST(TestMPSCQueue, Pool)
+{
+  Queue queue(1);
+  Queue::Node* first = queue.Alloc();
+  Queue::Node* second = queue.Alloc();
+  EXPECT_TRUE(first != second);
+
+  // only one node is kept, the other one is deleted
+  queue.Free(first);
+  queue.Free(second);
+  EXPECT_EQ(first, queue.Alloc());
+
+  // a popped node can be handed back and is used again
+  first->value = 1;
+  queue.Push(first);
+  Queue::Node* node = queue.Pop();
+  EXPECT_EQ(first, node);
+  queue.Free(node);
+  EXPECT_EQ(first, queue.Alloc());
+  queue.Free(first);
+}
+
+TEST(TestMPSCQueue, MultipleProducers)
+{
+  Queue queue;
+  std::vector<DoPush*> producers;
+  std::vector<thread> threads;
+  for (long i = 0; i < NUMTHREADS; i++)
+  {
+    producers.push_back(new DoPush(queue, i));
+    threads.push_back(thread(*producers.back()));
+  }
+
+  // every producer's values must arrive complete and in order
+  std::vector<long> next(NUMTHREADS, 0);
+  long received = 0;
+  while (received < NUMTHREADS * TESTNUM)
+  {
+    Queue::Node* node = queue.Pop();
+    if (!node)
+      continue;
+    long id = node->value / TESTNUM;
+    ASSERT_TRUE(id >= 0 && id < NUMTHREADS);
+    EXPECT_EQ(next[id], node->value % TESTNUM);
+    next[id] = node->value % TESTNUM + 1;
+    queue.Free(node);
+    received++;
+  }
+
+  for (long i = 0; i < NUMTHREADS; i++)
+  {
+    EXPECT_TRUE(threads[i].timed_join(MILLIS(10000)));
+    EXPECT_EQ(TESTNUM, next[i]);
+    delete producers[i];
+  }
+  EXPECT_TRUE(queue.Pop() == NULL);
+  EXPECT_EQ(0, queue.GetStats().depth);
+}
+
+// times producers and a consumer against the locked queue, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestMPSCQueue.*
+TEST(TestMPSCQueue, DISABLED_Benchmark)
+{
+  int64_t start = CurrentHostCounter();
+  {
+    Queue queue;
+    std::vector<DoPush*> producers;
+    std::vector<thread> threads;
+    for (long i = 0; i < NUMTHREADS; i++)
+    {
+      producers.push_back(new DoPush(queue, i));
+      threads.push_back(thread(*producers.back()));
+    }
+    for (long received = 0; received < NUMTHREADS * TESTNUM;)
+    {
+      Queue::Node* node = queue.Pop();
+      if (!node)
+        continue;
+      queue.Free(node);
+      received++;
+    }
+    for (long i = 0; i < NUMTHREADS; i++)
+    {
+      threads[i].join();
+      delete producers[i];
+    }
+  }
+  int64_t lockfree = CurrentHostCounter() - start;
+
+  start = CurrentHostCounter();
+  {
+    LockedQueue queue;
+    std::vector<DoLockedPush*> producers;
+    std::vector<thread> threads;
+    for (long i = 0; i < NUMTHREADS; i++)
+    {
+      producers.push_back(new DoLockedPush(queue));
+      threads.push_back(thread(*producers.back()));
+    }
+    long value;
+    for (long received = 0; received < NUMTHREADS * TESTNUM;)
+    {
+      if (queue.Pop(value))
+        received++;
+    }
+    for (long i = 0; i < NUMTHREADS; i++)
+    {
+      threads[i].join();
+      delete producers[i];
+    }
+  }
+  int64_t locked = CurrentHostCounter() - start;
+
+  double frequency = (double)CurrentHostFrequency();
+  std::cout << NUMTHREADS << " producers, " << NUMTHREADS * TESTNUM << " messages: locked queue "
+            << locked * 1000.0 / frequency << " ms, lock free queue "
+            << lockfree * 1000.0 / frequency << " ms" << std::endl;
+}
@@ -166,3 +166,34 @@ TEST(TestThreadLocal, HeapDestroyed)
   cleanup();
 }
 
+
+CEvent exited;
+static void deleteThinggy(void* val)
+{
+  delete (Thinggy*)val;
+  exited.Set();
+}
+
+ThreadLocal<Thinggy> exitThreadLocal(deleteThinggy);
+
+class ExitThreadLocal : public IRunnable
+{
+public:
+  inline void Run() { exitThreadLocal.set(new Thinggy); }
+};
+
+TEST(TestThreadLocal, OnExit)
+{
+  exited.Reset();
+  {
+    ExitThreadLocal runnable;
+    thread t(runnable);
+    t.join();
+  }
+
+  // the value is handed back once the thread is gone
+  EXPECT_TRUE(exited.WaitMSec(10000));
+  EXPECT_TRUE(destructorCalled);
+  EXPECT_TRUE(exitThreadLocal.get() == NULL);
+  cleanup();
+}
@@ -19,6 +19,9 @@
  */
 
 #include "ActorProtocol.h"
+#include "threads/SystemClock.h"
+
+#include <algorithm>
 
 using namespace Actor;
 
@@ -33,17 +36,28 @@ void Message::Release()
   if (skip)
     return;
 
-  // free data buffer
-  if (data != buffer)
-    delete [] data;
-
-  // delete event in case of sync message
-  if (event)
-    delete event;
-
+  // the payload buffer and the event stay with the message for reuse
   origin->ReturnMessage(this);
 }
 
+void Message::SetPayload(void *payload, int size)
+{
+  if (size > MSG_INTERNAL_BUFFER_SIZE)
+  {
+    if (size > heapSize)
+    {
+      delete [] heapData;
+      heapData = new uint8_t[size];
+      heapSize = size;
+    }
+    data = heapData;
+  }
+  else
+    data = buffer;
+  memcpy(data, payload, size);
+  payloadSize = size;
+}
+
 bool Message::Reply(int sig, void *data /* = NULL*/, int size /* = 0 */)
 {
   if (!isSync)
@@ -63,13 +77,7 @@ bool Message::Reply(int sig, void *data /* = NULL*/, int size /* = 0 */)
     msg->isOut = !isOut;
     replyMessage = msg;
     if (data)
-    {
-      if (size > MSG_INTERNAL_BUFFER_SIZE)
-        msg->data = new uint8_t[size];
-      else
-        msg->data = msg->buffer;
-      memcpy(msg->data, data, size);
-    }
+      msg->SetPayload(data, size);
   }
 
   origin->Unlock();
@@ -82,29 +90,62 @@ bool Message::Reply(int sig, void *data /* = NULL*/, int size /* = 0 */)
 
 Protocol::~Protocol()
 {
+  // drop what is queued, even if the receiving side is deferred
   Message *msg;
-  Purge();
-  while (!freeMessageQueue.empty())
+  while (Receive(inMessages, &msg))
+    msg->Release();
+  while (Receive(outMessages, &msg))
+    msg->Release();
+
+  // messages still held by a receiver or by a sender waiting for a sync reply
+  // live in the slabs, wait until they are returned
+  closing = true;
+  XbmcThreads::EndTime timeout(MSG_RETURN_TIMEOUT);
+  while (inUse > 0)
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
-    delete msg;
+    if (timeout.IsTimePast())
+    {
+      CLog::Log(LOGERROR, "Protocol::~Protocol - port %s: %ld messages were not returned, keeping their memory",
+                portName.c_str(), inUse);
+      return;
+    }
+    returnedEvent.WaitMSec(std::min(timeout.MillisLeft(), (unsigned int)10));
   }
+
+  // the thread that returned the last message may still be in ReturnMessage
+  { CAtomicSpinLock lock(freeLock); }
+
+  for (std::vector<Message*>::iterator it = slabs.begin(); it != slabs.end(); ++it)
+    delete [] *it;
 }
 
 Message *Protocol::GetMessage()
 {
-  Message *msg;
+  Message *msg = NULL;
 
-  CSingleLock lock(criticalSection);
+  {
+    CAtomicSpinLock lock(freeLock);
+    if (freeMessages)
+    {
+      msg = freeMessages;
+      freeMessages = msg->nextFree;
+    }
+  }
 
-  if (!freeMessageQueue.empty())
+  if (!msg)
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
+    // all messages are in use, add another slab of them
+    Message *slab = new Message[MSG_SLAB_SIZE];
+    for (int i = 1; i < MSG_SLAB_SIZE - 1; i++)
+      slab[i].nextFree = &slab[i + 1];
+
+    CAtomicSpinLock lock(freeLock);
+    slab[MSG_SLAB_SIZE - 1].nextFree = freeMessages;
+    freeMessages = &slab[1];
+    slabs.push_back(slab);
+    msg = &slab[0];
   }
-  else
-    msg = new Message();
+  AtomicIncrement(&inUse);
 
   msg->isSync = false;
   msg->isSyncFini = false;
@@ -120,9 +161,39 @@ Message *Protocol::GetMessage()
 
 void Protocol::ReturnMessage(Message *msg)
 {
-  CSingleLock lock(criticalSection);
+  CAtomicSpinLock lock(freeLock);
 
-  freeMessageQueue.push(msg);
+  msg->nextFree = freeMessages;
+  freeMessages = msg;
+  if (AtomicDecrement(&inUse) == 0 && closing)
+    returnedEvent.Set();
+}
+
+void Protocol::Send(Direction &direction, Message *msg)
+{
+  MessageQueue::Node *node = direction.queue.Alloc();
+  node->value = msg;
+  direction.queue.Push(node);
+}
+
+bool Protocol::Receive(Direction &direction, Message **msg)
+{
+  CSingleLock lock(direction.section);
+
+  if (!direction.pending.empty())
+  {
+    *msg = direction.pending.front();
+    direction.pending.pop_front();
+    return true;
+  }
+
+  MessageQueue::Node *node = direction.queue.Pop();
+  if (!node)
+    return false;
+
+  *msg = node->value;
+  direction.queue.Free(node);
+  return true;
 }
 
 bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, int size /* = 0 */, Message *outMsg /* = NULL */)
@@ -137,17 +208,9 @@ bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, int size /* =
   msg->isOut = true;
 
   if (data)
-  {
-    if (size > MSG_INTERNAL_BUFFER_SIZE)
-      msg->data = new uint8_t[size];
-    else
-      msg->data = msg->buffer;
-    memcpy(msg->data, data, size);
-  }
+    msg->SetPayload(data, size);
 
-  { CSingleLock lock(criticalSection);
-    outMessages.push(msg);
-  }
+  Send(outMessages, msg);
   containerOutEvent->Set();
 
   return true;
@@ -165,17 +228,9 @@ bool Protocol::SendInMessage(int signal, void *data /* = NULL */, int size /* =
   msg->isOut = false;
 
   if (data)
-  {
-    if (size > MSG_INTERNAL_BUFFER_SIZE)
-      msg->data = new uint8_t[size];
-    else
-      msg->data = msg->buffer;
-    memcpy(msg->data, data, size);
-  }
+    msg->SetPayload(data, size);
 
-  { CSingleLock lock(criticalSection);
-    inMessages.push(msg);
-  }
+  Send(inMessages, msg);
   containerInEvent->Set();
 
   return true;
@@ -187,7 +242,7 @@ bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, voi
   Message *msg = GetMessage();
   msg->isOut = true;
   msg->isSync = true;
-  msg->event = new CEvent;
+  msg->event = &msg->syncEvent;
   msg->event->Reset();
   SendOutMessage(signal, data, size, msg);
 
@@ -216,28 +271,18 @@ bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, voi
 
 bool Protocol::ReceiveOutMessage(Message **msg)
 {
-  CSingleLock lock(criticalSection);
-
-  if (outMessages.empty() || outDefered)
+  if (outDefered)
     return false;
 
-  *msg = outMessages.front();
-  outMessages.pop();
-
-  return true;
+  return Receive(outMessages, msg);
 }
 
 bool Protocol::ReceiveInMessage(Message **msg)
 {
-  CSingleLock lock(criticalSection);
-
-  if (inMessages.empty() || inDefered)
+  if (inDefered)
     return false;
 
-  *msg = inMessages.front();
-  inMessages.pop();
-
-  return true;
+  return Receive(inMessages, msg);
 }
 
 
@@ -254,44 +299,34 @@ void Protocol::Purge()
 
 void Protocol::PurgeIn(int signal)
 {
-  Message *msg;
-  std::queue<Message*> msgs;
-
-  CSingleLock lock(criticalSection);
-
-  while (!inMessages.empty())
-  {
-    msg = inMessages.front();
-    inMessages.pop();
-    if (msg->signal != signal)
-      msgs.push(msg);
-  }
-  while (!msgs.empty())
-  {
-    msg = msgs.front();
-    msgs.pop();
-    inMessages.push(msg);
-  }
+  PurgeSignal(inMessages, signal);
 }
 
 void Protocol::PurgeOut(int signal)
 {
-  Message *msg;
-  std::queue<Message*> msgs;
+  PurgeSignal(outMessages, signal);
+}
 
-  CSingleLock lock(criticalSection);
+void Protocol::PurgeSignal(Direction &direction, int signal)
+{
+  CSingleLock lock(direction.section);
 
-  while (!outMessages.empty())
+  MessageQueue::Node *node;
+  while ((node = direction.queue.Pop()))
   {
-    msg = outMessages.front();
-    outMessages.pop();
-    if (msg->signal != signal)
-      msgs.push(msg);
+    direction.pending.push_back(node->value);
+    direction.queue.Free(node);
   }
-  while (!msgs.empty())
+
+  std::list<Message*>::iterator it = direction.pending.begin();
+  while (it != direction.pending.end())
   {
-    msg = msgs.front();
-    msgs.pop();
-    outMessages.push(msg);
+    if ((*it)->signal == signal)
+    {
+      (*it)->Release();
+      it = direction.pending.erase(it);
+    }
+    else
+      ++it;
   }
 }
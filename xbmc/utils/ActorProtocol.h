@@ -21,11 +21,15 @@
 #pragma once
 
 #include "threads/Thread.h"
+#include "threads/MPSCQueue.h"
 #include "utils/log.h"
-#include <queue>
+#include <list>
+#include <vector>
 #include "memory.h"
 
 #define MSG_INTERNAL_BUFFER_SIZE 32
+#define MSG_SLAB_SIZE 32
+#define MSG_RETURN_TIMEOUT 1000
 
 namespace Actor
 {
@@ -52,14 +56,23 @@ public:
   bool Reply(int sig, void *data = NULL, int size = 0);
 
 private:
-  Message() {isSync = false; data = NULL; event = NULL; replyMessage = NULL;};
+  Message() {isSync = false; data = NULL; event = NULL; replyMessage = NULL; heapData = NULL; heapSize = 0; nextFree = NULL;};
+  ~Message() {delete [] heapData;};
+  void SetPayload(void *payload, int size);
+
+  // larger payloads and the event of sync messages are kept when the message
+  // is returned, so recycled messages do not allocate again
+  uint8_t *heapData;
+  int heapSize;
+  CEvent syncEvent;
+  Message *nextFree;
 };
 
 class Protocol
 {
 public:
   Protocol(std::string name, CEvent* inEvent, CEvent *outEvent)
-    : portName(name), inDefered(false), outDefered(false) {containerInEvent = inEvent; containerOutEvent = outEvent;};
+    : portName(name), freeMessages(NULL), freeLock(0), inUse(0), closing(false), inDefered(false), outDefered(false) {containerInEvent = inEvent; containerOutEvent = outEvent;};
   virtual ~Protocol();
   Message *GetMessage();
   void ReturnMessage(Message *msg);
@@ -78,11 +91,34 @@ public:
   std::string portName;
 
 protected:
+  typedef XbmcThreads::CMPSCQueue<Message*> MessageQueue;
+
+  /**
+   * One direction of the port. Senders push without locking, receivers
+   * serialize on the section, which senders never touch. Messages put aside
+   * by a purge are kept in front of the queue.
+   */
+  struct Direction
+  {
+    MessageQueue queue;
+    std::list<Message*> pending;
+    CCriticalSection section;
+  };
+
+  void Send(Direction &direction, Message *msg);
+  bool Receive(Direction &direction, Message **msg);
+  void PurgeSignal(Direction &direction, int signal);
+
   CEvent *containerInEvent, *containerOutEvent;
   CCriticalSection criticalSection;
-  std::queue<Message*> outMessages;
-  std::queue<Message*> inMessages;
-  std::queue<Message*> freeMessageQueue;
+  Direction outMessages;
+  Direction inMessages;
+  Message *freeMessages;
+  long freeLock;
+  std::vector<Message*> slabs;
+  volatile long inUse;    // messages taken from the slabs and not returned yet
+  volatile bool closing;
+  CEvent returnedEvent;   // set when the last message comes back while closing
   bool inDefered, outDefered;
 };
 
@@ -0,0 +1,127 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <locale>
+
+#include "JSONStreamWriter.h"
+#include "JSONVariantWriter.h"
+#include "Variant.h"
+
+CJSONStreamWriter::CJSONStreamWriter(IJSONStreamOutput &output, bool compact, size_t chunkSize /* = 16384 */)
+  : m_output(output),
+    m_chunkSize(chunkSize),
+    m_written(0),
+    m_failed(false)
+{
+  m_generator = yajl_gen_alloc(NULL);
+  yajl_gen_config(m_generator, yajl_gen_beautify, compact ? 0 : 1);
+  yajl_gen_config(m_generator, yajl_gen_indent_string, "\t");
+}
+
+CJSONStreamWriter::~CJSONStreamWriter()
+{
+  yajl_gen_clear(m_generator);
+  yajl_gen_free(m_generator);
+}
+
+bool CJSONStreamWriter::BeginObject()
+{
+  return Generated(!m_failed && yajl_gen_map_open(m_generator) == yajl_gen_status_ok);
+}
+
+bool CJSONStreamWriter::EndObject()
+{
+  return Generated(!m_failed && yajl_gen_map_close(m_generator) == yajl_gen_status_ok);
+}
+
+bool CJSONStreamWriter::BeginArray()
+{
+  return Generated(!m_failed && yajl_gen_array_open(m_generator) == yajl_gen_status_ok);
+}
+
+bool CJSONStreamWriter::EndArray()
+{
+  return Generated(!m_failed && yajl_gen_array_close(m_generator) == yajl_gen_status_ok);
+}
+
+bool CJSONStreamWriter::Key(const std::string &key)
+{
+  return Generated(!m_failed && yajl_gen_string(m_generator, (const unsigned char*)key.c_str(), key.size()) == yajl_gen_status_ok);
+}
+
+bool CJSONStreamWriter::Value(const CVariant &value)
+{
+  if (m_failed)
+    return false;
+
+  // Set locale to classic ("C") to ensure valid JSON numbers
+  const char *currentLocale = setlocale(LC_NUMERIC, NULL);
+  std::string backupLocale;
+  if (currentLocale != NULL)
+  {
+    backupLocale = currentLocale;
+    setlocale(LC_NUMERIC, "C");
+  }
+
+  bool success = CJSONVariantWriter::InternalWrite(m_generator, value);
+
+  // Re-set locale to what it was before using yajl
+  if (!backupLocale.empty())
+    setlocale(LC_NUMERIC, backupLocale.c_str());
+
+  return Generated(success);
+}
+
+bool CJSONStreamWriter::Flush()
+{
+  if (m_failed)
+    return false;
+
+  const unsigned char *buffer;
+  size_t length;
+  yajl_gen_get_buf(m_generator, &buffer, &length);
+  if (length == 0)
+    return true;
+
+  if (!m_output.Write((const char *)buffer, length))
+    m_failed = true;
+  else
+    m_written += length;
+
+  yajl_gen_clear(m_generator);
+  return !m_failed;
+}
+
+bool CJSONStreamWriter::Generated(bool success)
+{
+  if (!success)
+  {
+    m_failed = true;
+    return false;
+  }
+
+  const unsigned char *buffer;
+  size_t length;
+  yajl_gen_get_buf(m_generator, &buffer, &length);
+  if (length < m_chunkSize)
+    return true;
+
+  return Flush();
+}
@@ -0,0 +1,102 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stddef.h>
+#include <string>
+#include <yajl/yajl_gen.h>
+
+class CVariant;
+
+/*!
+ \brief Receives the output of a CJSONStreamWriter chunk by chunk.
+ */
+class IJSONStreamOutput
+{
+public:
+  virtual ~IJSONStreamOutput() { }
+
+  /*!
+   \brief Passes on the next chunk of JSON.
+   \return false if it couldn't be passed on, e.g. because the client went away
+   */
+  virtual bool Write(const char *data, size_t size) = 0;
+};
+
+/*!
+ \brief Collects the output of a CJSONStreamWriter in a string.
+ */
+class CJSONStringOutput : public IJSONStreamOutput
+{
+public:
+  CJSONStringOutput(std::string &output) : m_output(output) { }
+
+  virtual bool Write(const char *data, size_t size) { m_output.append(data, size); return true; }
+
+private:
+  std::string &m_output;
+};
+
+/*!
+ \brief Writes a JSON document piece by piece.
+
+ Unlike CJSONVariantWriter the document never has to exist as a whole, neither
+ as a CVariant nor as a string. Whenever more than a chunk of output has been
+ generated it is handed to the IJSONStreamOutput, so the memory needed is
+ bounded by the chunk size and the largest value passed to Value().
+ */
+class CJSONStreamWriter
+{
+public:
+  CJSONStreamWriter(IJSONStreamOutput &output, bool compact, size_t chunkSize = 16384);
+  ~CJSONStreamWriter();
+
+  bool BeginObject();
+  bool EndObject();
+  bool BeginArray();
+  bool EndArray();
+
+  /*! \brief writes the name of the next member of the current object */
+  bool Key(const std::string &key);
+
+  /*! \brief writes a complete value, e.g. an array element or the value of a member */
+  bool Value(const CVariant &value);
+
+  /*! \brief hands whatever output hasn't been passed on yet to the output */
+  bool Flush();
+
+  /*! \brief true once generating or passing on output failed, all further calls fail then */
+  bool HasFailed() const { return m_failed; }
+
+  /*! \brief the number of bytes passed on to the output so far */
+  size_t GetBytesWritten() const { return m_written; }
+
+private:
+  CJSONStreamWriter(const CJSONStreamWriter&);
+  CJSONStreamWriter& operator=(const CJSONStreamWriter&);
+
+  bool Generated(bool success);
+
+  IJSONStreamOutput &m_output;
+  yajl_gen m_generator;
+  size_t m_chunkSize;
+  size_t m_written;
+  bool m_failed;
+};
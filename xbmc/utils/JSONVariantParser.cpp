@@ -64,7 +64,9 @@ CVariant CJSONVariantParser::Parse(const unsigned char *json, unsigned int lengt
 
   parser.push_buffer(json, length);
 
-  return callback.GetOutput();
+  CVariant result;
+  result.swap(callback.GetOutput());
+  return result;
 }
 
 int CJSONVariantParser::ParseNull(void * ctx)
@@ -164,28 +166,33 @@ int CJSONVariantParser::ParseArrayEnd(void * ctx)
 
 void CJSONVariantParser::PushObject(CVariant variant)
 {
+  PARSE_STATUS status = ParseVariable;
+  if (variant.isObject())
+    status = ParseObject;
+  else if (variant.isArray())
+    status = ParseArray;
+
+  // hand the new value over to its parent instead of copying it
   if (m_status == ParseObject)
   {
-    (*m_parse[m_parse.size() - 1])[m_key] = variant;
-    m_parse.push_back(&(*m_parse[m_parse.size() - 1])[m_key]);
+    CVariant &member = (*m_parse[m_parse.size() - 1])[m_key];
+    member.swap(variant);
+    m_parse.push_back(&member);
   }
   else if (m_status == ParseArray)
   {
-    CVariant *temp = m_parse[m_parse.size() - 1];
-    temp->push_back(variant);
-    m_parse.push_back(&(*temp)[temp->size() - 1]);
+    CVariant &element = m_parse[m_parse.size() - 1]->emplace_back();
+    element.swap(variant);
+    m_parse.push_back(&element);
   }
   else if (m_parse.size() == 0)
   {
-    m_parse.push_back(new CVariant(variant));
+    CVariant *root = new CVariant();
+    root->swap(variant);
+    m_parse.push_back(root);
   }
 
-  if (variant.isObject())
-    m_status = ParseObject;
-  else if (variant.isArray())
-    m_status = ParseArray;
-  else
-    m_status = ParseVariable;
+  m_status = status;
 }
 
 void CJSONVariantParser::PopObject()
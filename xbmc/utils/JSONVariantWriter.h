@@ -27,5 +27,7 @@ class CJSONVariantWriter
 public:
   static std::string Write(const CVariant &value, bool compact);
 private:
+  friend class CJSONStreamWriter;
+
   static bool InternalWrite(yajl_gen g, const CVariant &value);
 };
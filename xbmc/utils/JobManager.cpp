@@ -23,6 +23,7 @@
 #include <stdexcept>
 #include "threads/SingleLock.h"
 #include "utils/log.h"
+#include "utils/PerformanceTrace.h"
 
 #include "system.h"
 
@@ -65,6 +66,7 @@ void CJobWorker::Process()
     bool success = false;
     try
     {
+      TRACE_SCOPE(job->GetType());
       success = job->DoWork();
     }
     catch (...)
@@ -27,6 +27,7 @@
 
 #include "Application.h"
 #include "log.h"
+#include "PerformanceTrace.h"
 #include "TimeUtils.h"
 
 using namespace std;
@@ -59,6 +60,9 @@ void CPerformanceSample::Reset()
 
 void CPerformanceSample::CheckPoint()
 {
+  if (CPerformanceTrace::IsEnabled())
+    CPerformanceTrace::AddEvent(m_statName.c_str(), m_tmStart, CurrentHostCounter());
+
 #ifdef HAS_PERFORMANCE_SAMPLE
   int64_t tmNow;
   tmNow = CurrentHostCounter();
@@ -0,0 +1,238 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PerformanceTrace.h"
+#include "Application.h"
+#include "filesystem/File.h"
+#include "threads/Atomics.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "threads/ThreadLocal.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <deque>
+#include <string.h>
+#include <vector>
+
+// events kept per thread, the oldest ones are overwritten
+#define TRACE_BUFFER_SIZE     4096
+// threads that can record at the same time, the buffers of threads that
+// exited are given to new threads
+#define TRACE_MAX_THREADS     128
+#define TRACE_EVENT_NAME_SIZE 48
+
+struct TraceEvent
+{
+  int64_t start;
+  int64_t end;
+  char    name[TRACE_EVENT_NAME_SIZE];
+};
+
+// written by its thread only, read by GetJSON()
+struct TraceBuffer
+{
+  TraceEvent       *events;
+  volatile long     written;  // events written in the current session
+  volatile long     session;
+  int               id;
+  std::string       thread;
+};
+
+volatile bool CPerformanceTrace::m_enabled = false;
+
+static void ReleaseThread(void *value);
+
+static CCriticalSection                      g_traceSection;
+static std::vector<TraceBuffer*>             g_traceBuffers;
+static std::deque<TraceBuffer*>              g_traceReleased; // oldest first
+static XbmcThreads::ThreadLocal<TraceBuffer> g_traceBuffer(ReleaseThread);
+static TraceBuffer                           g_traceUntraced = { NULL, 0, 0, 0, "" };
+static volatile long                         g_traceSession = 0;
+static int64_t                               g_traceStart = 0;
+static int                                   g_traceThreads = 0;
+static bool                                  g_traceFull = false;
+
+static TraceBuffer* RegisterThread()
+{
+  CSingleLock lock(g_traceSection);
+
+  TraceBuffer *buffer = &g_traceUntraced;
+  if (!g_traceReleased.empty())
+  {
+    // the events of the thread that exited first go
+    buffer = g_traceReleased.front();
+    g_traceReleased.pop_front();
+  }
+  else if (g_traceBuffers.size() < TRACE_MAX_THREADS)
+  {
+    buffer = new TraceBuffer;
+    buffer->events = new TraceEvent[TRACE_BUFFER_SIZE]();
+    g_traceBuffers.push_back(buffer);
+  }
+  else if (!g_traceFull)
+  {
+    CLog::Log(LOGWARNING, "CPerformanceTrace - more than %d threads at the same time, not tracing the new ones", TRACE_MAX_THREADS);
+    g_traceFull = true;
+  }
+
+  if (buffer != &g_traceUntraced)
+  {
+    buffer->written = 0;
+    buffer->session = g_traceSession;
+    buffer->id = ++g_traceThreads;
+
+    CThread *thread = CThread::GetCurrentThread();
+    if (thread)
+      buffer->thread = thread->GetName();
+    else if (g_application.IsCurrentThread())
+      buffer->thread = "Application";
+    else
+      buffer->thread = StringUtils::Format("Thread %d", buffer->id);
+  }
+
+  g_traceBuffer.set(buffer);
+  return buffer;
+}
+
+// called by the thread local when a thread that recorded exits
+static void ReleaseThread(void *value)
+{
+  TraceBuffer *buffer = (TraceBuffer*)value;
+  if (buffer == &g_traceUntraced)
+    return;
+
+  // the events stay in the trace until another thread takes the buffer
+  CSingleLock lock(g_traceSection);
+  g_traceReleased.push_back(buffer);
+}
+
+static std::string EscapeJSON(const char *str)
+{
+  std::string escaped;
+  for (; *str; str++)
+  {
+    if (*str == '"' || *str == '\\')
+      escaped += '\\';
+    if ((unsigned char)*str < 0x20)
+      escaped += StringUtils::Format("\\u%04x", (unsigned char)*str);
+    else
+      escaped += *str;
+  }
+  return escaped;
+}
+
+void CPerformanceTrace::Start()
+{
+  CSingleLock lock(g_traceSection);
+
+  g_traceStart = CurrentHostCounter();
+  AtomicIncrement(&g_traceSession);
+  m_enabled = true;
+  CLog::Log(LOGNOTICE, "CPerformanceTrace - recording started");
+}
+
+void CPerformanceTrace::Stop()
+{
+  m_enabled = false;
+  CLog::Log(LOGNOTICE, "CPerformanceTrace - recording stopped");
+}
+
+void CPerformanceTrace::AddEvent(const char *name, int64_t start, int64_t end)
+{
+  TraceBuffer *buffer = g_traceBuffer.get();
+  if (!buffer)
+    buffer = RegisterThread();
+  if (!buffer->events)
+    return;
+
+  long session = g_traceSession;
+  if (buffer->session != session)
+  {
+    // first event of a new session, the old events are gone
+    buffer->written = 0;
+    buffer->session = session;
+  }
+
+  TraceEvent &event = buffer->events[buffer->written % TRACE_BUFFER_SIZE];
+  event.start = start;
+  event.end = end;
+  strncpy(event.name, name, TRACE_EVENT_NAME_SIZE - 1);
+
+  // publishes the event, AtomicIncrement is a barrier
+  AtomicIncrement(&buffer->written);
+}
+
+std::string CPerformanceTrace::GetJSON()
+{
+  CSingleLock lock(g_traceSection);
+
+  std::string json = "{\"traceEvents\":[";
+  double scale = 1000000.0 / CurrentHostFrequency();
+  std::vector<TraceEvent> events;
+  bool first = true;
+
+  for (std::vector<TraceBuffer*>::iterator it = g_traceBuffers.begin(); it != g_traceBuffers.end(); ++it)
+  {
+    TraceBuffer *buffer = *it;
+    json += StringUtils::Format("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                                first ? "" : ",", buffer->id, EscapeJSON(buffer->thread.c_str()).c_str());
+    first = false;
+
+    if (buffer->session != g_traceSession)
+      continue;
+
+    // copy the events, then drop those the thread overwrote meanwhile and
+    // the one in the slot it may be writing to right now
+    long end = AtomicAdd(&buffer->written, 0);
+    long begin = std::max(0L, end - TRACE_BUFFER_SIZE);
+    events.resize(end - begin);
+    for (long i = begin; i < end; i++)
+      events[i - begin] = buffer->events[i % TRACE_BUFFER_SIZE];
+    long overwritten = AtomicAdd(&buffer->written, 0) - TRACE_BUFFER_SIZE + 1;
+
+    for (long i = std::max(begin, overwritten); i < end; i++)
+    {
+      const TraceEvent &event = events[i - begin];
+      json += StringUtils::Format(",{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                                  EscapeJSON(event.name).c_str(), buffer->id,
+                                  (event.start - g_traceStart) * scale, (event.end - event.start) * scale);
+    }
+  }
+
+  json += "],\"displayTimeUnit\":\"ms\"}";
+  return json;
+}
+
+bool CPerformanceTrace::Dump(const std::string &file)
+{
+  std::string json = GetJSON();
+
+  XFILE::CFile output;
+  if (!output.OpenForWrite(file, true) || output.Write(json.c_str(), json.size()) != (ssize_t)json.size())
+  {
+    CLog::Log(LOGERROR, "CPerformanceTrace - unable to write trace to %s", file.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGNOTICE, "CPerformanceTrace - trace written to %s", file.c_str());
+  return true;
+}
@@ -0,0 +1,94 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/TimeUtils.h"
+
+#include <string>
+
+#define TRACE_FUNCTION CPerformanceTraceScope aTraceScope(__FUNCTION__);
+#define TRACE_SCOPE(n) CPerformanceTraceScope aTraceScope(n);
+
+/*!
+ \brief Records a timeline of what the threads are doing.
+ While enabled, every thread writes the scopes it runs through into a ring
+ buffer of its own, so recording takes no locks and keeps only the most
+ recent events per thread. The timeline can be written out in the Chrome
+ trace event format, to be viewed in chrome://tracing or Perfetto.
+
+ Recording is off by default and costs a single flag check per scope then.
+ */
+class CPerformanceTrace
+{
+public:
+  /*!
+   \brief Discard the events recorded so far and start recording.
+   */
+  static void Start();
+
+  /*!
+   \brief Stop recording, the recorded events are kept.
+   */
+  static void Stop();
+
+  static bool IsEnabled() { return m_enabled; }
+
+  /*!
+   \brief Add an event to the timeline of the calling thread.
+   \param name what was done, copied into the buffer and truncated if long
+   \param start begin of the event as returned by CurrentHostCounter()
+   \param end end of the event as returned by CurrentHostCounter()
+   */
+  static void AddEvent(const char *name, int64_t start, int64_t end);
+
+  /*!
+   \brief Get the recorded events as Chrome trace JSON.
+   Can be called while recording.
+   */
+  static std::string GetJSON();
+
+  /*!
+   \brief Write the recorded events as Chrome trace JSON to a file.
+   */
+  static bool Dump(const std::string &file);
+
+private:
+  static volatile bool m_enabled;
+};
+
+/*!
+ \brief Records the lifetime of the object as a trace event.
+ name must outlive the object, which string literals and __FUNCTION__ do.
+ */
+class CPerformanceTraceScope
+{
+public:
+  CPerformanceTraceScope(const char *name)
+    : m_name(name), m_start(CPerformanceTrace::IsEnabled() ? CurrentHostCounter() : 0) {}
+  ~CPerformanceTraceScope()
+  {
+    if (m_start)
+      CPerformanceTrace::AddEvent(m_name, m_start, CurrentHostCounter());
+  }
+
+private:
+  const char *m_name;
+  int64_t m_start;
+};
@@ -0,0 +1,100 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RandomSampler.h"
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
+
+CRandomSampler::CRandomSampler()
+  : m_drawn(0)
+{
+  int64_t now = CurrentHostCounter();
+  m_state = (uint32_t)(now ^ (now >> 32)) | 1;
+}
+
+CRandomSampler::CRandomSampler(uint32_t seed)
+  : m_drawn(0), m_state(seed | 1)
+{
+}
+
+void CRandomSampler::Reset(const std::vector<int> &ids)
+{
+  m_ids = ids;
+  m_drawn = 0;
+}
+
+void CRandomSampler::Clear()
+{
+  m_ids.clear();
+  m_drawn = 0;
+}
+
+bool CRandomSampler::Next(int &id, const std::set<int> &recent /* = std::set<int>() */)
+{
+  if (m_ids.empty())
+    return false;
+
+  // give up on avoiding recent ids once a whole round has been looked at,
+  // which may start part way through the current one
+  unsigned int maxTries = 2 * m_ids.size() - m_drawn;
+  id = Draw();
+  for (unsigned int tries = 1; tries < maxTries && recent.find(id) != recent.end(); tries++)
+    id = Draw();
+  return true;
+}
+
+void CRandomSampler::Remove(int id)
+{
+  std::vector<int>::iterator it = std::find(m_ids.begin(), m_ids.end(), id);
+  if (it == m_ids.end())
+    return;
+
+  // keep the drawn ids in front of the ones still to come
+  unsigned int pos = it - m_ids.begin();
+  if (pos < m_drawn)
+  {
+    m_drawn--;
+    std::swap(m_ids[pos], m_ids[m_drawn]);
+    pos = m_drawn;
+  }
+  m_ids[pos] = m_ids.back();
+  m_ids.pop_back();
+}
+
+int CRandomSampler::Draw()
+{
+  if (m_drawn >= m_ids.size())
+    m_drawn = 0;
+
+  // a Fisher-Yates shuffle step: pick one of the ids not yet drawn
+  unsigned int pick = m_drawn + Random(m_ids.size() - m_drawn);
+  std::swap(m_ids[m_drawn], m_ids[pick]);
+  return m_ids[m_drawn++];
+}
+
+uint32_t CRandomSampler::Random(uint32_t range)
+{
+  // xorshift32, rand() only gives 15 bits on some platforms
+  m_state ^= m_state << 13;
+  m_state ^= m_state >> 17;
+  m_state ^= m_state << 5;
+  return (uint32_t)(((uint64_t)m_state * range) >> 32);
+}
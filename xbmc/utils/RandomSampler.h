@@ -0,0 +1,71 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <set>
+#include <vector>
+#include <stdint.h>
+
+/*!
+ \brief Draws random ids from a fixed set without asking the database.
+ The ids are dealt like a shuffled deck of cards: every id comes up once
+ before any comes up again, after which the deck is reshuffled. Shuffling
+ is done one card at a time as they are drawn, so a draw costs the same
+ no matter how many ids there are.
+ */
+class CRandomSampler
+{
+public:
+  CRandomSampler();
+  explicit CRandomSampler(uint32_t seed);
+
+  /*!
+   \brief Replace the ids to draw from.
+   */
+  void Reset(const std::vector<int> &ids);
+
+  void Clear();
+  bool IsEmpty() const { return m_ids.empty(); }
+  unsigned int Size() const { return m_ids.size(); }
+
+  /*!
+   \brief Draw the next id.
+   Ids found in recent are passed over as long as others are left to draw
+   from, so that a reshuffle doesn't bring back what was just played.
+   \param id the drawn id
+   \param recent ids to avoid
+   \return false if there are no ids to draw from
+   */
+  bool Next(int &id, const std::set<int> &recent = std::set<int>());
+
+  /*!
+   \brief Take an id out of the set, e.g. after it turned out to be gone
+   from the database.
+   */
+  void Remove(int id);
+
+private:
+  int Draw();
+  uint32_t Random(uint32_t range);
+
+  std::vector<int> m_ids;
+  unsigned int m_drawn;
+  uint32_t m_state;
+};
@@ -248,6 +248,8 @@ CRegExp& CRegExp::operator=(const CRegExp& re)
   Cleanup();
   m_jitCompiled = false;
   m_pattern = re.m_pattern;
+  m_utf8Mode = re.m_utf8Mode;
+  m_iOptions = re.m_iOptions;
   if (re.m_re)
   {
     if (pcre_fullinfo(re.m_re, NULL, PCRE_INFO_SIZE, &size) >= 0)
@@ -260,7 +262,6 @@ CRegExp& CRegExp::operator=(const CRegExp& re)
         m_iMatchCount = re.m_iMatchCount;
         m_bMatched = re.m_bMatched;
         m_subject = re.m_subject;
-        m_iOptions = re.m_iOptions;
       }
       else
         CLog::Log(LOGSEVERE, "%s: Failed to allocate memory", __FUNCTION__);
@@ -371,7 +372,7 @@ int CRegExp::PrivateRegFind(size_t bufferLen, const char *str, unsigned int star
     bufferLen = std::min<size_t>(bufferLen, startoffset + maxNumberOfCharsToTest);
 
   m_subject.assign(str + startoffset, bufferLen - startoffset);
-  int rc = pcre_exec(m_re, NULL, m_subject.c_str(), m_subject.length(), 0, 0, m_iOvector, OVECCOUNT);
+  int rc = pcre_exec(m_re, m_sd, m_subject.c_str(), m_subject.length(), 0, 0, m_iOvector, OVECCOUNT);
 
   if (rc<1)
   {
@@ -428,6 +429,14 @@ int CRegExp::GetCaptureTotal() const
   return c;
 }
 
+void CRegExp::ClearMatch()
+{
+  m_offset      = 0;
+  m_bMatched    = false;
+  m_iMatchCount = 0;
+  std::string().swap(m_subject);
+}
+
 std::string CRegExp::GetReplaceString(const std::string& sReplaceExp) const
 {
   if (!m_bMatched || sReplaceExp.empty())
@@ -116,6 +116,10 @@ public:
    */
   int RegFind(const std::string& str, unsigned int startoffset = 0, int maxNumberOfCharsToTest = -1)
   { return PrivateRegFind(str.length(), str.c_str(), startoffset, maxNumberOfCharsToTest); }
+  /**
+   * Forget the last match and the string it was found in, the expression stays compiled
+   */
+  void ClearMatch();
   std::string GetReplaceString(const std::string& sReplaceExp) const;
   int GetFindLen() const
   {
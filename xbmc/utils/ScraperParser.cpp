@@ -32,6 +32,9 @@
 #include "utils/StringUtils.h"
 #include "utils/XSLTUtils.h"
 #include "utils/XMLUtils.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include <algorithm>
 #include <sstream>
 #include <cstring>
 
@@ -39,22 +42,57 @@ using namespace std;
 using namespace ADDON;
 using namespace XFILE;
 
+#define MAX_IDLE_SCRAPER_PROGRAMS 8
+
+static const char* OptionalParamExpression = "(.*)(\\\\\\(.*\\\\2.*)\\\\\\)(.*)";
+static const char* JSONUnicodeExpression = "\\\\u([0-f]{4})";
+static const char* JSONHexExpression = "\\\\x([0-9]{2})([^\\\\]+;)";
+
+std::vector<CScraperParser::Program*> CScraperParser::m_idlePrograms;
+CCriticalSection CScraperParser::m_idleProgramsSection;
+
+CScraperParser::Step::Step()
+  : xslt(false),
+    dest(1),
+    append(false),
+    hasInput(false),
+    inputReferences(false),
+    hasConditional(false),
+    inverse(false),
+    hasExpression(false),
+    expressionReferences(false),
+    outputReferences(false),
+    repeat(false),
+    clear(false),
+    optional(-1),
+    compare(-1)
+{
+}
+
 CScraperParser::CScraperParser()
+  : m_optionalParam(false, CRegExp::asciiOnly, OptionalParamExpression, CRegExp::StudyRegExp),
+    m_jsonUnicode(false, CRegExp::asciiOnly, JSONUnicodeExpression, CRegExp::StudyRegExp),
+    m_jsonHex(false, CRegExp::asciiOnly, JSONHexExpression, CRegExp::StudyRegExp)
 {
   m_pRootElement = NULL;
   m_document = NULL;
   m_SearchStringEncoding = "UTF-8";
   m_scraper = NULL;
   m_isNoop = true;
+  m_program = NULL;
 }
 
 CScraperParser::CScraperParser(const CScraperParser& parser)
+  : m_optionalParam(false, CRegExp::asciiOnly, OptionalParamExpression, CRegExp::StudyRegExp),
+    m_jsonUnicode(false, CRegExp::asciiOnly, JSONUnicodeExpression, CRegExp::StudyRegExp),
+    m_jsonHex(false, CRegExp::asciiOnly, JSONHexExpression, CRegExp::StudyRegExp)
 {
   m_pRootElement = NULL;
   m_document = NULL;
   m_SearchStringEncoding = "UTF-8";
   m_scraper = NULL;
   m_isNoop = true;
+  m_program = NULL;
   *this = parser;
 }
 
@@ -67,6 +105,7 @@ CScraperParser &CScraperParser::operator=(const CScraperParser &parser)
     {
       m_scraper = parser.m_scraper;
       m_document = new CXBMCTinyXML(*parser.m_document);
+      m_programKey = parser.m_programKey;
       LoadFromXML();
     }
     else
@@ -87,6 +126,10 @@ void CScraperParser::Clear()
 
   m_document = NULL;
   m_strFile.clear();
+
+  ReleaseProgram(m_program);
+  m_program = NULL;
+  m_programKey.clear();
 }
 
 bool CScraperParser::Load(const std::string& strXMLFile)
@@ -101,7 +144,10 @@ bool CScraperParser::Load(const std::string& strXMLFile)
   m_strFile = strXMLFile;
 
   if (m_document->LoadFile(strXMLFile))
+  {
+    m_programKey = GetProgramKey(strXMLFile);
     return LoadFromXML();
+  }
 
   delete m_document;
   m_document = NULL;
@@ -153,14 +199,17 @@ void CScraperParser::ReplaceBuffers(std::string& strDest)
 {
   // insert buffers
   size_t iIndex;
-  for (int i=MAX_SCRAPER_BUFFERS-1; i>=0; i--)
+  if (strDest.find("$$") != std::string::npos)
   {
-    iIndex = 0;
-    std::string temp = StringUtils::Format("$$%i",i+1);
-    while ((iIndex = strDest.find(temp,iIndex)) != std::string::npos)
+    for (int i=MAX_SCRAPER_BUFFERS-1; i>=0; i--)
     {
-      strDest.replace(strDest.begin()+iIndex,strDest.begin()+iIndex+temp.size(),m_param[i]);
-      iIndex += m_param[i].length();
+      iIndex = 0;
+      std::string temp = StringUtils::Format("$$%i",i+1);
+      while ((iIndex = strDest.find(temp,iIndex)) != std::string::npos)
+      {
+        strDest.replace(strDest.begin()+iIndex,strDest.begin()+iIndex+temp.size(),m_param[i]);
+        iIndex += m_param[i].length();
+      }
     }
   }
   // insert settings
@@ -192,161 +241,112 @@ void CScraperParser::ReplaceBuffers(std::string& strDest)
     strDest.replace(strDest.begin()+iIndex,strDest.begin()+iIndex+2,"\n");
 }
 
-void CScraperParser::ParseExpression(const std::string& input, std::string& dest, TiXmlElement* element, bool bAppend)
+void CScraperParser::ParseExpression(const std::string& input, std::string& dest, Step& step, bool bAppend)
 {
-  std::string strOutput = XMLUtils::GetAttribute(element, "output");
+  if (!step.hasExpression)
+    return;
 
-  TiXmlElement* pExpression = element->FirstChildElement("expression");
-  if (pExpression)
+  CRegExp& reg = step.regExp;
+  if (step.expressionReferences)
   {
-    bool bInsensitive=true;
-    const char* sensitive = pExpression->Attribute("cs");
-    if (sensitive)
-      if (stricmp(sensitive,"yes") == 0)
-        bInsensitive=false; // match case sensitive
-
-    CRegExp::utf8Mode eUtf8 = CRegExp::autoUtf8;
-    const char* const strUtf8 = pExpression->Attribute("utf8");
-    if (strUtf8)
-    {
-      if (stricmp(strUtf8, "yes") == 0)
-        eUtf8 = CRegExp::forceUtf8;
-      else if (stricmp(strUtf8, "no") == 0)
-        eUtf8 = CRegExp::asciiOnly;
-      else if (stricmp(strUtf8, "auto") == 0)
-        eUtf8 = CRegExp::autoUtf8;
-    }
-
-    CRegExp reg(bInsensitive, eUtf8);
-    std::string strExpression;
-    if (pExpression->FirstChild())
-      strExpression = pExpression->FirstChild()->Value();
-    else
-      strExpression = "(.*)";
+    std::string strExpression = step.expression;
     ReplaceBuffers(strExpression);
-    ReplaceBuffers(strOutput);
-
-    if (!reg.RegComp(strExpression.c_str()))
+    // the buffers tend to hold the same values for a while, only recompile when they changed
+    if (!reg.IsCompiled() || reg.GetPattern() != strExpression)
     {
-      return;
+      if (!reg.RegComp(strExpression.c_str()))
+        return;
     }
+  }
+  else if (!reg.IsCompiled())
+    return;
 
-    bool bRepeat = false;
-    const char* szRepeat = pExpression->Attribute("repeat");
-    if (szRepeat)
-      if (stricmp(szRepeat,"yes") == 0)
-        bRepeat = true;
-
-    const char* szClear = pExpression->Attribute("clear");
-    if (szClear)
-      if (stricmp(szClear,"yes") == 0)
-        dest=""; // clear no matter if regexp fails
-
-    bool bClean[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bClean,pExpression->Attribute("noclean"),true);
-
-    bool bTrim[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bTrim,pExpression->Attribute("trim"),false);
-
-    bool bFixChars[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bFixChars,pExpression->Attribute("fixchars"),false);
+  std::string strOutput = step.output;
+  if (step.outputReferences)
+  {
+    ReplaceBuffers(strOutput);
+    for (std::vector<std::pair<int, const char*> >::const_iterator token = step.tokens.begin(); token != step.tokens.end(); ++token)
+      InsertToken(strOutput, token->first, token->second);
+  }
 
-    bool bEncode[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bEncode,pExpression->Attribute("encode"),false);
+  if (step.clear)
+    dest=""; // clear no matter if regexp fails
 
-    int iOptional = -1;
-    pExpression->QueryIntAttribute("optional",&iOptional);
+  if (step.compare > -1)
+    StringUtils::ToLower(m_param[step.compare-1]);
 
-    int iCompare = -1;
-    pExpression->QueryIntAttribute("compare",&iCompare);
-    if (iCompare > -1)
-      StringUtils::ToLower(m_param[iCompare-1]);
-    std::string curInput = input;
-    for (int iBuf=0;iBuf<MAX_SCRAPER_BUFFERS;++iBuf)
+  // repeated matches continue behind the previous one instead of cutting off the input
+  size_t offset = 0;
+  int i = reg.RegFind(input.c_str());
+  while (i > -1 && (i < (int)input.size() || offset == input.size()))
+  {
+    if (!bAppend)
     {
-      if (bClean[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!CLEAN!!!");
-      if (bTrim[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!TRIM!!!");
-      if (bFixChars[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!FIXCHARS!!!");
-      if (bEncode[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!ENCODE!!!");
+      dest = "";
+      bAppend = true;
     }
-    int i = reg.RegFind(curInput.c_str());
-    while (i > -1 && (i < (int)curInput.size() || curInput.size() == 0))
-    {
-      if (!bAppend)
-      {
-        dest = "";
-        bAppend = true;
-      }
-      std::string strCurOutput=strOutput;
+    std::string strCurOutput=strOutput;
 
-      if (iOptional > -1) // check that required param is there
+    if (step.optional > -1) // check that required param is there
+    {
+      std::string szParam = reg.GetReplaceString(step.optionalParam);
+      int i2=m_optionalParam.RegFind(strCurOutput.c_str());
+      while (i2 > -1)
       {
-        char temp[4];
-        sprintf(temp,"\\%i",iOptional);
-        std::string szParam = reg.GetReplaceString(temp);
-        CRegExp reg2;
-        reg2.RegComp("(.*)(\\\\\\(.*\\\\2.*)\\\\\\)(.*)");
-        int i2=reg2.RegFind(strCurOutput.c_str());
-        while (i2 > -1)
+        std::string szRemove(m_optionalParam.GetMatch(2));
+        int iRemove = szRemove.size();
+        int i3 = strCurOutput.find(szRemove);
+        if (!szParam.empty())
         {
-          std::string szRemove(reg2.GetMatch(2));
-          int iRemove = szRemove.size();
-          int i3 = strCurOutput.find(szRemove);
-          if (!szParam.empty())
-          {
-            strCurOutput.erase(i3+iRemove,2);
-            strCurOutput.erase(i3,2);
-          }
-          else
-            strCurOutput.replace(strCurOutput.begin()+i3,strCurOutput.begin()+i3+iRemove+2,"");
-
-          i2 = reg2.RegFind(strCurOutput.c_str());
+          strCurOutput.erase(i3+iRemove,2);
+          strCurOutput.erase(i3,2);
         }
+        else
+          strCurOutput.replace(strCurOutput.begin()+i3,strCurOutput.begin()+i3+iRemove+2,"");
+
+        i2 = m_optionalParam.RegFind(strCurOutput.c_str());
       }
+    }
 
-      int iLen = reg.GetFindLen();
-      // nasty hack #1 - & means \0 in a replace string
-      StringUtils::Replace(strCurOutput, "&","!!!AMPAMP!!!");
-      std::string result = reg.GetReplaceString(strCurOutput.c_str());
-      if (!result.empty())
+    int iLen = reg.GetFindLen();
+    // nasty hack #1 - & means \0 in a replace string
+    StringUtils::Replace(strCurOutput, "&","!!!AMPAMP!!!");
+    std::string result = reg.GetReplaceString(strCurOutput.c_str());
+    if (!result.empty())
+    {
+      std::string strResult(result);
+      StringUtils::Replace(strResult, "!!!AMPAMP!!!","&");
+      Clean(strResult);
+      ReplaceBuffers(strResult);
+      if (step.compare > -1)
       {
-        std::string strResult(result);
-        StringUtils::Replace(strResult, "!!!AMPAMP!!!","&");
-        Clean(strResult);
-        ReplaceBuffers(strResult);
-        if (iCompare > -1)
-        {
-          std::string strResultNoCase = strResult;
-          StringUtils::ToLower(strResultNoCase);
-          if (strResultNoCase.find(m_param[iCompare-1]) != std::string::npos)
-            dest += strResult;
-        }
-        else
+        std::string strResultNoCase = strResult;
+        StringUtils::ToLower(strResultNoCase);
+        if (strResultNoCase.find(m_param[step.compare-1]) != std::string::npos)
           dest += strResult;
       }
-      if (bRepeat && iLen > 0)
-      {
-        curInput.erase(0,i+iLen>(int)curInput.size()?curInput.size():i+iLen);
-        i = reg.RegFind(curInput.c_str());
-      }
       else
-        i = -1;
+        dest += strResult;
+    }
+    if (step.repeat && iLen > 0)
+    {
+      offset = std::min(input.size(), (size_t)(i + iLen));
+      i = reg.RegFind(input.c_str(), offset);
     }
+    else
+      i = -1;
   }
+
+  // don't keep a copy of the input around until the expression is used again
+  reg.ClearMatch();
 }
 
-void CScraperParser::ParseXSLT(const std::string& input, std::string& dest, TiXmlElement* element, bool bAppend)
+void CScraperParser::ParseXSLT(const std::string& input, std::string& dest, const Step& step, bool bAppend)
 {
-  TiXmlElement* pSheet = element->FirstChildElement();
-  if (pSheet)
+  if (!step.stylesheet.empty())
   {
     XSLTUtils xsltUtils;
-    std::string strXslt;
-    strXslt << *pSheet;
+    std::string strXslt = step.stylesheet;
     ReplaceBuffers(strXslt);
 
     if (!xsltUtils.SetInput(input))
@@ -379,93 +379,238 @@ TiXmlElement *NextSiblingScraperElement(TiXmlElement *element)
   return NULL;
 }
 
-void CScraperParser::ParseNext(TiXmlElement* element)
+static bool HasReferences(const std::string& str)
 {
-  TiXmlElement* pReg = element;
-  while (pReg)
+  return str.find("$$") != std::string::npos ||
+         str.find("$INFO[") != std::string::npos ||
+         str.find("$LOCALIZE[") != std::string::npos;
+}
+
+void CScraperParser::Compile(TiXmlElement* element, std::vector<Step>& steps)
+{
+  for (TiXmlElement* pReg = element; pReg; pReg = NextSiblingScraperElement(pReg))
   {
+    // nested elements are run before the element itself
     TiXmlElement* pChildReg = FirstChildScraperElement(pReg);
+    if (!pChildReg)
+      pChildReg = pReg->FirstChildElement("clear");
     if (pChildReg)
-      ParseNext(pChildReg);
-    else
-    {
-      TiXmlElement* pChildReg = pReg->FirstChildElement("clear");
-      if (pChildReg)
-        ParseNext(pChildReg);
-    }
+      Compile(pChildReg, steps);
+
+    steps.push_back(Step());
+    Step& step = steps.back();
+    step.xslt = pReg->ValueStr() == "XSLT";
 
-    int iDest = 1;
-    bool bAppend = false;
     const char* szDest = pReg->Attribute("dest");
     if (szDest && strlen(szDest))
     {
       if (szDest[strlen(szDest)-1] == '+')
-        bAppend = true;
+        step.append = true;
 
-      iDest = atoi(szDest);
+      step.dest = atoi(szDest);
     }
 
+    // anything that doesn't refer to buffers or settings is only prepared once
     const char *szInput = pReg->Attribute("input");
-    std::string strInput;
     if (szInput)
     {
-      strInput = szInput;
-      ReplaceBuffers(strInput);
+      step.hasInput = true;
+      step.input = szInput;
+      step.inputReferences = HasReferences(step.input);
+      if (!step.inputReferences)
+        ReplaceBuffers(step.input);
     }
-    else
-      strInput = m_param[0];
 
     const char* szConditional = pReg->Attribute("conditional");
-    bool bExecute = true;
     if (szConditional)
     {
-      bool bInverse=false;
+      step.hasConditional = true;
       if (szConditional[0] == '!')
       {
-        bInverse = true;
+        step.inverse = true;
         szConditional++;
       }
+      step.conditional = szConditional;
+    }
+
+    if (step.xslt)
+    {
+      TiXmlElement* pSheet = pReg->FirstChildElement();
+      if (pSheet)
+        step.stylesheet << *pSheet;
+      continue;
+    }
+
+    TiXmlElement* pExpression = pReg->FirstChildElement("expression");
+    if (!pExpression)
+      continue;
+
+    step.hasExpression = true;
+
+    bool bInsensitive=true;
+    const char* sensitive = pExpression->Attribute("cs");
+    if (sensitive)
+      if (stricmp(sensitive,"yes") == 0)
+        bInsensitive=false; // match case sensitive
+
+    CRegExp::utf8Mode eUtf8 = CRegExp::autoUtf8;
+    const char* const strUtf8 = pExpression->Attribute("utf8");
+    if (strUtf8)
+    {
+      if (stricmp(strUtf8, "yes") == 0)
+        eUtf8 = CRegExp::forceUtf8;
+      else if (stricmp(strUtf8, "no") == 0)
+        eUtf8 = CRegExp::asciiOnly;
+      else if (stricmp(strUtf8, "auto") == 0)
+        eUtf8 = CRegExp::autoUtf8;
+    }
+    step.regExp = CRegExp(bInsensitive, eUtf8);
+
+    if (pExpression->FirstChild())
+      step.expression = pExpression->FirstChild()->Value();
+    else
+      step.expression = "(.*)";
+    step.expressionReferences = HasReferences(step.expression);
+    if (!step.expressionReferences)
+      ReplaceBuffers(step.expression);
+
+    const char* szRepeat = pExpression->Attribute("repeat");
+    if (szRepeat)
+      if (stricmp(szRepeat,"yes") == 0)
+        step.repeat = true;
+
+    const char* szClear = pExpression->Attribute("clear");
+    if (szClear)
+      if (stricmp(szClear,"yes") == 0)
+        step.clear = true;
+
+    bool bClean[MAX_SCRAPER_BUFFERS];
+    GetBufferParams(bClean,pExpression->Attribute("noclean"),true);
+
+    bool bTrim[MAX_SCRAPER_BUFFERS];
+    GetBufferParams(bTrim,pExpression->Attribute("trim"),false);
+
+    bool bFixChars[MAX_SCRAPER_BUFFERS];
+    GetBufferParams(bFixChars,pExpression->Attribute("fixchars"),false);
+
+    bool bEncode[MAX_SCRAPER_BUFFERS];
+    GetBufferParams(bEncode,pExpression->Attribute("encode"),false);
+
+    for (int iBuf=0;iBuf<MAX_SCRAPER_BUFFERS;++iBuf)
+    {
+      if (bClean[iBuf])
+        step.tokens.push_back(std::make_pair(iBuf+1, "!!!CLEAN!!!"));
+      if (bTrim[iBuf])
+        step.tokens.push_back(std::make_pair(iBuf+1, "!!!TRIM!!!"));
+      if (bFixChars[iBuf])
+        step.tokens.push_back(std::make_pair(iBuf+1, "!!!FIXCHARS!!!"));
+      if (bEncode[iBuf])
+        step.tokens.push_back(std::make_pair(iBuf+1, "!!!ENCODE!!!"));
+    }
+
+    pExpression->QueryIntAttribute("optional",&step.optional);
+    if (step.optional > -1)
+      step.optionalParam = StringUtils::Format("\\%i", step.optional);
+
+    pExpression->QueryIntAttribute("compare",&step.compare);
+
+    step.output = XMLUtils::GetAttribute(pReg, "output");
+    step.outputReferences = HasReferences(step.output);
+    if (!step.outputReferences)
+    {
+      ReplaceBuffers(step.output);
+      for (std::vector<std::pair<int, const char*> >::const_iterator token = step.tokens.begin(); token != step.tokens.end(); ++token)
+        InsertToken(step.output, token->first, token->second);
+    }
+  }
+}
+
+CScraperParser::Function* CScraperParser::GetFunction(const std::string& strTag)
+{
+  if (!m_program)
+    m_program = AcquireProgram(m_programKey);
+
+  std::map<std::string, Function>::iterator it = m_program->functions.find(strTag);
+  if (it != m_program->functions.end())
+    return &it->second;
+
+  TiXmlElement* pChildElement = m_pRootElement->FirstChildElement(strTag.c_str());
+  if (pChildElement == NULL)
+    return NULL;
+
+  Function& function = m_program->functions[strTag];
+  function.dest = 1; // default to param 1
+  pChildElement->QueryIntAttribute("dest",&function.dest);
+  const char* szClearBuffers = pChildElement->Attribute("clearbuffers");
+  function.clearBuffers = !szClearBuffers || stricmp(szClearBuffers,"no") != 0;
+
+  Compile(FirstChildScraperElement(pChildElement), function.steps);
+
+  // the steps are in place now, compile the expressions that stay the same.
+  // they're studied but not JIT compiled as every JIT compiled expression
+  // reserves its own stack
+  for (std::vector<Step>::iterator step = function.steps.begin(); step != function.steps.end(); ++step)
+  {
+    if (step->hasExpression && !step->expressionReferences)
+      step->regExp.RegComp(step->expression, CRegExp::StudyRegExp);
+  }
+
+  return &function;
+}
+
+void CScraperParser::Run(std::vector<Step>& steps)
+{
+  for (std::vector<Step>::iterator step = steps.begin(); step != steps.end(); ++step)
+  {
+    std::string strInput;
+    if (step->hasInput)
+    {
+      strInput = step->input;
+      if (step->inputReferences)
+        ReplaceBuffers(strInput);
+    }
+    else
+      strInput = m_param[0];
+
+    bool bExecute = true;
+    if (step->hasConditional)
+    {
       std::string strSetting;
       if (m_scraper && m_scraper->HasSettings())
-        strSetting = m_scraper->GetSetting(szConditional);
-      bExecute = bInverse != (strSetting == "true");
+        strSetting = m_scraper->GetSetting(step->conditional);
+      bExecute = step->inverse != (strSetting == "true");
     }
 
     if (bExecute)
     {
-      if (iDest-1 < MAX_SCRAPER_BUFFERS && iDest-1 > -1)
+      if (step->dest-1 < MAX_SCRAPER_BUFFERS && step->dest-1 > -1)
       {
-        if (pReg->ValueStr() == "XSLT")
-          ParseXSLT(strInput, m_param[iDest - 1], pReg, bAppend);
+        if (step->xslt)
+          ParseXSLT(strInput, m_param[step->dest - 1], *step, step->append);
         else
-          ParseExpression(strInput, m_param[iDest - 1],pReg,bAppend);
+          ParseExpression(strInput, m_param[step->dest - 1], *step, step->append);
       }
       else
-        CLog::Log(LOGERROR,"CScraperParser::ParseNext: destination buffer "
+        CLog::Log(LOGERROR,"CScraperParser::Run: destination buffer "
                            "out of bounds, skipping expression");
     }
-    pReg = NextSiblingScraperElement(pReg);
   }
 }
 
 const std::string CScraperParser::Parse(const std::string& strTag,
                                        CScraper* scraper)
 {
-  TiXmlElement* pChildElement = m_pRootElement->FirstChildElement(strTag.c_str());
-  if(pChildElement == NULL)
+  Function* function = GetFunction(strTag);
+  if (function == NULL)
   {
     CLog::Log(LOGERROR,"%s: Could not find scraper function %s",__FUNCTION__,strTag.c_str());
     return "";
   }
-  int iResult = 1; // default to param 1
-  pChildElement->QueryIntAttribute("dest",&iResult);
-  TiXmlElement* pChildStart = FirstChildScraperElement(pChildElement);
   m_scraper = scraper;
-  ParseNext(pChildStart);
-  std::string tmp = m_param[iResult-1];
+  Run(function->steps);
+  std::string tmp = m_param[function->dest-1];
 
-  const char* szClearBuffers = pChildElement->Attribute("clearbuffers");
-  if (!szClearBuffers || stricmp(szClearBuffers,"no") != 0)
+  if (function->clearBuffers)
     ClearBuffers();
 
   return tmp;
@@ -541,8 +686,7 @@ void CScraperParser::Clean(std::string& strDirty)
 
 void CScraperParser::ConvertJSON(std::string &string)
 {
-  CRegExp reg;
-  reg.RegComp("\\\\u([0-f]{4})");
+  CRegExp& reg = m_jsonUnicode;
   while (reg.RegFind(string.c_str()) > -1)
   {
     int pos = reg.GetSubStart(1);
@@ -552,8 +696,7 @@ void CScraperParser::ConvertJSON(std::string &string)
     string.replace(string.begin()+pos-2, string.begin()+pos+4, replace);
   }
 
-  CRegExp reg2;
-  reg2.RegComp("\\\\x([0-9]{2})([^\\\\]+;)");
+  CRegExp& reg2 = m_jsonHex;
   while (reg2.RegFind(string.c_str()) > -1)
   {
     int pos1 = reg2.GetSubStart(1);
@@ -612,5 +755,64 @@ void CScraperParser::AddDocument(const CXBMCTinyXML* doc)
     m_pRootElement->InsertEndChild(*node);
     node = node->NextSibling();
   }
+
+  // functions may have been added or replaced
+  ReleaseProgram(m_program);
+  m_program = NULL;
+  if (!m_programKey.empty())
+  {
+    std::string key = GetProgramKey(doc->ValueStr());
+    m_programKey = key.empty() ? key : m_programKey + key;
+  }
+}
+
+std::string CScraperParser::GetProgramKey(const std::string& file)
+{
+  struct __stat64 buffer;
+  if (file.empty() || CFile::Stat(file, &buffer) != 0)
+    return "";
+
+  return StringUtils::Format("%s|%" PRId64"|", file.c_str(), (int64_t)buffer.st_mtime);
 }
 
+CScraperParser::Program* CScraperParser::AcquireProgram(const std::string& key)
+{
+  if (!key.empty())
+  {
+    CSingleLock lock(m_idleProgramsSection);
+    for (std::vector<Program*>::reverse_iterator it = m_idlePrograms.rbegin(); it != m_idlePrograms.rend(); ++it)
+    {
+      if ((*it)->key == key)
+      {
+        Program* program = *it;
+        m_idlePrograms.erase(--it.base());
+        return program;
+      }
+    }
+  }
+
+  Program* program = new Program;
+  program->key = key;
+  return program;
+}
+
+void CScraperParser::ReleaseProgram(Program* program)
+{
+  if (!program)
+    return;
+
+  // programs of documents that can't be told apart aren't shared
+  if (program->key.empty())
+  {
+    delete program;
+    return;
+  }
+
+  CSingleLock lock(m_idleProgramsSection);
+  m_idlePrograms.push_back(program);
+  if (m_idlePrograms.size() > MAX_IDLE_SCRAPER_PROGRAMS)
+  {
+    delete m_idlePrograms.front();
+    m_idlePrograms.erase(m_idlePrograms.begin());
+  }
+}
@@ -21,9 +21,13 @@
  *
  */
 
+#include <map>
 #include <string>
 #include <vector>
 
+#include "RegExp.h"
+#include "threads/CriticalSection.h"
+
 #define MAX_SCRAPER_BUFFERS 20
 
 namespace ADDON
@@ -58,9 +62,63 @@ public:
   std::string m_param[MAX_SCRAPER_BUFFERS];
 
 private:
+  /*! \brief A <RegExp> or <XSLT> element of a scraper function with its
+   attributes parsed and, unless it depends on the buffers or settings,
+   its expression compiled and its output prepared.
+   */
+  struct Step
+  {
+    Step();
+
+    bool xslt;
+    int dest;
+    bool append;
+    bool hasInput;
+    std::string input;
+    bool inputReferences;
+    bool hasConditional;
+    bool inverse;
+    std::string conditional;
+    std::string stylesheet;
+    bool hasExpression;
+    std::string expression;
+    bool expressionReferences;
+    std::string output;
+    bool outputReferences;
+    std::vector<std::pair<int, const char*> > tokens;
+    bool repeat;
+    bool clear;
+    int optional;
+    std::string optionalParam;
+    int compare;
+    CRegExp regExp;
+  };
+
+  /*! \brief A scraper function as the list of its steps in the order they are run */
+  struct Function
+  {
+    int dest;
+    bool clearBuffers;
+    std::vector<Step> steps;
+  };
+
+  /*! \brief The functions of a scraper compiled so far.
+   Programs are only used by one parser at a time as the compiled expressions
+   keep the state of their last match. Parsers of the same scraper pass them
+   on to each other through a pool, see AcquireProgram() and ReleaseProgram().
+   */
+  struct Program
+  {
+    std::string key;
+    std::map<std::string, Function> functions;
+  };
+
   bool LoadFromXML();
   void ReplaceBuffers(std::string& strDest);
-  void ParseExpression(const std::string& input, std::string& dest, TiXmlElement* element, bool bAppend);
+  Function* GetFunction(const std::string& strTag);
+  void Compile(TiXmlElement* element, std::vector<Step>& steps);
+  void Run(std::vector<Step>& steps);
+  void ParseExpression(const std::string& input, std::string& dest, Step& step, bool bAppend);
 
   /*! \brief Parse an 'XSLT' declaration from the scraper
    This allow us to transform an inbound XML document using XSLT
@@ -68,17 +126,24 @@ private:
    to the album loaders or similar
    \param input the input document
    \param dest the output destation for the conversion
-   \param element the current XML element
+   \param step the compiled XSLT element
    \param bAppend append or clear the buffer
    */
-  void ParseXSLT(const std::string& input, std::string& dest, TiXmlElement* element, bool bAppend);
-  void ParseNext(TiXmlElement* element);
+  void ParseXSLT(const std::string& input, std::string& dest, const Step& step, bool bAppend);
   void Clean(std::string& strDirty);
   void ConvertJSON(std::string &string);
   void ClearBuffers();
   void GetBufferParams(bool* result, const char* attribute, bool defvalue);
   void InsertToken(std::string& strOutput, int buf, const char* token);
 
+  /*! \brief Identifies the scraper files the program is compiled from
+   \param file path of a scraper file
+   \return the path and modification time of the file, empty if it can't be identified
+   */
+  static std::string GetProgramKey(const std::string& file);
+  static Program* AcquireProgram(const std::string& key);
+  static void ReleaseProgram(Program* program);
+
   CXBMCTinyXML* m_document;
   TiXmlElement* m_pRootElement;
 
@@ -87,6 +152,15 @@ private:
 
   std::string m_strFile;
   ADDON::CScraper* m_scraper;
+
+  std::string m_programKey;
+  Program* m_program;
+  CRegExp m_optionalParam;
+  CRegExp m_jsonUnicode;
+  CRegExp m_jsonHex;
+
+  static std::vector<Program*> m_idlePrograms;
+  static CCriticalSection m_idleProgramsSection;
 };
 
 #endif
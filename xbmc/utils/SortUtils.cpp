@@ -744,6 +744,49 @@ bool SortUtils::SortFromDataset(const SortDescription &sortDescription, const Me
   return true;
 }
 
+std::string SortUtils::BuildOrderClause(const SortDescription &sortDescription, const MediaType &mediaType)
+{
+  Field field;
+  switch (sortDescription.sortBy)
+  {
+    case SortByDateAdded:
+      field = FieldDateAdded;
+      break;
+    case SortByPlaycount:
+      field = FieldPlaycount;
+      break;
+    case SortByLastPlayed:
+      field = FieldLastPlayed;
+      break;
+    case SortByYear:
+      field = FieldYear;
+      break;
+    case SortByTrackNumber:
+      field = FieldTrackNumber;
+      break;
+    case SortByTime:
+      field = FieldTime;
+      break;
+    default:
+      return "";
+  }
+
+  // the video database stores these as text, only the music database can order them
+  if ((field == FieldYear || field == FieldTrackNumber || field == FieldTime) &&
+      mediaType != MediaTypeSong && mediaType != MediaTypeAlbum)
+    return "";
+
+  std::string column = DatabaseUtils::GetField(field, mediaType, DatabaseQueryPartOrderBy);
+  std::string id = DatabaseUtils::GetField(FieldId, mediaType, DatabaseQueryPartOrderBy);
+  if (column.empty() || id.empty())
+    return "";
+
+  const char *order = sortDescription.sortOrder == SortOrderDescending ? " DESC" : " ASC";
+  if (column == id)
+    return " ORDER BY " + id + order;
+  return " ORDER BY " + column + order + ", " + id + order;
+}
+
 const SortUtils::SortPreparator& SortUtils::getPreparator(SortBy sortBy)
 {
   map<SortBy, SortPreparator>::const_iterator it = m_preparators.find(sortBy);
@@ -136,6 +136,15 @@ public:
   static void Sort(const SortDescription &sortDescription, DatabaseResults& items);
   static void Sort(const SortDescription &sortDescription, SortItems& items);
   static bool SortFromDataset(const SortDescription &sortDescription, const MediaType &mediaType, const std::auto_ptr<dbiplus::Dataset> &dataset, DatabaseResults &results);
+  /*! \brief Build an ORDER BY clause letting the database do the sorting.
+   Only sort methods on a single numeric or date column are translated, as the
+   database can't reproduce the label handling of the in memory sorting. Ties
+   are ordered by id.
+   \param sortDescription the sorting to translate
+   \param mediaType the media type of the queried view
+   \return the " ORDER BY ..." clause or an empty string if the sorting can't be done by the database
+   */
+  static std::string BuildOrderClause(const SortDescription &sortDescription, const MediaType &mediaType);
   
   static const Fields& GetFieldsForSorting(SortBy sortBy);
   static std::string RemoveArticles(const std::string &label);
@@ -18,6 +18,7 @@
  *
  */
 
+#include <algorithm>
 #include <stdlib.h>
 #include <string.h>
 #include <sstream>
@@ -628,7 +629,11 @@ void CVariant::push_back(const CVariant &variant)
   }
 
   if (m_type == VariantTypeArray)
-    m_data.array->push_back(variant);
+  {
+    // copy first, variant might be one of our own elements
+    CVariant copy(variant);
+    emplace_back().swap(copy);
+  }
 }
 
 void CVariant::append(const CVariant &variant)
@@ -644,8 +649,40 @@ const char *CVariant::c_str() const
     return NULL;
 }
 
+CVariant &CVariant::emplace_back()
+{
+  if (m_type == VariantTypeNull)
+  {
+    m_type = VariantTypeArray;
+    m_data.array = new VariantArray;
+  }
+
+  if (m_type != VariantTypeArray)
+    return ConstNullVariant;
+
+  VariantArray &array = *m_data.array;
+  if (array.size() == array.capacity())
+  {
+    // std::vector would deep copy every element (with all of its children) into
+    // the new storage, swapping them over only moves the pointers
+    VariantArray grown;
+    grown.reserve(std::max<size_t>(array.capacity() * 2, 4));
+    grown.resize(array.size());
+    for (size_t i = 0; i < array.size(); i++)
+      grown[i].swap(array[i]);
+    array.swap(grown);
+  }
+
+  array.push_back(CVariant());
+  return array.back();
+}
+
 void CVariant::swap(CVariant &rhs)
 {
+  // ConstNullVariant is handed out as a read-only placeholder, keep it that way
+  if (m_type == VariantTypeConstNull || rhs.m_type == VariantTypeConstNull)
+    return;
+
   VariantType  temp_type = m_type;
   VariantUnion temp_data = m_data;
 
@@ -782,7 +819,13 @@ void CVariant::erase(unsigned int position)
   }
 
   if (m_type == VariantTypeArray && position < size())
-    m_data.array->erase(m_data.array->begin() + position);
+  {
+    // shift the following elements down by swapping rather than copying them
+    VariantArray &array = *m_data.array;
+    for (size_t i = position; i + 1 < array.size(); i++)
+      array[i].swap(array[i + 1]);
+    array.pop_back();
+  }
 }
 
 bool CVariant::isMember(const std::string &key) const
@@ -99,6 +99,13 @@ public:
 
   void push_back(const CVariant &variant);
   void append(const CVariant &variant);
+  /*!
+   \brief Appends a null element and returns it so that it can be filled in place
+
+   Together with swap() this avoids the deep copy push_back() makes, e.g.
+   result.emplace_back().swap(item) hands item over to result without copying it.
+   */
+  CVariant &emplace_back();
 
   const char *c_str() const;
 
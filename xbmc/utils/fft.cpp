@@ -174,3 +174,137 @@ void twochanwithwindow(float data[], int n)
   }
 }
 
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+CTwoChannelFFT::CTwoChannelFFT(unsigned int n)
+  : m_size(n),
+    m_window(n),
+    m_reverse(n),
+    m_twiddleRe(n),
+    m_twiddleIm(n),
+    m_re(n),
+    m_im(n)
+{
+  // the Hann window of twochanwithwindow()
+  for (unsigned int i = 0; i < n; i++)
+    m_window[i] = (float)(0.5 * (1 - cos(2 * M_PI * i / n)));
+
+  unsigned int bits = 0;
+  while ((1u << bits) < n)
+    bits++;
+  for (unsigned int i = 0; i < n; i++)
+  {
+    unsigned int reverse = 0;
+    for (unsigned int bit = 0; bit < bits; bit++)
+    {
+      if (i & (1 << bit))
+        reverse |= 1 << (bits - 1 - bit);
+    }
+    m_reverse[i] = reverse;
+  }
+
+  for (unsigned int m = 1; m < n; m <<= 1)
+  {
+    for (unsigned int k = 0; k < m; k++)
+    {
+      m_twiddleRe[m + k] = (float)cos(M_PI * k / m);
+      m_twiddleIm[m + k] = (float)sin(M_PI * k / m);
+    }
+  }
+}
+
+void CTwoChannelFFT::Calculate(const float* samples, float* spectrum)
+{
+  const unsigned int n = m_size;
+  float* re = &m_re[0];
+  float* im = &m_im[0];
+
+  // window the channels into the real and imaginary parts, in bit reversed order
+  for (unsigned int i = 0; i < n; i++)
+  {
+    unsigned int j = m_reverse[i];
+    re[j] = samples[2 * i] * m_window[i];
+    im[j] = samples[2 * i + 1] * m_window[i];
+  }
+
+  // the first two stages have no twiddles worth multiplying with
+  for (unsigned int i = 0; i < n; i += 4)
+  {
+    float r0 = re[i] + re[i + 1], r1 = re[i] - re[i + 1];
+    float i0 = im[i] + im[i + 1], i1 = im[i] - im[i + 1];
+    float r2 = re[i + 2] + re[i + 3], r3 = re[i + 2] - re[i + 3];
+    float i2 = im[i + 2] + im[i + 3], i3 = im[i + 2] - im[i + 3];
+    // r3 + i*i3 times i
+    re[i] = r0 + r2;     im[i] = i0 + i2;
+    re[i + 2] = r0 - r2; im[i + 2] = i0 - i2;
+    re[i + 1] = r1 - i3; im[i + 1] = i1 + r3;
+    re[i + 3] = r1 + i3; im[i + 3] = i1 - r3;
+  }
+
+  for (unsigned int m = 4; m < n; m <<= 1)
+  {
+    const float* wr = &m_twiddleRe[m];
+    const float* wi = &m_twiddleIm[m];
+    for (unsigned int group = 0; group < n; group += 2 * m)
+    {
+      float* ar = re + group;
+      float* ai = im + group;
+      float* br = ar + m;
+      float* bi = ai + m;
+      for (unsigned int k = 0; k < m; k += 4)
+      {
+#if defined(__SSE2__)
+        __m128 twr = _mm_loadu_ps(wr + k), twi = _mm_loadu_ps(wi + k);
+        __m128 xr = _mm_loadu_ps(br + k), xi = _mm_loadu_ps(bi + k);
+        __m128 tr = _mm_sub_ps(_mm_mul_ps(twr, xr), _mm_mul_ps(twi, xi));
+        __m128 ti = _mm_add_ps(_mm_mul_ps(twr, xi), _mm_mul_ps(twi, xr));
+        __m128 yr = _mm_loadu_ps(ar + k), yi = _mm_loadu_ps(ai + k);
+        _mm_storeu_ps(br + k, _mm_sub_ps(yr, tr));
+        _mm_storeu_ps(bi + k, _mm_sub_ps(yi, ti));
+        _mm_storeu_ps(ar + k, _mm_add_ps(yr, tr));
+        _mm_storeu_ps(ai + k, _mm_add_ps(yi, ti));
+#elif defined(__ARM_NEON__)
+        float32x4_t twr = vld1q_f32(wr + k), twi = vld1q_f32(wi + k);
+        float32x4_t xr = vld1q_f32(br + k), xi = vld1q_f32(bi + k);
+        float32x4_t tr = vmlsq_f32(vmulq_f32(twr, xr), twi, xi);
+        float32x4_t ti = vmlaq_f32(vmulq_f32(twr, xi), twi, xr);
+        float32x4_t yr = vld1q_f32(ar + k), yi = vld1q_f32(ai + k);
+        vst1q_f32(br + k, vsubq_f32(yr, tr));
+        vst1q_f32(bi + k, vsubq_f32(yi, ti));
+        vst1q_f32(ar + k, vaddq_f32(yr, tr));
+        vst1q_f32(ai + k, vaddq_f32(yi, ti));
+#else
+        for (unsigned int l = k; l < k + 4; l++)
+        {
+          float tr = wr[l] * br[l] - wi[l] * bi[l];
+          float ti = wr[l] * bi[l] + wi[l] * br[l];
+          br[l] = ar[l] - tr;
+          bi[l] = ai[l] - ti;
+          ar[l] += tr;
+          ai[l] += ti;
+        }
+#endif
+      }
+    }
+  }
+
+  // separate the channels, X(k) and X(n - k) hold both of them
+  spectrum[0] = re[0] * re[0];
+  spectrum[1] = im[0] * im[0];
+  spectrum[n] = re[n / 2] * re[n / 2];
+  spectrum[n + 1] = im[n / 2] * im[n / 2];
+  for (unsigned int k = 1; k < n / 2; k++)
+  {
+    float rep = re[k] + re[n - k];
+    float rem = re[k] - re[n - k];
+    float aip = im[k] + im[n - k];
+    float aim = im[k] - im[n - k];
+    spectrum[2 * k] = 0.5f * (rep * rep + aim * aim);
+    spectrum[2 * k + 1] = 0.5f * (rem * rem + aip * aip);
+  }
+}
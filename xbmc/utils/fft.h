@@ -25,6 +25,8 @@
  *  Arvin Schnell, Am Heidberg 8, 28865 Lilienthal, Germany
  *
  */
+#include <vector>
+
 static __inline long double sqr( long double arg )
 {
   return arg * arg;
@@ -48,5 +50,30 @@ void fft( float data[], int nn, int isign );
 void twochannelrfft(float data[], int n);
 void twochanwithwindow(float data[], int n); // test
 
+// Same result as twochanwithwindow(), for repeated transforms of one size.
+// The window, the twiddle factors and the bit reversal are computed once,
+// the transform runs on split real/imaginary arrays with SSE2 or NEON.
+class CTwoChannelFFT
+{
+public:
+  // n is the number of samples per channel and must be a power of 2, at least 8
+  CTwoChannelFFT(unsigned int n);
+
+  // samples holds n interleaved sample pairs and is left untouched. spectrum
+  // gets the squared amplitudes of both channels, interleaved, n + 2 values.
+  void Calculate(const float* samples, float* spectrum);
+
+  unsigned int GetSize() const { return m_size; }
+
+private:
+  unsigned int m_size;
+  std::vector<float> m_window;
+  std::vector<unsigned int> m_reverse;
+  std::vector<float> m_twiddleRe;   // for the stage with half size m at [m, 2m)
+  std::vector<float> m_twiddleIm;
+  std::vector<float> m_re;
+  std::vector<float> m_im;
+};
+
 
 #endif
@@ -0,0 +1,256 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/ActorProtocol.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+
+#define TEST_ROUNDTRIPS 20000
+#define TEST_SYNC_INTERVAL 64
+
+using namespace Actor;
+
+// signals as used between an ActiveAE stream and the engine
+enum
+{
+  STREAMSAMPLE = 0,
+  STREAMBUFFER,
+  DRAINSTREAM,
+  ACC,
+};
+
+struct TestSample
+{
+  void *buffer;
+  void *stream;
+};
+
+// plays the engine: takes samples from the stream and hands back buffers
+class CTestEngine : public CThread
+{
+public:
+  CTestEngine(Protocol &port, CEvent &outEvent)
+    : CThread("TestEngine"), m_port(port), m_outEvent(outEvent) {}
+
+protected:
+  virtual void Process()
+  {
+    Message *msg;
+    while (!m_bStop)
+    {
+      if (!m_port.ReceiveOutMessage(&msg))
+      {
+        m_outEvent.WaitMSec(10);
+        continue;
+      }
+
+      if (msg->signal == STREAMSAMPLE)
+      {
+        TestSample *sample = (TestSample*)msg->data;
+        m_port.SendInMessage(STREAMBUFFER, &sample->buffer, sizeof(sample->buffer));
+      }
+      else if (msg->signal == DRAINSTREAM)
+        msg->Reply(ACC);
+      msg->Release();
+    }
+  }
+
+  Protocol &m_port;
+  CEvent &m_outEvent;
+};
+
+// a receiver still busy with a message while its port goes away
+class CTestHolder : public CThread
+{
+public:
+  CTestHolder(Message *msg) : CThread("TestHolder"), m_msg(msg) {}
+
+protected:
+  virtual void Process()
+  {
+    Sleep(100);
+    m_msg->signal = ACC;
+    m_msg->Release();
+  }
+
+  Message *m_msg;
+};
+
+class TestActorProtocol : public testing::Test
+{
+protected:
+  TestActorProtocol() : m_port("TestPort", &m_inEvent, &m_outEvent) {}
+
+  CEvent m_inEvent;
+  CEvent m_outEvent;
+  Protocol m_port;
+};
+
+TEST_F(TestActorProtocol, Order)
+{
+  for (int i = 0; i < 100; i++)
+    m_port.SendOutMessage(i, &i, sizeof(i));
+
+  Message *msg;
+  for (int i = 0; i < 100; i++)
+  {
+    ASSERT_TRUE(m_port.ReceiveOutMessage(&msg));
+    EXPECT_EQ(i, msg->signal);
+    EXPECT_EQ(i, *(int*)msg->data);
+    msg->Release();
+  }
+  EXPECT_FALSE(m_port.ReceiveOutMessage(&msg));
+  EXPECT_FALSE(m_port.ReceiveInMessage(&msg));
+}
+
+TEST_F(TestActorProtocol, Payload)
+{
+  uint8_t large[MSG_INTERNAL_BUFFER_SIZE * 4];
+  for (unsigned int i = 0; i < sizeof(large); i++)
+    large[i] = i;
+
+  Message *msg;
+  m_port.SendInMessage(STREAMBUFFER, large, sizeof(large));
+  ASSERT_TRUE(m_port.ReceiveInMessage(&msg));
+  EXPECT_EQ(0, memcmp(large, msg->data, sizeof(large)));
+  uint8_t *data = msg->data;
+  msg->Release();
+
+  // the recycled message keeps its buffer for the next large payload
+  m_port.SendInMessage(STREAMBUFFER, large, sizeof(large) / 2);
+  ASSERT_TRUE(m_port.ReceiveInMessage(&msg));
+  EXPECT_EQ(data, msg->data);
+  EXPECT_EQ(0, memcmp(large, msg->data, sizeof(large) / 2));
+  msg->Release();
+
+  // small payloads still live in the message itself
+  m_port.SendInMessage(STREAMBUFFER, large, MSG_INTERNAL_BUFFER_SIZE);
+  ASSERT_TRUE(m_port.ReceiveInMessage(&msg));
+  EXPECT_EQ(msg->buffer, msg->data);
+  msg->Release();
+}
+
+TEST_F(TestActorProtocol, Purge)
+{
+  for (int i = 0; i < 10; i++)
+    m_port.SendOutMessage(i % 2 ? STREAMSAMPLE : STREAMBUFFER);
+  m_port.PurgeOut(STREAMSAMPLE);
+  m_port.SendOutMessage(DRAINSTREAM);
+
+  Message *msg;
+  for (int i = 0; i < 5; i++)
+  {
+    ASSERT_TRUE(m_port.ReceiveOutMessage(&msg));
+    EXPECT_EQ(STREAMBUFFER, msg->signal);
+    msg->Release();
+  }
+  ASSERT_TRUE(m_port.ReceiveOutMessage(&msg));
+  EXPECT_EQ(DRAINSTREAM, msg->signal);
+  msg->Release();
+
+  m_port.SendOutMessage(STREAMSAMPLE);
+  m_port.DeferOut(true);
+  EXPECT_FALSE(m_port.ReceiveOutMessage(&msg));
+  m_port.DeferOut(false);
+  m_port.Purge();
+  EXPECT_FALSE(m_port.ReceiveOutMessage(&msg));
+}
+
+TEST_F(TestActorProtocol, Sync)
+{
+  CTestEngine engine(m_port, m_outEvent);
+  engine.Create();
+
+  Message *reply;
+  ASSERT_TRUE(m_port.SendOutMessageSync(DRAINSTREAM, &reply, 1000));
+  EXPECT_EQ(ACC, reply->signal);
+  reply->Release();
+
+  engine.StopThread();
+}
+
+TEST(TestActorProtocolLifetime, HeldMessage)
+{
+  CEvent inEvent, outEvent;
+  Protocol *port = new Protocol("TestPort", &inEvent, &outEvent);
+  port->SendOutMessage(STREAMSAMPLE);
+  port->SendOutMessage(DRAINSTREAM);
+  port->DeferOut(true);
+  port->SendInMessage(STREAMBUFFER);
+
+  Message *msg;
+  port->DeferOut(false);
+  ASSERT_TRUE(port->ReceiveOutMessage(&msg));
+  port->DeferOut(true);
+  CTestHolder holder(msg);
+  holder.Create();
+
+  // the queued messages are dropped even though out is deferred, the held
+  // one is waited for instead of freed while the holder still writes to it
+  int64_t start = CurrentHostCounter();
+  delete port;
+  EXPECT_GE((CurrentHostCounter() - start) * 1000 / CurrentHostFrequency(), 50);
+
+  holder.StopThread();
+}
+
+// times handing buffers to the engine the way a stream does, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestActorProtocol.*
+TEST_F(TestActorProtocol, DISABLED_Benchmark)
+{
+  CTestEngine engine(m_port, m_outEvent);
+  engine.Create();
+
+  // the stream hands over a full buffer and waits for an empty one,
+  // draining now and then, like CActiveAEStream::AddData()
+  int64_t async = 0, sync = 0;
+  int syncCount = 0;
+  TestSample sample = { &sample, this };
+  for (int i = 0; i < TEST_ROUNDTRIPS; i++)
+  {
+    Message *msg;
+    int64_t start = CurrentHostCounter();
+    if (i % TEST_SYNC_INTERVAL)
+    {
+      m_port.SendOutMessage(STREAMSAMPLE, &sample, sizeof(sample));
+      while (!m_port.ReceiveInMessage(&msg))
+        ASSERT_TRUE(m_inEvent.WaitMSec(1000));
+      EXPECT_EQ(STREAMBUFFER, msg->signal);
+      async += CurrentHostCounter() - start;
+    }
+    else
+    {
+      ASSERT_TRUE(m_port.SendOutMessageSync(DRAINSTREAM, &msg, 1000));
+      sync += CurrentHostCounter() - start;
+      syncCount++;
+    }
+    msg->Release();
+  }
+
+  engine.StopThread();
+
+  double frequency = (double)CurrentHostFrequency();
+  std::cout << "Actor message round trip: async "
+            << async * 1000000.0 / frequency / (TEST_ROUNDTRIPS - syncCount) << " us, sync "
+            << sync * 1000000.0 / frequency / syncCount << " us" << std::endl;
+}
@@ -0,0 +1,205 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/JSONStreamWriter.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+
+#define BENCHMARK_SONGS 20000
+
+/* keeps track of how the output arrives instead of keeping it */
+class CMeasuringOutput : public IJSONStreamOutput
+{
+public:
+  CMeasuringOutput(int64_t start, bool fail = false)
+    : m_start(start), m_firstByte(0), m_chunks(0), m_largestChunk(0), m_total(0), m_fail(fail)
+  { }
+
+  virtual bool Write(const char *data, size_t size)
+  {
+    if (m_fail)
+      return false;
+    if (m_chunks++ == 0)
+      m_firstByte = CurrentHostCounter() - m_start;
+    m_largestChunk = std::max(m_largestChunk, size);
+    m_total += size;
+    return true;
+  }
+
+  int64_t m_start;
+  int64_t m_firstByte;
+  size_t m_chunks;
+  size_t m_largestChunk;
+  size_t m_total;
+  bool m_fail;
+};
+
+/* roughly what AudioLibrary.GetSongs returns for a song with a dozen properties */
+static void GetSong(int id, CVariant &song)
+{
+  song["songid"] = id;
+  song["label"] = StringUtils::Format("Song number %d", id);
+  song["title"] = StringUtils::Format("Song number %d", id);
+  song["artist"].push_back(StringUtils::Format("Artist %d", id / 100));
+  song["albumartist"].push_back(StringUtils::Format("Artist %d", id / 100));
+  song["album"] = StringUtils::Format("Album %d", id / 10);
+  song["genre"].push_back("Rock");
+  song["genre"].push_back("Pop");
+  song["year"] = 1970 + id % 45;
+  song["track"] = id % 10 + 1;
+  song["duration"] = 180 + id % 120;
+  song["rating"] = (id % 6) * 1.0;
+  song["playcount"] = id % 7;
+  song["file"] = StringUtils::Format("/storage/music/Artist %d/Album %d/%02d - Song number %d.flac", id / 100, id / 10, id % 10 + 1, id);
+  song["thumbnail"] = StringUtils::Format("image://music@%2fstorage%2fmusic%2fArtist%20%d%2fAlbum%20%d%2fcover.jpg/", id / 100, id / 10);
+  song["fanart"] = "";
+}
+
+TEST(TestJSONStreamWriter, MatchesVariantWriter)
+{
+  CVariant songs(CVariant::VariantTypeArray);
+  for (int i = 0; i < 100; i++)
+  {
+    CVariant song;
+    GetSong(i, song);
+    songs.push_back(song);
+  }
+  CVariant result;
+  result["limits"]["start"] = 0;
+  result["limits"]["end"] = 100;
+  result["limits"]["total"] = 100;
+  result["songs"] = songs;
+
+  for (int compact = 0; compact < 2; compact++)
+  {
+    std::string output;
+    CJSONStringOutput stringOutput(output);
+    // a tiny chunk size so that the output is passed on while the document is still open
+    CJSONStreamWriter writer(stringOutput, compact != 0, 64);
+    EXPECT_TRUE(writer.BeginObject());
+    EXPECT_TRUE(writer.Key("limits"));
+    EXPECT_TRUE(writer.Value(result["limits"]));
+    EXPECT_TRUE(writer.Key("songs"));
+    EXPECT_TRUE(writer.BeginArray());
+    for (CVariant::const_iterator_array song = songs.begin_array(); song != songs.end_array(); ++song)
+      EXPECT_TRUE(writer.Value(*song));
+    EXPECT_TRUE(writer.EndArray());
+    EXPECT_TRUE(writer.EndObject());
+    EXPECT_TRUE(writer.Flush());
+
+    EXPECT_EQ(CJSONVariantWriter::Write(result, compact != 0), output);
+    EXPECT_EQ(output.size(), writer.GetBytesWritten());
+  }
+}
+
+TEST(TestJSONStreamWriter, Chunks)
+{
+  CMeasuringOutput output(CurrentHostCounter());
+  CJSONStreamWriter writer(output, true, 1024);
+  EXPECT_TRUE(writer.BeginArray());
+  for (int i = 0; i < 1000; i++)
+  {
+    CVariant song;
+    GetSong(i, song);
+    EXPECT_TRUE(writer.Value(song));
+  }
+  EXPECT_TRUE(writer.EndArray());
+  EXPECT_TRUE(writer.Flush());
+
+  // nothing is held back for much longer than a chunk takes
+  EXPECT_GT(output.m_chunks, 100u);
+  EXPECT_LT(output.m_largestChunk, 2048u);
+  EXPECT_EQ(output.m_total, writer.GetBytesWritten());
+}
+
+TEST(TestJSONStreamWriter, OutputFailure)
+{
+  CMeasuringOutput output(CurrentHostCounter(), true);
+  CJSONStreamWriter writer(output, true, 16);
+  EXPECT_TRUE(writer.BeginArray());
+  EXPECT_FALSE(writer.Value(CVariant("a string that is longer than a chunk")));
+  EXPECT_TRUE(writer.HasFailed());
+  EXPECT_FALSE(writer.EndArray());
+  EXPECT_FALSE(writer.Flush());
+  EXPECT_EQ(0u, writer.GetBytesWritten());
+}
+
+// 20000 songs, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestJSONStreamWriter.*
+TEST(TestJSONStreamWriter, DISABLED_Benchmark)
+{
+  double frequency = (double)CurrentHostFrequency();
+
+  // the way responses used to be built: the whole list as CVariant, then as string
+  int64_t start = CurrentHostCounter();
+  {
+    CVariant result;
+    result["limits"]["start"] = 0;
+    result["limits"]["end"] = BENCHMARK_SONGS;
+    result["limits"]["total"] = BENCHMARK_SONGS;
+    for (int i = 0; i < BENCHMARK_SONGS; i++)
+    {
+      CVariant song;
+      GetSong(i, song);
+      result["songs"].push_back(song);
+    }
+    std::string output = CJSONVariantWriter::Write(result, true);
+    int64_t buffered = CurrentHostCounter() - start;
+
+    std::cout << "JSON buffered: " << BENCHMARK_SONGS << " songs, " << output.size() / 1024
+              << " KiB held at once, first byte after " << buffered * 1000.0 / frequency << " ms" << std::endl;
+  }
+
+  // streamed: one song at a time, passed on in chunks
+  start = CurrentHostCounter();
+  CMeasuringOutput output(start);
+  CJSONStreamWriter writer(output, true);
+  writer.BeginObject();
+  writer.Key("limits");
+  CVariant limits;
+  limits["start"] = 0;
+  limits["end"] = BENCHMARK_SONGS;
+  limits["total"] = BENCHMARK_SONGS;
+  writer.Value(limits);
+  writer.Key("songs");
+  writer.BeginArray();
+  for (int i = 0; i < BENCHMARK_SONGS; i++)
+  {
+    CVariant song;
+    GetSong(i, song);
+    writer.Value(song);
+  }
+  writer.EndArray();
+  writer.EndObject();
+  EXPECT_TRUE(writer.Flush());
+  int64_t streamed = CurrentHostCounter() - start;
+
+  std::cout << "JSON streamed: " << BENCHMARK_SONGS << " songs, " << output.m_largestChunk / 1024
+            << " KiB held at once, first byte after " << output.m_firstByte * 1000.0 / frequency
+            << " ms, complete after " << streamed * 1000.0 / frequency << " ms" << std::endl;
+
+  EXPECT_LT(output.m_largestChunk, output.m_total / 100);
+}
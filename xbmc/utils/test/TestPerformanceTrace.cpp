@@ -0,0 +1,156 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/PerformanceTrace.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/Variant.h"
+#include "threads/Thread.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+
+static CVariant GetTrace()
+{
+  std::string json = CPerformanceTrace::GetJSON();
+  return CJSONVariantParser::Parse((const unsigned char*)json.c_str(), json.size());
+}
+
+// number of complete events named name in the trace and the thread they were on
+static int CountEvents(const CVariant &trace, const std::string &name, int *tid = NULL)
+{
+  int count = 0;
+  const CVariant &events = trace["traceEvents"];
+  for (CVariant::const_iterator_array it = events.begin_array(); it != events.end_array(); ++it)
+  {
+    if ((*it)["ph"].asString() == "X" && (*it)["name"].asString() == name)
+    {
+      if (tid)
+        *tid = (int)(*it)["tid"].asInteger();
+      count++;
+    }
+  }
+  return count;
+}
+
+class TraceThread : public CThread
+{
+public:
+  TraceThread(const char *event = "TraceThread::Process") : CThread("TraceThread"), m_event(event) {}
+protected:
+  virtual void Process()
+  {
+    TRACE_SCOPE(m_event);
+  }
+  const char *m_event;
+};
+
+TEST(TestPerformanceTrace, Disabled)
+{
+  CPerformanceTrace::Start();
+  CPerformanceTrace::Stop();
+  {
+    TRACE_SCOPE("TestPerformanceTrace.Disabled");
+  }
+  EXPECT_EQ(0, CountEvents(GetTrace(), "TestPerformanceTrace.Disabled"));
+}
+
+TEST(TestPerformanceTrace, Events)
+{
+  CPerformanceTrace::Start();
+  {
+    TRACE_SCOPE("TestPerformanceTrace \"Events\"");
+  }
+  TraceThread thread;
+  thread.Create();
+  thread.StopThread();
+  CPerformanceTrace::Stop();
+
+  CVariant trace = GetTrace();
+  ASSERT_TRUE(trace.isObject());
+  int mainThread = 0, otherThread = 0;
+  EXPECT_EQ(1, CountEvents(trace, "TestPerformanceTrace \"Events\"", &mainThread));
+  EXPECT_EQ(1, CountEvents(trace, "TraceThread::Process", &otherThread));
+  EXPECT_NE(mainThread, otherThread);
+
+  // a new recording forgets the old events
+  CPerformanceTrace::Start();
+  CPerformanceTrace::Stop();
+  EXPECT_EQ(0, CountEvents(GetTrace(), "TraceThread::Process"));
+}
+
+TEST(TestPerformanceTrace, ShortLivedThreads)
+{
+  // far more threads than there are buffers, one after the other
+  CPerformanceTrace::Start();
+  for (int i = 0; i < 300; i++)
+  {
+    TraceThread thread;
+    thread.Create();
+    thread.StopThread();
+  }
+  TraceThread last("TestPerformanceTrace.ShortLivedThreads");
+  last.Create();
+  last.StopThread();
+  CPerformanceTrace::Stop();
+
+  // the buffers of the threads that exited were given to the new ones
+  EXPECT_EQ(1, CountEvents(GetTrace(), "TestPerformanceTrace.ShortLivedThreads"));
+}
+
+TEST(TestPerformanceTrace, Overflow)
+{
+  CPerformanceTrace::Start();
+  for (int i = 0; i < 100000; i++)
+  {
+    TRACE_SCOPE(i < 50000 ? "TestPerformanceTrace.Old" : "TestPerformanceTrace.New");
+  }
+  CPerformanceTrace::Stop();
+
+  // only the most recent events of the thread are kept
+  CVariant trace = GetTrace();
+  EXPECT_EQ(0, CountEvents(trace, "TestPerformanceTrace.Old"));
+  EXPECT_GT(CountEvents(trace, "TestPerformanceTrace.New"), 0);
+}
+
+// times trace scopes with tracing off and on, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestPerformanceTrace.*
+TEST(TestPerformanceTrace, DISABLED_Overhead)
+{
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < 100000; i++)
+  {
+    TRACE_SCOPE("TestPerformanceTrace.Overhead");
+  }
+  int64_t disabled = CurrentHostCounter() - start;
+
+  CPerformanceTrace::Start();
+  start = CurrentHostCounter();
+  for (int i = 0; i < 100000; i++)
+  {
+    TRACE_SCOPE("TestPerformanceTrace.Overhead");
+  }
+  int64_t enabled = CurrentHostCounter() - start;
+  CPerformanceTrace::Stop();
+
+  double frequency = (double)CurrentHostFrequency();
+  std::cout << "Trace scope cost: disabled " << disabled * 1000000000.0 / frequency / 100000
+            << " ns, enabled " << enabled * 1000000000.0 / frequency / 100000 << " ns" << std::endl;
+}
@@ -0,0 +1,202 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/RandomSampler.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+#include <memory>
+
+#define TEST_SONGS    200000
+#define TEST_PICKS    20
+#define TEST_HISTORY  200
+
+static std::vector<int> GetIds(int count)
+{
+  std::vector<int> ids;
+  for (int i = 1; i <= count; i++)
+    ids.push_back(i);
+  return ids;
+}
+
+TEST(TestRandomSampler, Empty)
+{
+  CRandomSampler sampler(1);
+  int id;
+  EXPECT_TRUE(sampler.IsEmpty());
+  EXPECT_FALSE(sampler.Next(id));
+
+  sampler.Reset(GetIds(1));
+  EXPECT_TRUE(sampler.Next(id));
+  EXPECT_EQ(1, id);
+  sampler.Remove(1);
+  EXPECT_FALSE(sampler.Next(id));
+}
+
+TEST(TestRandomSampler, Cycle)
+{
+  CRandomSampler sampler(1234);
+  sampler.Reset(GetIds(100));
+
+  // every id comes up once per round
+  for (int round = 0; round < 3; round++)
+  {
+    std::set<int> seen;
+    for (int i = 0; i < 100; i++)
+    {
+      int id;
+      ASSERT_TRUE(sampler.Next(id));
+      EXPECT_TRUE(seen.insert(id).second);
+    }
+    EXPECT_EQ(1, *seen.begin());
+    EXPECT_EQ(100, *seen.rbegin());
+  }
+}
+
+TEST(TestRandomSampler, Recent)
+{
+  CRandomSampler sampler(42);
+  std::vector<int> ids = GetIds(10);
+  sampler.Reset(ids);
+
+  std::set<int> recent(ids.begin(), ids.begin() + 9);
+  for (int i = 0; i < 20; i++)
+  {
+    int id;
+    ASSERT_TRUE(sampler.Next(id, recent));
+    EXPECT_EQ(10, id);
+  }
+
+  // with nothing else left, a recent id is better than none
+  recent.insert(10);
+  int id;
+  EXPECT_TRUE(sampler.Next(id, recent));
+}
+
+TEST(TestRandomSampler, Remove)
+{
+  CRandomSampler sampler(7);
+  sampler.Reset(GetIds(20));
+
+  std::set<int> seen;
+  for (int i = 0; i < 10; i++)
+  {
+    int id;
+    ASSERT_TRUE(sampler.Next(id));
+    seen.insert(id);
+  }
+  // take out a drawn and an undrawn id, the rest of the round is still complete
+  int drawn = *seen.begin();
+  int undrawn = 1;
+  while (seen.find(undrawn) != seen.end())
+    undrawn++;
+  sampler.Remove(drawn);
+  sampler.Remove(undrawn);
+  seen.erase(drawn);
+  EXPECT_EQ(18U, sampler.Size());
+
+  for (int i = 0; i < 9; i++)
+  {
+    int id;
+    ASSERT_TRUE(sampler.Next(id));
+    EXPECT_NE(drawn, id);
+    EXPECT_NE(undrawn, id);
+    EXPECT_TRUE(seen.insert(id).second);
+  }
+  EXPECT_EQ(18U, seen.size());
+}
+
+// builds a database of TEST_SONGS songs, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestRandomSampler.*
+TEST(TestRandomSampler, DISABLED_Benchmark)
+{
+  // a synthetic library with the filter and history of a running party mode
+  std::string path = CSpecialProtocol::TranslatePath("special://temp/");
+  dbiplus::SqliteDatabase db;
+  db.setHostName(path.c_str());
+  db.setDatabase("TestRandomSampler.db");
+  ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+  std::auto_ptr<dbiplus::Dataset> ds(db.CreateDataset());
+
+  ds->exec("CREATE TABLE digit (i integer)");
+  for (int i = 0; i < 10; i++)
+    ds->exec(StringUtils::Format("INSERT INTO digit VALUES (%i)", i));
+  ds->exec("CREATE TABLE song (idSong integer primary key, strTitle text, iYear integer, iTimesPlayed integer, idAlbum integer)");
+  db.start_transaction();
+  ds->exec("INSERT INTO song SELECT a.i + 10 * b.i + 100 * c.i + 1000 * d.i + 10000 * e.i + 100000 * f.i + 1, "
+           "'Song', 1950 + (a.i + 10 * b.i) % 70, c.i, 10 * d.i + e.i FROM digit a, digit b, digit c, digit d, digit e, digit f "
+           "WHERE f.i < 2");
+  db.commit_transaction();
+
+  std::string filter = "iYear >= 1980 AND iTimesPlayed < 8";
+  std::set<int> recent;
+  std::vector<std::string> history;
+  for (int i = 0; i < TEST_HISTORY; i++)
+  {
+    recent.insert(i * 7 + 1);
+    history.push_back(StringUtils::Format("%i", i * 7 + 1));
+  }
+  std::string historyWhere = " AND idSong NOT IN (" + StringUtils::Join(history, ",") + ")";
+
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < TEST_PICKS; i++)
+  {
+    ds->query("SELECT * FROM song WHERE " + filter + historyWhere + " ORDER BY RANDOM() LIMIT 1");
+    EXPECT_EQ(1, ds->num_rows());
+  }
+  int64_t ordered = CurrentHostCounter() - start;
+
+  start = CurrentHostCounter();
+  std::vector<int> ids;
+  ds->query("SELECT idSong FROM song WHERE " + filter);
+  while (!ds->eof())
+  {
+    ids.push_back(ds->fv(0).get_asInt());
+    ds->next();
+  }
+  CRandomSampler sampler;
+  sampler.Reset(ids);
+  int64_t load = CurrentHostCounter() - start;
+
+  start = CurrentHostCounter();
+  for (int i = 0; i < TEST_PICKS; i++)
+  {
+    int id;
+    ASSERT_TRUE(sampler.Next(id, recent));
+    ds->query(StringUtils::Format("SELECT * FROM song WHERE idSong = %i", id));
+    EXPECT_EQ(1, ds->num_rows());
+  }
+  int64_t sampled = CurrentHostCounter() - start;
+  ds->close();
+  db.disconnect();
+  XFILE::CFile::Delete(path + "TestRandomSampler.db");
+
+  double frequency = (double)CurrentHostFrequency();
+  std::cout << "Random song out of " << ids.size() << ": ORDER BY RANDOM() "
+            << ordered * 1000.0 / frequency / TEST_PICKS << " ms, sampler "
+            << sampled * 1000.0 / frequency / TEST_PICKS << " ms (loading ids "
+            << load * 1000.0 / frequency << " ms)" << std::endl;
+}
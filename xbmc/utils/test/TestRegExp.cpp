@@ -134,6 +134,31 @@ TEST(TestRegExp, operatorEqual)
   EXPECT_STREQ("string", match.c_str());
 }
 
+TEST(TestRegExp, operatorEqualOptions)
+{
+  CRegExp regexcopy;
+
+  // options are taken over even if nothing has been compiled yet
+  regexcopy = CRegExp(true);
+  EXPECT_TRUE(regexcopy.RegComp("^test"));
+  EXPECT_EQ(0, regexcopy.RegFind("Test string."));
+}
+
+TEST(TestRegExp, ClearMatch)
+{
+  CRegExp regex;
+
+  EXPECT_TRUE(regex.RegComp("^(Test)\\s*(.*)\\.", CRegExp::StudyRegExp));
+  EXPECT_EQ(0, regex.RegFind("Test string."));
+  EXPECT_EQ(12, regex.GetFindLen());
+  regex.ClearMatch();
+  EXPECT_EQ(0, regex.GetFindLen());
+  EXPECT_STREQ("", regex.GetMatch(1).c_str());
+  EXPECT_TRUE(regex.IsCompiled());
+  EXPECT_EQ(0, regex.RegFind("Test again."));
+  EXPECT_STREQ("again", regex.GetMatch(2).c_str());
+}
+
 class TestRegExpLog : public testing::Test
 {
 protected:
@@ -19,11 +19,18 @@
  */
 
 #include "utils/ScraperParser.h"
+#include "filesystem/File.h"
+#include "utils/TimeUtils.h"
+#include "utils/XBMCTinyXML.h"
 
 #include "test/TestUtils.h"
 
 #include "gtest/gtest.h"
 
+#include <iostream>
+
+#define BENCHMARK_MOVIES 50
+
 TEST(TestScraperParser, General)
 {
   CScraperParser a;
@@ -37,3 +44,129 @@ TEST(TestScraperParser, General)
     a.GetFilename().c_str());
   EXPECT_STREQ("UTF-8", a.GetSearchStringEncoding().c_str());
 }
+
+static std::string LoadFixture(const std::string& name)
+{
+  XFILE::CFile file;
+  XFILE::auto_buffer buffer;
+  if (file.LoadFile(XBMC_REF_FILE_PATH("/xbmc/utils/test/" + name), buffer) <= 0)
+    return "";
+  return std::string(buffer.get(), buffer.size());
+}
+
+/* what CScraper::Load() does for the bundled movie scraper */
+static bool LoadScraper(CScraperParser& parser)
+{
+  CXBMCTinyXML common;
+  if (!parser.Load(XBMC_REF_FILE_PATH("/addons/metadata.themoviedb.org/tmdb.xml")) ||
+      !common.LoadFile(XBMC_REF_FILE_PATH("/addons/metadata.common.themoviedb.org/tmdb.xml")))
+    return false;
+  parser.AddDocument(&common);
+  return true;
+}
+
+/* replays the responses of a movie lookup, the way CScraper passes them on */
+class CRecordedMovie
+{
+public:
+  CRecordedMovie()
+    : m_search(LoadFixture("ScraperParser-tmdb-search.json")),
+      m_movie(LoadFixture("ScraperParser-tmdb-movie.json")),
+      m_casts(LoadFixture("ScraperParser-tmdb-casts.json"))
+  { }
+
+  void Scrape(CScraperParser& parser, std::vector<std::string>& results)
+  {
+    Run(parser, "GetSearchResults", m_search, results);
+    Run(parser, "GetDetails", m_movie, results);
+    Run(parser, "ParseTMDBPlot", m_movie, results);
+    Run(parser, "ParseTMDBGenres", m_movie, results);
+    Run(parser, "ParseTMDBStudio", m_movie, results);
+    Run(parser, "ParseTMDBRating", m_movie, results);
+    // keeps the base url in $$20 for the cast
+    Run(parser, "ParseTMDBBaseImageURL", "{\"images\":{\"base_url\":\"http://image.tmdb.org/t/p/\",\"secure_base_url\":\"https://image.tmdb.org/t/p/\"}}", results);
+    Run(parser, "ParseTMDBCast", m_casts, results);
+    Run(parser, "ParseTMDBDirectors", m_casts, results);
+    Run(parser, "ParseTMDBWriters", m_casts, results);
+  }
+
+  bool IsLoaded() const
+  {
+    return !m_search.empty() && !m_movie.empty() && !m_casts.empty();
+  }
+
+private:
+  void Run(CScraperParser& parser, const std::string& function, const std::string& response, std::vector<std::string>& results)
+  {
+    parser.m_param[0] = response;
+    parser.m_param[1] = "603";
+    results.push_back(parser.Parse(function, NULL));
+  }
+
+  std::string m_search;
+  std::string m_movie;
+  std::string m_casts;
+};
+
+TEST(TestScraperParser, RecordedMovie)
+{
+  CRecordedMovie movie;
+  ASSERT_TRUE(movie.IsLoaded());
+
+  CScraperParser parser;
+  ASSERT_TRUE(LoadScraper(parser));
+  std::vector<std::string> results;
+  movie.Scrape(parser, results);
+
+  EXPECT_NE(std::string::npos, results[0].find("<title>The Matrix</title><id>603</id><year>1999</year>"));
+  EXPECT_NE(std::string::npos, results[0].find("<title>The Matrix Revolutions</title><id>605</id><year>2003</year>"));
+  EXPECT_NE(std::string::npos, results[1].find("<id>tt0133093</id>"));
+  EXPECT_NE(std::string::npos, results[1].find("<year>1999</year>"));
+  EXPECT_NE(std::string::npos, results[1].find("<runtime>136</runtime>"));
+  EXPECT_NE(std::string::npos, results[2].find("known as \"Neo\"."));
+  EXPECT_NE(std::string::npos, results[3].find("<genre>Action</genre><genre>Science Fiction</genre>"));
+  EXPECT_NE(std::string::npos, results[5].find("<rating>7.6</rating><votes>5120</votes>"));
+  EXPECT_NE(std::string::npos, results[7].find("<actor><name>Keanu Reeves</name><role>Neo</role><order>0</order><thumb>http://image.tmdb.org/t/p/original/id1qIb7cZs2eQno90KsKwG8VLGN.jpg</thumb></actor>"));
+  EXPECT_NE(std::string::npos, results[7].find("<actor><name>Julian Arahanga</name><role>Apoc</role><order>7</order></actor>"));
+  EXPECT_NE(std::string::npos, results[8].find("<director>Andy Wachowski</director>"));
+
+  // the next parser of the scraper gets the compiled program and has to come to the same results
+  CScraperParser next;
+  ASSERT_TRUE(LoadScraper(next));
+  std::vector<std::string> nextResults;
+  movie.Scrape(next, nextResults);
+  EXPECT_EQ(results, nextResults);
+
+  // and so does a copy
+  CScraperParser copy(next);
+  nextResults.clear();
+  movie.Scrape(copy, nextResults);
+  EXPECT_EQ(results, nextResults);
+}
+
+// 50 movies, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestScraperParser.*
+TEST(TestScraperParser, DISABLED_Benchmark)
+{
+  CRecordedMovie movie;
+  ASSERT_TRUE(movie.IsLoaded());
+
+  double frequency = (double)CurrentHostFrequency();
+  int64_t parsing = 0;
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < BENCHMARK_MOVIES; i++)
+  {
+    // every movie of a library scan gets its own copy of the scraper
+    CScraperParser parser;
+    ASSERT_TRUE(LoadScraper(parser));
+    std::vector<std::string> results;
+    int64_t parseStart = CurrentHostCounter();
+    movie.Scrape(parser, results);
+    parsing += CurrentHostCounter() - parseStart;
+  }
+  int64_t total = CurrentHostCounter() - start;
+
+  std::cout << "Scraper: " << BENCHMARK_MOVIES << " movies, " << parsing * 1000.0 / frequency / BENCHMARK_MOVIES
+            << " ms parsing and " << total * 1000.0 / frequency / BENCHMARK_MOVIES
+            << " ms including loading the scraper per movie" << std::endl;
+}
@@ -131,3 +131,26 @@ TEST(TestSortUtils, GetFieldsForSorting)
   EXPECT_EQ(FieldTrackNumber, *it);
   EXPECT_EQ((unsigned int)4, fields.size());
 }
+
+TEST(TestSortUtils, BuildOrderClause)
+{
+  SortDescription desc;
+  desc.sortBy = SortByYear;
+  EXPECT_STREQ(" ORDER BY songview.iYear ASC, songview.idSong ASC",
+               SortUtils::BuildOrderClause(desc, MediaTypeSong).c_str());
+
+  desc.sortBy = SortByDateAdded;
+  desc.sortOrder = SortOrderDescending;
+  EXPECT_STREQ(" ORDER BY songview.idSong DESC",
+               SortUtils::BuildOrderClause(desc, MediaTypeSong).c_str());
+  EXPECT_STREQ(" ORDER BY movie_view.dateAdded DESC, movie_view.idMovie DESC",
+               SortUtils::BuildOrderClause(desc, MediaTypeMovie).c_str());
+
+  // the year of videos is stored as text and labels need sorting in memory
+  desc.sortBy = SortByYear;
+  EXPECT_TRUE(SortUtils::BuildOrderClause(desc, MediaTypeMovie).empty());
+  desc.sortBy = SortByLabel;
+  EXPECT_TRUE(SortUtils::BuildOrderClause(desc, MediaTypeSong).empty());
+  desc.sortBy = SortByNone;
+  EXPECT_TRUE(SortUtils::BuildOrderClause(desc, MediaTypeSong).empty());
+}
@@ -18,10 +18,18 @@
  *
  */
 
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/Variant.h"
 
 #include "gtest/gtest.h"
 
+#include <iostream>
+
+#define BENCHMARK_ITEMS 20000
+
 TEST(TestVariant, VariantTypeInteger)
 {
   CVariant a((int)0), b((int64_t)1);
@@ -348,3 +356,100 @@ TEST(TestVariant, isMember)
   EXPECT_TRUE(a.isMember("key1"));
   EXPECT_FALSE(a.isMember("key2"));
 }
+
+TEST(TestVariant, emplace_back)
+{
+  CVariant a;
+  a.emplace_back() = "string1";
+  EXPECT_TRUE(a.isArray());
+
+  CVariant b;
+  b["key"] = "string2";
+  a.emplace_back().swap(b);
+  EXPECT_TRUE(b.isNull());
+
+  // growing the array keeps the elements intact
+  for (int i = 0; i < 100; i++)
+    a.push_back(i);
+  EXPECT_EQ(102u, a.size());
+  EXPECT_STREQ("string1", a[0].c_str());
+  EXPECT_STREQ("string2", a[1]["key"].c_str());
+  EXPECT_EQ(99, a[101].asInteger());
+
+  // appending an element of the array itself
+  a.push_back(a[1]);
+  EXPECT_STREQ("string2", a[102]["key"].c_str());
+
+  CVariant c("string3");
+  EXPECT_TRUE(c.emplace_back().isNull());
+  EXPECT_STREQ("string3", c.c_str());
+}
+
+TEST(TestVariant, swapConstNull)
+{
+  CVariant a("string1"), b;
+  b["key"] = "string2";
+
+  a.swap(b);
+  EXPECT_STREQ("string2", a["key"].c_str());
+  EXPECT_STREQ("string1", b.c_str());
+
+  // the placeholder for missing members stays empty
+  a.swap(CVariant::ConstNullVariant);
+  EXPECT_TRUE(a.isObject());
+  EXPECT_TRUE(CVariant::ConstNullVariant.isNull());
+}
+
+// 20000 items, too slow for every test run. run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestVariant.*
+TEST(TestVariant, DISABLED_RoundTripBenchmark)
+{
+  // roughly what a client sends to VideoLibrary.SetMovieDetails etc. in bulk
+  CVariant items(CVariant::VariantTypeArray);
+  for (int i = 0; i < BENCHMARK_ITEMS; i++)
+  {
+    CVariant &item = items.emplace_back();
+    item["movieid"] = i;
+    item["title"] = StringUtils::Format("Movie number %d", i);
+    item["genre"].push_back("Drama");
+    item["genre"].push_back("Thriller");
+    item["file"] = StringUtils::Format("/storage/movies/Movie number %d.mkv", i);
+    item["playcount"] = i % 3;
+  }
+  std::string json = CJSONVariantWriter::Write(items, true);
+  double frequency = (double)CurrentHostFrequency();
+
+  // parse, move every other item over to a new list, write it out again
+  for (int swapping = 0; swapping < 2; swapping++)
+  {
+    int64_t start = CurrentHostCounter();
+    CVariant parsed = CJSONVariantParser::Parse((const unsigned char *)json.c_str(), json.size());
+    ASSERT_EQ((unsigned int)BENCHMARK_ITEMS, parsed.size());
+    int64_t parsedAt = CurrentHostCounter();
+
+    CVariant modified(CVariant::VariantTypeArray);
+    for (CVariant::iterator_array item = parsed.begin_array(); item != parsed.end_array(); ++item)
+    {
+      if (item->operator[]("movieid").asInteger() % 2 != 0)
+        continue;
+      (*item)["playcount"] = (*item)["playcount"].asInteger() + 1;
+      if (swapping)
+        modified.emplace_back().swap(*item);
+      else
+        modified.push_back(*item);
+    }
+    int64_t modifiedAt = CurrentHostCounter();
+
+    std::string output = CJSONVariantWriter::Write(modified, true);
+    int64_t end = CurrentHostCounter();
+
+    EXPECT_EQ((unsigned int)BENCHMARK_ITEMS / 2, modified.size());
+    EXPECT_EQ(1, modified[0]["playcount"].asInteger());
+    EXPECT_STREQ("Movie number 2", modified[1]["title"].c_str());
+
+    std::cout << "CVariant round trip (" << (swapping ? "swap" : "copy") << "): "
+              << BENCHMARK_ITEMS << " items, parse " << (parsedAt - start) * 1000.0 / frequency
+              << " ms, modify " << (modifiedAt - parsedAt) * 1000.0 / frequency
+              << " ms, write " << (end - modifiedAt) * 1000.0 / frequency << " ms" << std::endl;
+  }
+}
@@ -23,6 +23,13 @@
 
 #include "gtest/gtest.h"
 
+#include <math.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832795
+#endif
+
 /* refdata[] below was generated using the following Python script.
 
 import math
@@ -298,3 +305,51 @@ TEST(Testfft, twochanwithwindow)
     EXPECT_STREQ(refstr.c_str(), varstr.c_str());
   }
 }
+
+TEST(Testfft, CTwoChannelFFT)
+{
+  int n = REFDATA_NUMELEMENTS / 2;
+  float vardata[REFDATA_NUMELEMENTS];
+  float spectrum[REFDATA_NUMELEMENTS / 2 + 2];
+
+  memcpy(vardata, refdata, sizeof(refdata));
+  twochanwithwindow(vardata, n);
+
+  CTwoChannelFFT fft(n);
+  fft.Calculate(refdata, spectrum);
+  for (int i = 0; i < n + 2; i++)
+    EXPECT_NEAR(vardata[i], spectrum[i], 1e-4 * (1 + vardata[i])) << "value " << i;
+
+  // the input is left alone, so the same samples give the same result again
+  float again[REFDATA_NUMELEMENTS / 2 + 2];
+  fft.Calculate(refdata, again);
+  EXPECT_EQ(0, memcmp(spectrum, again, sizeof(again)));
+}
+
+TEST(Testfft, CTwoChannelFFTChannels)
+{
+  // a sine on the left and a cosine of another frequency on the right stay apart
+  const int n = 512;
+  std::vector<float> samples(2 * n);
+  for (int i = 0; i < n; i++)
+  {
+    samples[2 * i] = (float)sin(2 * M_PI * 32 * i / n);
+    samples[2 * i + 1] = (float)cos(2 * M_PI * 100 * i / n);
+  }
+  std::vector<float> spectrum(n + 2);
+  CTwoChannelFFT fft(n);
+  fft.Calculate(&samples[0], &spectrum[0]);
+
+  int left = 0, right = 0;
+  for (int k = 0; k < n / 2; k++)
+  {
+    if (spectrum[2 * k] > spectrum[2 * left])
+      left = k;
+    if (spectrum[2 * k + 1] > spectrum[2 * right + 1])
+      right = k;
+  }
+  EXPECT_EQ(32, left);
+  EXPECT_EQ(100, right);
+  EXPECT_LT(spectrum[2 * 100], spectrum[2 * 32] * 1e-6);
+  EXPECT_LT(spectrum[2 * 32 + 1], spectrum[2 * 100 + 1] * 1e-6);
+}
@@ -65,6 +65,10 @@ namespace VIDEO
   struct SScanSettings;
 }
 
+// columns of the search index holding titles and names, and plots
+#define VIDEODB_SEARCH_COLUMNS "name,plot,outline,tagline"
+#define VIDEODB_SEARCH_PLOT    "plot,outline,tagline"
+
 // these defines are based on how many columns we have and which column certain data is going to be in
 // when we do GetDetailsForMovie()
 #define VIDEODB_MAX_COLUMNS 24
@@ -726,7 +730,7 @@ public:
 
   // partymode
   unsigned int GetMusicVideoIDs(const std::string& strWhere, std::vector<std::pair<int, int> > &songIDs);
-  bool GetRandomMusicVideo(CFileItem* item, int& idSong, const std::string& strWhere);
+  bool GetPartyModeMusicVideo(CFileItem* item, int idMVideo);
 
   static void VideoContentTypeToString(VIDEODB_CONTENT_TYPE type, std::string& out)
   {
@@ -32,8 +32,10 @@
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
 #include "GUIInfoManager.h"
+#include "ApplicationMessenger.h"
 #include "utils/Variant.h"
 #include "utils/StringUtils.h"
+#include "windowing/WindowingFactory.h"
 
 #include <climits>
 
@@ -116,6 +118,19 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
     info = StringUtils::Format("LOG: %s%s.log\nMEM: %" PRIu64"/%" PRIu64" KB - FPS: %2.1f fps\nCPU: %s (CPU-%s %4.2f%%%s)", g_advancedSettings.m_logFolder.c_str(), lcAppName.c_str(),
                                stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, g_infoManager.GetFPS(), strCores.c_str(), ucAppName.c_str(), dCPU, profiling.c_str());
 #endif
+
+    // depth (max) and latency (avg/max) of the application and gui thread message queues
+    CApplicationMessenger::MessageQueue::Stats app = CApplicationMessenger::Get().GetQueueStats();
+    XbmcThreads::CMPSCQueue< std::pair<CGUIMessage*,int> >::Stats gui = g_windowManager.GetThreadMessageStats();
+    info += StringUtils::Format("\nMSG: app %ld (%ld) %u/%u ms - gui %ld (%ld) %u/%u ms",
+                                app.depth, app.maxDepth, app.processed ? app.totalLatency / app.processed : 0, app.maxLatency,
+                                gui.depth, gui.maxDepth, gui.processed ? gui.totalLatency / gui.processed : 0, gui.maxLatency);
+
+    // what the last frame cost the GPU
+    const RenderStats &render = g_Windowing.GetFrameStats();
+    info += StringUtils::Format("\nGPU: %u draw calls (%u quads batched) - %u vertices - %u uploads (%" PRIu64" KB)",
+                                render.drawCalls, render.batchedQuads, render.vertices,
+                                render.textureUploads, render.textureBytes / 1024);
   }
 
   // render the skin debug info